@@ -0,0 +1,313 @@
+#include "async_logger.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <stdexcept>
+
+namespace mts {
+namespace core {
+
+namespace {
+
+    thread_local LogRing* tlsLogRing = nullptr;
+    thread_local bool tlsRingReturned = false;   // 本執行緒已歸還 ring：之後的記錄直接丟棄
+
+    // 執行緒結束時歸還 ring；只在第一次取得 ring 時建立，熱路徑仍只讀 tlsLogRing
+    struct RingLease {
+        LogRing* ring = nullptr;
+        ~RingLease() {
+            if (ring != nullptr) {
+                tlsLogRing = nullptr;
+                tlsRingReturned = true;
+                ring->retire();
+            }
+        }
+    };
+
+    template <typename T>
+    T readScalar(const char*& pos) noexcept {
+        T value;
+        std::memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    template <typename T>
+    void appendNumber(std::string& out, T value) {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    // 解碼一個參數並附加到 out；已無參數時回傳 false
+    bool appendArg(const char*& pos, const char* end, std::string& out) {
+        if (pos >= end) {
+            return false;
+        }
+        switch (*pos++) {
+            case 'i': appendNumber(out, readScalar<int64_t>(pos)); break;
+            case 'u': appendNumber(out, readScalar<uint64_t>(pos)); break;
+            case 'd': appendNumber(out, readScalar<double>(pos)); break;
+            case 'c': out.push_back(readScalar<char>(pos)); break;
+            case 'b': out.append(readScalar<uint8_t>(pos) ? "true" : "false"); break;
+            case 'p': {
+                char buffer[24] = "0x";
+                auto result = std::to_chars(buffer + 2, buffer + sizeof(buffer), readScalar<uintptr_t>(pos), 16);
+                out.append(buffer, result.ptr);
+                break;
+            }
+            case 's': {
+                uint16_t length = readScalar<uint16_t>(pos);
+                out.append(pos, length);
+                pos += length;
+                break;
+            }
+            default:
+                pos = end;   // 無法辨識：停止解碼
+                return false;
+        }
+        return true;
+    }
+
+    // [HH:MM:SS.ffffff]（本地時間）
+    void appendTimestamp(std::string& out, uint64_t timestampNs) {
+        std::time_t seconds = static_cast<std::time_t>(timestampNs / 1000000000ull);
+        uint64_t micros = (timestampNs / 1000ull) % 1000000ull;
+        std::tm local{};
+#ifdef _WIN32
+        localtime_s(&local, &seconds);
+#else
+        localtime_r(&seconds, &local);
+#endif
+        char buffer[32];
+        int length = std::snprintf(buffer, sizeof(buffer), "[%02d:%02d:%02d.%06llu] ",
+                                   local.tm_hour, local.tm_min, local.tm_sec,
+                                   static_cast<unsigned long long>(micros));
+        out.append(buffer, static_cast<size_t>(length));
+    }
+
+} // namespace
+
+const char* logLevelToString(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info:  return "INFO";
+        case LogLevel::Warn:  return "WARN";
+        case LogLevel::Error: return "ERROR";
+        case LogLevel::Off:   return "OFF";
+        default:              return "UNKNOWN";
+    }
+}
+
+// ===== LogRing =====
+
+LogRing::LogRing(size_t capacity, uint32_t threadIndex)
+    : capacity_(capacity), mask_(capacity - 1), threadIndex_(threadIndex) {
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+        throw std::invalid_argument("LogRing capacity must be a power of two >= 2");
+    }
+    slots_ = std::make_unique<LogRecord[]>(capacity);
+}
+
+// ===== AsyncLogger =====
+
+AsyncLogger& AsyncLogger::instance() {
+    // 刻意不解構：其他執行緒在靜態解構期間仍可能寫日誌；
+    // 結束時由 atexit 寫出剩餘記錄
+    static AsyncLogger* logger = [] {
+        auto* created = new AsyncLogger();
+        std::atexit([] { AsyncLogger::instance().flush(); });
+        return created;
+    }();
+    return *logger;
+}
+
+AsyncLogger::AsyncLogger() {
+    thread_ = std::thread(&AsyncLogger::run, this);
+    thread_.detach();
+}
+
+LogRing* AsyncLogger::threadRing() noexcept {
+    if (tlsLogRing != nullptr) {
+        return tlsLogRing;
+    }
+    if (tlsRingReturned) {
+        return nullptr;   // 執行緒正在結束（其他 thread_local 解構時寫日誌）
+    }
+    AsyncLogger& logger = instance();
+    try {
+        std::lock_guard<std::mutex> lock(logger.ringsMutex_);
+        // 優先沿用已結束執行緒留下、且已被背景執行緒讀完的 ring
+        LogRing* ring = nullptr;
+        for (auto& candidate : logger.rings_) {
+            if (candidate->tryReuse()) {
+                ring = candidate.get();
+                break;
+            }
+        }
+        if (ring == nullptr) {
+            uint32_t index = static_cast<uint32_t>(logger.rings_.size());
+            logger.rings_.push_back(std::make_unique<LogRing>(RING_CAPACITY, index));
+            ring = logger.rings_.back().get();
+        }
+        thread_local RingLease lease;
+        lease.ring = ring;
+        tlsLogRing = ring;
+    } catch (...) {
+        return nullptr;   // 配置失敗時放棄這筆記錄
+    }
+    return tlsLogRing;
+}
+
+uint64_t AsyncLogger::nowNs() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+bool AsyncLogger::setOutputFile(const std::string& path) {
+    std::lock_guard<std::mutex> lock(drainMutex_);
+    drain();
+    if (file_ != nullptr) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+    if (path.empty()) {
+        return true;
+    }
+    file_ = std::fopen(path.c_str(), "a");
+    return file_ != nullptr;
+}
+
+void AsyncLogger::flush() {
+    std::lock_guard<std::mutex> lock(drainMutex_);
+    while (drain() > 0) {
+    }
+}
+
+uint64_t AsyncLogger::droppedRecords() const {
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    uint64_t dropped = 0;
+    for (const auto& ring : rings_) {
+        dropped += ring->dropped();
+    }
+    return dropped;
+}
+
+size_t AsyncLogger::ringCount() const {
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    return rings_.size();
+}
+
+void AsyncLogger::run() {
+    while (true) {
+        size_t drained;
+        {
+            std::lock_guard<std::mutex> lock(drainMutex_);
+            drained = drain();
+        }
+        if (drained == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+size_t AsyncLogger::drain() {
+    struct Pending {
+        const LogRecord* record;
+        size_t ring;
+    };
+
+    // 只在執行緒註冊時增加、不會釋放；複製指標後即可放開鎖
+    std::vector<LogRing*> rings;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        rings.reserve(rings_.size());
+        for (auto& ring : rings_) {
+            rings.push_back(ring.get());
+        }
+    }
+
+    std::vector<Pending> pending;
+    std::vector<size_t> counts(rings.size(), 0);
+    uint64_t dropped = 0;
+    for (size_t i = 0; i < rings.size(); ++i) {
+        counts[i] = rings[i]->available();
+        for (size_t j = 0; j < counts[i]; ++j) {
+            pending.push_back(Pending{&rings[i]->peek(j), i});
+        }
+        dropped += rings[i]->dropped();
+    }
+
+    // 各執行緒的記錄交錯，依時間排序後輸出
+    std::stable_sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) {
+        return a.record->timestampNs < b.record->timestampNs;
+    });
+
+    std::string message;
+    for (const auto& entry : pending) {
+        const LogRecord& record = *entry.record;
+        std::string& out = (file_ == nullptr && record.level >= LogLevel::Warn) ? stderrBuffer_ : stdoutBuffer_;
+        appendTimestamp(out, record.timestampNs);
+        const char* level = logLevelToString(record.level);
+        out.push_back('[');
+        out.append(level);
+        out.append(5 - std::min<size_t>(5, std::strlen(level)), ' ');
+        out.append("] [T");
+        appendNumber(out, record.threadIndex);
+        out.append("] ");
+        message.clear();
+        formatMessage(record.format, record.args, record.argBytes, record.truncated, message);
+        out.append(message);
+        out.push_back('\n');
+    }
+
+    if (dropped > reportedDrops_) {
+        std::string& out = file_ ? stdoutBuffer_ : stderrBuffer_;
+        out.append("[WARN ] ");
+        appendNumber(out, dropped - reportedDrops_);
+        out.append(" log records dropped (ring full)\n");
+        reportedDrops_ = dropped;
+    }
+
+    for (size_t i = 0; i < rings.size(); ++i) {
+        if (counts[i] > 0) {
+            rings[i]->release(counts[i]);
+        }
+    }
+
+    if (!stdoutBuffer_.empty()) {
+        std::FILE* target = file_ ? file_ : stdout;
+        std::fwrite(stdoutBuffer_.data(), 1, stdoutBuffer_.size(), target);
+        std::fflush(target);
+        stdoutBuffer_.clear();
+    }
+    if (!stderrBuffer_.empty()) {
+        std::fwrite(stderrBuffer_.data(), 1, stderrBuffer_.size(), stderr);
+        stderrBuffer_.clear();
+    }
+    return pending.size();
+}
+
+void AsyncLogger::formatMessage(const char* format, const char* args, size_t argBytes, bool truncated,
+                                std::string& out) {
+    const char* pos = args;
+    const char* end = args + argBytes;
+    for (const char* p = format; *p != '\0'; ++p) {
+        if (p[0] == '{' && p[1] == '}') {
+            if (!appendArg(pos, end, out)) {
+                out.append("{}");
+            }
+            ++p;
+            continue;
+        }
+        out.push_back(*p);
+    }
+    if (truncated) {
+        out.append("…");
+    }
+}
+
+} // namespace core
+} // namespace mts
@@ -0,0 +1,335 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ===== 編譯期日誌等級 =====
+// 由 CMake 的 LOG_LEVEL 設定；低於此等級的 MTS_LOG_* 展開為空敘述，參數不會被求值
+#define MTS_LOG_LEVEL_DEBUG 0
+#define MTS_LOG_LEVEL_INFO  1
+#define MTS_LOG_LEVEL_WARN  2
+#define MTS_LOG_LEVEL_ERROR 3
+#define MTS_LOG_LEVEL_OFF   4
+
+#ifndef MTS_LOG_LEVEL
+    #define MTS_LOG_LEVEL MTS_LOG_LEVEL_INFO
+#endif
+
+namespace mts {
+namespace core {
+
+enum class LogLevel : uint8_t {
+    Debug = MTS_LOG_LEVEL_DEBUG,
+    Info = MTS_LOG_LEVEL_INFO,
+    Warn = MTS_LOG_LEVEL_WARN,
+    Error = MTS_LOG_LEVEL_ERROR,
+    Off = MTS_LOG_LEVEL_OFF
+};
+
+const char* logLevelToString(LogLevel level);
+
+// ===== 二進位日誌記錄 =====
+
+/*
+   一筆記錄佔一個固定大小的槽位，熱路徑只複製參數，不做格式化：
+   ┌────────────┬─────────────┬───────┬───────────┬──────────┬────────────────────┐
+   │ format (8) │ timeNs (8)  │ level │ truncated │ argBytes │ thread (4) │ args… │
+   └────────────┴─────────────┴───────┴───────────┴──────────┴────────────────────┘
+   format 是字串常值的位址（即格式 id），由背景執行緒以 "{}" 依序代入參數
+   參數編碼：1 byte 型別標記 + 內容
+     'i' int64 │ 'u' uint64 │ 'd' double │ 'c' char │ 'b' bool │ 'p' 指標
+     's' uint16 長度 + 位元組（放不下時截斷，後續參數捨棄）
+*/
+struct LogRecord {
+    static constexpr size_t SIZE = 512;
+    static constexpr size_t ARG_CAPACITY = SIZE - 24;
+
+    const char* format;
+    uint64_t timestampNs;      // system_clock
+    LogLevel level;
+    bool truncated;
+    uint16_t argBytes;
+    uint32_t threadIndex;
+    char args[ARG_CAPACITY];
+};
+
+static_assert(sizeof(LogRecord) == LogRecord::SIZE, "LogRecord must fill exactly one slot");
+
+class LogArgWriter {
+public:
+    LogArgWriter(char* buffer, size_t capacity) noexcept : begin_(buffer), pos_(buffer), end_(buffer + capacity) {}
+
+    void putInt(int64_t value) noexcept { putScalar('i', value); }
+    void putUint(uint64_t value) noexcept { putScalar('u', value); }
+    void putDouble(double value) noexcept { putScalar('d', value); }
+    void putChar(char value) noexcept { putScalar('c', value); }
+    void putBool(bool value) noexcept { putScalar('b', static_cast<uint8_t>(value)); }
+    void putPointer(const void* value) noexcept { putScalar('p', reinterpret_cast<uintptr_t>(value)); }
+
+    void putString(std::string_view value) noexcept {
+        if (truncated_ || end_ - pos_ < 3) {
+            truncated_ = true;
+            return;
+        }
+        size_t room = static_cast<size_t>(end_ - pos_) - 3;
+        uint16_t length = static_cast<uint16_t>(std::min<size_t>({value.size(), room, UINT16_MAX}));
+        *pos_++ = 's';
+        std::memcpy(pos_, &length, sizeof(length));
+        pos_ += sizeof(length);
+        std::memcpy(pos_, value.data(), length);
+        pos_ += length;
+        truncated_ = length < value.size();
+    }
+
+    size_t size() const noexcept { return static_cast<size_t>(pos_ - begin_); }
+    bool truncated() const noexcept { return truncated_; }
+
+private:
+    template <typename T>
+    void putScalar(char tag, T value) noexcept {
+        if (truncated_ || static_cast<size_t>(end_ - pos_) < 1 + sizeof(T)) {
+            truncated_ = true;
+            return;
+        }
+        *pos_++ = tag;
+        std::memcpy(pos_, &value, sizeof(T));
+        pos_ += sizeof(T);
+    }
+
+    char* begin_;
+    char* pos_;
+    char* end_;
+    bool truncated_ = false;
+};
+
+template <typename T>
+struct LogUnsupportedArg : std::false_type {};
+
+// 依參數型別選擇編碼；不支援的型別在編譯期報錯（請先轉成字串或數值）
+template <typename T>
+void encodeLogArg(LogArgWriter& writer, const T& value) noexcept {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool>) {
+        writer.putBool(value);
+    } else if constexpr (std::is_same_v<U, char>) {
+        writer.putChar(value);
+    } else if constexpr (std::is_enum_v<U>) {
+        writer.putInt(static_cast<int64_t>(value));
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        writer.putInt(static_cast<int64_t>(value));
+    } else if constexpr (std::is_integral_v<U>) {
+        writer.putUint(static_cast<uint64_t>(value));
+    } else if constexpr (std::is_floating_point_v<U>) {
+        writer.putDouble(static_cast<double>(value));
+    } else if constexpr (std::is_array_v<T>) {
+        // 字元陣列（含字串常值）：位址不會是 null，長度以陣列大小為上限，不要求以 '\0' 結尾
+        static_assert(std::is_same_v<std::remove_cv_t<std::remove_extent_t<T>>, char>, "unsupported log argument type");
+        writer.putString(std::string_view(value, ::strnlen(value, std::extent_v<T>)));
+    } else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>) {
+        writer.putString(value ? std::string_view(value) : std::string_view("(null)"));
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        writer.putString(std::string_view(value));
+    } else if constexpr (std::is_pointer_v<U>) {
+        writer.putPointer(value);
+    } else {
+        static_assert(LogUnsupportedArg<T>::value, "unsupported log argument type");
+    }
+}
+
+/*
+┌──────────────────────────────────────────────┐
+│                   LogRing                    │
+├──────────────────────────────────────────────┤
+│ • 單生產者 / 單消費者，固定數量的 LogRecord 槽位 │
+│ • 生產者：claim() 取得槽位就地寫入 → publish()  │
+│ • 消費者：背景執行緒讀取後 release()            │
+│ • 已滿時 claim() 回傳 nullptr，記錄被丟棄並計數 │
+│ • 擁有的執行緒結束時 retire()，清空後可給新執行緒 │
+└──────────────────────────────────────────────┘
+*/
+class LogRing {
+public:
+    LogRing(size_t capacity, uint32_t threadIndex);
+
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    LogRecord* claim() noexcept {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= capacity_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &slots_[head & mask_];
+    }
+
+    void publish() noexcept {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // ===== 消費者 =====
+    size_t available() const noexcept {
+        return static_cast<size_t>(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed));
+    }
+    const LogRecord& peek(size_t offset) const noexcept {
+        return slots_[(tail_.load(std::memory_order_relaxed) + offset) & mask_];
+    }
+    void release(size_t count) noexcept {
+        tail_.store(tail_.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    uint32_t threadIndex() const noexcept { return threadIndex_; }
+    uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    // ===== 回收 =====
+    // 生產者結束後呼叫；之前發佈的記錄仍由消費者照常讀出
+    void retire() noexcept { retired_.store(true, std::memory_order_release); }
+    // 已退役且已讀完時交給新的生產者（需由 AsyncLogger 在 ringsMutex_ 下呼叫）
+    bool tryReuse() noexcept {
+        if (!retired_.load(std::memory_order_acquire) || available() != 0) {
+            return false;
+        }
+        retired_.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    const uint64_t capacity_;
+    const uint64_t mask_;
+    const uint32_t threadIndex_;
+    std::unique_ptr<LogRecord[]> slots_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> retired_{false};
+};
+
+/*
+┌──────────────────────────────────────────────────────────┐
+│                        AsyncLogger                        │
+├──────────────────────────────────────────────────────────┤
+│ • 行程唯一，第一次使用時啟動背景執行緒，行程結束時寫出剩餘記錄 │
+│ • 熱路徑：取得本執行緒的 LogRing → 複製格式 id 與參數 → 發佈 │
+│   不加鎖、不配置記憶體、不做格式化、不碰 stdout             │
+│ • 執行緒結束時歸還 ring，清空後由下一條新執行緒沿用          │
+│   （[T#] 為 ring 編號），ring 數量以同時存在的執行緒為上限    │
+│ • 背景執行緒：收集所有 ring，依時間排序、格式化後一次寫出      │
+│   Debug / Info → stdout，Warn / Error → stderr；           │
+│   setOutputFile() 後全部寫入檔案                          │
+└──────────────────────────────────────────────────────────┘
+   MTS_LOG_INFO("Order {} submitted to shard {}", orderId, shard);
+     → [12:34:56.789012] [INFO ] [T3] Order 42 submitted to shard 1
+*/
+class AsyncLogger {
+public:
+    static constexpr size_t RING_CAPACITY = 2048;   // 每條執行緒的槽位數
+
+    static AsyncLogger& instance();
+
+    template <size_t N, typename... Args>
+    static void write(LogLevel level, const char (&format)[N], const Args&... args) noexcept {
+        AsyncLogger& logger = instance();
+        if (level < logger.minLevel_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        LogRing* ring = threadRing();
+        LogRecord* record = ring ? ring->claim() : nullptr;
+        if (record == nullptr) {
+            return;
+        }
+        record->format = format;
+        record->timestampNs = nowNs();
+        record->level = level;
+        record->threadIndex = ring->threadIndex();
+        LogArgWriter writer(record->args, LogRecord::ARG_CAPACITY);
+        (encodeLogArg(writer, args), ...);
+        record->argBytes = static_cast<uint16_t>(writer.size());
+        record->truncated = writer.truncated();
+        ring->publish();
+    }
+
+    // 執行期等級（在編譯期過濾之上再過濾）
+    void setLevel(LogLevel level) noexcept { minLevel_.store(level, std::memory_order_relaxed); }
+    LogLevel getLevel() const noexcept { return minLevel_.load(std::memory_order_relaxed); }
+
+    // 之後的記錄全部寫入 path；空字串恢復為 stdout / stderr
+    bool setOutputFile(const std::string& path);
+
+    // 在呼叫端同步寫出目前已發佈的所有記錄
+    void flush();
+
+    uint64_t droppedRecords() const;
+    size_t ringCount() const;
+
+    // 以記錄的參數代入格式字串（背景執行緒與測試使用）
+    static void formatMessage(const char* format, const char* args, size_t argBytes, bool truncated,
+                              std::string& out);
+
+private:
+    AsyncLogger();
+
+    static LogRing* threadRing() noexcept;
+    static uint64_t nowNs() noexcept;
+
+    void run();
+    size_t drain();   // 需持有 drainMutex_
+
+    std::atomic<LogLevel> minLevel_{LogLevel::Debug};
+
+    mutable std::mutex ringsMutex_;
+    std::vector<std::unique_ptr<LogRing>> rings_;   // 只增不減：退役的 ring 清空後重用
+
+    std::mutex drainMutex_;
+    std::FILE* file_ = nullptr;
+    uint64_t reportedDrops_ = 0;
+    std::string stdoutBuffer_;
+    std::string stderrBuffer_;
+
+    std::thread thread_;
+};
+
+} // namespace core
+} // namespace mts
+
+// ===== 日誌巨集 =====
+// 格式字串必須是字串常值，"{}" 依序代入參數
+
+#define MTS_LOG_AT(level, ...) ::mts::core::AsyncLogger::write(level, __VA_ARGS__)
+
+#if MTS_LOG_LEVEL <= MTS_LOG_LEVEL_DEBUG
+    #define MTS_LOG_DEBUG(...) MTS_LOG_AT(::mts::core::LogLevel::Debug, __VA_ARGS__)
+    // 舊有 stream 風格的除錯巨集：在呼叫端組字串後以單一參數送出
+    #define MTS_LOG_DEBUG_STREAM(msg) \
+        do { std::ostringstream mtsLogStream_; mtsLogStream_ << msg; MTS_LOG_DEBUG("{}", mtsLogStream_.str()); } while (0)
+#else
+    #define MTS_LOG_DEBUG(...) do {} while (0)
+    #define MTS_LOG_DEBUG_STREAM(msg) do {} while (0)
+#endif
+
+#if MTS_LOG_LEVEL <= MTS_LOG_LEVEL_INFO
+    #define MTS_LOG_INFO(...) MTS_LOG_AT(::mts::core::LogLevel::Info, __VA_ARGS__)
+#else
+    #define MTS_LOG_INFO(...) do {} while (0)
+#endif
+
+#if MTS_LOG_LEVEL <= MTS_LOG_LEVEL_WARN
+    #define MTS_LOG_WARN(...) MTS_LOG_AT(::mts::core::LogLevel::Warn, __VA_ARGS__)
+#else
+    #define MTS_LOG_WARN(...) do {} while (0)
+#endif
+
+#if MTS_LOG_LEVEL <= MTS_LOG_LEVEL_ERROR
+    #define MTS_LOG_ERROR(...) MTS_LOG_AT(::mts::core::LogLevel::Error, __VA_ARGS__)
+#else
+    #define MTS_LOG_ERROR(...) do {} while (0)
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+namespace mts {
+namespace core {
+
+// ===== 溢位檢查的整數運算 =====
+// 成功時寫入 out 並回傳 true；溢位時回傳 false，out 不變。
+// GCC/Clang 使用內建函式，MSVC 以先除後乘的邊界檢查代替
+
+inline bool checkedMul(int64_t a, int64_t b, int64_t& out) noexcept {
+#ifdef _MSC_VER
+    constexpr int64_t MAX = std::numeric_limits<int64_t>::max();
+    constexpr int64_t MIN = std::numeric_limits<int64_t>::min();
+    bool overflow;
+    if (a > 0) {
+        overflow = b > 0 ? a > MAX / b : b < MIN / a;
+    } else {
+        overflow = b > 0 ? a < MIN / b : (a != 0 && b < MAX / a);
+    }
+    if (overflow) {
+        return false;
+    }
+    out = a * b;
+    return true;
+#else
+    int64_t result;
+    if (__builtin_mul_overflow(a, b, &result)) {
+        return false;
+    }
+    out = result;
+    return true;
+#endif
+}
+
+inline bool checkedMul(uint64_t a, uint64_t b, uint64_t& out) noexcept {
+    if (b != 0 && a > std::numeric_limits<uint64_t>::max() / b) {
+        return false;
+    }
+    out = a * b;
+    return true;
+}
+
+inline bool checkedAdd(uint64_t a, uint64_t b, uint64_t& out) noexcept {
+    if (a > std::numeric_limits<uint64_t>::max() - b) {
+        return false;
+    }
+    out = a + b;
+    return true;
+}
+
+} // namespace core
+} // namespace mts
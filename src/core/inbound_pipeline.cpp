@@ -0,0 +1,172 @@
+#include "inbound_pipeline.h"
+#include "async_logger.h"
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace mts {
+namespace core {
+
+std::string InboundStatistics::toString() const {
+    std::ostringstream oss;
+    oss << "Inbound[connects=" << connects.load()
+        << " frames=" << framesPosted.load()
+        << " largeFrames=" << largeFrames.load()
+        << " disconnects=" << disconnects.load()
+        << " ringFullWaits=" << ringFullWaits.load()
+        << " processed=" << eventsProcessed.load() << "]";
+    return oss.str();
+}
+
+// ===== 建構 / 生命週期 =====
+
+InboundPipeline::InboundPipeline(const InboundConfig& config)
+    : config_(config) {
+    if (config_.stageThreadCount == 0) {
+        throw std::invalid_argument("InboundPipeline requires at least one stage thread");
+    }
+    stages_.reserve(config_.stageThreadCount);
+    for (size_t i = 0; i < config_.stageThreadCount; ++i) {
+        stages_.push_back(std::make_unique<Stage>(i, config_.ringCapacity, config_.waitStrategy));
+    }
+}
+
+InboundPipeline::~InboundPipeline() {
+    stop();
+}
+
+bool InboundPipeline::start() {
+    if (running_.load()) {
+        return false;
+    }
+    if (!eventHandler_) {
+        MTS_LOG_ERROR("InboundPipeline requires an event handler");
+        return false;
+    }
+
+    running_ = true;
+    stagesRunning_ = true;
+    for (auto& stage : stages_) {
+        stage->thread = std::thread(&InboundPipeline::stageLoop, this, std::ref(*stage));
+    }
+    return true;
+}
+
+void InboundPipeline::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    stagesRunning_ = false;
+    for (auto& stage : stages_) {
+        stage->waiter.wakeAll();
+        if (stage->thread.joinable()) {
+            stage->thread.join();
+        }
+    }
+}
+
+// ===== 解碼執行緒端 =====
+
+template <typename Fill>
+void InboundPipeline::publish(uint64_t sessionId, Fill&& fill) {
+    Stage& stage = *stages_[stageForSession(sessionId)];
+    if (!stage.ring.tryPublish(fill)) {
+        // Session 執行緒跟不上：喚醒它並讓出 CPU，直到有空位
+        stats_.ringFullWaits.fetch_add(1, std::memory_order_relaxed);
+        do {
+            stage.waiter.notify();
+            std::this_thread::yield();
+        } while (!stage.ring.tryPublish(fill));
+    }
+    stage.waiter.notify();
+}
+
+void InboundPipeline::postConnect(uint64_t sessionId) {
+    publish(sessionId, [sessionId](InboundEvent& event) noexcept {
+        event.type = InboundEventType::Connect;
+        event.sessionId = sessionId;
+        event.length = 0;
+        event.trace.mask = 0;
+    });
+    stats_.connects.fetch_add(1, std::memory_order_relaxed);
+}
+
+void InboundPipeline::postFrame(uint64_t sessionId, std::string_view frame) {
+    bool large = frame.size() > InboundEvent::INLINE_FRAME_SIZE;
+    publish(sessionId, [sessionId, frame, large](InboundEvent& event) noexcept {
+        event.type = InboundEventType::Frame;
+        event.sessionId = sessionId;
+        event.length = static_cast<uint32_t>(frame.size());
+        if (!large) {
+            std::memcpy(event.inlineFrame, frame.data(), frame.size());
+        } else {
+            try {
+                event.largeFrame.assign(frame.data(), frame.size());
+            } catch (...) {
+                event.length = 0;   // 配置失敗：以空訊息送出，由 Session 端解析失敗記錄
+            }
+        }
+        OrderTracer::takePending(event.trace);
+    });
+    stats_.framesPosted.fetch_add(1, std::memory_order_relaxed);
+    if (large) {
+        stats_.largeFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void InboundPipeline::postDisconnect(uint64_t sessionId) {
+    publish(sessionId, [sessionId](InboundEvent& event) noexcept {
+        event.type = InboundEventType::Disconnect;
+        event.sessionId = sessionId;
+        event.length = 0;
+        event.trace.mask = 0;
+    });
+    stats_.disconnects.fetch_add(1, std::memory_order_relaxed);
+}
+
+// ===== Session 執行緒 =====
+
+void InboundPipeline::stageLoop(Stage& stage) {
+    pinCurrentThread(cpuForThread(config_.stageCpus, stage.index), "Session");
+
+    while (true) {
+        if (drainStage(stage) > 0) {
+            continue;
+        }
+        // 停止時佇列已清空才離開
+        if (!stagesRunning_.load(std::memory_order_relaxed)) {
+            break;
+        }
+        stage.waiter.wait([this, &stage] {
+            return !stage.ring.empty() || !stagesRunning_.load(std::memory_order_relaxed);
+        });
+    }
+}
+
+size_t InboundPipeline::drainStage(Stage& stage) {
+    size_t processed = 0;
+    while (processed < DRAIN_BATCH_SIZE) {
+        InboundEvent* event = stage.ring.front();
+        if (event == nullptr) {
+            break;
+        }
+        if (event->type == InboundEventType::Frame) {
+            OrderTracer::restorePending(event->trace);
+        }
+        try {
+            eventHandler_(*event);
+        } catch (const std::exception& e) {
+            MTS_LOG_ERROR("❌ Inbound event handler error for session {}: {}", event->sessionId, e.what());
+        }
+        stage.ring.release();
+        ++processed;
+    }
+    if (processed > 0) {
+        stats_.eventsProcessed.fetch_add(processed, std::memory_order_relaxed);
+    }
+    return processed;
+}
+
+} // namespace core
+} // namespace mts
@@ -0,0 +1,139 @@
+#pragma once
+#include "mpsc_ring.h"
+#include "order_trace.h"
+#include "thread_affinity.h"
+#include "wait_strategy.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace mts {
+namespace core {
+
+// ===== 輸入管線 =====
+
+enum class InboundEventType : uint8_t {
+    Connect,      // 新連線：建立 Session
+    Frame,        // 一筆完整的 FIX 訊息
+    Disconnect    // 連線關閉：清理 Session
+};
+
+// 預先配置在環形佇列中的槽位：解碼執行緒直接寫入、Session 執行緒直接讀取，不經過暫存物件
+struct InboundEvent {
+    static constexpr size_t INLINE_FRAME_SIZE = 512;   // 一般訂單訊息放得下，更長的才用 largeFrame
+
+    InboundEventType type = InboundEventType::Frame;
+    uint64_t sessionId = 0;
+    uint32_t length = 0;
+    PendingTrace trace;                       // 解碼端尚未綁定 OrderID 的追蹤點（Recv / Frame）
+    char inlineFrame[INLINE_FRAME_SIZE];
+    std::string largeFrame;                   // 容量保留給之後重用此槽位的大訊息
+
+    // 只在事件處理回調期間有效
+    std::string_view frame() const noexcept {
+        return length <= INLINE_FRAME_SIZE ? std::string_view(inlineFrame, length) : std::string_view(largeFrame);
+    }
+};
+
+struct InboundConfig {
+    size_t ringCapacity = 4096;       // 每條 Session 執行緒的輸入環形佇列容量，2 的次方
+    size_t stageThreadCount = 1;      // Session / 風控階段的執行緒數，連線依 id 分配
+    WaitStrategy waitStrategy = WaitStrategy::Blocking;   // Session 執行緒的等待策略
+    CpuList stageCpus;                // Session 執行緒 i 綁到 cpuForThread(stageCpus, i)
+};
+
+struct InboundStatistics {
+    std::atomic<uint64_t> connects{0};
+    std::atomic<uint64_t> framesPosted{0};
+    std::atomic<uint64_t> largeFrames{0};        // 超過內嵌容量、改用 heap 的訊息
+    std::atomic<uint64_t> disconnects{0};
+    std::atomic<uint64_t> ringFullWaits{0};      // 環形佇列已滿、解碼執行緒被迫等待的次數
+    std::atomic<uint64_t> eventsProcessed{0};
+
+    std::string toString() const;
+};
+
+/*
+┌──────────────────────────────────────────────────────────────┐
+│                        InboundPipeline                        │
+├──────────────────────────────────────────────────────────────┤
+│ 解碼執行緒 ×R（reactor：recv → 分幀）                          │
+│        │ post*() 依 sessionId % S 選擇環形佇列，原地寫入槽位      │
+│        ▼                                                      │
+│ MpscRing<InboundEvent> ×S（每條 Session 執行緒一個）            │
+│        │                                                      │
+│        ▼                                                      │
+│ Session 執行緒 ×S：EventHandler                               │
+│   （解析、FIX Session 驗證、轉換、風控欄位檢查、送入撮合）        │
+└──────────────────────────────────────────────────────────────┘
+   • 同一連線的 Connect / Frame / Disconnect 進同一個佇列，依序處理
+   • Session 狀態只由所屬 Session 執行緒存取，處理時不需全域鎖
+   • 環形佇列滿時解碼執行緒讓出 CPU 等待，壓力傳回 TCP 接收端
+*/
+class InboundPipeline {
+public:
+    // 在 Session 執行緒上呼叫；event 只在回調期間有效
+    using EventHandler = std::function<void(const InboundEvent& event)>;
+
+    static constexpr size_t DRAIN_BATCH_SIZE = 256;   // 每次喚醒最多連續處理的事件數
+
+    explicit InboundPipeline(const InboundConfig& config = InboundConfig());
+    ~InboundPipeline();
+
+    InboundPipeline(const InboundPipeline&) = delete;
+    InboundPipeline& operator=(const InboundPipeline&) = delete;
+
+    // ===== 設定（需在 start() 前呼叫）=====
+    void setEventHandler(EventHandler handler) { eventHandler_ = std::move(handler); }
+
+    // ===== 生命週期 =====
+    bool start();
+    // 處理完佇列中剩餘的事件再結束執行緒；需在解碼端停止後呼叫
+    void stop();
+    bool isRunning() const noexcept { return running_.load(); }
+
+    // ===== 解碼執行緒端（任意執行緒）=====
+    void postConnect(uint64_t sessionId);
+    void postFrame(uint64_t sessionId, std::string_view frame);
+    void postDisconnect(uint64_t sessionId);
+
+    size_t stageForSession(uint64_t sessionId) const noexcept {
+        return static_cast<size_t>(sessionId % stages_.size());
+    }
+    size_t getStageCount() const noexcept { return stages_.size(); }
+    const InboundConfig& getConfig() const noexcept { return config_; }
+    const InboundStatistics& getStatistics() const noexcept { return stats_; }
+
+private:
+    struct Stage {
+        Stage(size_t index, size_t capacity, WaitStrategy strategy)
+            : index(index), ring(capacity), waiter(strategy) {}
+
+        size_t index;
+        MpscRing<InboundEvent> ring;
+        IdleWaiter waiter;
+        std::thread thread;
+    };
+
+    template <typename Fill>
+    void publish(uint64_t sessionId, Fill&& fill);
+    void stageLoop(Stage& stage);
+    size_t drainStage(Stage& stage);
+
+    InboundConfig config_;
+    std::vector<std::unique_ptr<Stage>> stages_;
+    EventHandler eventHandler_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stagesRunning_{false};
+
+    InboundStatistics stats_;
+};
+
+} // namespace core
+} // namespace mts
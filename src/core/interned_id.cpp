@@ -0,0 +1,59 @@
+#include "interned_id.h"
+#include <stdexcept>
+
+namespace mts {
+namespace core {
+
+InternTable::InternTable() {
+    for (auto& chunk : chunks_) {
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
+    intern("");   // ID 0：空字串
+}
+
+InternTable::~InternTable() {
+    for (auto& chunk : chunks_) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+InternTable::Id InternTable::find(std::string_view name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    return it != ids_.end() ? it->second : NOT_FOUND;
+}
+
+InternTable::Id InternTable::intern(std::string_view name) {
+    // 快速路徑：已存在的名稱只需共享鎖
+    Id existing = find(name);
+    if (existing != NOT_FOUND) {
+        return existing;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;   // 取得獨佔鎖前已被其他執行緒加入
+    }
+
+    size_t index = size_.load(std::memory_order_relaxed);
+    if (index >= CHUNK_SIZE * MAX_CHUNKS) {
+        throw std::length_error("InternTable capacity exceeded");
+    }
+
+    std::string* chunk = chunks_[index / CHUNK_SIZE].load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new std::string[CHUNK_SIZE];
+        chunks_[index / CHUNK_SIZE].store(chunk, std::memory_order_release);
+    }
+
+    std::string& slot = chunk[index % CHUNK_SIZE];
+    slot.assign(name.data(), name.size());
+    Id id = static_cast<Id>(index);
+    ids_.emplace(std::string_view(slot), id);
+    size_.store(index + 1, std::memory_order_release);
+    return id;
+}
+
+} // namespace core
+} // namespace mts
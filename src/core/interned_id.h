@@ -0,0 +1,123 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace mts {
+namespace core {
+
+// ===== 字串駐留 (interning) =====
+
+/*
+┌──────────────────────────────────────────────┐
+│                 InternTable                  │
+├──────────────────────────────────────────────┤
+│ • 字串 ↔ 緊湊整數 ID，ID 由 0 起連續配發         │
+│ • ID 0 固定為空字串                             │
+│ • 名稱存於固定大小的區塊，位址永不移動             │
+│ • 以 ID 查名稱不加鎖；只有新增時取得獨佔鎖          │
+└──────────────────────────────────────────────┘
+   chunks_[id / CHUNK_SIZE][id % CHUNK_SIZE] = "AAPL"
+   ids_["AAPL"] = id        （key 為指向區塊內字串的 string_view）
+*/
+class InternTable {
+public:
+    using Id = uint32_t;
+    static constexpr size_t CHUNK_SIZE = 1024;
+    static constexpr size_t MAX_CHUNKS = 1024;     // 最多約 100 萬個名稱
+    static constexpr Id NOT_FOUND = UINT32_MAX;
+
+    InternTable();
+    ~InternTable();
+
+    InternTable(const InternTable&) = delete;
+    InternTable& operator=(const InternTable&) = delete;
+
+    // 取得（必要時配發）名稱的 ID；容量用盡時丟出 std::length_error
+    Id intern(std::string_view name);
+
+    // 只查詢，不存在時回傳 NOT_FOUND
+    Id find(std::string_view name) const;
+
+    // id 必須由 intern / find 取得
+    const std::string& name(Id id) const noexcept {
+        return chunks_[id / CHUNK_SIZE].load(std::memory_order_acquire)[id % CHUNK_SIZE];
+    }
+
+    size_t size() const noexcept { return size_.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<std::string*> chunks_[MAX_CHUNKS];
+    std::atomic<size_t> size_{0};
+    std::unordered_map<std::string_view, Id> ids_;
+    mutable std::shared_mutex mutex_;
+};
+
+// 以 Tag 區分命名空間的駐留 ID；可隱式轉成 const std::string&，方便沿用字串介面
+template <typename Tag>
+class InternedId {
+public:
+    using Value = InternTable::Id;
+
+    InternedId() noexcept = default;
+    InternedId(std::string_view name) : id_(table().intern(name)) {}
+    InternedId(const std::string& name) : InternedId(std::string_view(name)) {}
+    InternedId(const char* name) : InternedId(std::string_view(name)) {}
+
+    static InternedId fromValue(Value value) noexcept {
+        InternedId id;
+        id.id_ = value;
+        return id;
+    }
+
+    Value value() const noexcept { return id_; }
+    bool empty() const noexcept { return id_ == 0; }
+    const std::string& str() const noexcept { return table().name(id_); }
+    operator const std::string&() const noexcept { return str(); }
+
+    bool operator==(InternedId other) const noexcept { return id_ == other.id_; }
+    bool operator!=(InternedId other) const noexcept { return id_ != other.id_; }
+    bool operator<(InternedId other) const noexcept { return id_ < other.id_; }
+
+    // 與字串比較時比對名稱，不會新增駐留項目
+    friend bool operator==(InternedId id, std::string_view name) noexcept { return id.str() == name; }
+    friend bool operator==(std::string_view name, InternedId id) noexcept { return id.str() == name; }
+    friend bool operator!=(InternedId id, std::string_view name) noexcept { return id.str() != name; }
+    friend bool operator!=(std::string_view name, InternedId id) noexcept { return id.str() != name; }
+    friend bool operator==(InternedId id, const char* name) noexcept { return id.str() == name; }
+    friend bool operator!=(InternedId id, const char* name) noexcept { return id.str() != name; }
+
+    friend std::ostream& operator<<(std::ostream& os, InternedId id) { return os << id.str(); }
+
+    static InternTable& table() {
+        static InternTable instance;
+        return instance;
+    }
+
+private:
+    Value id_ = 0;
+};
+
+struct SymbolTag {};
+struct ClientTag {};
+
+using SymbolId = InternedId<SymbolTag>;
+using ClientKey = InternedId<ClientTag>;
+
+} // namespace core
+} // namespace mts
+
+namespace std {
+    template <typename Tag>
+    struct hash<mts::core::InternedId<Tag>> {
+        size_t operator()(mts::core::InternedId<Tag> id) const noexcept {
+            return std::hash<uint32_t>()(id.value());
+        }
+    };
+}
@@ -0,0 +1,575 @@
+#include "journal.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace mts {
+namespace core {
+
+namespace {
+
+    constexpr char SEGMENT_MAGIC[8] = {'M', 'T', 'S', 'J', 'R', 'N', 'L', '\0'};
+    constexpr uint32_t SEGMENT_VERSION = 1;
+    constexpr const char* SEGMENT_PREFIX = "segment-";
+    constexpr const char* SEGMENT_SUFFIX = ".journal";
+
+    struct SegmentHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint64_t segmentSize;
+        uint64_t firstSequence;
+        char reserved[32];
+    };
+    static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader must stay 64 bytes");
+
+    struct RecordHeader {
+        uint32_t length;          // 整筆長度（含 header 與補齊），8 的倍數
+        uint32_t checksum;        // [8, length) 的校驗和
+        uint64_t sequence;
+        uint64_t timestampNs;
+        uint64_t orderId;
+        int64_t price;
+        uint64_t quantity;
+        uint8_t type;
+        uint8_t side;
+        uint8_t orderType;
+        uint8_t timeInForce;
+        uint8_t symbolLength;
+        uint8_t clientIdLength;
+        uint8_t reasonLength;
+        uint8_t reserved0;
+        uint64_t reserved1;
+    };
+    static_assert(sizeof(RecordHeader) == 64, "RecordHeader must stay 64 bytes");
+
+    constexpr size_t MAX_RECORD_SIZE = sizeof(RecordHeader) + 3 * 255 + 8;
+
+    constexpr size_t align8(size_t size) noexcept { return (size + 7) & ~size_t(7); }
+
+    // 以 8 位元組為單位的 FNV-1a 變體；記錄長度必為 8 的倍數
+    uint32_t recordChecksum(const char* record, size_t length) noexcept {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t offset = 8; offset < length; offset += 8) {
+            uint64_t word;
+            std::memcpy(&word, record + offset, sizeof(word));
+            hash = (hash ^ word) * 1099511628211ull;
+        }
+        return static_cast<uint32_t>(hash ^ (hash >> 32));
+    }
+
+    uint64_t nowNs() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    std::string segmentPath(const std::string& directory, uint64_t firstSequence) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "%s%020llu%s", SEGMENT_PREFIX,
+                      static_cast<unsigned long long>(firstSequence), SEGMENT_SUFFIX);
+        return (std::filesystem::path(directory) / name).string();
+    }
+
+    // 依檔名（即第一筆序號）排序的區段清單
+    std::vector<std::string> listSegments(const std::string& directory) {
+        std::vector<std::string> segments;
+        std::error_code ec;
+        if (!std::filesystem::is_directory(directory, ec)) {
+            return segments;
+        }
+        for (const auto& item : std::filesystem::directory_iterator(directory, ec)) {
+            std::string name = item.path().filename().string();
+            if (item.is_regular_file(ec) && name.rfind(SEGMENT_PREFIX, 0) == 0 &&
+                name.size() > std::strlen(SEGMENT_SUFFIX) &&
+                name.compare(name.size() - std::strlen(SEGMENT_SUFFIX), std::string::npos, SEGMENT_SUFFIX) == 0) {
+                segments.push_back(item.path().string());
+            }
+        }
+        std::sort(segments.begin(), segments.end());
+        return segments;
+    }
+
+    bool validSegmentHeader(const char* data, size_t size) noexcept {
+        if (size < sizeof(SegmentHeader)) {
+            return false;
+        }
+        SegmentHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        return std::memcmp(header.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) == 0 &&
+               header.version == SEGMENT_VERSION && header.headerSize == sizeof(SegmentHeader);
+    }
+
+    uint64_t segmentFirstSequence(const char* data) noexcept {
+        SegmentHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        return header.firstSequence;
+    }
+
+    // 檢查 offset 處是否為序號 expected 的完整記錄，是則回傳長度，否則回傳 0
+    size_t validRecordAt(const char* data, size_t size, size_t offset, uint64_t expected) noexcept {
+        if (size - offset < sizeof(RecordHeader)) {
+            return 0;
+        }
+        RecordHeader header;
+        std::memcpy(&header, data + offset, sizeof(header));
+        size_t length = header.length;
+        if (length < sizeof(RecordHeader) || length % 8 != 0 || length > size - offset ||
+            header.sequence != expected) {
+            return 0;
+        }
+        size_t payload = size_t(header.symbolLength) + header.clientIdLength + header.reasonLength;
+        if (sizeof(RecordHeader) + payload > length ||
+            recordChecksum(data + offset, length) != header.checksum) {
+            return 0;
+        }
+        return length;
+    }
+
+    // 掃描區段內連續有效的記錄，回傳結尾位置並更新 lastSequence
+    size_t scanSegment(const char* data, size_t size, uint64_t& lastSequence) noexcept {
+        size_t offset = sizeof(SegmentHeader);
+        uint64_t expected = segmentFirstSequence(data);
+        while (size_t length = validRecordAt(data, size, offset, expected)) {
+            lastSequence = expected++;
+            offset += length;
+        }
+        return offset;
+    }
+
+    void decodeRecord(const char* record, JournalEntry& entry) {
+        RecordHeader header;
+        std::memcpy(&header, record, sizeof(header));
+        entry.sequence = header.sequence;
+        entry.timestampNs = header.timestampNs;
+        entry.type = static_cast<JournalRecordType>(header.type);
+        entry.orderId = header.orderId;
+        entry.price = Price(header.price);
+        entry.quantity = header.quantity;
+        entry.side = static_cast<Side>(header.side);
+        entry.orderType = static_cast<OrderType>(header.orderType);
+        entry.timeInForce = static_cast<TimeInForce>(header.timeInForce);
+        const char* text = record + sizeof(RecordHeader);
+        entry.symbol.assign(text, header.symbolLength);
+        text += header.symbolLength;
+        entry.clientId.assign(text, header.clientIdLength);
+        text += header.clientIdLength;
+        entry.reason.assign(text, header.reasonLength);
+    }
+
+#ifndef _WIN32
+    size_t pageSize() noexcept {
+        static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    std::string systemError(const std::string& what, const std::string& path) {
+        return what + " " + path + ": " + std::strerror(errno);
+    }
+#endif
+
+} // namespace
+
+const char* journalRecordTypeToString(JournalRecordType type) {
+    switch (type) {
+        case JournalRecordType::NewOrder:    return "NEW";
+        case JournalRecordType::CancelOrder: return "CANCEL";
+        case JournalRecordType::ModifyOrder: return "MODIFY";
+        default:                             return "UNKNOWN";
+    }
+}
+
+// ===== JournalWriter =====
+
+struct JournalWriter::RecordFields {
+    JournalRecordType type;
+    OrderID orderId;
+    Price price;
+    Quantity quantity;
+    Side side;
+    OrderType orderType;
+    TimeInForce timeInForce;
+    std::string_view symbol;
+    std::string_view clientId;
+    std::string_view reason;
+};
+
+JournalWriter::~JournalWriter() {
+    close();
+}
+
+#ifndef _WIN32
+
+bool JournalWriter::open(const JournalConfig& config, std::string& error) {
+    close();
+    if (config.directory.empty()) {
+        error = "journal directory is empty";
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(config.directory, ec);
+    if (ec) {
+        error = "cannot create journal directory " + config.directory + ": " + ec.message();
+        return false;
+    }
+
+    config_ = config;
+    size_t page = pageSize();
+    config_.segmentSize = std::max(config_.segmentSize, JournalConfig::MIN_SEGMENT_SIZE);
+    config_.segmentSize = (config_.segmentSize + page - 1) / page * page;
+    nextSequence_ = 1;
+    syncCount_ = 0;
+    segmentCount_ = 0;
+    lastSync_ = std::chrono::steady_clock::now();
+
+    // 只需掃描最後一個區段即可找到續寫位置
+    auto segments = listSegments(config_.directory);
+    if (segments.empty()) {
+        return openSegment(1, error);
+    }
+    const std::string& last = segments.back();
+    if (!mapSegment(last, false, error)) {
+        return false;
+    }
+    if (!validSegmentHeader(mapping_, config_.segmentSize)) {
+        closeSegment();
+        error = "corrupt journal segment header: " + last;
+        return false;
+    }
+    uint64_t firstSequence = segmentFirstSequence(mapping_);
+    uint64_t lastSequence = firstSequence - 1;
+    size_t endOffset = scanSegment(mapping_, config_.segmentSize, lastSequence);
+    segmentCount_ = segments.size();
+    recoverTail(endOffset, lastSequence);
+    return true;
+}
+
+void JournalWriter::recoverTail(size_t endOffset, uint64_t lastSequence) {
+    // 清除殘缺的尾端，之後的讀者不會把舊資料誤認為記錄
+    std::memset(mapping_ + endOffset, 0, config_.segmentSize - endOffset);
+    writeOffset_ = endOffset;
+    syncRange(endOffset, config_.segmentSize);
+    syncedOffset_ = endOffset;
+    nextSequence_ = lastSequence + 1;
+    syncedSequence_ = lastSequence;
+}
+
+bool JournalWriter::mapSegment(const std::string& path, bool create, std::string& error) {
+    int flags = O_RDWR | (create ? O_CREAT | O_EXCL : 0);
+    fd_ = ::open(path.c_str(), flags, 0644);
+    if (fd_ < 0) {
+        error = systemError("cannot open journal segment", path);
+        return false;
+    }
+    struct stat info {};
+    if (::fstat(fd_, &info) != 0) {
+        error = systemError("cannot stat journal segment", path);
+        closeSegment();
+        return false;
+    }
+    if (create) {
+        // 預先配置磁碟空間，避免寫入 mmap 時因空間不足收到 SIGBUS
+        int rc = ::posix_fallocate(fd_, 0, static_cast<off_t>(config_.segmentSize));
+        if (rc != 0 && ::ftruncate(fd_, static_cast<off_t>(config_.segmentSize)) != 0) {
+            error = systemError("cannot allocate journal segment", path);
+            closeSegment();
+            return false;
+        }
+    } else if (static_cast<size_t>(info.st_size) != config_.segmentSize) {
+        // 既有區段以其實際大小為準
+        config_.segmentSize = static_cast<size_t>(info.st_size);
+        if (config_.segmentSize < sizeof(SegmentHeader) + MAX_RECORD_SIZE) {
+            error = "journal segment too small: " + path;
+            closeSegment();
+            return false;
+        }
+    }
+
+    int mapFlags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    mapFlags |= MAP_POPULATE;   // 預先建立頁表，熱路徑上不發生缺頁
+#endif
+    void* mapping = ::mmap(nullptr, config_.segmentSize, PROT_READ | PROT_WRITE, mapFlags, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        error = systemError("cannot map journal segment", path);
+        closeSegment();
+        return false;
+    }
+    mapping_ = static_cast<char*>(mapping);
+    return true;
+}
+
+bool JournalWriter::openSegment(uint64_t firstSequence, std::string& error) {
+    std::string path = segmentPath(config_.directory, firstSequence);
+    if (!mapSegment(path, true, error)) {
+        return false;
+    }
+    SegmentHeader header{};
+    std::memcpy(header.magic, SEGMENT_MAGIC, sizeof(header.magic));
+    header.version = SEGMENT_VERSION;
+    header.headerSize = sizeof(SegmentHeader);
+    header.segmentSize = config_.segmentSize;
+    header.firstSequence = firstSequence;
+    std::memcpy(mapping_, &header, sizeof(header));
+    writeOffset_ = sizeof(SegmentHeader);
+    syncedOffset_ = 0;
+    ++segmentCount_;
+
+    // 新檔案的目錄項也需落盤，否則斷電後可能找不到區段
+    syncRange(0, writeOffset_);
+    syncedOffset_ = writeOffset_;
+    int dirFd = ::open(config_.directory.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+}
+
+void JournalWriter::syncRange(size_t begin, size_t end) {
+    if (mapping_ == nullptr || end <= begin) {
+        return;
+    }
+    size_t alignedBegin = begin / pageSize() * pageSize();
+    ::msync(mapping_ + alignedBegin, end - alignedBegin, MS_SYNC);
+}
+
+void JournalWriter::closeSegment() {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, config_.segmentSize);
+        mapping_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+#else   // _WIN32
+
+bool JournalWriter::open(const JournalConfig&, std::string& error) {
+    error = "journal is not supported on Windows";
+    return false;
+}
+
+void JournalWriter::recoverTail(size_t, uint64_t) {}
+bool JournalWriter::mapSegment(const std::string&, bool, std::string&) { return false; }
+bool JournalWriter::openSegment(uint64_t, std::string&) { return false; }
+void JournalWriter::syncRange(size_t, size_t) {}
+void JournalWriter::closeSegment() {}
+
+#endif
+
+void JournalWriter::close() {
+    if (mapping_ != nullptr) {
+        commit(false, true);
+    }
+    closeSegment();
+}
+
+uint64_t JournalWriter::appendNewOrder(const Order& order) {
+    return append(RecordFields{JournalRecordType::NewOrder, order.getOrderId(), order.getPrice(),
+                               order.getQuantity(), order.getSide(), order.getOrderType(),
+                               order.getTimeInForce(), order.getSymbol(), order.getClientId(), {}});
+}
+
+uint64_t JournalWriter::appendCancel(OrderID orderId, std::string_view reason) {
+    return append(RecordFields{JournalRecordType::CancelOrder, orderId, Price(), 0, Side::Buy,
+                               OrderType::Limit, TimeInForce::Day, {}, {}, reason});
+}
+
+uint64_t JournalWriter::appendModify(OrderID orderId, Price newPrice, Quantity newQuantity) {
+    return append(RecordFields{JournalRecordType::ModifyOrder, orderId, newPrice, newQuantity, Side::Buy,
+                               OrderType::Limit, TimeInForce::Day, {}, {}, {}});
+}
+
+uint64_t JournalWriter::append(const RecordFields& fields) {
+    if (mapping_ == nullptr) {
+        return 0;
+    }
+    size_t symbolLength = std::min<size_t>(fields.symbol.size(), 255);
+    size_t clientIdLength = std::min<size_t>(fields.clientId.size(), 255);
+    size_t reasonLength = std::min<size_t>(fields.reason.size(), 255);
+    size_t length = align8(sizeof(RecordHeader) + symbolLength + clientIdLength + reasonLength);
+
+    // 區段剩餘空間不足：同步並換到下一個區段（其後保持為 0，讀者視為區段結尾）
+    if (config_.segmentSize - writeOffset_ < length) {
+        commit(false, true);
+        closeSegment();
+        std::string error;
+        if (!openSegment(nextSequence_, error)) {
+            return 0;
+        }
+    }
+
+    char* record = mapping_ + writeOffset_;
+    RecordHeader header{};
+    header.length = static_cast<uint32_t>(length);
+    header.sequence = nextSequence_;
+    header.timestampNs = nowNs();
+    header.orderId = fields.orderId;
+    header.price = fields.price.ticks();
+    header.quantity = fields.quantity;
+    header.type = static_cast<uint8_t>(fields.type);
+    header.side = static_cast<uint8_t>(fields.side);
+    header.orderType = static_cast<uint8_t>(fields.orderType);
+    header.timeInForce = static_cast<uint8_t>(fields.timeInForce);
+    header.symbolLength = static_cast<uint8_t>(symbolLength);
+    header.clientIdLength = static_cast<uint8_t>(clientIdLength);
+    header.reasonLength = static_cast<uint8_t>(reasonLength);
+
+    char* text = record + sizeof(RecordHeader);
+    std::memcpy(text, fields.symbol.data(), symbolLength);
+    text += symbolLength;
+    std::memcpy(text, fields.clientId.data(), clientIdLength);
+    text += clientIdLength;
+    std::memcpy(text, fields.reason.data(), reasonLength);
+    text += reasonLength;
+    std::memset(text, 0, static_cast<size_t>(record + length - text));
+
+    std::memcpy(record, &header, sizeof(header));
+    header.checksum = recordChecksum(record, length);
+    std::memcpy(record + offsetof(RecordHeader, checksum), &header.checksum, sizeof(header.checksum));
+
+    writeOffset_ += length;
+    return nextSequence_++;
+}
+
+bool JournalWriter::commit(bool idle, bool force) {
+    uint64_t pending = lastSequence() - syncedSequence_;
+    if (mapping_ == nullptr || pending == 0) {
+        return false;
+    }
+    if (!force && !(idle && config_.syncWhenIdle) &&
+        !(config_.syncEveryRecords > 0 && pending >= config_.syncEveryRecords)) {
+        if (config_.syncInterval.count() <= 0) {
+            return false;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastSync_ < config_.syncInterval) {
+            return false;
+        }
+    }
+    syncRange(syncedOffset_, writeOffset_);
+    syncedOffset_ = writeOffset_;
+    syncedSequence_ = lastSequence();
+    lastSync_ = std::chrono::steady_clock::now();
+    ++syncCount_;
+    return true;
+}
+
+// ===== JournalReader =====
+
+JournalReader::~JournalReader() {
+    unload();
+}
+
+bool JournalReader::open(const std::string& directory, std::string& error) {
+    unload();
+    segments_ = listSegments(directory);
+    segmentIndex_ = 0;
+    lastSequence_ = 0;
+    ended_ = false;
+    if (segments_.empty()) {
+        ended_ = true;
+        return true;
+    }
+    if (!loadSegment(0)) {
+        error = "cannot read journal segment " + segments_[0];
+        return false;
+    }
+    lastSequence_ = segmentFirstSequence(data_) - 1;
+    return true;
+}
+
+bool JournalReader::next(JournalEntry& entry, uint64_t fromSequence) {
+    while (!ended_) {
+        size_t length = validRecordAt(data_, size_, offset_, lastSequence_ + 1);
+        if (length == 0) {
+            // 區段結尾：下一個區段必須緊接著目前的序號
+            if (segmentIndex_ + 1 >= segments_.size() || !loadSegment(segmentIndex_ + 1) ||
+                segmentFirstSequence(data_) != lastSequence_ + 1) {
+                ended_ = true;
+                unload();
+                return false;
+            }
+            continue;
+        }
+        const char* record = data_ + offset_;
+        offset_ += length;
+        ++lastSequence_;
+        if (lastSequence_ >= fromSequence) {
+            decodeRecord(record, entry);
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifndef _WIN32
+
+bool JournalReader::loadSegment(size_t index) {
+    unload();
+    segmentIndex_ = index;
+    int fd = ::open(segments_[index].c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SegmentHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    data_ = static_cast<const char*>(mapping);
+    size_ = size;
+    if (!validSegmentHeader(data_, size_)) {
+        unload();
+        return false;
+    }
+    offset_ = sizeof(SegmentHeader);
+    return true;
+}
+
+void JournalReader::unload() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+#else   // _WIN32
+
+bool JournalReader::loadSegment(size_t) { return false; }
+void JournalReader::unload() {}
+
+#endif
+
+bool readJournal(const std::string& directory, std::vector<JournalEntry>& entries, std::string& error) {
+    JournalReader reader;
+    if (!reader.open(directory, error)) {
+        return false;
+    }
+    JournalEntry entry;
+    while (reader.next(entry)) {
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+} // namespace core
+} // namespace mts
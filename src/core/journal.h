@@ -0,0 +1,155 @@
+#pragma once
+#include "order.h"
+#include "price.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mts {
+namespace core {
+
+// ===== 撮合引擎輸入日誌 (write-ahead journal) =====
+
+// 日誌記錄類型，與撮合引擎的輸入訊息一一對應
+enum class JournalRecordType : uint8_t {
+    NewOrder = 1,
+    CancelOrder = 2,
+    ModifyOrder = 3
+};
+
+const char* journalRecordTypeToString(JournalRecordType type);
+
+// 解碼後的一筆日誌記錄；欄位依類型使用
+struct JournalEntry {
+    uint64_t sequence = 0;        // 日誌序號，由 1 起連續遞增
+    uint64_t timestampNs = 0;     // 寫入時間 (system_clock，自 epoch 起的奈秒)
+    JournalRecordType type = JournalRecordType::NewOrder;
+    OrderID orderId = 0;          // 新訂單的 OrderID，或取消 / 修改的目標
+    Price price;                  // 新訂單價格，或修改後價格
+    Quantity quantity = 0;        // 新訂單數量，或修改後數量
+    Side side = Side::Buy;
+    OrderType orderType = OrderType::Limit;
+    TimeInForce timeInForce = TimeInForce::Day;
+    std::string symbol;
+    std::string clientId;
+    std::string reason;           // 取消原因
+};
+
+// 日誌設定
+struct JournalConfig {
+    static constexpr size_t DEFAULT_SEGMENT_SIZE = 64u << 20;   // 64 MB
+    static constexpr size_t MIN_SEGMENT_SIZE = 64u << 10;       // 64 KB
+
+    std::string directory;                            // 區段檔所在目錄，不存在時建立
+    size_t segmentSize = DEFAULT_SEGMENT_SIZE;        // 每個區段檔大小（向上取整到頁大小）
+    // 群組提交：未同步記錄達 syncEveryRecords 筆，或距上次同步超過 syncInterval 時 msync
+    // 兩者皆為 0 時只在換區段與關閉時同步（程序當掉不遺失，斷電可能遺失）
+    size_t syncEveryRecords = 256;
+    std::chrono::microseconds syncInterval{1000};
+    bool syncWhenIdle = true;                         // 輸入佇列清空時立即同步，低流量時延遲最小
+};
+
+/*
+┌──────────────────────────────────────────────────────────┐
+│                      JournalWriter                        │
+├──────────────────────────────────────────────────────────┤
+│ • 只由單一執行緒（撮合執行緒）寫入，不加鎖                  │
+│ • 區段檔預先配置並 mmap，append 只是 memcpy                │
+│ • commit() 依群組提交條件對未同步範圍 msync(MS_SYNC)        │
+│ • 開啟既有目錄時從最後一筆有效記錄之後續寫，殘缺尾端清零      │
+└──────────────────────────────────────────────────────────┘
+   <dir>/segment-00000000000000000001.journal
+   <dir>/segment-00000000000000052417.journal   ← 檔名為區段第一筆序號
+
+   區段：[SegmentHeader 64B][record][record]...[0000...]
+   記錄：[RecordHeader 64B][symbol][clientId][reason][pad → 8B]
+         length = 0 表示區段內其後沒有記錄
+*/
+class JournalWriter {
+public:
+    JournalWriter() = default;
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    // 失敗時回傳 false 並填入 error
+    bool open(const JournalConfig& config, std::string& error);
+    void close();
+    bool isOpen() const noexcept { return mapping_ != nullptr; }
+
+    // 寫入一筆記錄並回傳其序號；無法寫入（未開啟、換區段失敗）時回傳 0
+    uint64_t appendNewOrder(const Order& order);
+    uint64_t appendCancel(OrderID orderId, std::string_view reason);
+    uint64_t appendModify(OrderID orderId, Price newPrice, Quantity newQuantity);
+
+    // 群組提交：符合條件（或 force）時同步未同步的記錄，回傳是否執行了同步
+    bool commit(bool idle = false, bool force = false);
+
+    uint64_t lastSequence() const noexcept { return nextSequence_ - 1; }
+    uint64_t syncedSequence() const noexcept { return syncedSequence_; }
+    uint64_t syncCount() const noexcept { return syncCount_; }
+    uint64_t segmentCount() const noexcept { return segmentCount_; }
+    const JournalConfig& config() const noexcept { return config_; }
+
+private:
+    struct RecordFields;
+    uint64_t append(const RecordFields& fields);
+    bool openSegment(uint64_t firstSequence, std::string& error);
+    void recoverTail(size_t endOffset, uint64_t lastSequence);
+    bool mapSegment(const std::string& path, bool create, std::string& error);
+    void syncRange(size_t begin, size_t end);
+    void closeSegment();
+
+    JournalConfig config_;
+    int fd_ = -1;
+    char* mapping_ = nullptr;
+    size_t writeOffset_ = 0;
+    size_t syncedOffset_ = 0;
+    uint64_t nextSequence_ = 1;
+    uint64_t syncedSequence_ = 0;
+    uint64_t syncCount_ = 0;
+    uint64_t segmentCount_ = 0;
+    std::chrono::steady_clock::time_point lastSync_;
+};
+
+/*
+   JournalReader：依序號讀出目錄內所有區段的記錄
+   遇到長度為 0、校驗和不符或序號不連續即視為日誌結尾
+*/
+class JournalReader {
+public:
+    JournalReader() = default;
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    // 目錄不存在或沒有區段時仍成功（沒有記錄）；區段檔損毀時回傳 false
+    bool open(const std::string& directory, std::string& error);
+
+    // 讀出下一筆序號 >= fromSequence 的記錄；已到結尾時回傳 false
+    bool next(JournalEntry& entry, uint64_t fromSequence = 0);
+
+    uint64_t lastSequence() const noexcept { return lastSequence_; }
+
+private:
+    bool loadSegment(size_t index);
+    void unload();
+
+    std::vector<std::string> segments_;
+    size_t segmentIndex_ = 0;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t offset_ = 0;
+    uint64_t lastSequence_ = 0;
+    bool ended_ = false;
+};
+
+// 讀出整個目錄的記錄（測試與工具用）
+bool readJournal(const std::string& directory, std::vector<JournalEntry>& entries, std::string& error);
+
+} // namespace core
+} // namespace mts
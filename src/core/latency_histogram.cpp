@@ -0,0 +1,146 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace mts {
+namespace core {
+
+namespace {
+
+    inline unsigned highestBit(uint64_t word) noexcept {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, word);
+        return static_cast<unsigned>(index);
+#else
+        return 63u - static_cast<unsigned>(__builtin_clzll(word));
+#endif
+    }
+
+    std::string formatNs(uint64_t ns) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(3) << (static_cast<double>(ns) / 1000.0) << "μs";
+        return oss.str();
+    }
+
+} // namespace
+
+// ===== LatencyHistogram =====
+
+LatencyHistogram::LatencyHistogram() : counts_(BUCKET_COUNT, 0) {}
+
+size_t LatencyHistogram::bucketIndex(uint64_t valueNs) noexcept {
+    if (valueNs < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(valueNs);
+    }
+    if (valueNs > MAX_TRACKABLE_NS) {
+        return BUCKET_COUNT - 1;
+    }
+    unsigned shift = highestBit(valueNs) - SUB_BUCKET_BITS;
+    return static_cast<size_t>((shift + 1) * SUB_BUCKET_COUNT + (valueNs >> shift) - SUB_BUCKET_COUNT);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) noexcept {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    unsigned shift = static_cast<unsigned>(index / SUB_BUCKET_COUNT) - 1;
+    uint64_t sub = index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * count_)));
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        cumulative += counts_[i];
+        if (cumulative >= target) {
+            return std::min(bucketUpperBound(i), max_);
+        }
+    }
+    return max_;
+}
+
+std::string LatencyHistogram::toString() const {
+    std::ostringstream oss;
+    oss << "n=" << count_;
+    if (count_ > 0) {
+        oss << " p50=" << formatNs(percentile(50.0))
+            << " p90=" << formatNs(percentile(90.0))
+            << " p99=" << formatNs(percentile(99.0))
+            << " p99.9=" << formatNs(percentile(99.9))
+            << " max=" << formatNs(max_);
+    }
+    return oss.str();
+}
+
+// ===== LatencySnapshot =====
+
+void LatencySnapshot::merge(const LatencySnapshot& other) {
+    newOrder.merge(other.newOrder);
+    cancelOrder.merge(other.cancelOrder);
+    modifyOrder.merge(other.modifyOrder);
+    queueDelay.merge(other.queueDelay);
+    for (const auto& pair : other.perSymbol) {
+        perSymbol[pair.first].merge(pair.second);
+    }
+}
+
+void LatencySnapshot::reset() {
+    newOrder.reset();
+    cancelOrder.reset();
+    modifyOrder.reset();
+    queueDelay.reset();
+    perSymbol.clear();
+}
+
+std::string LatencySnapshot::toString() const {
+    std::ostringstream oss;
+    oss << "Latency[New: " << newOrder.toString()
+        << " | Cancel: " << cancelOrder.toString()
+        << " | Modify: " << modifyOrder.toString()
+        << " | Queue: " << queueDelay.toString() << "]";
+
+    // 依名稱排序，輸出穩定
+    std::map<std::string, const LatencyHistogram*> symbols;
+    for (const auto& pair : perSymbol) {
+        symbols.emplace(pair.first.str(), &pair.second);
+    }
+    for (const auto& pair : symbols) {
+        oss << "\n  " << pair.first << ": " << pair.second->toString();
+    }
+    return oss.str();
+}
+
+} // namespace core
+} // namespace mts
@@ -0,0 +1,85 @@
+#pragma once
+#include "interned_id.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mts {
+namespace core {
+
+// ===== 延遲直方圖 =====
+
+/*
+┌──────────────────────────────────────────────┐
+│               LatencyHistogram               │
+├──────────────────────────────────────────────┤
+│ • 對數-線性分桶 (HDR 風格)，單位為奈秒           │
+│ • 每個 2 的次方區間切成 32 個等寬子桶            │
+│   → 相對誤差 ≤ 1/32 (約 3%)                    │
+│ • 0 ~ 31ns 每奈秒一桶；上限約 2^40ns (18 分鐘)   │
+│ • 非執行緒安全：由單一執行緒記錄，快照時整份複製   │
+└──────────────────────────────────────────────┘
+   值 v (v ≥ 32)：msb = floor(log2 v), shift = msb - 5
+     index = (shift + 1) * 32 + (v >> shift) - 32
+   例：1000ns → msb 9, shift 4 → 1000 >> 4 = 62 → index 5*32 + 30 = 190
+*/
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr uint64_t SUB_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_VALUE_BITS = 40;
+    static constexpr uint64_t MAX_TRACKABLE_NS = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+    static constexpr size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    LatencyHistogram();
+
+    // 超過 MAX_TRACKABLE_NS 的值記在最後一桶（max 仍保留實際值）
+    void record(uint64_t valueNs) noexcept {
+        ++counts_[bucketIndex(valueNs)];
+        ++count_;
+        sum_ += valueNs;
+        if (valueNs < min_) min_ = valueNs;
+        if (valueNs > max_) max_ = valueNs;
+    }
+
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t count() const noexcept { return count_; }
+    uint64_t min() const noexcept { return count_ ? min_ : 0; }
+    uint64_t max() const noexcept { return max_; }
+    double mean() const noexcept { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+
+    // percentile ∈ [0, 100]；回傳所在桶的上界（不超過 max），無資料時回傳 0
+    uint64_t percentile(double percentile) const;
+
+    // "n=1000 p50=1.2μs p90=... p99=... p99.9=... max=..."
+    std::string toString() const;
+
+    static size_t bucketIndex(uint64_t valueNs) noexcept;
+    static uint64_t bucketUpperBound(size_t index) noexcept;
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
+
+// 撮合引擎的延遲分佈：各訊息類型的處理時間、排隊延遲與各標的處理時間
+struct LatencySnapshot {
+    LatencyHistogram newOrder;
+    LatencyHistogram cancelOrder;
+    LatencyHistogram modifyOrder;
+    LatencyHistogram queueDelay;     // submitOrder / cancelOrder / modifyOrder → 撮合執行緒取出
+    std::unordered_map<SymbolId, LatencyHistogram> perSymbol;
+
+    void merge(const LatencySnapshot& other);
+    void reset();
+    std::string toString() const;
+};
+
+} // namespace core
+} // namespace mts
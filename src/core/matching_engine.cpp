@@ -1,4 +1,6 @@
 #include "matching_engine.h"
+#include "order_trace.h"
+#include "async_logger.h"
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
@@ -7,7 +9,7 @@
 
 // Debug 巨集
 #ifdef ENABLE_MATCHING_DEBUG
-    #define MATCHING_DEBUG(msg) std::cout << "[MATCHING_DEBUG] " << msg << std::endl
+    #define MATCHING_DEBUG(msg) MTS_LOG_DEBUG_STREAM("[MATCHING_DEBUG] " << msg)
 #else
     #define MATCHING_DEBUG(msg) do {} while(0)
 #endif
@@ -15,62 +17,28 @@
 namespace mts {
 namespace core {
 
-// ===== 內部訊息類型 (用於處理異步請求) =====
-enum class InternalMessageType {
-    NewOrder,
-    CancelOrder,
-    ModifyOrder
-};
+namespace {
 
-struct InternalMessage {
-    InternalMessageType type;
-    OrderPtr order;           // 新訂單時使用
-    OrderID targetOrderId;    // 取消/修改時使用
-    std::string reason;       // 取消原因
-    Price newPrice;          // 修改價格
-    Quantity newQuantity;    // 修改數量
-    
-    // 建構函式
-    static std::shared_ptr<InternalMessage> createNewOrder(OrderPtr order) {
-        auto msg = std::make_shared<InternalMessage>();
-        msg->type = InternalMessageType::NewOrder;
-        msg->order = order;
-        return msg;
-    }
-    
-    static std::shared_ptr<InternalMessage> createCancelOrder(OrderID orderId, const std::string& reason) {
-        auto msg = std::make_shared<InternalMessage>();
-        msg->type = InternalMessageType::CancelOrder;
-        msg->targetOrderId = orderId;
-        msg->reason = reason;
-        return msg;
-    }
-    
-    static std::shared_ptr<InternalMessage> createModifyOrder(OrderID orderId, Price price, Quantity qty) {
-        auto msg = std::make_shared<InternalMessage>();
-        msg->type = InternalMessageType::ModifyOrder;
-        msg->targetOrderId = orderId;
-        msg->newPrice = price;
-        msg->newQuantity = qty;
-        return msg;
+    uint64_t steadyNowNs() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
     }
-};
 
-using InternalMessagePtr = std::shared_ptr<InternalMessage>;
+} // namespace
 
 // ===== ExecutionReport 實作 =====
 
 ExecutionReport::ExecutionReport(const Order& order)
     : orderId(order.getOrderId())
     , counterOrderId(0)
-    , symbol(order.getSymbol())
+    , symbol(order.getSymbolId())
     , side(order.getSide())
     , orderType(order.getOrderType())
     , price(order.getPrice())
     , originalQuantity(order.getQuantity())
     , filledQuantity(order.getFilledQuantity())
     , remainingQuantity(order.getRemainingQuantity())
-    , executionPrice(0.0)
+    , executionPrice()
     , executionQuantity(0)
     , status(order.getStatus())
     , timestamp(std::chrono::high_resolution_clock::now())
@@ -79,7 +47,6 @@ ExecutionReport::ExecutionReport(const Order& order)
 
 std::string ExecutionReport::toString() const {
     std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2);
     oss << "ExecReport[OrderID=" << orderId
         << ", Symbol=" << symbol
         << ", Side=" << sideToString(side)
@@ -90,7 +57,7 @@ std::string ExecutionReport::toString() const {
     
     if (executionQuantity > 0) {
         oss << ", ExecQty=" << executionQuantity
-            << ", ExecPrice=" << executionPrice;
+            << ", ExecPrice=" << formatPrice(symbol, executionPrice);
         if (counterOrderId != 0) {
             oss << ", CounterOrderID=" << counterOrderId;
         }
@@ -104,27 +71,134 @@ std::string ExecutionReport::toString() const {
     return oss.str();
 }
 
+// ===== ExecutionReportPool 實作 =====
+
+struct ExecutionReportPool::State {
+    mutable std::mutex mutex;
+    std::vector<void*> freeList;
+    size_t blockSize = 0;        // 第一次配置時由控制區塊的型別決定
+    size_t reserveBlocks;
+    size_t allocated = 0;
+    
+    explicit State(size_t reserve) : reserveBlocks(reserve) {}
+    
+    ~State() {
+        for (void* block : freeList) {
+            ::operator delete(block);
+        }
+    }
+    
+    void* acquire(size_t size) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (blockSize == 0) {
+                blockSize = size;
+                freeList.reserve(reserveBlocks);
+                for (size_t i = 0; i < reserveBlocks; ++i) {
+                    freeList.push_back(::operator new(size));
+                }
+                allocated = reserveBlocks;
+            }
+            if (size == blockSize) {
+                if (!freeList.empty()) {
+                    void* block = freeList.back();
+                    freeList.pop_back();
+                    return block;
+                }
+                // 空閒串列保留足夠容量，歸還時不會再配置
+                ++allocated;
+                if (freeList.capacity() < allocated) {
+                    freeList.reserve(allocated * 2);
+                }
+            }
+        }
+        return ::operator new(size);
+    }
+    
+    void release(void* block, size_t size) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (size == blockSize) {
+                freeList.push_back(block);
+                return;
+            }
+        }
+        ::operator delete(block);
+    }
+};
+
+template <typename T>
+class ExecutionReportPool::Allocator {
+public:
+    using value_type = T;
+    
+    explicit Allocator(std::shared_ptr<State> state) noexcept : state_(std::move(state)) {}
+    template <typename U>
+    Allocator(const Allocator<U>& other) noexcept : state_(other.state_) {}
+    
+    T* allocate(size_t n) {
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(state_->acquire(sizeof(T)));
+    }
+    
+    void deallocate(T* p, size_t n) noexcept {
+        if (n != 1) {
+            ::operator delete(p);
+            return;
+        }
+        state_->release(p, sizeof(T));
+    }
+    
+    template <typename U>
+    bool operator==(const Allocator<U>& other) const noexcept { return state_ == other.state_; }
+    template <typename U>
+    bool operator!=(const Allocator<U>& other) const noexcept { return state_ != other.state_; }
+    
+private:
+    template <typename U> friend class Allocator;
+    std::shared_ptr<State> state_;
+};
+
+ExecutionReportPool::ExecutionReportPool(size_t reserveBlocks)
+    : state_(std::make_shared<State>(reserveBlocks)) {}
+
+ExecutionReportPtr ExecutionReportPool::create(const Order& order) const {
+    return std::allocate_shared<ExecutionReport>(Allocator<ExecutionReport>(state_), order);
+}
+
+size_t ExecutionReportPool::allocatedBlocks() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->allocated;
+}
+
+size_t ExecutionReportPool::freeBlocks() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->freeList.size();
+}
+
 // ===== MarketDataSnapshot 實作 =====
 
 MarketDataSnapshot::MarketDataSnapshot(const Symbol& sym)
     : symbol(sym)
-    , bidPrice(0.0)
-    , askPrice(0.0)
+    , bidPrice()
+    , askPrice()
     , bidQuantity(0)
     , askQuantity(0)
-    , lastTradePrice(0.0)
+    , lastTradePrice()
     , lastTradeQuantity(0)
     , timestamp(std::chrono::high_resolution_clock::now())
 {
 }
 
 std::string MarketDataSnapshot::toString() const {
+    PriceScale scale = PriceScaleRegistry::get(symbol);
     std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2);
     oss << "MarketData[" << symbol
-        << ", Bid=" << bidPrice << "(" << bidQuantity << ")"
-        << ", Ask=" << askPrice << "(" << askQuantity << ")"
-        << ", LastTrade=" << lastTradePrice << "(" << lastTradeQuantity << ")"
+        << ", Bid=" << scale.toString(bidPrice) << "(" << bidQuantity << ")"
+        << ", Ask=" << scale.toString(askPrice) << "(" << askQuantity << ")"
+        << ", LastTrade=" << scale.toString(lastTradePrice) << "(" << lastTradeQuantity << ")"
         << "]";
     return oss.str();
 }
@@ -146,6 +220,35 @@ void EngineStatistics::reset() {
     maxProcessingTimeNs.store(0);
     totalProcessingTimeNs.store(0);
     startTime = std::chrono::steady_clock::now();
+    
+    std::lock_guard<std::mutex> lock(latencyMutex_);
+    latency_.reset();
+}
+
+void EngineStatistics::merge(const EngineStatistics& other) {
+    ordersProcessed.fetch_add(other.ordersProcessed.load());
+    tradesExecuted.fetch_add(other.tradesExecuted.load());
+    ordersRejected.fetch_add(other.ordersRejected.load());
+    totalVolume.fetch_add(other.totalVolume.load());
+    totalValue.fetch_add(other.totalValue.load());
+    totalProcessingTimeNs.fetch_add(other.totalProcessingTimeNs.load());
+    minProcessingTimeNs.store(std::min(minProcessingTimeNs.load(), other.minProcessingTimeNs.load()));
+    maxProcessingTimeNs.store(std::max(maxProcessingTimeNs.load(), other.maxProcessingTimeNs.load()));
+    startTime = std::min(startTime, other.startTime);
+    
+    LatencySnapshot otherLatency = other.getLatency();
+    std::lock_guard<std::mutex> lock(latencyMutex_);
+    latency_.merge(otherLatency);
+}
+
+LatencySnapshot EngineStatistics::getLatency() const {
+    std::lock_guard<std::mutex> lock(latencyMutex_);
+    return latency_;
+}
+
+void EngineStatistics::publishLatency(const LatencySnapshot& latency) {
+    std::lock_guard<std::mutex> lock(latencyMutex_);
+    latency_ = latency;
 }
 
 double EngineStatistics::getAverageProcessingTimeUs() const {
@@ -175,14 +278,20 @@ std::string EngineStatistics::toString() const {
         << ", Value=" << totalValue.load()
         << ", AvgTime=" << std::fixed << std::setprecision(3) << getAverageProcessingTimeUs() << "μs"
         << ", Throughput=" << std::fixed << std::setprecision(0) << getThroughputPerSecond() << "/sec"
-        << "]";
+        << "]\n" << getLatency().toString();
     return oss.str();
 }
 
 // ===== MatchingEngine 實作 =====
 
-MatchingEngine::MatchingEngine() {
-    MATCHING_DEBUG("MatchingEngine created");
+MatchingEngine::MatchingEngine(size_t orderPoolCapacity, size_t queueCapacity)
+    : orderPool_(orderPoolCapacity)
+    , orderIndex_(orderPoolCapacity)
+    , incomingMessages_(queueCapacity)
+{
+    tradeBuffer_.reserve(64);
+    MATCHING_DEBUG("MatchingEngine created (order pool: " << orderPoolCapacity
+                   << ", queue: " << queueCapacity << ")");
 }
 
 MatchingEngine::~MatchingEngine() {
@@ -204,6 +313,7 @@ bool MatchingEngine::start() {
     try {
         running_.store(true);
         statistics_.reset();
+        liveLatency_.reset();
         
         // 啟動處理執行緒
         processingThread_ = std::thread(&MatchingEngine::processingLoop, this);
@@ -228,45 +338,54 @@ void MatchingEngine::stop() {
     running_.store(false);
     
     // 通知處理執行緒
-    {
-        std::lock_guard<std::mutex> lock(messageQueueMutex_);
-        messageQueueCV_.notify_all();
-    }
+    idleWaiter_.wakeAll();
     
     // 等待處理執行緒結束
     if (processingThread_.joinable()) {
         processingThread_.join();
     }
+    if (snapshotThread_.joinable()) {
+        snapshotThread_.join();
+    }
+    
+    // 最後一次發佈延遲分佈
+    statistics_.publishLatency(liveLatency_);
+    
+    if (journal_) {
+        journal_->commit(true, true);
+    }
     
     MATCHING_DEBUG("MatchingEngine stopped");
 }
 
 // ===== 主要介面 =====
 
-bool MatchingEngine::submitOrder(OrderPtr order) {
-    if (!order) {
-        notifyError("Cannot submit null order");
+bool MatchingEngine::submitOrder(OrderHandle handle) {
+    if (orderPool_.get(handle) == nullptr) {
+        notifyError("Cannot submit invalid order handle");
         return false;
     }
     
     if (!running_.load()) {
         notifyError("MatchingEngine is not running");
+        orderPool_.release(handle);
         return false;
     }
     
-    MATCHING_DEBUG("Submitting order: " << order->toString());
-    
-    // 建立內部訊息
-    auto message = InternalMessage::createNewOrder(order);
+    MATCHING_DEBUG("Submitting order: " << orderPool_[handle].toString());
     
     // 加入訊息佇列
-    {
-        std::lock_guard<std::mutex> lock(messageQueueMutex_);
-        incomingMessages_.push(message);
+    InternalMessage message = InternalMessage::createNewOrder(handle);
+    message.enqueueTimeNs = steadyNowNs();
+    OrderTracer::trace(orderPool_[handle].getOrderId(), TraceStage::Enqueue);
+    if (!incomingMessages_.tryPush(std::move(message))) {
+        notifyError("MatchingEngine inbound queue is full");
+        orderPool_.release(handle);
+        return false;
     }
     
     // 通知處理執行緒
-    messageQueueCV_.notify_one();
+    idleWaiter_.notify();
     
     return true;
 }
@@ -278,18 +397,18 @@ bool MatchingEngine::cancelOrder(OrderID orderId, const std::string& reason) {
     }
     
     MATCHING_DEBUG("Canceling order: " << orderId << ", reason: " << reason);
-    
-    // 建立取消訊息
-    auto message = InternalMessage::createCancelOrder(orderId, reason);
+    warnIfReasonTruncated(orderId, reason);
     
     // 加入訊息佇列
-    {
-        std::lock_guard<std::mutex> lock(messageQueueMutex_);
-        incomingMessages_.push(message);
+    InternalMessage message = InternalMessage::createCancelOrder(orderId, reason);
+    message.enqueueTimeNs = steadyNowNs();
+    if (!incomingMessages_.tryPush(std::move(message))) {
+        notifyError("MatchingEngine inbound queue is full");
+        return false;
     }
     
     // 通知處理執行緒
-    messageQueueCV_.notify_one();
+    idleWaiter_.notify();
     
     return true;
 }
@@ -301,44 +420,56 @@ bool MatchingEngine::modifyOrder(OrderID orderId, Price newPrice, Quantity newQu
     }
     
     MATCHING_DEBUG("Modifying order: " << orderId 
-                   << ", newPrice=" << newPrice 
+                   << ", newPrice=" << newPrice.ticks() 
                    << ", newQuantity=" << newQuantity);
     
-    // 建立修改訊息
-    auto message = InternalMessage::createModifyOrder(orderId, newPrice, newQuantity);
-    
     // 加入訊息佇列
-    {
-        std::lock_guard<std::mutex> lock(messageQueueMutex_);
-        incomingMessages_.push(message);
+    InternalMessage message = InternalMessage::createModifyOrder(orderId, newPrice, newQuantity);
+    message.enqueueTimeNs = steadyNowNs();
+    if (!incomingMessages_.tryPush(std::move(message))) {
+        notifyError("MatchingEngine inbound queue is full");
+        return false;
     }
     
     // 通知處理執行緒
-    messageQueueCV_.notify_one();
+    idleWaiter_.notify();
     
     return true;
 }
 
-ExecutionReportPtr MatchingEngine::processOrderSync(OrderPtr order) {
-    if (!order) {
-        auto dummyOrder = std::make_shared<Order>();
-        return createExecutionReport(*dummyOrder, OrderStatus::Rejected, "Null order");
-    }
-    
+ExecutionReportPtr MatchingEngine::processOrderSync(OrderHandle handle) {
     auto start = std::chrono::high_resolution_clock::now();
-    auto report = processNewOrder(order);
+    journalMessage(InternalMessage::createNewOrder(handle));
+    auto report = processNewOrder(handle);
     auto end = std::chrono::high_resolution_clock::now();
     
     auto processingTime = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
     updateStatistics(report, processingTime);
+    recordLatency(InternalMessageType::NewOrder, report, static_cast<uint64_t>(processingTime.count()));
+    
+    // 進場訂單的回報由呼叫端取得，被成交掛單的回報經回調送出
+    for (const auto& passive : passiveReports_) {
+        notifyExecution(passive);
+    }
+    passiveReports_.clear();
     
     return report;
 }
 
 ExecutionReportPtr MatchingEngine::cancelOrderSync(OrderID orderId, const std::string& reason) {
+    warnIfReasonTruncated(orderId, reason);
+    journalMessage(InternalMessage::createCancelOrder(orderId, reason));
     return processCancelOrder(orderId, reason);
 }
 
+// 取消原因以固定長度存放於 InternalMessage，超過時明確記錄被截斷的內容
+void MatchingEngine::warnIfReasonTruncated(OrderID orderId, const std::string& reason) {
+    if (!InternalMessage::reasonFits(reason)) {
+        MTS_LOG_WARN("⚠️ Cancel reason for order {} truncated to {} of {} bytes: {}",
+                     orderId, InternalMessage::MAX_REASON_LENGTH, reason.size(), reason);
+    }
+}
+
 // ===== 查詢介面 =====
 
 std::shared_ptr<const OrderBook> MatchingEngine::getOrderBook(const Symbol& symbol) const {
@@ -370,27 +501,134 @@ std::vector<Symbol> MatchingEngine::getAllSymbols() const {
     return symbols;
 }
 
-OrderPtr MatchingEngine::findOrder(OrderID orderId) const {
-    std::lock_guard<std::mutex> lock(orderMapMutex_);
-    
-    auto it = orderSymbolMap_.find(orderId);
-    if (it == orderSymbolMap_.end()) {
-        return nullptr;
+const Order* MatchingEngine::findOrder(OrderID orderId) const {
+    // 池中槽位在歸還前不會被其他訂單使用
+    return orderPool_.get(findOrderHandle(orderId));
+}
+
+OrderHandle MatchingEngine::findOrderHandle(OrderID orderId) const {
+    const OrderIndex::Entry* entry = orderIndex_.find(orderId);
+    return entry ? entry->handle : INVALID_ORDER_HANDLE;
+}
+
+void MatchingEngine::retireOrder(OrderID orderId) {
+    OrderHandle handle = orderIndex_.erase(orderId);
+    if (handle != INVALID_ORDER_HANDLE) {
+        orderPool_.release(handle);
+    }
+}
+
+// ===== 工具方法 =====
+
+bool MatchingEngine::setBatchSize(size_t batchSize) {
+    if (running_.load()) {
+        notifyError("Cannot change batch size while MatchingEngine is running");
+        return false;
+    }
+    batchSize_ = std::max<size_t>(batchSize, 1);
+    return true;
+}
+
+bool MatchingEngine::setCpuAffinity(int cpu) {
+    if (running_.load()) {
+        notifyError("Cannot change CPU affinity while MatchingEngine is running");
+        return false;
+    }
+    cpu_ = cpu;
+    return true;
+}
+
+bool MatchingEngine::enableJournal(const JournalConfig& config) {
+    if (running_.load()) {
+        notifyError("Cannot enable journal while MatchingEngine is running");
+        return false;
+    }
+    auto journal = std::make_unique<JournalWriter>();
+    std::string error;
+    if (!journal->open(config, error)) {
+        notifyError("Failed to open journal: " + error);
+        return false;
+    }
+    journal_ = std::move(journal);
+    return true;
+}
+
+bool MatchingEngine::requestSnapshot() {
+    if (!journal_) {
+        notifyError("Snapshots require the journal to be enabled");
+        return false;
+    }
+    snapshotRequested_.store(true, std::memory_order_release);
+    idleWaiter_.notify();
+    return true;
+}
+
+bool MatchingEngine::recover(const std::string& directory, RecoveryResult& result) {
+    if (running_.load()) {
+        notifyError("Cannot recover while MatchingEngine is running");
+        return false;
+    }
+    if (journal_) {
+        notifyError("Recover must run before the journal is enabled");
+        return false;
     }
     
-    const Symbol& symbol = it->second;
+    auto start = std::chrono::steady_clock::now();
+    result = RecoveryResult{};
+    std::string error;
     
-    // 從對應的 OrderBook 中查找
-    std::shared_lock<std::shared_mutex> obLock(orderBooksMutex_);
-    auto obIt = orderBooks_.find(symbol);
-    if (obIt != orderBooks_.end()) {
-        return obIt->second->findOrder(orderId);
+    std::string snapshotPath = findLatestSnapshot(directory);
+    if (!snapshotPath.empty()) {
+        SnapshotData data;
+        if (!readSnapshotFile(snapshotPath, data, error)) {
+            notifyError("Failed to load snapshot: " + error);
+            return false;
+        }
+        if (!restoreSnapshot(data, result)) {
+            return false;
+        }
     }
     
-    return nullptr;
+    // 只重播快照之後的日誌尾端；重播期間不發行情
+    JournalReader reader;
+    if (!reader.open(directory, error)) {
+        notifyError("Failed to open journal: " + error);
+        return false;
+    }
+    bool marketData = enableMarketData_;
+    enableMarketData_ = false;
+    JournalEntry entry;
+    uint64_t expected = result.snapshotSequence + 1;
+    bool gap = false;
+    while (reader.next(entry, expected)) {
+        if (entry.sequence != expected) {
+            gap = true;
+            break;
+        }
+        replayJournalEntry(entry, result);
+        ++expected;
+    }
+    enableMarketData_ = marketData;
+    
+    // 日誌須從快照涵蓋的序號之後連續接續
+    result.lastSequence = expected - 1;
+    if (gap || reader.lastSequence() < result.snapshotSequence) {
+        notifyError("Journal in " + directory + " does not continue from snapshot @" +
+                    std::to_string(result.snapshotSequence));
+        return false;
+    }
+    result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
 }
 
-// ===== 工具方法 =====
+bool MatchingEngine::setWaitStrategy(WaitStrategy strategy) {
+    if (running_.load()) {
+        notifyError("Cannot change wait strategy while MatchingEngine is running");
+        return false;
+    }
+    idleWaiter_.setStrategy(strategy);
+    return true;
+}
 
 std::string MatchingEngine::toString() const {
     std::ostringstream oss;
@@ -417,38 +655,27 @@ void MatchingEngine::dumpOrderBooks() const {
 #ifdef MTS_TESTING
 void MatchingEngine::waitForOrderProcessing() const {
     // 等待佇列清空
-    while (true) {
-        {
-            std::lock_guard<std::mutex> lock(messageQueueMutex_);
-            if (incomingMessages_.empty()) {
-                break;
-            }
-        }
+    while (!incomingMessages_.empty()) {
         std::this_thread::sleep_for(std::chrono::microseconds(10));
     }
 }
 
 size_t MatchingEngine::getPendingOrderCount() const {
-    std::lock_guard<std::mutex> lock(messageQueueMutex_);
     return incomingMessages_.size();
 }
 
+// 佇列只允許單一消費者：僅在引擎未啟動時使用
 void MatchingEngine::processAllPendingOrders() {
-    while (true) {
-        InternalMessagePtr message;
-        {
-            std::lock_guard<std::mutex> lock(messageQueueMutex_);
-            if (incomingMessages_.empty()) {
-                break;
-            }
-            message = incomingMessages_.front();
-            incomingMessages_.pop();
-        }
-        
+    InternalMessage message;
+    while (incomingMessages_.tryPop(message)) {
         auto report = processInternalMessage(message);
         if (report) {
             notifyExecution(report);
         }
+        for (const auto& passive : passiveReports_) {
+            notifyExecution(passive);
+        }
+        passiveReports_.clear();
     }
 }
 #endif
@@ -457,72 +684,365 @@ void MatchingEngine::processAllPendingOrders() {
 
 void MatchingEngine::processingLoop() {
     MATCHING_DEBUG("Processing loop started");
+    pinCurrentThread(cpu_, "Matching");
+    
+    std::vector<ExecutionReportPtr> batch;
+    batch.reserve(batchSize_);
     
     while (running_.load()) {
-        try {
-            InternalMessagePtr message;
-            
-            // 等待新訊息
-            {
-                std::unique_lock<std::mutex> lock(messageQueueMutex_);
-                messageQueueCV_.wait(lock, [this] { 
-                    return !incomingMessages_.empty() || !running_.load(); 
-                });
-                
-                if (!running_.load()) {
-                    break;
+        InternalMessage message;
+        
+        // 等待新訊息
+        if (!incomingMessages_.tryPop(message)) {
+            idleWaiter_.wait([this] {
+                return !incomingMessages_.empty() || !running_.load(std::memory_order_relaxed)
+                    || latencyPublishRequested_.load(std::memory_order_relaxed)
+                    || latencyResetRequested_.load(std::memory_order_relaxed)
+                    || (snapshotRequested_.load(std::memory_order_relaxed) &&
+                        !snapshotWriting_.load(std::memory_order_relaxed));
+            });
+            serviceLatencyRequests();
+            serviceSnapshotRequest();
+            continue;
+        }
+        
+        // 一次喚醒最多連續處理 batchSize_ 筆，回報與行情在批次結束時一起送出
+        deferMarketData_ = true;
+        size_t processed = 0;
+        do {
+            try {
+                auto report = processTimed(message);
+                if (report) {
+                    batch.push_back(std::move(report));
                 }
-                
-                if (incomingMessages_.empty()) {
-                    continue;
+                // 被成交的掛單回報排在進場訂單之後
+                if (!passiveReports_.empty()) {
+                    batch.insert(batch.end(), passiveReports_.begin(), passiveReports_.end());
+                    passiveReports_.clear();
                 }
-                
-                message = incomingMessages_.front();
-                incomingMessages_.pop();
+            } catch (const std::exception& e) {
+                notifyError("Error in processing loop: " + std::string(e.what()));
             }
-            
-            // 處理訊息
-            auto start = std::chrono::high_resolution_clock::now();
-            
-            auto report = processInternalMessage(message);
-            
-            auto end = std::chrono::high_resolution_clock::now();
-            auto processingTime = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-            
-            // 檢查處理時間是否超時
-            if (processingTime > maxProcessingTime_) {
-                std::ostringstream oss;
-                oss << "Message processing timeout: " 
-                    << std::chrono::duration_cast<std::chrono::microseconds>(processingTime).count() 
-                    << "μs (limit: " 
-                    << maxProcessingTime_.count() << "μs)";
-                notifyError(oss.str());
+        } while (++processed < batchSize_ && incomingMessages_.tryPop(message));
+        deferMarketData_ = false;
+        
+        // 群組提交：回報送出前本批次的輸入已依設定落盤
+        if (journal_) {
+            journal_->commit(incomingMessages_.empty());
+        }
+        flushBatch(batch);
+        serviceLatencyRequests();
+        serviceSnapshotRequest();
+    }
+    
+    MATCHING_DEBUG("Processing loop ended");
+}
+
+ExecutionReportPtr MatchingEngine::processTimed(const InternalMessage& message) {
+    auto start = std::chrono::high_resolution_clock::now();
+    if (message.enqueueTimeNs != 0) {
+        uint64_t dequeueNs = steadyNowNs();
+        liveLatency_.queueDelay.record(dequeueNs > message.enqueueTimeNs ? dequeueNs - message.enqueueTimeNs : 0);
+    }
+    
+    // 新訂單的生命週期追蹤（訂單可能在處理中歸還訂單池，先取出 OrderID）
+    OrderID tracedOrderId = 0;
+    if (message.type == InternalMessageType::NewOrder && OrderTracer::instance().isEnabled()) {
+        if (const Order* order = orderPool_.get(message.order)) {
+            tracedOrderId = order->getOrderId();
+            OrderTracer::trace(tracedOrderId, TraceStage::Dequeue);
+        }
+    }
+    
+    journalMessage(message);
+    auto report = processInternalMessage(message);
+    if (tracedOrderId != 0) {
+        OrderTracer::trace(tracedOrderId, TraceStage::Match);
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    auto processingTime = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    
+    // 檢查處理時間是否超時
+    if (processingTime > maxProcessingTime_) {
+        std::ostringstream oss;
+        oss << "Message processing timeout: " 
+            << std::chrono::duration_cast<std::chrono::microseconds>(processingTime).count() 
+            << "μs (limit: " 
+            << maxProcessingTime_.count() << "μs)";
+        notifyError(oss.str());
+    }
+    
+    // 更新統計
+    if (report) {
+        updateStatistics(report, processingTime);
+    }
+    recordLatency(message.type, report, static_cast<uint64_t>(processingTime.count()));
+    return report;
+}
+
+void MatchingEngine::recordLatency(InternalMessageType type, const ExecutionReportPtr& report, uint64_t processingNs) {
+    switch (type) {
+        case InternalMessageType::NewOrder:    liveLatency_.newOrder.record(processingNs); break;
+        case InternalMessageType::CancelOrder: liveLatency_.cancelOrder.record(processingNs); break;
+        case InternalMessageType::ModifyOrder: liveLatency_.modifyOrder.record(processingNs); break;
+    }
+    if (report && !report->symbol.empty()) {
+        liveLatency_.perSymbol[report->symbol].record(processingNs);
+    }
+}
+
+void MatchingEngine::serviceLatencyRequests() {
+    // 先讀發佈要求：在它之前送出的重設要求必定可見，會先套用
+    bool publish = latencyPublishRequested_.load(std::memory_order_acquire);
+    if (latencyResetRequested_.load(std::memory_order_relaxed)) {
+        liveLatency_.reset();
+        latencyResetRequested_.store(false, std::memory_order_relaxed);
+    }
+    if (publish) {
+        statistics_.publishLatency(liveLatency_);
+        latencyPublishRequested_.store(false, std::memory_order_relaxed);
+        latencyPublishCount_.fetch_add(1, std::memory_order_release);
+    }
+}
+
+const EngineStatistics& MatchingEngine::getStatistics() const {
+    if (!running_.load()) {
+        statistics_.publishLatency(liveLatency_);   // 沒有撮合執行緒在寫入
+        return statistics_;
+    }
+    
+    uint64_t published = latencyPublishCount_.load(std::memory_order_acquire);
+    latencyPublishRequested_.store(true, std::memory_order_release);
+    idleWaiter_.notify();
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+    while (latencyPublishCount_.load(std::memory_order_acquire) == published &&
+           running_.load() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    return statistics_;
+}
+
+void MatchingEngine::resetStatistics() {
+    statistics_.reset();
+    if (running_.load()) {
+        latencyResetRequested_.store(true, std::memory_order_relaxed);
+        idleWaiter_.notify();
+    } else {
+        liveLatency_.reset();
+    }
+}
+
+void MatchingEngine::flushBatch(std::vector<ExecutionReportPtr>& batch) {
+    if (!batch.empty()) {
+        if (OrderTracer::instance().isEnabled()) {
+            for (const auto& report : batch) {
+                OrderTracer::trace(report->orderId, TraceStage::Report);
             }
-            
-            // 更新統計和通知
-            if (report) {
-                updateStatistics(report, processingTime);
+        }
+        if (executionBatchCallback_) {
+            try {
+                executionBatchCallback_(batch.data(), batch.size());
+            } catch (const std::exception& e) {
+                MATCHING_DEBUG("Error in execution batch callback: " << e.what());
+            }
+        } else {
+            for (const auto& report : batch) {
                 notifyExecution(report);
             }
-            
+        }
+        batch.clear();
+    }
+    
+    if (pendingMarketData_.empty()) {
+        return;
+    }
+    
+    // 同一批次內每個標的只發一次最新快照
+    if (marketDataBatchCallback_) {
+        std::vector<MarketDataPtr> snapshots;
+        snapshots.reserve(pendingMarketData_.size());
+        for (const auto& symbol : pendingMarketData_) {
+            if (auto snapshot = createMarketData(symbol)) {
+                snapshots.push_back(std::move(snapshot));
+            }
+        }
+        try {
+            marketDataBatchCallback_(snapshots.data(), snapshots.size());
         } catch (const std::exception& e) {
-            notifyError("Error in processing loop: " + std::string(e.what()));
+            MATCHING_DEBUG("Error in market data batch callback: " << e.what());
+        }
+    } else {
+        for (const auto& symbol : pendingMarketData_) {
+            publishMarketData(symbol);
+        }
+    }
+    pendingMarketData_.clear();
+}
+
+void MatchingEngine::journalMessage(const InternalMessage& message) {
+    if (!journal_) {
+        return;
+    }
+    uint64_t sequence = 0;
+    switch (message.type) {
+        case InternalMessageType::NewOrder:
+            if (const Order* order = orderPool_.get(message.order)) {
+                sequence = journal_->appendNewOrder(*order);
+                break;
+            }
+            return;   // 無效 handle：撮合時直接拒絕，不影響狀態
+        case InternalMessageType::CancelOrder:
+            sequence = journal_->appendCancel(message.targetOrderId, message.reason);
+            break;
+        case InternalMessageType::ModifyOrder:
+            sequence = journal_->appendModify(message.targetOrderId, message.newPrice, message.newQuantity);
+            break;
+    }
+    if (sequence == 0) {
+        notifyError("Failed to write journal record");
+    }
+}
+
+void MatchingEngine::serviceSnapshotRequest() {
+    if (!snapshotRequested_.load(std::memory_order_acquire) || snapshotWriting_.load(std::memory_order_acquire)) {
+        return;
+    }
+    snapshotRequested_.store(false, std::memory_order_relaxed);
+    if (journal_->lastSequence() == lastSnapshotSequence_) {
+        return;
+    }
+    lastSnapshotSequence_ = journal_->lastSequence();
+    
+    // 序號屏障：到 journal_->lastSequence() 為止的輸入都已處理完，先讓它們落盤
+    journal_->commit(false, true);
+    auto image = std::make_shared<SnapshotImage>();
+    image->journalSequence = journal_->lastSequence();
+    image->engineSequence = nextSequence_;
+    {
+        std::shared_lock<std::shared_mutex> lock(orderBooksMutex_);
+        std::vector<const Order*> bids;
+        std::vector<const Order*> asks;
+        for (const auto& pair : orderBooks_) {
+            bids.clear();
+            asks.clear();
+            pair.second->collectOrders(bids, asks);
+            image->beginBook(pair.first, pair.second->getConfig());
+            for (const Order* order : bids) {
+                image->addOrder(*order);
+            }
+            for (const Order* order : asks) {
+                image->addOrder(*order);
+            }
         }
     }
     
-    MATCHING_DEBUG("Processing loop ended");
+    if (snapshotThread_.joinable()) {
+        snapshotThread_.join();   // 上一個寫入已結束
+    }
+    snapshotWriting_.store(true, std::memory_order_release);
+    std::string directory = journal_->config().directory;
+    snapshotThread_ = std::thread([this, image, directory] {
+        std::string path;
+        std::string error;
+        if (writeSnapshotFile(directory, *image, path, error)) {
+            pruneSnapshots(directory, SNAPSHOTS_TO_KEEP);
+            snapshotCount_.fetch_add(1);
+            MATCHING_DEBUG("Snapshot written: " << path << " (" << image->orderCount() << " orders)");
+        } else {
+            notifyError("Failed to write snapshot: " + error);
+        }
+        snapshotWriting_.store(false, std::memory_order_release);
+        idleWaiter_.notify();   // 寫入期間延後的要求
+    });
 }
 
-ExecutionReportPtr MatchingEngine::processInternalMessage(InternalMessagePtr message) {
-    switch (message->type) {
+bool MatchingEngine::restoreSnapshot(const SnapshotData& data, RecoveryResult& result) {
+    nextSequence_ = data.engineSequence;
+    result.snapshotSequence = data.journalSequence;
+    
+    for (const auto& book : data.books) {
+        setOrderBookConfig(book.symbol, book.config);
+        OrderBook* orderBook = getOrCreateOrderBook(book.symbol);
+        if (!orderBook) {
+            return false;
+        }
+        orderBook->setTradeCallback(nullptr);
+        
+        // 依優先順序掛回；快照中的簿不交叉，不會產生成交
+        for (const auto* side : {&book.bids, &book.asks}) {
+            for (const auto& saved : *side) {
+                OrderHandle handle = INVALID_ORDER_HANDLE;
+                try {
+                    handle = orderPool_.acquire(saved.orderId, saved.clientId, book.symbol, saved.side,
+                                                saved.orderType, saved.price, saved.quantity, saved.timeInForce);
+                } catch (const std::exception& e) {
+                    notifyError("Invalid order " + std::to_string(saved.orderId) + " in snapshot: " + e.what());
+                    return false;
+                }
+                if (handle == INVALID_ORDER_HANDLE) {
+                    notifyError("Order pool exhausted while restoring snapshot");
+                    return false;
+                }
+                Order& order = orderPool_[handle];
+                order.setRemainingQuantity(saved.remainingQuantity);
+                order.setStatus(saved.status);
+                order.setSequence(saved.sequence);
+                if (!orderIndex_.insert(saved.orderId, handle, orderBook)) {
+                    orderPool_.release(handle);
+                    notifyError("Duplicate order " + std::to_string(saved.orderId) + " in snapshot");
+                    return false;
+                }
+                orderBook->addOrder(&order);
+                result.maxOrderId = std::max(result.maxOrderId, saved.orderId);
+                ++result.restoredOrders;
+            }
+        }
+    }
+    return true;
+}
+
+void MatchingEngine::replayJournalEntry(const JournalEntry& entry, RecoveryResult& result) {
+    switch (entry.type) {
+        case JournalRecordType::NewOrder: {
+            result.maxOrderId = std::max(result.maxOrderId, entry.orderId);
+            OrderHandle handle = INVALID_ORDER_HANDLE;
+            try {
+                handle = orderPool_.acquire(entry.orderId, entry.clientId, entry.symbol, entry.side,
+                                            entry.orderType, entry.price, entry.quantity, entry.timeInForce);
+            } catch (const std::exception& e) {
+                notifyError("Invalid order in journal #" + std::to_string(entry.sequence) + ": " + e.what());
+                break;
+            }
+            if (handle == INVALID_ORDER_HANDLE) {
+                notifyError("Order pool exhausted while replaying journal");
+                break;
+            }
+            processNewOrder(handle);
+            passiveReports_.clear();   // 重播不送出回報
+            break;
+        }
+        case JournalRecordType::CancelOrder:
+            processCancelOrder(entry.orderId, entry.reason);
+            break;
+        case JournalRecordType::ModifyOrder:
+            processModifyOrder(entry.orderId, entry.price, entry.quantity);
+            break;
+    }
+    ++result.replayedRecords;
+}
+
+ExecutionReportPtr MatchingEngine::processInternalMessage(const InternalMessage& message) {
+    switch (message.type) {
         case InternalMessageType::NewOrder:
-            return processNewOrder(message->order);
+            return processNewOrder(message.order);
             
         case InternalMessageType::CancelOrder:
-            return processCancelOrder(message->targetOrderId, message->reason);
+            return processCancelOrder(message.targetOrderId, message.getReason());
             
         case InternalMessageType::ModifyOrder:
-            return processModifyOrder(message->targetOrderId, message->newPrice, message->newQuantity);
+            return processModifyOrder(message.targetOrderId, message.newPrice, message.newQuantity);
             
         default:
             notifyError("Unknown internal message type");
@@ -530,45 +1050,53 @@ ExecutionReportPtr MatchingEngine::processInternalMessage(InternalMessagePtr mes
     }
 }
 
-ExecutionReportPtr MatchingEngine::processNewOrder(OrderPtr order) {
+ExecutionReportPtr MatchingEngine::processNewOrder(OrderHandle handle) {
+    Order* order = orderPool_.get(handle);
     if (!order) {
-        auto dummyOrder = std::make_shared<Order>();
-        return createExecutionReport(*dummyOrder, OrderStatus::Rejected, "Null order");
+        Order dummyOrder;
+        return createExecutionReport(dummyOrder, OrderStatus::Rejected, "Invalid order handle");
     }
     
     MATCHING_DEBUG("Processing new order: " << order->toString());
     
+    // 未進入簿的訂單：產生回報後立即歸還訂單池
+    auto reject = [this, order, handle](const std::string& reason) {
+        auto report = createExecutionReport(*order, OrderStatus::Rejected, reason);
+        orderPool_.release(handle);
+        return report;
+    };
+    
     // 基本驗證
     std::string rejectReason;
     if (!validateOrderBasic(*order, rejectReason)) {
-        return createExecutionReport(*order, OrderStatus::Rejected, rejectReason);
+        return reject(rejectReason);
     }
     
     // 風險檢查
     if (enableRiskCheck_ && !performRiskCheck(*order, rejectReason)) {
-        return createExecutionReport(*order, OrderStatus::Rejected, rejectReason);
+        return reject(rejectReason);
     }
     
     // 取得或建立 OrderBook
     OrderBook* orderBook = getOrCreateOrderBook(order->getSymbol());
     if (!orderBook) {
-        return createExecutionReport(*order, OrderStatus::Rejected, "Failed to create OrderBook");
+        return reject("Failed to create OrderBook");
     }
     
-    // 記錄訂單對應的標的
-    {
-        std::lock_guard<std::mutex> lock(orderMapMutex_);
-        orderSymbolMap_[order->getOrderId()] = order->getSymbol();
+    if (order->isLimitOrder() && !orderBook->acceptsPrice(order->getPrice())) {
+        return reject("Price outside order book range");
     }
     
-    // 設定訂單回調
-    std::vector<TradePtr> trades;
-    orderBook->setTradeCallback([&trades](const TradePtr& trade) {
-        trades.push_back(trade);
-    });
+    // 登記訂單索引
+    if (!orderIndex_.insert(order->getOrderId(), handle, orderBook)) {
+        return reject("Duplicate OrderID");
+    }
+    order->setSequence(++nextSequence_);
     
-    // 加入 OrderBook 進行撮合
-    auto generatedTrades = orderBook->addOrder(order);
+    // 加入 OrderBook 進行撮合；成交寫入重複使用的緩衝區
+    tradeBuffer_.clear();
+    orderBook->addOrder(order, tradeBuffer_);
+    const std::vector<Trade>& generatedTrades = tradeBuffer_;
     
     // 建立執行回報
     auto report = createExecutionReport(*order, order->getStatus());
@@ -576,11 +1104,11 @@ ExecutionReportPtr MatchingEngine::processNewOrder(OrderPtr order) {
     // 處理成交
     if (!generatedTrades.empty()) {
         // 取最後一筆成交作為主要成交資訊
-        auto lastTrade = generatedTrades.back();
-        report->executionPrice = lastTrade->price;
-        report->executionQuantity = lastTrade->quantity;
+        const Trade& lastTrade = generatedTrades.back();
+        report->executionPrice = lastTrade.price;
+        report->executionQuantity = lastTrade.quantity;
         report->counterOrderId = order->isBuyOrder() ? 
-            lastTrade->sellOrderId : lastTrade->buyOrderId;
+            lastTrade.sellOrderId : lastTrade.buyOrderId;
         
         MATCHING_DEBUG("Order matched: " << generatedTrades.size() << " trades generated");
         
@@ -588,6 +1116,26 @@ ExecutionReportPtr MatchingEngine::processNewOrder(OrderPtr order) {
         if (enableMarketData_) {
             notifyMarketData(order->getSymbol());
         }
+        
+        // 被動成交的掛單各自產生一筆成交回報（部分成交 / 全部成交），
+        // 完全成交的對手單已離開簿，產生回報後歸還訂單池
+        for (const auto& trade : generatedTrades) {
+            OrderID counterId = order->isBuyOrder() ? trade.sellOrderId : trade.buyOrderId;
+            const Order* counter = findOrder(counterId);
+            if (!counter) {
+                continue;
+            }
+            auto passive = createTradeExecutionReport(*counter, trade);
+            passiveReports_.push_back(std::move(passive));
+            if (counter->isFilled()) {
+                retireOrder(counterId);
+            }
+        }
+    }
+    
+    // 本單未掛上簿（全部成交或市價單剩餘被拒）
+    if (!order->isActive()) {
+        retireOrder(order->getOrderId());
     }
     
     return report;
@@ -596,39 +1144,39 @@ ExecutionReportPtr MatchingEngine::processNewOrder(OrderPtr order) {
 ExecutionReportPtr MatchingEngine::processCancelOrder(OrderID orderId, const std::string& reason) {
     MATCHING_DEBUG("Processing cancel order: " << orderId << ", reason: " << reason);
     
-    // 查找訂單
-    auto order = findOrder(orderId);
-    if (!order) {
+    // 一次探測取得訂單與所屬 OrderBook
+    const OrderIndex::Entry* entry = orderIndex_.find(orderId);
+    if (!entry) {
         // 建立假的訂單物件用於回報
-        auto dummyOrder = std::make_shared<Order>();
-        return createExecutionReport(*dummyOrder, OrderStatus::Rejected, "Order not found");
-    }
-    
-    // 從 OrderBook 中取消
-    const Symbol& symbol = order->getSymbol();
-    
-    std::shared_lock<std::shared_mutex> lock(orderBooksMutex_);
-    auto it = orderBooks_.find(symbol);
-    if (it == orderBooks_.end()) {
-        return createExecutionReport(*order, OrderStatus::Rejected, "OrderBook not found");
+        Order dummyOrder;
+        return createExecutionReport(dummyOrder, OrderStatus::Rejected, "Order not found");
     }
+    Order* order = &orderPool_[entry->handle];
     
-    bool cancelled = it->second->cancelOrder(orderId);
+    bool cancelled = entry->book->cancelOrder(order);
     if (cancelled) {
-        // 從映射中移除
-        {
-            std::lock_guard<std::mutex> mapLock(orderMapMutex_);
-            orderSymbolMap_.erase(orderId);
-        }
-        
-        return createExecutionReport(*order, OrderStatus::Cancelled, reason);
+        // 回報複製完訂單內容後再歸還訂單池
+        auto report = createExecutionReport(*order, OrderStatus::Cancelled, reason);
+        retireOrder(orderId);
+        return report;
     } else {
         return createExecutionReport(*order, OrderStatus::Rejected, "Failed to cancel order");
     }
 }
 
 ExecutionReportPtr MatchingEngine::processModifyOrder(OrderID orderId, Price newPrice, Quantity newQuantity) {
-    // 簡化實作：修改訂單 = 取消 + 重新下單
+    // 價格不變且只減量：在原位修改，保留時間優先
+    if (const OrderIndex::Entry* entry = orderIndex_.find(orderId)) {
+        Order* order = &orderPool_[entry->handle];
+        if (order->getPrice() == newPrice && newQuantity < order->getQuantity()) {
+            if (entry->book->reduceOrderQuantity(order, newQuantity)) {
+                MATCHING_DEBUG("Order quantity reduced in place for OrderID: " << orderId);
+                return createExecutionReport(*order, order->getStatus());
+            }
+        }
+    }
+    
+    // 其他情況簡化為：修改訂單 = 取消 + 重新下單
     // 生產環境需要原子性的修改操作
     
     auto cancelReport = processCancelOrder(orderId, "Modify order");
@@ -654,15 +1202,40 @@ OrderBook* MatchingEngine::getOrCreateOrderBook(const Symbol& symbol) {
         return it->second.get();
     }
     
-    // 建立新的 OrderBook
-    auto orderBook = std::make_unique<OrderBook>(symbol);
+    // 建立新的 OrderBook，套用該標的的容器策略（未設定則用 std::map）
+    OrderBookConfig config;
+    auto configIt = orderBookConfigs_.find(symbol);
+    if (configIt != orderBookConfigs_.end()) {
+        config = configIt->second;
+    }
+    
+    std::unique_ptr<OrderBook> orderBook;
+    try {
+        orderBook = std::make_unique<OrderBook>(symbol, config);
+    } catch (const std::exception& e) {
+        notifyError("Failed to create OrderBook for " + symbol + ": " + e.what());
+        return nullptr;
+    }
+    
     OrderBook* ptr = orderBook.get();
     orderBooks_[symbol] = std::move(orderBook);
     
-    MATCHING_DEBUG("Created new OrderBook for symbol: " << symbol);
+    MATCHING_DEBUG("Created new OrderBook for symbol: " << symbol
+                   << " (" << priceLevelPolicyToString(config.policy) << ")");
     return ptr;
 }
 
+bool MatchingEngine::setOrderBookConfig(const Symbol& symbol, const OrderBookConfig& config) {
+    std::unique_lock<std::shared_mutex> lock(orderBooksMutex_);
+    
+    if (orderBooks_.count(symbol)) {
+        return false;  // 容器策略在建立時決定，之後不可更換
+    }
+    
+    orderBookConfigs_[symbol] = config;
+    return true;
+}
+
 // 風險檢查
 bool MatchingEngine::performRiskCheck(const Order& order, std::string& rejectReason) const {
     // 價格檢查
@@ -700,7 +1273,7 @@ bool MatchingEngine::validateOrderBasic(const Order& order, std::string& rejectR
         return false;
     }
     
-    if (order.isLimitOrder() && order.getPrice() <= 0.0) {
+    if (order.isLimitOrder() && order.getPrice() <= Price()) {
         rejectReason = "Invalid price for limit order";
         return false;
     }
@@ -720,9 +1293,15 @@ bool MatchingEngine::validateOrderSize(const Order& order, std::string& rejectRe
 
 // 訂單價格驗證
 bool MatchingEngine::validateOrderPrice(const Order& order, std::string& rejectReason) const {
-    if (order.isLimitOrder() && order.getPrice() > maxOrderPrice_) {
-        rejectReason = "Order price exceeds maximum limit: " + std::to_string(maxOrderPrice_);
-        return false;
+    if (order.isLimitOrder()) {
+        // 不同標的的 tick 大小不同，統一換算到 MAX_DECIMALS 再比較
+        PriceScale scale = PriceScaleRegistry::forSymbol(order.getSymbolId());
+        Price::Ticks normalized;
+        if (!scale.checkedNormalize(order.getPrice(), normalized) || normalized > maxOrderPriceNormalized_) {
+            PriceScale maxScale(PriceScale::MAX_DECIMALS);
+            rejectReason = "Order price exceeds maximum limit: " + maxScale.toString(Price(maxOrderPriceNormalized_));
+            return false;
+        }
     }
     
     return true;
@@ -756,8 +1335,18 @@ void MatchingEngine::notifyExecution(const ExecutionReportPtr& report) {
     }
 }
 
-// 通知市場行情
+// 通知市場行情；處理執行緒的批次中只記錄標的，批次結束時再發送
 void MatchingEngine::notifyMarketData(const Symbol& symbol) {
+    if (deferMarketData_) {
+        if (std::find(pendingMarketData_.begin(), pendingMarketData_.end(), symbol) == pendingMarketData_.end()) {
+            pendingMarketData_.push_back(symbol);
+        }
+        return;
+    }
+    publishMarketData(symbol);
+}
+
+void MatchingEngine::publishMarketData(const Symbol& symbol) {
     if (marketDataCallback_) {
         try {
             auto marketData = createMarketData(symbol);
@@ -792,19 +1381,12 @@ void MatchingEngine::updateStatistics(const ExecutionReportPtr& report,
     uint64_t timeNs = processingTime.count();
     statistics_.totalProcessingTimeNs.fetch_add(timeNs);
     
-    // 更新最小/最大處理時間
-    uint64_t currentMin = statistics_.minProcessingTimeNs.load();
-    while (timeNs < currentMin) {
-        if (statistics_.minProcessingTimeNs.compare_exchange_weak(currentMin, timeNs)) {
-            break;
-        }
+    // 更新最小/最大處理時間（只有撮合執行緒寫入，不需要 CAS 迴圈）
+    if (timeNs < statistics_.minProcessingTimeNs.load(std::memory_order_relaxed)) {
+        statistics_.minProcessingTimeNs.store(timeNs, std::memory_order_relaxed);
     }
-    
-    uint64_t currentMax = statistics_.maxProcessingTimeNs.load();
-    while (timeNs > currentMax) {
-        if (statistics_.maxProcessingTimeNs.compare_exchange_weak(currentMax, timeNs)) {
-            break;
-        }
+    if (timeNs > statistics_.maxProcessingTimeNs.load(std::memory_order_relaxed)) {
+        statistics_.maxProcessingTimeNs.store(timeNs, std::memory_order_relaxed);
     }
     
     // 如果有成交，更新成交統計
@@ -812,9 +1394,23 @@ void MatchingEngine::updateStatistics(const ExecutionReportPtr& report,
         statistics_.tradesExecuted.fetch_add(1);
         statistics_.totalVolume.fetch_add(report->executionQuantity);
         
-        // 計算成交金額 (以分為單位)
-        uint64_t tradeValue = static_cast<uint64_t>(report->executionPrice * report->executionQuantity * 100);
-        statistics_.totalValue.fetch_add(tradeValue);
+        // 計算成交金額（整數運算，以 10^-MAX_DECIMALS 為單位）
+        // 價格已通過 validateOrderPrice 的上限檢查，乘上數量仍可能溢位；溢位時飽和在最大值
+        PriceScale scale = PriceScaleRegistry::forSymbol(report->symbol);
+        uint64_t tradeValue;
+        if (!checkedMul(static_cast<uint64_t>(scale.normalize(report->executionPrice)),
+                        static_cast<uint64_t>(report->executionQuantity), tradeValue)) {
+            tradeValue = UINT64_MAX;
+            MTS_LOG_WARN("⚠️ Trade value overflow for order {} ({} @ {} ticks), totalValue saturated",
+                         report->orderId, report->executionQuantity, report->executionPrice.ticks());
+        }
+        uint64_t total = statistics_.totalValue.load(std::memory_order_relaxed);
+        uint64_t updated;
+        do {
+            if (!checkedAdd(total, tradeValue, updated)) {
+                updated = UINT64_MAX;
+            }
+        } while (!statistics_.totalValue.compare_exchange_weak(total, updated, std::memory_order_relaxed));
     }
     
     // 如果是拒絕，更新拒絕統計
@@ -827,7 +1423,7 @@ void MatchingEngine::updateStatistics(const ExecutionReportPtr& report,
 ExecutionReportPtr MatchingEngine::createExecutionReport(const Order& order, 
                                                        OrderStatus status,
                                                        const std::string& rejectReason) const {
-    auto report = std::make_shared<ExecutionReport>(order);
+    auto report = reportPool_.create(order);
     report->status = status;
     report->rejectReason = rejectReason;
     
@@ -836,16 +1432,16 @@ ExecutionReportPtr MatchingEngine::createExecutionReport(const Order& order,
 
 // 建立成交執行回報
 ExecutionReportPtr MatchingEngine::createTradeExecutionReport(const Order& order,
-                                                            const TradePtr& trade) const {
-    auto report = std::make_shared<ExecutionReport>(order);
-    report->executionPrice = trade->price;
-    report->executionQuantity = trade->quantity;
+                                                            const Trade& trade) const {
+    auto report = reportPool_.create(order);
+    report->executionPrice = trade.price;
+    report->executionQuantity = trade.quantity;
     
     // 設定對手單ID
     if (order.isBuyOrder()) {
-        report->counterOrderId = trade->sellOrderId;
+        report->counterOrderId = trade.sellOrderId;
     } else {
-        report->counterOrderId = trade->buyOrderId;
+        report->counterOrderId = trade.buyOrderId;
     }
     
     return report;
@@ -867,7 +1463,7 @@ MarketDataPtr MatchingEngine::createMarketData(const Symbol& symbol) const {
         
         // 最後成交價和成交量需要從交易記錄中獲取
         // 這裡簡化處理，實際需要維護最後成交資訊
-        marketData->lastTradePrice = (marketData->bidPrice + marketData->askPrice) / 2.0;
+        marketData->lastTradePrice = midPrice(marketData->bidPrice, marketData->askPrice);
         marketData->lastTradeQuantity = 0;
     }
     
@@ -892,17 +1488,15 @@ void MatchingEngine::cleanup() {
         orderBooks_.clear();
     }
     
-    // 清除訂單映射
-    {
-        std::lock_guard<std::mutex> lock(orderMapMutex_);
-        orderSymbolMap_.clear();
-    }
+    // 清除訂單索引
+    orderIndex_.clear();
     
-    // 清除訊息佇列
-    {
-        std::lock_guard<std::mutex> lock(messageQueueMutex_);
-        std::queue<InternalMessagePtr> empty;
-        incomingMessages_.swap(empty);
+    // 清除訊息佇列；尚未處理的新訂單歸還訂單池
+    InternalMessage message;
+    while (incomingMessages_.tryPop(message)) {
+        if (message.type == InternalMessageType::NewOrder) {
+            orderPool_.release(message.order);
+        }
     }
     
     MATCHING_DEBUG("MatchingEngine cleanup completed");
@@ -1,6 +1,15 @@
 #pragma once
 #include "order.h"
 #include "order_book.h"
+#include "order_pool.h"
+#include "order_index.h"
+#include "mpsc_ring.h"
+#include "wait_strategy.h"
+#include "thread_affinity.h"
+#include "latency_histogram.h"
+#include "journal.h"
+#include "snapshot.h"
+#include <algorithm>
 #include <string>
 #include <unordered_map>
 #include <memory>
@@ -8,8 +17,6 @@
 #include <thread>
 #include <atomic>
 #include <functional>
-#include <queue>
-#include <condition_variable>
 #include <chrono>
 #include <shared_mutex>
 namespace mts {
@@ -19,18 +26,16 @@ namespace core {
 struct ExecutionReport;
 struct MarketDataSnapshot;
 struct EngineStatistics;
-struct InternalMessage;  // 新增：內部訊息結構
 
 // 類型別名
 using ExecutionReportPtr = std::shared_ptr<ExecutionReport>;
 using MarketDataPtr = std::shared_ptr<MarketDataSnapshot>;
-using OrderPtr = std::shared_ptr<Order>;
 
 // 執行回報
 struct ExecutionReport {
     OrderID orderId;
     OrderID counterOrderId;  // 對手單ID (若有撮合)
-    Symbol symbol;
+    SymbolId symbol;
     Side side;
     OrderType orderType;
     Price price;
@@ -47,6 +52,28 @@ struct ExecutionReport {
     std::string toString() const;
 };
 
+/*
+   執行回報的記憶體池：以 std::allocate_shared 建立，回報與引用計數的控制區塊放在同一個固定大小的區塊，
+   最後一個引用釋放時區塊回到空閒串列，穩態下建立回報不經過 operator new。
+   • 回報可能在其他執行緒（輸出管線、測試）釋放，空閒串列以互斥鎖保護，無競爭時不進核心
+   • 池的狀態由每個回報的控制區塊共同持有，回報可比池與 MatchingEngine 活得久
+*/
+class ExecutionReportPool {
+public:
+    explicit ExecutionReportPool(size_t reserveBlocks = 1024);
+    
+    ExecutionReportPtr create(const Order& order) const;
+    
+    size_t allocatedBlocks() const;   // 曾向系統配置的區塊數
+    size_t freeBlocks() const;
+    
+private:
+    struct State;
+    template <typename T> class Allocator;
+    
+    std::shared_ptr<State> state_;
+};
+
 // 市場行情快照
 struct MarketDataSnapshot {
     Symbol symbol;
@@ -68,7 +95,7 @@ struct EngineStatistics {
     std::atomic<uint64_t> tradesExecuted{0};
     std::atomic<uint64_t> ordersRejected{0};
     std::atomic<uint64_t> totalVolume{0};
-    std::atomic<uint64_t> totalValue{0};  // 以分為單位
+    std::atomic<uint64_t> totalValue{0};  // 以 10^-PriceScale::MAX_DECIMALS 為單位
     
     // 效能統計
     std::atomic<uint64_t> minProcessingTimeNs{UINT64_MAX};
@@ -79,16 +106,79 @@ struct EngineStatistics {
     
     EngineStatistics();
     void reset();
+    void merge(const EngineStatistics& other);   // 累加另一份統計（分片彙總用）
     double getAverageProcessingTimeUs() const;
     double getThroughputPerSecond() const;
-    std::string toString() const;
+    std::string toString() const;                // 含延遲百分位數
+    
+    // 延遲分佈：撮合執行緒在本地記錄，需要時才發佈一份完整複本到這裡
+    LatencySnapshot getLatency() const;
+    void publishLatency(const LatencySnapshot& latency);
+    
+private:
+    LatencySnapshot latency_;
+    mutable std::mutex latencyMutex_;
+};
+
+// ===== 內部訊息類型 (用於處理異步請求) =====
+enum class InternalMessageType {
+    NewOrder,
+    CancelOrder,
+    ModifyOrder
+};
+
+// 固定大小、可平凡複製，以值存放於環形佇列中；新訂單只帶訂單池 handle
+struct InternalMessage {
+    static constexpr size_t MAX_REASON_LENGTH = 39;
+
+    InternalMessageType type = InternalMessageType::NewOrder;
+    OrderHandle order = INVALID_ORDER_HANDLE;  // 新訂單時使用
+    OrderID targetOrderId = 0;                 // 取消/修改時使用
+    Price newPrice;                            // 修改價格
+    Quantity newQuantity = 0;                  // 修改數量
+    uint64_t enqueueTimeNs = 0;                // 放入佇列的時間 (steady_clock)，0 表示未經佇列
+    char reason[MAX_REASON_LENGTH + 1] = {};   // 取消原因，過長時截斷（MatchingEngine 會記錄警告）
+    
+    std::string getReason() const { return std::string(reason); }
+    static bool reasonFits(const std::string& reason) noexcept { return reason.size() <= MAX_REASON_LENGTH; }
+    
+    static InternalMessage createNewOrder(OrderHandle order) {
+        InternalMessage msg;
+        msg.type = InternalMessageType::NewOrder;
+        msg.order = order;
+        return msg;
+    }
+    
+    static InternalMessage createCancelOrder(OrderID orderId, const std::string& reason) {
+        InternalMessage msg;
+        msg.type = InternalMessageType::CancelOrder;
+        msg.targetOrderId = orderId;
+        size_t length = std::min(reason.size(), MAX_REASON_LENGTH);
+        reason.copy(msg.reason, length);
+        msg.reason[length] = '\0';
+        return msg;
+    }
+    
+    static InternalMessage createModifyOrder(OrderID orderId, Price price, Quantity qty) {
+        InternalMessage msg;
+        msg.type = InternalMessageType::ModifyOrder;
+        msg.targetOrderId = orderId;
+        msg.newPrice = price;
+        msg.newQuantity = qty;
+        return msg;
+    }
 };
+static_assert(std::is_trivially_copyable<InternalMessage>::value,
+              "InternalMessage must stay trivially copyable for the inbound ring");
 
 // 撮合引擎主類別
 class MatchingEngine {
 public:
     // 回調函式類型
     using ExecutionCallback = std::function<void(const ExecutionReportPtr&)>;
+    // 批次回調：reports[0, count) 依處理順序排列，只在回調期間有效
+    using ExecutionBatchCallback = std::function<void(const ExecutionReportPtr* reports, size_t count)>;
+    using MarketDataBatchCallback = std::function<void(const MarketDataPtr* snapshots, size_t count)>;
     using MarketDataCallback = std::function<void(const MarketDataPtr&)>;
     using ErrorCallback = std::function<void(const std::string&)>;
     
@@ -102,24 +192,57 @@ public:
 private:
     // OrderBook 管理
     std::unordered_map<Symbol, std::unique_ptr<OrderBook>> orderBooks_;
+    std::unordered_map<Symbol, OrderBookConfig> orderBookConfigs_;  // 尚未建立的 OrderBook 所用設定
     mutable std::shared_mutex orderBooksMutex_;
     
-    // 訂單快取 (OrderID -> OrderBook Symbol)
-    std::unordered_map<OrderID, Symbol> orderSymbolMap_;
-    mutable std::mutex orderMapMutex_;
+    // 訂單池與索引 (OrderID -> 池中 handle + OrderBook)；訂單在終止狀態時歸還
+    // 索引只由撮合執行緒（或引擎未啟動時的同步介面）存取，不加鎖
+    OrderPool orderPool_;
+    OrderIndex orderIndex_;
+    uint64_t nextSequence_{0};    // 接受順序，只在撮合執行緒遞增
     
     // 執行緒模型
     std::atomic<bool> running_{false};
     std::thread processingThread_;
+    int cpu_{-1};                 // 撮合執行緒綁定的 CPU，-1 表示不綁核
     
-    // 內部訊息佇列 (修正設計衝突)
-    std::queue<std::shared_ptr<struct InternalMessage>> incomingMessages_;
-    std::mutex messageQueueMutex_;
-    std::condition_variable messageQueueCV_;
+    // 內部訊息佇列：閘道執行緒（多）→ 撮合執行緒（一）
+    MpscRing<InternalMessage> incomingMessages_;
+    mutable IdleWaiter idleWaiter_;   // getStatistics() 也需要喚醒撮合執行緒
     
     // 回調函式
     ExecutionCallback executionCallback_;
     MarketDataCallback marketDataCallback_;
+    ExecutionBatchCallback executionBatchCallback_;
+    MarketDataBatchCallback marketDataBatchCallback_;
+    
+    // 延遲直方圖（只由撮合執行緒記錄，無原子操作）
+    LatencySnapshot liveLatency_;
+    mutable std::atomic<bool> latencyPublishRequested_{false};
+    std::atomic<bool> latencyResetRequested_{false};
+    std::atomic<uint64_t> latencyPublishCount_{0};
+    
+    // 輸入日誌：撮合前寫入，批次結束送出回報前群組提交（只由撮合執行緒存取）
+    std::unique_ptr<JournalWriter> journal_;
+    
+    // 快照：撮合執行緒在批次之間擷取影像，背景執行緒寫檔
+    std::atomic<bool> snapshotRequested_{false};
+    std::atomic<bool> snapshotWriting_{false};
+    std::atomic<uint64_t> snapshotCount_{0};
+    uint64_t lastSnapshotSequence_{UINT64_MAX};   // 上次擷取時的日誌序號，沒有新輸入時不重複快照
+    std::thread snapshotThread_;
+    
+    // 批次處理（只由撮合執行緒存取）
+    size_t batchSize_{1};
+    bool deferMarketData_{false};
+    std::vector<Symbol> pendingMarketData_;
+    
+    // processNewOrder 為被動成交的掛單產生的回報，由呼叫端接在主回報之後送出（撮合執行緒專用）
+    std::vector<ExecutionReportPtr> passiveReports_;
+    
+    // 成交緩衝與回報池（撮合執行緒專用）：容量重複使用，撮合路徑上不逐筆配置
+    std::vector<Trade> tradeBuffer_;
+    ExecutionReportPool reportPool_;
     ErrorCallback errorCallback_;
     
     // 設定
@@ -132,12 +255,17 @@ private:
     mutable EngineStatistics statistics_;
     
     // 風險檢查參數
-    Price maxOrderPrice_{10000.0};      // 最大訂單價格
+    Price::Ticks maxOrderPriceNormalized_{10000 * 10000}; // 最大訂單價格（MAX_DECIMALS 精度，預設 10000.0000）
     Quantity maxOrderQuantity_{1000000}; // 最大訂單數量
     uint32_t maxOrdersPerSymbol_{10000}; // 每個標的最大訂單數
     
 public:
-    MatchingEngine();
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = 1 << 16;
+    static constexpr size_t SNAPSHOTS_TO_KEEP = 2;
+
+    // queueCapacity 須為 2 的次方
+    explicit MatchingEngine(size_t orderPoolCapacity = OrderPool::DEFAULT_CAPACITY,
+                            size_t queueCapacity = DEFAULT_QUEUE_CAPACITY);
     ~MatchingEngine();
     
     // 禁用複製和移動
@@ -153,8 +281,21 @@ public:
     
     // ===== 主要介面 =====
     
-    // 處理新訂單 (異步)
-    bool submitOrder(OrderPtr order);
+    // 從訂單池建立訂單（參數同 Order 建構函式）；池已滿時回傳 INVALID_ORDER_HANDLE
+    template <typename... Args>
+    OrderHandle createOrder(Args&&... args) {
+        return orderPool_.acquire(std::forward<Args>(args)...);
+    }
+    
+    // 建立後未送出的訂單需自行歸還
+    void discardOrder(OrderHandle handle) { orderPool_.release(handle); }
+    
+    // 存取尚未送出的訂單（送出後由撮合執行緒管理）
+    Order& getOrder(OrderHandle handle) { return orderPool_[handle]; }
+    const OrderPool& getOrderPool() const { return orderPool_; }
+    
+    // 處理新訂單 (異步)；引擎接手 handle，送出失敗（未啟動、佇列已滿）時直接歸還
+    bool submitOrder(OrderHandle handle);
     
     // 處理訂單取消 (異步)
     bool cancelOrder(OrderID orderId, const std::string& reason = "User requested");
@@ -163,7 +304,7 @@ public:
     bool modifyOrder(OrderID orderId, Price newPrice, Quantity newQuantity);
     
     // 同步處理訂單 (主要用於測試)
-    ExecutionReportPtr processOrderSync(OrderPtr order);
+    ExecutionReportPtr processOrderSync(OrderHandle handle);
     ExecutionReportPtr cancelOrderSync(OrderID orderId, const std::string& reason = "User requested");
     
     // ===== 查詢介面 =====
@@ -177,8 +318,8 @@ public:
     // 取得所有交易標的
     std::vector<Symbol> getAllSymbols() const;
     
-    // 查詢訂單狀態
-    OrderPtr findOrder(OrderID orderId) const;
+    // 查詢訂單狀態；回傳的指標在訂單終止（成交 / 取消）後失效，只應在撮合執行緒或同步介面中使用
+    const Order* findOrder(OrderID orderId) const;
     
     // ===== 回調設定 =====
     void setExecutionCallback(ExecutionCallback callback) { 
@@ -189,6 +330,15 @@ public:
         marketDataCallback_ = std::move(callback); 
     }
     
+    // 設定後撮合執行緒改以批次回報，取代逐筆的 ExecutionCallback / MarketDataCallback
+    void setExecutionBatchCallback(ExecutionBatchCallback callback) {
+        executionBatchCallback_ = std::move(callback);
+    }
+    
+    void setMarketDataBatchCallback(MarketDataBatchCallback callback) {
+        marketDataBatchCallback_ = std::move(callback);
+    }
+    
     void setErrorCallback(ErrorCallback callback) { 
         errorCallback_ = std::move(callback); 
     }
@@ -197,24 +347,56 @@ public:
     void setMatchingMode(MatchingMode mode) { matchingMode_ = mode; }
     MatchingMode getMatchingMode() const { return matchingMode_; }
     
+    // 設定標的的價格層級容器策略；需在該標的第一筆訂單之前呼叫，已建立時回傳 false
+    bool setOrderBookConfig(const Symbol& symbol, const OrderBookConfig& config);
+    
     void enableRiskCheck(bool enable) { enableRiskCheck_ = enable; }
     bool isRiskCheckEnabled() const { return enableRiskCheck_; }
     
     void enableMarketData(bool enable) { enableMarketData_ = enable; }
     bool isMarketDataEnabled() const { return enableMarketData_; }
     
+    // 每次喚醒最多連續處理的訊息數（最小 1）；需在 start() 之前設定
+    bool setBatchSize(size_t batchSize);
+    size_t getBatchSize() const { return batchSize_; }
+    
+    // 撮合執行緒的等待策略；需在 start() 之前設定
+    bool setWaitStrategy(WaitStrategy strategy);
+    WaitStrategy getWaitStrategy() const { return idleWaiter_.getStrategy(); }
+    
+    // 撮合執行緒綁定的 CPU（-1 不綁核）；需在 start() 之前設定
+    bool setCpuAffinity(int cpu);
+    int getCpuAffinity() const { return cpu_; }
+    
+    // 開啟輸入日誌，之後每筆新單 / 取消 / 修改在撮合前寫入；需在 start() 之前設定
+    bool enableJournal(const JournalConfig& config);
+    const JournalWriter* getJournal() const { return journal_.get(); }
+    
+    // 要求在下一個批次邊界擷取快照，寫入日誌目錄；未開啟日誌時回傳 false
+    // 上一個快照仍在寫入時，要求延到寫完後處理
+    bool requestSnapshot();
+    uint64_t getSnapshotCount() const { return snapshotCount_.load(); }
+    
+    // 由 directory 內最新的快照加上其後的日誌記錄重建狀態；需在 start() 與 enableJournal() 之前呼叫
+    // 重播產生的回報與行情不會送給回調
+    bool recover(const std::string& directory, RecoveryResult& result);
+    
     void setMaxProcessingTime(std::chrono::microseconds maxTime) { 
         maxProcessingTime_ = maxTime; 
     }
     
     // 風險檢查參數設定
-    void setMaxOrderPrice(Price maxPrice) { maxOrderPrice_ = maxPrice; }
+    // maxPrice 以 scale 的精度解讀
+    void setMaxOrderPrice(Price maxPrice, PriceScale scale = PriceScale()) {
+        maxOrderPriceNormalized_ = scale.normalize(maxPrice);
+    }
     void setMaxOrderQuantity(Quantity maxQty) { maxOrderQuantity_ = maxQty; }
     void setMaxOrdersPerSymbol(uint32_t maxOrders) { maxOrdersPerSymbol_ = maxOrders; }
     
     // ===== 統計資訊 =====
-    const EngineStatistics& getStatistics() const { return statistics_; }
-    void resetStatistics() { statistics_.reset(); }
+    // 回傳前先請撮合執行緒發佈最新的延遲分佈（最多等待約 50ms）
+    const EngineStatistics& getStatistics() const;
+    void resetStatistics();
     
     // ===== 工具方法 =====
     std::string toString() const;
@@ -235,16 +417,28 @@ private:
     void processingLoop();
     
     // 內部訊息處理
-    ExecutionReportPtr processInternalMessage(std::shared_ptr<struct InternalMessage> message);
-    
-    // 訂單處理
-    ExecutionReportPtr processNewOrder(OrderPtr order);
+    ExecutionReportPtr processInternalMessage(const InternalMessage& message);
+    ExecutionReportPtr processTimed(const InternalMessage& message);   // 計時、逾時檢查與統計
+    void recordLatency(InternalMessageType type, const ExecutionReportPtr& report, uint64_t processingNs);
+    void serviceLatencyRequests();   // 撮合執行緒處理發佈 / 重設要求
+    void flushBatch(std::vector<ExecutionReportPtr>& batch);
+    void journalMessage(const InternalMessage& message);
+    void serviceSnapshotRequest();
+    bool restoreSnapshot(const SnapshotData& data, RecoveryResult& result);
+    void replayJournalEntry(const JournalEntry& entry, RecoveryResult& result);
+    
+    // 訂單處理：processNewOrder 回傳進場訂單的回報，被成交的掛單回報放入 passiveReports_
+    ExecutionReportPtr processNewOrder(OrderHandle handle);
     ExecutionReportPtr processCancelOrder(OrderID orderId, const std::string& reason);
     ExecutionReportPtr processModifyOrder(OrderID orderId, Price newPrice, Quantity newQuantity);
     
     // 取得或建立 OrderBook
     OrderBook* getOrCreateOrderBook(const Symbol& symbol);
     
+    // 訂單生命週期：離開簿（成交 / 取消 / 拒絕）後自索引移除並歸還訂單池
+    OrderHandle findOrderHandle(OrderID orderId) const;
+    void retireOrder(OrderID orderId);
+    
     // 風險檢查
     bool performRiskCheck(const Order& order, std::string& rejectReason) const;
     bool validateOrderBasic(const Order& order, std::string& rejectReason) const;
@@ -255,7 +449,9 @@ private:
     // 回調通知
     void notifyExecution(const ExecutionReportPtr& report);
     void notifyMarketData(const Symbol& symbol);
+    void publishMarketData(const Symbol& symbol);
     void notifyError(const std::string& error);
+    static void warnIfReasonTruncated(OrderID orderId, const std::string& reason);
     
     // 統計更新
     void updateStatistics(const ExecutionReportPtr& report, 
@@ -267,7 +463,7 @@ private:
                                            const std::string& rejectReason = "") const;
     
     ExecutionReportPtr createTradeExecutionReport(const Order& order,
-                                                const TradePtr& trade) const;
+                                                const Trade& trade) const;
     
     // 建立市場行情
     MarketDataPtr createMarketData(const Symbol& symbol) const;
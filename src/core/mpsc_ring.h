@@ -0,0 +1,163 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace mts {
+namespace core {
+
+// ===== 無鎖多生產者 / 單消費者環形佇列 =====
+
+/*
+┌──────────────────────────────────────────────┐
+│                  MpscRing<T>                 │
+├──────────────────────────────────────────────┤
+│ • 固定容量（2 的次方），啟動時一次配置          │
+│ • 生產者：CAS 搶 tail_ 位置後寫入槽位           │
+│ • 消費者：只有一個，head_ 由其獨佔，不需 CAS     │
+│ • 每個槽位的 sequence 決定可寫 / 可讀          │
+│ • 已滿時 tryPush 回傳 false，由呼叫端決定退路    │
+│ • tryPublish / front 直接在槽位上寫入與讀取      │
+│   （大型元素不經過暫存物件搬移）                 │
+└──────────────────────────────────────────────┘
+   槽位 i 的 sequence：
+     == pos       → 空，生產者可在位置 pos 寫入
+     == pos + 1   → 已寫入，消費者可在位置 pos 讀取
+     讀取後設為 pos + capacity，供下一輪使用
+
+   head_ / tail_ 各自佔一條快取線，避免生產者與消費者互相失效。
+*/
+template <typename T>
+class MpscRing {
+    static_assert(std::is_nothrow_move_assignable<T>::value,
+                  "MpscRing element must be nothrow move assignable");
+
+public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    explicit MpscRing(size_t capacity)
+        : capacity_(capacity), mask_(capacity - 1) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("MpscRing capacity must be a power of two >= 2");
+        }
+        cells_ = std::make_unique<Cell[]>(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // 任意執行緒呼叫；佇列已滿時回傳 false，value 保持不變
+    bool tryPush(T&& value) noexcept {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+                // CAS 失敗時 pos 已更新為最新 tail_
+            } else if (diff < 0) {
+                return false;   // 消費者尚未讀走上一輪的資料
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 任意執行緒呼叫；搶到槽位後 fill(T&) 直接填入槽位中既有的物件，不可丟出例外
+    // 佇列已滿時回傳 false，fill 不會被呼叫
+    template <typename Fill>
+    bool tryPublish(Fill&& fill) noexcept {
+        static_assert(noexcept(fill(std::declval<T&>())), "MpscRing::tryPublish fill must be noexcept");
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(cell.value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 只能由唯一的消費者執行緒呼叫：下一個已寫入的槽位，沒有時回傳 nullptr
+    // 槽位在 release() 之前不會被生產者覆寫
+    T* front() noexcept {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[pos & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return nullptr;
+        }
+        return &cell.value;
+    }
+
+    // 歸還 front() 取得的槽位
+    void release() noexcept {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        cells_[pos & mask_].sequence.store(pos + capacity_, std::memory_order_release);
+        head_.store(pos + 1, std::memory_order_relaxed);
+    }
+
+    // 只能由唯一的消費者執行緒呼叫
+    bool tryPop(T& out) noexcept {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[pos & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+        out = std::move(cell.value);
+        cell.sequence.store(pos + capacity_, std::memory_order_release);
+        head_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 消費者視角的空判斷（下一個槽位尚未寫入）
+    bool empty() const noexcept {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    // 近似值：已搶到位置但尚未寫完的項目也會計入
+    size_t size() const noexcept {
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t head = head_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const noexcept { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};   // 生產者共用
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};   // 消費者獨佔
+};
+
+} // namespace core
+} // namespace mts
@@ -16,25 +16,26 @@ Order::Order(OrderID orderId,
              Price price,
              Quantity quantity,
              TimeInForce timeInForce)
-    : orderId_(orderId)
-    , clientId_(clientId)
-    , symbol_(symbol)
-    , side_(side)
-    , orderType_(orderType)
-    , price_(price)
-    , quantity_(quantity)
-    , remainingQuantity_(quantity)
-    , status_(OrderStatus::New)
-    , timeInForce_(timeInForce)
-    , timestamp_(std::chrono::high_resolution_clock::now())
 {
+    hot_.orderId = orderId;
+    hot_.price = price;
+    hot_.quantity = quantity;
+    hot_.remainingQuantity = quantity;
+    hot_.side = side;
+    hot_.orderType = orderType;
+    hot_.status = OrderStatus::New;
+    hot_.symbol = SymbolId(symbol);
+    cold_.clientId = ClientKey(clientId);
+    cold_.timeInForce = timeInForce;
+    cold_.timestamp = std::chrono::high_resolution_clock::now();
+    
     // 市價單價格應為 0
     if (orderType == OrderType::Market) {
-        price_ = 0.0;
+        hot_.price = Price();
     }
     
     // 限價單必須有有效價格
-    if (orderType == OrderType::Limit && price <= 0.0) {
+    if (orderType == OrderType::Limit && price <= Price()) {
         throw std::invalid_argument("Limit order must have valid price > 0");
     }
     
@@ -54,7 +55,7 @@ Order::Order(OrderID orderId,
              Side side,
              Quantity quantity,
              TimeInForce timeInForce)
-    : Order(orderId, clientId, symbol, side, OrderType::Market, 0.0, quantity, timeInForce)
+    : Order(orderId, clientId, symbol, side, OrderType::Market, Price(), quantity, timeInForce)
 {
 }
 
@@ -64,27 +65,37 @@ void Order::fillQuantity(Quantity filledQty) {
         return;
     }
     
-    if (filledQty > remainingQuantity_) {
+    if (filledQty > hot_.remainingQuantity) {
         throw std::invalid_argument("Filled quantity cannot exceed remaining quantity");
     }
     
-    remainingQuantity_ -= filledQty;
+    hot_.remainingQuantity -= filledQty;
     
     // 更新訂單狀態
-    if (remainingQuantity_ == 0) {
-        status_ = OrderStatus::Filled;
+    if (hot_.remainingQuantity == 0) {
+        hot_.status = OrderStatus::Filled;
     } else {
-        status_ = OrderStatus::PartiallyFilled;
+        hot_.status = OrderStatus::PartiallyFilled;
     }
 }
 
+void Order::reduceQuantity(Quantity newQuantity) {
+    Quantity filled = getFilledQuantity();
+    if (newQuantity > hot_.quantity || newQuantity <= filled) {
+        throw std::invalid_argument("Reduced quantity must be above filled quantity and not exceed original quantity");
+    }
+    
+    hot_.quantity = newQuantity;
+    hot_.remainingQuantity = newQuantity - filled;
+}
+
 bool Order::canFill(Quantity quantity) const noexcept {
-    return quantity > 0 && quantity <= remainingQuantity_ && isActive();
+    return quantity > 0 && quantity <= hot_.remainingQuantity && isActive();
 }
 
 // 比較運算子
 bool Order::operator==(const Order& other) const noexcept {
-    return orderId_ == other.orderId_;
+    return hot_.orderId == other.hot_.orderId;
 }
 
 bool Order::operator!=(const Order& other) const noexcept {
@@ -113,19 +124,18 @@ bool Order::TimeComparator::operator()(const Order& lhs, const Order& rhs) const
 // 字串轉換
 std::string Order::toString() const {
     std::stringstream ss;
-    ss << std::fixed << std::setprecision(2);
     
     ss << "Order["
-       << "ID=" << orderId_
-       << ", Client=" << clientId_
-       << ", Symbol=" << symbol_
-       << ", Side=" << sideToString(side_)
-       << ", Type=" << orderTypeToString(orderType_)
-       << ", Price=" << price_
-       << ", Qty=" << quantity_
-       << ", Remaining=" << remainingQuantity_
-       << ", Status=" << orderStatusToString(status_)
-       << ", TIF=" << timeInForceToString(timeInForce_)
+       << "ID=" << hot_.orderId
+       << ", Client=" << cold_.clientId
+       << ", Symbol=" << hot_.symbol
+       << ", Side=" << sideToString(hot_.side)
+       << ", Type=" << orderTypeToString(hot_.orderType)
+       << ", Price=" << formatPrice(hot_.symbol, hot_.price)
+       << ", Qty=" << hot_.quantity
+       << ", Remaining=" << hot_.remainingQuantity
+       << ", Status=" << orderStatusToString(hot_.status)
+       << ", TIF=" << timeInForceToString(cold_.timeInForce)
        << "]";
     
     return ss.str();
@@ -134,22 +144,22 @@ std::string Order::toString() const {
 // 驗證訂單有效性
 bool Order::isValid() const noexcept {
     // 基本欄位檢查
-    if (orderId_ == 0 || symbol_.empty() || quantity_ == 0) {
+    if (hot_.orderId == 0 || hot_.symbol.empty() || hot_.quantity == 0) {
         return false;
     }
     
     // 限價單必須有有效價格
-    if (orderType_ == OrderType::Limit && price_ <= 0.0) {
+    if (hot_.orderType == OrderType::Limit && hot_.price <= Price()) {
         return false;
     }
     
     // 市價單價格應為 0
-    if (orderType_ == OrderType::Market && price_ != 0.0) {
+    if (hot_.orderType == OrderType::Market && !hot_.price.isZero()) {
         return false;
     }
     
     // 剩餘數量不能超過總數量
-    if (remainingQuantity_ > quantity_) {
+    if (hot_.remainingQuantity > hot_.quantity) {
         return false;
     }
     
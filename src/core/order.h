@@ -1,5 +1,7 @@
 #pragma once
 
+#include "price.h"
+#include "interned_id.h"
 #include <string>
 #include <chrono>
 #include <memory>
@@ -9,7 +11,6 @@ namespace core {
 
 // 基礎型別定義
 using OrderID = uint64_t;
-using Price = double;
 using Quantity = uint64_t;     // 數量
 using Symbol = std::string;
 using ClientID = std::string;
@@ -46,6 +47,34 @@ enum class TimeInForce : char {
     FOK = '4'        // 全部成交否則取消 (Fill Or Kill)
 };
 
+/*
+   熱 / 冷資料分離：撮合迴圈只讀寫 OrderHot（剛好一條快取線），
+   字串、時間戳與 TIF 放在 OrderCold，僅於回報與查詢時存取。
+   標的與客戶以駐留 ID 保存，Order 本身不含 std::string。
+
+     Order (128 bytes, 64-byte 對齊)
+     ├─ [0, 64)   OrderHot : id | price | qty | remaining | sequence | symbol | side/type/status
+     └─ [64, 128) OrderCold: clientId | timeInForce | timestamp
+*/
+struct alignas(64) OrderHot {
+    OrderID orderId{0};
+    Price price{};
+    Quantity quantity{0};
+    Quantity remainingQuantity{0};
+    uint64_t sequence{0};              // 撮合引擎接受順序
+    SymbolId symbol;
+    Side side{Side::Buy};
+    OrderType orderType{OrderType::Limit};
+    OrderStatus status{OrderStatus::New};
+};
+static_assert(sizeof(OrderHot) == 64, "OrderHot must fit in one cache line");
+
+struct OrderCold {
+    ClientKey clientId;
+    TimeInForce timeInForce{TimeInForce::Day};
+    Timestamp timestamp{std::chrono::high_resolution_clock::now()};
+};
+
 class Order {
 public:
     // 建構函式
@@ -79,37 +108,44 @@ public:
     ~Order() = default;
     
     // Getter 方法
-    OrderID getOrderId() const noexcept { return orderId_; }
-    const ClientID& getClientId() const noexcept { return clientId_; }
-    const Symbol& getSymbol() const noexcept { return symbol_; }
-    Side getSide() const noexcept { return side_; }
-    OrderType getOrderType() const noexcept { return orderType_; }
-    Price getPrice() const noexcept { return price_; }
-    Quantity getQuantity() const noexcept { return quantity_; }
-    Quantity getRemainingQuantity() const noexcept { return remainingQuantity_; }
-    Quantity getFilledQuantity() const noexcept { return quantity_ - remainingQuantity_; }
-    OrderStatus getStatus() const noexcept { return status_; }
-    TimeInForce getTimeInForce() const noexcept { return timeInForce_; }
-    Timestamp getTimestamp() const noexcept { return timestamp_; }
+    OrderID getOrderId() const noexcept { return hot_.orderId; }
+    const ClientID& getClientId() const noexcept { return cold_.clientId.str(); }
+    const Symbol& getSymbol() const noexcept { return hot_.symbol.str(); }
+    SymbolId getSymbolId() const noexcept { return hot_.symbol; }
+    ClientKey getClientKey() const noexcept { return cold_.clientId; }
+    uint64_t getSequence() const noexcept { return hot_.sequence; }
+    Side getSide() const noexcept { return hot_.side; }
+    OrderType getOrderType() const noexcept { return hot_.orderType; }
+    Price getPrice() const noexcept { return hot_.price; }
+    Quantity getQuantity() const noexcept { return hot_.quantity; }
+    Quantity getRemainingQuantity() const noexcept { return hot_.remainingQuantity; }
+    Quantity getFilledQuantity() const noexcept { return hot_.quantity - hot_.remainingQuantity; }
+    OrderStatus getStatus() const noexcept { return hot_.status; }
+    TimeInForce getTimeInForce() const noexcept { return cold_.timeInForce; }
+    Timestamp getTimestamp() const noexcept { return cold_.timestamp; }
     
     // Setter 方法 (主要用於訂單狀態更新)
-    void setStatus(OrderStatus status) noexcept { status_ = status; }
-    void setRemainingQuantity(Quantity quantity) noexcept { remainingQuantity_ = quantity; }
+    void setStatus(OrderStatus status) noexcept { hot_.status = status; }
+    void setRemainingQuantity(Quantity quantity) noexcept { hot_.remainingQuantity = quantity; }
+    void setSequence(uint64_t sequence) noexcept { hot_.sequence = sequence; }
     
     // 業務邏輯方法
-    bool isMarketOrder() const noexcept { return orderType_ == OrderType::Market; }
-    bool isLimitOrder() const noexcept { return orderType_ == OrderType::Limit; }
-    bool isBuyOrder() const noexcept { return side_ == Side::Buy; }
-    bool isSellOrder() const noexcept { return side_ == Side::Sell; }
+    bool isMarketOrder() const noexcept { return hot_.orderType == OrderType::Market; }
+    bool isLimitOrder() const noexcept { return hot_.orderType == OrderType::Limit; }
+    bool isBuyOrder() const noexcept { return hot_.side == Side::Buy; }
+    bool isSellOrder() const noexcept { return hot_.side == Side::Sell; }
     bool isActive() const noexcept { 
-        return status_ == OrderStatus::New || status_ == OrderStatus::PartiallyFilled; 
+        return hot_.status == OrderStatus::New || hot_.status == OrderStatus::PartiallyFilled; 
     }
-    bool isFilled() const noexcept { return status_ == OrderStatus::Filled; }
-    bool isCancelled() const noexcept { return status_ == OrderStatus::Cancelled; }
-    bool isRejected() const noexcept { return status_ == OrderStatus::Rejected; }
+    bool isFilled() const noexcept { return hot_.status == OrderStatus::Filled; }
+    bool isCancelled() const noexcept { return hot_.status == OrderStatus::Cancelled; }
+    bool isRejected() const noexcept { return hot_.status == OrderStatus::Rejected; }
     
     // 部分成交處理
     void fillQuantity(Quantity filledQty);
+    
+    // 減少委託數量（改單減量），已成交量不變；newQuantity 需大於已成交量
+    void reduceQuantity(Quantity newQuantity);
     bool canFill(Quantity quantity) const noexcept;
     
     // 比較運算子 (用於排序)
@@ -132,17 +168,8 @@ public:
     bool isValid() const noexcept;
     
 private:
-    OrderID orderId_{0};
-    ClientID clientId_;
-    Symbol symbol_;
-    Side side_{Side::Buy};
-    OrderType orderType_{OrderType::Limit};
-    Price price_{0.0};
-    Quantity quantity_{0};
-    Quantity remainingQuantity_{0};
-    OrderStatus status_{OrderStatus::New};
-    TimeInForce timeInForce_{TimeInForce::Day};
-    Timestamp timestamp_{std::chrono::high_resolution_clock::now()};
+    OrderHot hot_;
+    OrderCold cold_;
 };
 
 // 輔助函式
@@ -156,5 +183,10 @@ OrderType stringToOrderType(const std::string& str);
 OrderStatus stringToOrderStatus(const std::string& str);
 TimeInForce stringToTimeInForce(const std::string& str);
 
+// 成交、取消、拒絕後訂單不再有後續回報
+inline bool isTerminalStatus(OrderStatus status) {
+    return status == OrderStatus::Filled || status == OrderStatus::Cancelled || status == OrderStatus::Rejected;
+}
+
 } // namespace core
 } // namespace mts
\ No newline at end of file
@@ -6,237 +6,264 @@
 namespace mts {
 namespace core {
 
-// OrderBookSide 實作
-OrderBookSide::OrderBookSide(Side side) : side_(side) {}
+// ===== OrderBookSide 實作 =====
+template <typename Levels>
+OrderBookSide<Levels>::OrderBookSide(Side side, const OrderBookConfig& config)
+    : side_(side), levels_(side, config), nodes_(config.orderCapacity) {}
 
-void OrderBookSide::addOrder(OrderPtr order) {
+template <typename Levels>
+bool OrderBookSide<Levels>::addOrder(OrderPtr order) {
     if (!order || order->getSide() != side_) {
-        return;
+        return false;
     }
     
     Price price = order->getPrice();
     
     // 市價單特殊處理：使用極端價格
     if (order->isMarketOrder()) {
-        price = (side_ == Side::Buy) ? std::numeric_limits<Price>::max() 
-                                    : std::numeric_limits<Price>::min();
+        price = (side_ == Side::Buy) ? Price::max() : Price::lowest();
     }
     
-    // 加入價格層級
-    priceLevels_[price].push(order);
-    
-    // 加入快速查找表
-    orders_[order->getOrderId()] = std::make_pair(price, order);
-}
-
-bool OrderBookSide::removeOrder(OrderID orderId) {
-    auto it = orders_.find(orderId);
-    if (it == orders_.end()) {
+    if (!levels_.accepts(price)) {
         return false;
     }
     
-    Price price = it->second.first;
-    orders_.erase(it);
-    
-    // 從價格層級中移除（需要重建該價格層級的佇列）
-    auto& priceLevel = priceLevels_[price];
-    std::queue<OrderPtr> newQueue;
-    
-    while (!priceLevel.empty()) {
-        auto order = priceLevel.front();
-        priceLevel.pop();
-        
-        if (order->getOrderId() != orderId) {
-            newQueue.push(order);
-        }
-    }
-    
-    if (newQueue.empty()) {
-        priceLevels_.erase(price);
-    } else {
-        priceLevels_[price] = std::move(newQueue);
+    // 取得預先配置的節點（位址在移除前不變）
+    OrderNode* inserted = nodes_.insert(order->getOrderId());
+    if (!inserted) {
+        return false;  // 重複的 OrderID
     }
     
+    OrderNode& node = *inserted;
+    node.order = order;
+    node.level = levels_.acquire(price);
+    levels_.at(node.level).pushBack(&node);
+    totalQuantity_ += node.order->getRemainingQuantity();
     return true;
 }
 
-OrderBookSide::OrderPtr OrderBookSide::findOrder(OrderID orderId) const {
-    auto it = orders_.find(orderId);
-    return (it != orders_.end()) ? it->second.second : nullptr;
-}
-
-OrderBookSide::OrderPtr OrderBookSide::getBestOrder() const {
-    if (priceLevels_.empty()) {
-        return nullptr;
+template <typename Levels>
+bool OrderBookSide<Levels>::removeOrder(OrderID orderId) {
+    OrderNode* found = nodes_.find(orderId);
+    if (!found) {
+        return false;
     }
     
-    if (side_ == Side::Buy) {
-        // 買單：從最高價開始找（使用 reverse_iterator）
-        for (auto it = priceLevels_.rbegin(); it != priceLevels_.rend(); ++it) {
-            auto& priceLevel = const_cast<PriceLevel&>(it->second);
-            
-            // 清理無效訂單
-            while (!priceLevel.empty() && !priceLevel.front()->isActive()) {
-                priceLevel.pop();
-            }
-            
-            if (!priceLevel.empty()) {
-                return priceLevel.front();
-            }
-        }
-    } else {
-        // 賣單：從最低價開始找（使用 iterator）
-        for (auto it = priceLevels_.begin(); it != priceLevels_.end(); ++it) {
-            auto& priceLevel = const_cast<PriceLevel&>(it->second);
-            
-            // 清理無效訂單
-            while (!priceLevel.empty() && !priceLevel.front()->isActive()) {
-                priceLevel.pop();
-            }
-            
-            if (!priceLevel.empty()) {
-                return priceLevel.front();
-            }
-        }
+    // 直接從所屬層級摘除節點，不需掃描同價位的其他訂單
+    OrderNode& node = *found;
+    PriceLevel& level = levels_.at(node.level);
+    totalQuantity_ -= node.order->getRemainingQuantity();
+    level.erase(&node);
+    if (level.empty()) {
+        levels_.release(node.level);
     }
     
-    return nullptr;
+    nodes_.erase(orderId);
+    return true;
 }
 
-Price OrderBookSide::getBestPrice() const {
-    auto bestOrder = getBestOrder();
-    return bestOrder ? bestOrder->getPrice() : 0.0;
+template <typename Levels>
+typename OrderBookSide<Levels>::OrderPtr OrderBookSide<Levels>::findOrder(OrderID orderId) const {
+    const OrderNode* node = nodes_.find(orderId);
+    return node ? node->order : nullptr;
 }
 
-Quantity OrderBookSide::getTotalQuantityAtPrice(Price price) const {
-    auto it = priceLevels_.find(price);
-    if (it == priceLevels_.end()) {
-        return 0;
+template <typename Levels>
+bool OrderBookSide<Levels>::reduceOrderQuantity(OrderID orderId, Quantity newQuantity) {
+    OrderNode* found = nodes_.find(orderId);
+    if (!found) {
+        return false;
     }
     
-    const auto& priceLevel = it->second;
-    std::queue<OrderPtr> tempQueue = priceLevel; // 複製以避免修改原始佇列
-    Quantity total = 0;
+    OrderNode& node = *found;
+    Order& order = *node.order;
+    if (newQuantity >= order.getQuantity() || newQuantity <= order.getFilledQuantity()) {
+        return false;
+    }
     
-    while (!tempQueue.empty()) {
-        auto order = tempQueue.front();
-        tempQueue.pop();
-        if (order->isActive()) {
-            total += order->getRemainingQuantity();
-        }
+    // 節點留在原位，時間優先不變
+    Quantity before = order.getRemainingQuantity();
+    order.reduceQuantity(newQuantity);
+    Quantity delta = before - order.getRemainingQuantity();
+    levels_.at(node.level).reduceQuantity(delta);
+    totalQuantity_ -= delta;
+    return true;
+}
+
+template <typename Levels>
+bool OrderBookSide<Levels>::fillOrder(OrderID orderId, Quantity quantity) {
+    OrderNode* found = nodes_.find(orderId);
+    if (!found) {
+        return false;
     }
     
-    return total;
+    OrderNode& node = *found;
+    node.order->fillQuantity(quantity);   // 超量時丟出例外，總量不受影響
+    levels_.at(node.level).reduceQuantity(quantity);
+    totalQuantity_ -= quantity;
+    return true;
 }
 
-Quantity OrderBookSide::getTotalQuantity() const {
-    Quantity total = 0;
-    for (const auto& pair : priceLevels_) {
-        const auto& priceLevel = pair.second;
-        std::queue<OrderPtr> tempQueue = priceLevel;
-        
-        while (!tempQueue.empty()) {
-            auto order = tempQueue.front();
-            tempQueue.pop();
-            if (order->isActive()) {
-                total += order->getRemainingQuantity();
+template <typename Levels>
+typename OrderBookSide<Levels>::OrderPtr OrderBookSide<Levels>::getBestOrder() const {
+    // 層級中只會有仍在簿上的訂單；略過外部已改為非活躍狀態者
+    OrderPtr best = nullptr;
+    levels_.forEachBestFirst([&best](const PriceLevel& level) {
+        for (const OrderNode* node = level.front(); node; node = node->next) {
+            if (node->order->isActive()) {
+                best = node->order;
+                return false;
             }
         }
-    }
-    return total;
+        return true;
+    });
+    return best;
+}
+
+template <typename Levels>
+Price OrderBookSide<Levels>::getBestPrice() const {
+    auto bestOrder = getBestOrder();
+    return bestOrder ? bestOrder->getPrice() : Price();
+}
+
+template <typename Levels>
+Quantity OrderBookSide<Levels>::getBestQuantity() const {
+    LevelIndex index = levels_.best();
+    return index == NO_LEVEL ? 0 : levels_.at(index).totalQuantity();
 }
 
-size_t OrderBookSide::getOrderCount() const {
-    return orders_.size();
+template <typename Levels>
+Quantity OrderBookSide<Levels>::getTotalQuantityAtPrice(Price price) const {
+    LevelIndex index = levels_.find(price);
+    if (index == NO_LEVEL) {
+        return 0;
+    }
+    return levels_.at(index).totalQuantity();
 }
 
-std::vector<std::pair<Price, Quantity>> OrderBookSide::getPriceLevels(size_t depth) const {
+template <typename Levels>
+std::vector<std::pair<Price, Quantity>> OrderBookSide<Levels>::getPriceLevels(size_t depth) const {
     std::vector<std::pair<Price, Quantity>> result;
-    result.reserve(depth);
+    result.reserve(std::min(depth, levels_.levelCount()));
     
-    if (side_ == Side::Buy) {
-        // 買單：從高價到低價
-        for (auto it = priceLevels_.rbegin(); it != priceLevels_.rend() && result.size() < depth; ++it) {
-            Quantity qty = getTotalQuantityAtPrice(it->first);
-            if (qty > 0) {
-                result.emplace_back(it->first, qty);
-            }
+    // 買單由高到低、賣單由低到高，順序由容器策略決定
+    levels_.forEachBestFirst([&result, depth](const PriceLevel& level) {
+        if (result.size() >= depth) {
+            return false;
         }
-    } else {
-        // 賣單：從低價到高價
-        for (auto it = priceLevels_.begin(); it != priceLevels_.end() && result.size() < depth; ++it) {
-            Quantity qty = getTotalQuantityAtPrice(it->first);
-            if (qty > 0) {
-                result.emplace_back(it->first, qty);
-            }
-        }
-    }
+        result.emplace_back(level.price(), level.totalQuantity());
+        return true;
+    });
     
     return result;
 }
 
-void OrderBookSide::clear() {
-    priceLevels_.clear();
-    orders_.clear();
+template <typename Levels>
+size_t OrderBookSide<Levels>::getPriceLevels(PriceLevelSummary* out, size_t depth) const {
+    size_t count = 0;
+    levels_.forEachBestFirst([out, depth, &count](const PriceLevel& level) {
+        if (count >= depth) {
+            return false;
+        }
+        out[count++] = PriceLevelSummary{level.price(), level.totalQuantity(), level.size()};
+        return true;
+    });
+    return count;
 }
 
-void OrderBookSide::removeEmptyPriceLevel(Price price) {
-    auto it = priceLevels_.find(price);
-    if (it != priceLevels_.end() && it->second.empty()) {
-        priceLevels_.erase(it);
-    }
+template <typename Levels>
+void OrderBookSide<Levels>::collectOrders(std::vector<const Order*>& out) const {
+    out.reserve(out.size() + nodes_.size());
+    levels_.forEachBestFirst([&out](const PriceLevel& level) {
+        for (const OrderNode* node = level.front(); node != nullptr; node = node->next) {
+            out.push_back(node->order);
+        }
+        return true;
+    });
 }
 
-bool OrderBookSide::isPriceBetter(Price newPrice, Price existingPrice) const {
-    if (side_ == Side::Buy) {
-        return newPrice > existingPrice;  // 買單：價格越高越好
-    } else {
-        return newPrice < existingPrice;  // 賣單：價格越低越好
-    }
+template <typename Levels>
+void OrderBookSide<Levels>::clear() {
+    levels_.clear();
+    nodes_.clear();
+    totalQuantity_ = 0;
 }
 
+template class OrderBookSide<MapPriceLevels>;
+template class OrderBookSide<LadderPriceLevels>;
+template class OrderBookSide<FlatPriceLevels>;
+
 // OrderBook 實作
-OrderBook::OrderBook(const Symbol& symbol) 
-    : symbol_(symbol), bidSide_(Side::Buy), askSide_(Side::Sell) {}
+OrderBook::OrderBook(const Symbol& symbol, const OrderBookConfig& config) 
+    : symbol_(symbol), symbolId_(symbol), config_(config), sides_(makeSides(config)) {}
+
+OrderBook::SidesVariant OrderBook::makeSides(const OrderBookConfig& config) {
+    // 兩側節點互相以指標連結、不可移動，直接在 variant 內建構
+    switch (config.policy) {
+        case PriceLevelPolicy::Ladder:
+            return SidesVariant(std::in_place_type<OrderBookSides<LadderPriceLevels>>, config);
+        case PriceLevelPolicy::FlatVector:
+            return SidesVariant(std::in_place_type<OrderBookSides<FlatPriceLevels>>, config);
+        case PriceLevelPolicy::Map:
+        default:
+            return SidesVariant(std::in_place_type<OrderBookSides<MapPriceLevels>>, config);
+    }
+}
+
+bool OrderBook::acceptsPrice(Price price) const {
+    return std::visit([price](const auto& sides) {
+        return sides.bid.acceptsPrice(price);
+    }, sides_);
+}
+
+std::vector<Trade> OrderBook::addOrder(OrderPtr order) {
+    std::vector<Trade> trades;
+    addOrder(order, trades);
+    return trades;
+}
 
-std::vector<TradePtr> OrderBook::addOrder(OrderPtr order) {
+size_t OrderBook::addOrder(OrderPtr order, std::vector<Trade>& trades) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (!order || order->getSymbol() != symbol_) {
-        return {};
+    if (!order || order->getSymbolId() != symbolId_) {
+        return 0;
     }
     
-    // 嘗試撮合
-    auto trades = matchOrder(order);
-    
-    // 如果訂單還有剩餘數量，加入相應的 Order Book 側
-    if (order->isActive() && order->getRemainingQuantity() > 0) {
-        if (order->isBuyOrder()) {
-            bidSide_.addOrder(order);
-        } else {
-            askSide_.addOrder(order);
+    const size_t before = trades.size();
+    std::visit([&](auto& sides) {
+        auto& ownSide = order->isBuyOrder() ? sides.bid : sides.ask;
+        auto& oppositeSide = order->isBuyOrder() ? sides.ask : sides.bid;
+        
+        // 限價超出容器範圍：撮合前就拒絕，避免成交後剩餘量無處可掛
+        if (order->isLimitOrder() && !ownSide.acceptsPrice(order->getPrice())) {
+            order->setStatus(OrderStatus::Rejected);
+            notifyOrderUpdate(order);
+            return;
         }
         
-        notifyOrderUpdate(order);
-    }
-    
-    return trades;
+        // 嘗試撮合
+        matchOrder(order, oppositeSide, trades);
+        
+        // 如果訂單還有剩餘數量，加入相應的 Order Book 側
+        if (order->isActive() && order->getRemainingQuantity() > 0) {
+            ownSide.addOrder(order);
+            notifyOrderUpdate(order);
+        }
+    }, sides_);
+    return trades.size() - before;
 }
 
-std::vector<TradePtr> OrderBook::matchOrder(OrderPtr order) {
+template <typename SideT>
+void OrderBook::matchOrder(OrderPtr order, SideT& oppositeSide, std::vector<Trade>& trades) {
     if (order->isMarketOrder()) {
-        return matchMarketOrder(order);
+        matchMarketOrder(order, oppositeSide, trades);
     } else {
-        return matchLimitOrder(order);
+        matchLimitOrder(order, oppositeSide, trades);
     }
 }
 
-std::vector<TradePtr> OrderBook::matchLimitOrder(OrderPtr order) {
-    std::vector<TradePtr> trades;
-    
-    // 選擇對手方
-    OrderBookSide& oppositeSide = order->isBuyOrder() ? askSide_ : bidSide_;
-    
+template <typename SideT>
+void OrderBook::matchLimitOrder(OrderPtr order, SideT& oppositeSide, std::vector<Trade>& trades) {
     while (order->isActive() && order->getRemainingQuantity() > 0) {
         auto bestOpposite = oppositeSide.getBestOrder();
         
@@ -261,17 +288,15 @@ std::vector<TradePtr> OrderBook::matchLimitOrder(OrderPtr order) {
                                    bestOpposite->getRemainingQuantity());
         
         // 執行交易
-        auto trade = executeTrade(
+        const Trade& trade = executeTrade(
             order->isBuyOrder() ? order : bestOpposite,
             order->isSellOrder() ? order : bestOpposite,
-            tradePrice, tradeQty
+            tradePrice, tradeQty, trades
         );
         
-        trades.push_back(trade);
-        
-        // 更新訂單
+        // 更新訂單（對手單經由簿側成交，同步維護層級總量）
         order->fillQuantity(tradeQty);
-        bestOpposite->fillQuantity(tradeQty);
+        oppositeSide.fillOrder(bestOpposite->getOrderId(), tradeQty);
         
         // 通知訂單更新
         notifyOrderUpdate(order);
@@ -283,15 +308,11 @@ std::vector<TradePtr> OrderBook::matchLimitOrder(OrderPtr order) {
             oppositeSide.removeOrder(bestOpposite->getOrderId());
         }
     }
-    
-    return trades;
 }
 
-std::vector<TradePtr> OrderBook::matchMarketOrder(OrderPtr order) {
-    std::vector<TradePtr> trades;
-    
+template <typename SideT>
+void OrderBook::matchMarketOrder(OrderPtr order, SideT& oppositeSide, std::vector<Trade>& trades) {
     // 市價單與所有可用的對手單撮合
-    OrderBookSide& oppositeSide = order->isBuyOrder() ? askSide_ : bidSide_;
     
     while (order->isActive() && order->getRemainingQuantity() > 0) {
         auto bestOpposite = oppositeSide.getBestOrder();
@@ -308,17 +329,15 @@ std::vector<TradePtr> OrderBook::matchMarketOrder(OrderPtr order) {
                                    bestOpposite->getRemainingQuantity());
         
         // 執行交易
-        auto trade = executeTrade(
+        const Trade& trade = executeTrade(
             order->isBuyOrder() ? order : bestOpposite,
             order->isSellOrder() ? order : bestOpposite,
-            tradePrice, tradeQty
+            tradePrice, tradeQty, trades
         );
         
-        trades.push_back(trade);
-        
-        // 更新訂單
+        // 更新訂單（對手單經由簿側成交，同步維護層級總量）
         order->fillQuantity(tradeQty);
-        bestOpposite->fillQuantity(tradeQty);
+        oppositeSide.fillOrder(bestOpposite->getOrderId(), tradeQty);
         
         // 通知訂單更新
         notifyOrderUpdate(order);
@@ -330,17 +349,16 @@ std::vector<TradePtr> OrderBook::matchMarketOrder(OrderPtr order) {
             oppositeSide.removeOrder(bestOpposite->getOrderId());
         }
     }
-    
-    return trades;
 }
 
-TradePtr OrderBook::executeTrade(OrderPtr buyOrder, OrderPtr sellOrder, Price price, Quantity quantity) {
-    return std::make_shared<Trade>(
+const Trade& OrderBook::executeTrade(OrderPtr buyOrder, OrderPtr sellOrder, Price price, Quantity quantity,
+                                    std::vector<Trade>& trades) {
+    return trades.emplace_back(
         buyOrder->getOrderId(),
         sellOrder->getOrderId(),
         price,
         quantity,
-        symbol_
+        symbolId_
     );
 }
 
@@ -351,166 +369,226 @@ bool OrderBook::canMatch(Price bidPrice, Price askPrice) const {
 // 市場資訊查詢
 Price OrderBook::getBidPrice() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return bidSide_.getBestPrice();
+    return std::visit([](const auto& sides) { return sides.bid.getBestPrice(); }, sides_);
 }
 
 Price OrderBook::getAskPrice() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return askSide_.getBestPrice();
+    return std::visit([](const auto& sides) { return sides.ask.getBestPrice(); }, sides_);
 }
 
 Price OrderBook::getSpread() const {
     std::lock_guard<std::mutex> lock(mutex_);  // 🔒 只鎖定一次
-    Price bid = bidSide_.getBestPrice();       // 直接調用，不再鎖定
-    Price ask = askSide_.getBestPrice();       // 直接調用，不再鎖定
-    return (bid > 0 && ask > 0) ? (ask - bid) : 0.0;
+    return std::visit([](const auto& sides) {
+        Price bid = sides.bid.getBestPrice();  // 直接調用，不再鎖定
+        Price ask = sides.ask.getBestPrice();  // 直接調用，不再鎖定
+        return (bid > Price() && ask > Price()) ? (ask - bid) : Price();
+    }, sides_);
 }
 
 Price OrderBook::getMidPrice() const {
     Price bid = getBidPrice();
     Price ask = getAskPrice();
-    return (bid > 0 && ask > 0) ? (bid + ask) / 2.0 : 0.0;
+    return midPrice(bid, ask);
 }
 
 Quantity OrderBook::getBidQuantity() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto bestOrder = bidSide_.getBestOrder();
-    return bestOrder ? bestOrder->getRemainingQuantity() : 0;
+    return std::visit([](const auto& sides) { return sides.bid.getBestQuantity(); }, sides_);
 }
 
 Quantity OrderBook::getAskQuantity() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto bestOrder = askSide_.getBestOrder();
-    return bestOrder ? bestOrder->getRemainingQuantity() : 0;
+    return std::visit([](const auto& sides) { return sides.ask.getBestQuantity(); }, sides_);
 }
 
 std::vector<std::pair<Price, Quantity>> OrderBook::getBidDepth(size_t depth) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return bidSide_.getPriceLevels(depth);
+    return std::visit([depth](const auto& sides) { return sides.bid.getPriceLevels(depth); }, sides_);
 }
 
 std::vector<std::pair<Price, Quantity>> OrderBook::getAskDepth(size_t depth) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return askSide_.getPriceLevels(depth);
+    return std::visit([depth](const auto& sides) { return sides.ask.getPriceLevels(depth); }, sides_);
+}
+
+size_t OrderBook::getBidDepth(PriceLevelSummary* out, size_t depth) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::visit([out, depth](const auto& sides) { return sides.bid.getPriceLevels(out, depth); }, sides_);
+}
+
+void OrderBook::collectOrders(std::vector<const Order*>& bids, std::vector<const Order*>& asks) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::visit([&bids, &asks](const auto& sides) {
+        sides.bid.collectOrders(bids);
+        sides.ask.collectOrders(asks);
+    }, sides_);
+}
+
+size_t OrderBook::getAskDepth(PriceLevelSummary* out, size_t depth) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::visit([out, depth](const auto& sides) { return sides.ask.getPriceLevels(out, depth); }, sides_);
+}
+
+Quantity OrderBook::getTotalBidQuantity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::visit([](const auto& sides) { return sides.bid.getTotalQuantity(); }, sides_);
+}
+
+Quantity OrderBook::getTotalAskQuantity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::visit([](const auto& sides) { return sides.ask.getTotalQuantity(); }, sides_);
 }
 
 size_t OrderBook::getTotalOrderCount() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return bidSide_.getOrderCount() + askSide_.getOrderCount();
+    return std::visit([](const auto& sides) {
+        return sides.bid.getOrderCount() + sides.ask.getOrderCount();
+    }, sides_);
 }
 
 size_t OrderBook::getBidOrderCount() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return bidSide_.getOrderCount();
+    return std::visit([](const auto& sides) { return sides.bid.getOrderCount(); }, sides_);
 }
 
 size_t OrderBook::getAskOrderCount() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return askSide_.getOrderCount();
+    return std::visit([](const auto& sides) { return sides.ask.getOrderCount(); }, sides_);
 }
 
 OrderBook::OrderPtr OrderBook::findOrder(OrderID orderId) const {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    // 先在買單側查找
-    auto order = bidSide_.findOrder(orderId);
-    if (order) {
-        return order;
-    }
+    return std::visit([orderId](const auto& sides) {
+        // 先在買單側查找，再在賣單側查找
+        auto order = sides.bid.findOrder(orderId);
+        return order ? order : sides.ask.findOrder(orderId);
+    }, sides_);
+}
+
+bool OrderBook::reduceOrderQuantity(OrderID orderId, Quantity newQuantity) {
+    std::lock_guard<std::mutex> lock(mutex_);
     
-    // 再在賣單側查找
-    return askSide_.findOrder(orderId);
+    return std::visit([&](auto& sides) {
+        auto& side = sides.bid.findOrder(orderId) ? sides.bid : sides.ask;
+        auto order = side.findOrder(orderId);
+        if (!order || !side.reduceOrderQuantity(orderId, newQuantity)) {
+            return false;
+        }
+        
+        notifyOrderUpdate(order);
+        return true;
+    }, sides_);
 }
 
 bool OrderBook::cancelOrder(OrderID orderId) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    // 先在買單側尋找
-    auto order = bidSide_.findOrder(orderId);
-    if (order) {
+    return std::visit([&](auto& sides) {
+        // 先在買單側尋找，再在賣單側尋找
+        for (auto* side : {&sides.bid, &sides.ask}) {
+            auto order = side->findOrder(orderId);
+            if (order) {
+                order->setStatus(OrderStatus::Cancelled);
+                side->removeOrder(orderId);
+                notifyOrderUpdate(order);
+                return true;
+            }
+        }
+        return false;
+    }, sides_);
+}
+
+bool OrderBook::cancelOrder(OrderPtr order) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    return std::visit([&](auto& sides) {
+        auto& side = order->isBuyOrder() ? sides.bid : sides.ask;
+        if (!side.removeOrder(order->getOrderId())) {
+            return false;
+        }
         order->setStatus(OrderStatus::Cancelled);
-        bidSide_.removeOrder(orderId);
         notifyOrderUpdate(order);
         return true;
-    }
+    }, sides_);
+}
+
+bool OrderBook::reduceOrderQuantity(OrderPtr order, Quantity newQuantity) {
+    std::lock_guard<std::mutex> lock(mutex_);
     
-    // 再在賣單側尋找
-    order = askSide_.findOrder(orderId);
-    if (order) {
-        order->setStatus(OrderStatus::Cancelled);
-        askSide_.removeOrder(orderId);
+    return std::visit([&](auto& sides) {
+        auto& side = order->isBuyOrder() ? sides.bid : sides.ask;
+        if (!side.reduceOrderQuantity(order->getOrderId(), newQuantity)) {
+            return false;
+        }
         notifyOrderUpdate(order);
         return true;
-    }
-    
-    return false;
+    }, sides_);
 }
 
 void OrderBook::clear() {
     std::lock_guard<std::mutex> lock(mutex_);
-    bidSide_.clear();
-    askSide_.clear();
+    std::visit([](auto& sides) {
+        sides.bid.clear();
+        sides.ask.clear();
+    }, sides_);
 }
 
+
 std::string OrderBook::toString() const {
     // 🎯 關鍵修正：只鎖定一次，直接訪問內部資料
     std::stringstream ss;
     
-    Price bidPrice = 0.0;
-    Price askPrice = 0.0;
+    Price bidPrice;
+    Price askPrice;
     Quantity bidQty = 0;
     Quantity askQty = 0;
     
     // 手動獲取數據，避免遞迴鎖定
     {
         std::lock_guard<std::mutex> lock(mutex_);  // 🔒 只鎖定一次
-        auto bestBid = bidSide_.getBestOrder();    // 直接調用，不再鎖定
-        auto bestAsk = askSide_.getBestOrder();    // 直接調用，不再鎖定
-        
-        if (bestBid) {
-            bidPrice = bestBid->getPrice();
-            bidQty = bestBid->getRemainingQuantity();
-        }
-        
-        if (bestAsk) {
-            askPrice = bestAsk->getPrice();
-            askQty = bestAsk->getRemainingQuantity();
-        }
+        std::visit([&](const auto& sides) {                // 直接調用，不再鎖定
+            bidPrice = sides.bid.getBestPrice();
+            askPrice = sides.ask.getBestPrice();
+            bidQty = sides.bid.getBestQuantity();
+            askQty = sides.ask.getBestQuantity();
+        }, sides_);
     } // 🔓 鎖在這裡釋放
     
     // 在鎖外進行字串運算
-    Price spread = (bidPrice > 0 && askPrice > 0) ? (askPrice - bidPrice) : 0.0;
-    Price midPrice = (bidPrice > 0 && askPrice > 0) ? (bidPrice + askPrice) / 2.0 : 0.0;
+    Price spread = (bidPrice > Price() && askPrice > Price()) ? (askPrice - bidPrice) : Price();
+    Price mid = midPrice(bidPrice, askPrice);
+    PriceScale scale = PriceScaleRegistry::get(symbol_);
     
     ss << "OrderBook[" << symbol_ << "]:\n";
-    ss << "  Best Bid: " << bidPrice << " (" << bidQty << ")\n";
-    ss << "  Best Ask: " << askPrice << " (" << askQty << ")\n";
-    ss << "  Spread: " << spread << "\n";
-    ss << "  Mid Price: " << midPrice << "\n";
+    ss << "  Best Bid: " << scale.toString(bidPrice) << " (" << bidQty << ")\n";
+    ss << "  Best Ask: " << scale.toString(askPrice) << " (" << askQty << ")\n";
+    ss << "  Spread: " << scale.toString(spread) << "\n";
+    ss << "  Mid Price: " << scale.toString(mid) << "\n";
     
     return ss.str();
 }
 
-void OrderBook::notifyTrade(const TradePtr& trade) {
+void OrderBook::notifyTrade(const Trade& trade) {
     if (tradeCallback_) {
         tradeCallback_(trade);
     }
 }
 
-void OrderBook::notifyOrderUpdate(const OrderPtr& order) {
+void OrderBook::notifyOrderUpdate(OrderPtr order) {
     if (orderUpdateCallback_) {
         orderUpdateCallback_(order);
     }
 }
 
 // 工具函式
-std::string tradeToString(const TradePtr& trade) {
+std::string tradeToString(const Trade& trade) {
     std::stringstream ss;
-    ss << std::fixed << std::setprecision(2);
-    ss << "Trade[" << trade->symbol << "] "
-       << "Buy#" << trade->buyOrderId << " "
-       << "Sell#" << trade->sellOrderId << " "
-       << trade->quantity << "@" << trade->price;
+    ss << "Trade[" << trade.symbol << "] "
+       << "Buy#" << trade.buyOrderId << " "
+       << "Sell#" << trade.sellOrderId << " "
+       << trade.quantity << "@" << formatPrice(trade.symbol, trade.price);
     return ss.str();
 }
 
@@ -1,98 +1,177 @@
 #pragma once
 #include "order.h"
-#include <map>
-#include <queue>
+#include "price_levels.h"
 #include <vector>
 #include <memory>
 #include <mutex>
 #include <functional>
 #include <limits>
+#include <variant>
 
 namespace mts {
 namespace core {
 
-// 交易記錄
+// 交易記錄；以值存放在呼叫端提供的緩衝區，撮合路徑上不個別配置
 struct Trade {
     OrderID buyOrderId;
     OrderID sellOrderId;
     Price price;
     Quantity quantity;
     Timestamp timestamp;
-    Symbol symbol;
+    SymbolId symbol;
     
-    Trade(OrderID bid, OrderID ask, Price p, Quantity q, const Symbol& sym)
+    Trade(OrderID bid, OrderID ask, Price p, Quantity q, SymbolId sym)
         : buyOrderId(bid), sellOrderId(ask), price(p), quantity(q)
         , symbol(sym), timestamp(std::chrono::high_resolution_clock::now()) {}
 };
 
-using TradePtr = std::shared_ptr<Trade>;
+// 單一價格層級的彙總（深度查詢用，直接讀取即時維護的總量）
+struct PriceLevelSummary {
+    Price price;
+    Quantity quantity = 0;    // 剩餘量總和
+    size_t orderCount = 0;    // 訂單筆數
+};
 
-// Order Book 的一邊（買單或賣單）
+/*
+┌──────────────────────────────────────────────┐
+│          OrderBookSide<Levels>               │
+├──────────────────────────────────────────────┤
+│ • 價格層級容器由 Levels 策略決定（見 price_levels.h）│
+│ • nodes_ 預先配置節點與 OrderID 索引（OrderNodeTable）│
+│   節點帶前後指標與所屬層級索引，掛單 / 移除不配置記憶體 │
+│ • 取消 / 成交移除 / 減量皆為 O(1)，不碰同層其他單  │
+│ • 每層與整側的剩餘量、筆數即時維護，深度查詢 O(depth)│
+└──────────────────────────────────────────────┘
+   levels_.at(idx[100.00]):  head ⇄ node(#1) ⇄ node(#5) ⇄ node(#9) ⇄ tail
+                                      ▲
+   nodes_[#5] ────────────────────────┘ （節點本體，位址在移除前不變）
+*/
+template <typename Levels>
 class OrderBookSide {
 public:
-    using OrderPtr = std::shared_ptr<Order>;
-    using PriceLevel = std::queue<OrderPtr>;
-    using PriceLevelMap = std::map<Price, PriceLevel>;
+    using OrderPtr = Order*;   // 不擁有；訂單由 OrderPool（或呼叫端）持有，掛單期間位址不變
+    
+    OrderBookSide(Side side, const OrderBookConfig& config = {});
     
-    OrderBookSide(Side side);
+    // 禁止複製：節點之間以指標互相連結
+    OrderBookSide(const OrderBookSide&) = delete;
+    OrderBookSide& operator=(const OrderBookSide&) = delete;
     
-    // 基本操作
-    void addOrder(OrderPtr order);
+    // 基本操作；價格超出容器範圍時不掛單並回傳 false
+    bool addOrder(OrderPtr order);
     bool removeOrder(OrderID orderId);
     OrderPtr findOrder(OrderID orderId) const;
     
+    // 就地減少數量，保留時間優先；newQuantity 需小於原數量且不少於已成交量
+    bool reduceOrderQuantity(OrderID orderId, Quantity newQuantity);
+    
+    // 成交：更新訂單與層級 / 整側總量；完全成交後仍留在簿上，由呼叫端 removeOrder
+    bool fillOrder(OrderID orderId, Quantity quantity);
+    
     // 撮合相關
     OrderPtr getBestOrder() const;
     Price getBestPrice() const;
+    Quantity getBestQuantity() const;       // 最佳價層級的剩餘量總和
     Quantity getTotalQuantityAtPrice(Price price) const;
-    Quantity getTotalQuantity() const;
+    Quantity getTotalQuantity() const { return totalQuantity_; }
     
     // 查詢操作
-    bool isEmpty() const { return orders_.empty(); }
-    size_t getOrderCount() const;
+    bool isEmpty() const { return nodes_.empty(); }
+    bool acceptsPrice(Price price) const { return levels_.accepts(price); }
+    size_t getOrderCount() const { return nodes_.size(); }
+    size_t getOrderCapacity() const { return nodes_.capacity(); }
+    size_t getLevelCount() const { return levels_.levelCount(); }
     std::vector<std::pair<Price, Quantity>> getPriceLevels(size_t depth = 10) const;
     
+    // 不配置記憶體的深度查詢：由最佳價起寫入最多 depth 層，回傳實際層數
+    size_t getPriceLevels(PriceLevelSummary* out, size_t depth) const;
+    
+    // 依優先順序（最佳價起、同價先到先）附加所有掛單，快照用
+    void collectOrders(std::vector<const Order*>& out) const;
+    
     // 清理操作
     void clear();
     
 private:
     Side side_;
-    PriceLevelMap priceLevels_;  // 價格層級 (價格 -> 訂單佇列)
-    std::map<OrderID, std::pair<Price, OrderPtr>> orders_;  // 快速查找: OrderID -> (Price, Order)
-    
-    // 根據買賣方向決定價格比較邏輯
-    bool isPriceBetter(Price newPrice, Price existingPrice) const;
-    void removeEmptyPriceLevel(Price price);
+    Levels levels_;                                  // 價格層級容器
+    OrderNodeTable nodes_;                           // 節點儲存 + OrderID 索引
+    Quantity totalQuantity_ = 0;                     // 整側剩餘量總和
+};
+
+using MapOrderBookSide = OrderBookSide<MapPriceLevels>;
+using LadderOrderBookSide = OrderBookSide<LadderPriceLevels>;
+using FlatOrderBookSide = OrderBookSide<FlatPriceLevels>;
+
+extern template class OrderBookSide<MapPriceLevels>;
+extern template class OrderBookSide<LadderPriceLevels>;
+extern template class OrderBookSide<FlatPriceLevels>;
+
+// 同一容器策略的買賣兩側
+template <typename Levels>
+struct OrderBookSides {
+    OrderBookSide<Levels> bid;
+    OrderBookSide<Levels> ask;
+    
+    explicit OrderBookSides(const OrderBookConfig& config)
+        : bid(Side::Buy, config), ask(Side::Sell, config) {}
 };
 
-// 完整的 Order Book
+/*
+   完整的 Order Book：對外 API 與容器策略無關，建立時依 OrderBookConfig 選定策略，
+   sides_ 以 std::variant 保存對應的買賣兩側，每個操作只在入口 dispatch 一次。
+   簿只持有 Order*，不管理生命週期；撮合路徑上沒有引用計數。
+   成交以值附加到呼叫端的 std::vector<Trade>，呼叫端重複使用同一個緩衝區即不配置記憶體。
+*/
 class OrderBook {
 public:
-    using OrderPtr = std::shared_ptr<Order>;
-    using TradeCallback = std::function<void(const TradePtr&)>;
-    using OrderUpdateCallback = std::function<void(const OrderPtr&)>;
+    using OrderPtr = Order*;   // 不擁有，呼叫端需保證訂單在簿上期間存活
+    using TradeCallback = std::function<void(const Trade&)>;
+    using OrderUpdateCallback = std::function<void(OrderPtr)>;
     
-    explicit OrderBook(const Symbol& symbol);
+    // Ladder 價格範圍無效時丟出 std::invalid_argument
+    explicit OrderBook(const Symbol& symbol, const OrderBookConfig& config = {});
     ~OrderBook() = default;
     
-    // 基本操作
-    std::vector<TradePtr> addOrder(OrderPtr order);
+    // 基本操作：成交附加到 trades（不清空），回傳本次成交筆數
+    size_t addOrder(OrderPtr order, std::vector<Trade>& trades);
+    std::vector<Trade> addOrder(OrderPtr order);
     bool cancelOrder(OrderID orderId);
+    bool reduceOrderQuantity(OrderID orderId, Quantity newQuantity);  // 保留時間優先
     OrderPtr findOrder(OrderID orderId) const;
     
+    // 已知簿上訂單時直接依其買賣方向處理，不必兩側搜尋（撮合引擎經 OrderIndex 取得）
+    bool cancelOrder(OrderPtr order);
+    bool reduceOrderQuantity(OrderPtr order, Quantity newQuantity);
+    
+    // 價格是否落在容器可掛單的範圍內（Ladder 以外恆為 true）
+    bool acceptsPrice(Price price) const;
+    PriceLevelPolicy getPolicy() const { return config_.policy; }
+    const OrderBookConfig& getConfig() const { return config_; }
+    
+    // 依優先順序取出兩側所有掛單（附加到 bids / asks）
+    void collectOrders(std::vector<const Order*>& bids, std::vector<const Order*>& asks) const;
+    
     // 市場資訊
     Price getBidPrice() const;      // 最佳買價
     Price getAskPrice() const;      // 最佳賣價
     Price getSpread() const;        // 買賣價差
     Price getMidPrice() const;      // 中間價
     
-    Quantity getBidQuantity() const;  // 最佳買價數量
-    Quantity getAskQuantity() const;  // 最佳賣價數量
+    Quantity getBidQuantity() const;  // 最佳買價數量（該價位所有訂單合計）
+    Quantity getAskQuantity() const;  // 最佳賣價數量（該價位所有訂單合計）
     
     // 深度資訊
     std::vector<std::pair<Price, Quantity>> getBidDepth(size_t depth = 10) const;
     std::vector<std::pair<Price, Quantity>> getAskDepth(size_t depth = 10) const;
     
+    // 不配置記憶體的版本，供每筆成交後的行情快照使用；回傳寫入的層數
+    size_t getBidDepth(PriceLevelSummary* out, size_t depth) const;
+    size_t getAskDepth(PriceLevelSummary* out, size_t depth) const;
+    
+    Quantity getTotalBidQuantity() const;
+    Quantity getTotalAskQuantity() const;
+    
     // 統計資訊
     size_t getTotalOrderCount() const;
     size_t getBidOrderCount() const;
@@ -110,32 +189,51 @@ public:
     mutable std::mutex mutex_;
     
 private:
+    using SidesVariant = std::variant<OrderBookSides<MapPriceLevels>,
+                                      OrderBookSides<LadderPriceLevels>,
+                                      OrderBookSides<FlatPriceLevels>>;
+    
     Symbol symbol_;
-    OrderBookSide bidSide_;   // 買單側
-    OrderBookSide askSide_;   // 賣單側
+    SymbolId symbolId_;       // 撮合路徑上以整數比對標的
+    OrderBookConfig config_;
+    SidesVariant sides_;      // 買單側 / 賣單側
+    
+    static SidesVariant makeSides(const OrderBookConfig& config);
     
     // 回調函式
     TradeCallback tradeCallback_;
     OrderUpdateCallback orderUpdateCallback_;
     
     // 撮合邏輯
-    std::vector<TradePtr> matchOrder(OrderPtr order);
-    std::vector<TradePtr> matchLimitOrder(OrderPtr order);
-    std::vector<TradePtr> matchMarketOrder(OrderPtr order);
+    template <typename SideT>
+    void matchOrder(OrderPtr order, SideT& oppositeSide, std::vector<Trade>& trades);
+    template <typename SideT>
+    void matchLimitOrder(OrderPtr order, SideT& oppositeSide, std::vector<Trade>& trades);
+    template <typename SideT>
+    void matchMarketOrder(OrderPtr order, SideT& oppositeSide, std::vector<Trade>& trades);
     
-    // 執行交易
-    TradePtr executeTrade(OrderPtr buyOrder, OrderPtr sellOrder, Price price, Quantity quantity);
+    // 執行交易：附加到 trades 並回傳該筆
+    const Trade& executeTrade(OrderPtr buyOrder, OrderPtr sellOrder, Price price, Quantity quantity,
+                              std::vector<Trade>& trades);
     
     // 通知回調
-    void notifyTrade(const TradePtr& trade);
-    void notifyOrderUpdate(const OrderPtr& order);
+    void notifyTrade(const Trade& trade);
+    void notifyOrderUpdate(OrderPtr order);
     
     // 價格驗證
     bool canMatch(Price bidPrice, Price askPrice) const;
 };
 
 // 工具函式
-std::string tradeToString(const TradePtr& trade);
+std::string tradeToString(const Trade& trade);
+
+// 買賣中間價；兩邊任一為空時回傳 0，半個 tick 向下取整
+inline Price midPrice(Price bid, Price ask) {
+    if (bid <= Price() || ask <= Price()) {
+        return Price();
+    }
+    return Price(bid.ticks() + (ask.ticks() - bid.ticks()) / 2);
+}
 
 } // namespace core
 } // namespace mts
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "order_index.h"
+#include <stdexcept>
+#include <string>
+
+namespace mts {
+namespace core {
+
+OrderIndex::OrderIndex(size_t maxOrders) : maxOrders_(maxOrders) {
+    if (maxOrders == 0 || maxOrders > (size_t(1) << 40)) {
+        throw std::invalid_argument("Invalid order index size: " + std::to_string(maxOrders));
+    }
+
+    // 2 的次方且至少為上限的兩倍
+    size_t capacity = 2;
+    unsigned bits = 1;
+    while (capacity < maxOrders * 2) {
+        capacity <<= 1;
+        ++bits;
+    }
+    slots_ = std::make_unique<Entry[]>(capacity);
+    mask_ = capacity - 1;
+    shift_ = 64 - bits;
+}
+
+bool OrderIndex::insert(OrderID orderId, OrderHandle handle, OrderBook* book) {
+    if (handle == INVALID_ORDER_HANDLE || size_ >= maxOrders_) {
+        return false;
+    }
+    for (size_t i = slotOf(orderId);; i = (i + 1) & mask_) {
+        Entry& entry = slots_[i];
+        if (entry.handle == INVALID_ORDER_HANDLE) {
+            entry = Entry{orderId, handle, book};
+            ++size_;
+            return true;
+        }
+        if (entry.orderId == orderId) {
+            return false;
+        }
+    }
+}
+
+OrderHandle OrderIndex::erase(OrderID orderId) {
+    const Entry* found = find(orderId);
+    if (!found) {
+        return INVALID_ORDER_HANDLE;
+    }
+    size_t hole = static_cast<size_t>(found - slots_.get());
+    OrderHandle handle = found->handle;
+
+    // 後移：把探測鏈上、理想位置不在 (hole, i] 之間的項目往前補洞
+    for (size_t i = (hole + 1) & mask_;; i = (i + 1) & mask_) {
+        Entry& entry = slots_[i];
+        if (entry.handle == INVALID_ORDER_HANDLE) {
+            break;
+        }
+        size_t home = slotOf(entry.orderId);
+        if (((i - home) & mask_) >= ((i - hole) & mask_)) {
+            slots_[hole] = entry;
+            hole = i;
+        }
+    }
+    slots_[hole] = Entry{};
+    --size_;
+    return handle;
+}
+
+void OrderIndex::clear() {
+    for (size_t i = 0; i <= mask_; ++i) {
+        slots_[i] = Entry{};
+    }
+    size_ = 0;
+}
+
+} // namespace core
+} // namespace mts
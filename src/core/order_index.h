@@ -0,0 +1,79 @@
+#pragma once
+#include "order.h"
+#include "order_pool.h"
+#include <cstdint>
+#include <memory>
+
+namespace mts {
+namespace core {
+
+class OrderBook;
+
+/*
+┌──────────────────────────────────────────────┐
+│                  OrderIndex                  │
+├──────────────────────────────────────────────┤
+│ • OrderID → (訂單池 handle, 所屬 OrderBook*)   │
+│ • 開放定址 + 線性探測，槽位一次配置、不 rehash   │
+│ • 容量 ≥ 2 × 訂單池容量：負載率恆 ≤ 0.5，不會滿  │
+│ • 刪除採後移（backward shift），沒有墓碑        │
+│ • 只由撮合執行緒存取，不加鎖                    │
+└──────────────────────────────────────────────┘
+   slots_: [空][#7→h3,AAPL][#12→h0,MSFT][空][#3→h9,AAPL] ...
+                   ▲ hash(#7) & mask，衝突時往後找第一個空槽
+
+   取消 / 改單：find(id) 一次探測即取得訂單與 OrderBook，
+   不再經過 OrderID → 標的 → OrderBook 的多次查表與鎖
+*/
+class OrderIndex {
+public:
+    struct Entry {
+        OrderID orderId = 0;
+        OrderHandle handle = INVALID_ORDER_HANDLE;   // INVALID 表示空槽
+        OrderBook* book = nullptr;
+    };
+
+    // maxOrders：同時在索引中的訂單上限（即訂單池容量）
+    explicit OrderIndex(size_t maxOrders);
+
+    OrderIndex(const OrderIndex&) = delete;
+    OrderIndex& operator=(const OrderIndex&) = delete;
+
+    // 重複的 OrderID 回傳 false
+    bool insert(OrderID orderId, OrderHandle handle, OrderBook* book);
+
+    // 不存在時回傳 nullptr；指標在下一次 insert / erase 前有效
+    const Entry* find(OrderID orderId) const noexcept {
+        for (size_t i = slotOf(orderId);; i = (i + 1) & mask_) {
+            const Entry& entry = slots_[i];
+            if (entry.handle == INVALID_ORDER_HANDLE) {
+                return nullptr;
+            }
+            if (entry.orderId == orderId) {
+                return &entry;
+            }
+        }
+    }
+
+    // 移除並回傳原本的 handle；不存在時回傳 INVALID_ORDER_HANDLE
+    OrderHandle erase(OrderID orderId);
+
+    void clear();
+    size_t size() const noexcept { return size_; }
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+private:
+    // OrderID 低位元多為遞增序號、高位元是分片標記：乘法混合後取高位元
+    size_t slotOf(OrderID orderId) const noexcept {
+        return static_cast<size_t>((orderId * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    std::unique_ptr<Entry[]> slots_;
+    size_t mask_ = 0;
+    unsigned shift_ = 64;
+    size_t size_ = 0;
+    size_t maxOrders_ = 0;
+};
+
+} // namespace core
+} // namespace mts
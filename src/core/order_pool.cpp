@@ -0,0 +1,62 @@
+#include "order_pool.h"
+#include <stdexcept>
+
+namespace mts {
+namespace core {
+
+OrderPool::OrderPool(size_t capacity)
+    : capacity_(capacity)
+    , slots_(std::make_unique<Order[]>(capacity))
+    , used_(capacity, 0)
+{
+    if (capacity == 0 || capacity >= INVALID_ORDER_HANDLE) {
+        throw std::invalid_argument("Invalid order pool capacity: " + std::to_string(capacity));
+    }
+
+    // 由小到大發放，讓早期訂單集中在池的前段
+    freeList_.reserve(capacity);
+    for (size_t i = capacity; i > 0; --i) {
+        freeList_.push_back(static_cast<OrderHandle>(i - 1));
+    }
+}
+
+OrderHandle OrderPool::allocateSlot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (freeList_.empty()) {
+        return INVALID_ORDER_HANDLE;
+    }
+    OrderHandle handle = freeList_.back();
+    freeList_.pop_back();
+    used_[handle] = 1;
+    return handle;
+}
+
+void OrderPool::release(OrderHandle handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (handle >= capacity_ || !used_[handle]) {
+        throw std::logic_error("Releasing order handle not in use: " + std::to_string(handle));
+    }
+    used_[handle] = 0;
+    freeList_.push_back(handle);   // 容量已預留，不會重新配置
+}
+
+OrderHandle OrderPool::handleOf(const Order* order) const noexcept {
+    const Order* base = slots_.get();
+    if (order < base || order >= base + capacity_) {
+        return INVALID_ORDER_HANDLE;
+    }
+    return static_cast<OrderHandle>(order - base);
+}
+
+size_t OrderPool::inUse() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_ - freeList_.size();
+}
+
+size_t OrderPool::available() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return freeList_.size();
+}
+
+} // namespace core
+} // namespace mts
@@ -0,0 +1,85 @@
+#pragma once
+#include "order.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mts {
+namespace core {
+
+// 訂單池中的位置；在 release 之前保持有效
+using OrderHandle = uint32_t;
+constexpr OrderHandle INVALID_ORDER_HANDLE = UINT32_MAX;
+
+/*
+┌──────────────────────────────────────────────┐
+│                  OrderPool                   │
+├──────────────────────────────────────────────┤
+│ • 啟動時一次配置 capacity 個 Order 槽位         │
+│ • acquire：取空槽並就地指定內容（無 heap 配置）    │
+│ • release：訂單進入終止狀態後歸還槽位             │
+│ • 槽位位址固定，OrderBook 可直接持有 Order*      │
+└──────────────────────────────────────────────┘
+   slots_:    [#0 使用中][#1 空][#2 使用中][#3 空] ...
+   freeList_: 3 → 1                         （LIFO，剛歸還的槽位仍在快取中）
+
+   生命週期：接受訂單時 acquire → 撮合 / 掛單 → 成交、取消或拒絕後 release
+   acquire 與 release 可能在不同執行緒（網路 / 撮合），free list 以 mutex 保護；
+   槽位內容只由持有 handle 的一方存取。
+*/
+class OrderPool {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 16;
+
+    explicit OrderPool(size_t capacity = DEFAULT_CAPACITY);
+
+    OrderPool(const OrderPool&) = delete;
+    OrderPool& operator=(const OrderPool&) = delete;
+
+    // 取得一個槽位並以參數建構訂單；池已滿時回傳 INVALID_ORDER_HANDLE
+    template <typename... Args>
+    OrderHandle acquire(Args&&... args) {
+        OrderHandle handle = allocateSlot();
+        if (handle != INVALID_ORDER_HANDLE) {
+            try {
+                slots_[handle] = Order(std::forward<Args>(args)...);
+            } catch (...) {
+                release(handle);   // 建構失敗（參數無效）不可佔住槽位
+                throw;
+            }
+        }
+        return handle;
+    }
+
+    // 歸還槽位；重複歸還或無效 handle 丟出 std::logic_error
+    void release(OrderHandle handle);
+
+    Order& operator[](OrderHandle handle) noexcept { return slots_[handle]; }
+    const Order& operator[](OrderHandle handle) const noexcept { return slots_[handle]; }
+    Order* get(OrderHandle handle) noexcept {
+        return handle < capacity_ ? &slots_[handle] : nullptr;
+    }
+    const Order* get(OrderHandle handle) const noexcept {
+        return handle < capacity_ ? &slots_[handle] : nullptr;
+    }
+
+    // 由槽位位址反查 handle；不屬於本池時回傳 INVALID_ORDER_HANDLE
+    OrderHandle handleOf(const Order* order) const noexcept;
+
+    size_t capacity() const noexcept { return capacity_; }
+    size_t inUse() const;
+    size_t available() const;
+
+private:
+    OrderHandle allocateSlot();
+
+    size_t capacity_;
+    std::unique_ptr<Order[]> slots_;
+    std::vector<uint8_t> used_;             // 偵測重複歸還
+    std::vector<OrderHandle> freeList_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace core
+} // namespace mts
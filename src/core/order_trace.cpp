@@ -0,0 +1,358 @@
+#include "order_trace.h"
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define MTS_HAS_RDTSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+    #include <intrin.h>
+    #define MTS_HAS_RDTSC 1
+#endif
+
+namespace mts {
+namespace core {
+
+namespace {
+
+    constexpr char TRACE_MAGIC[8] = {'M', 'T', 'S', 'T', 'R', 'A', 'C', 'E'};
+    constexpr uint32_t TRACE_VERSION = 1;
+
+    uint64_t steadyNowNs() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // 取得 OrderID 前的階段暫存，只由所屬執行緒存取
+    struct PendingStages {
+        uint64_t tsc[TRACE_STAGE_COUNT];
+        uint32_t mask = 0;
+        uint64_t generation = 0;
+    };
+
+    thread_local PendingStages tlsPending;
+    thread_local TraceRing* tlsRing = nullptr;
+
+    constexpr uint32_t stageBit(TraceStage stage) noexcept {
+        return uint32_t(1) << static_cast<unsigned>(stage);
+    }
+
+} // namespace
+
+const char* traceStageToString(TraceStage stage) {
+    switch (stage) {
+        case TraceStage::Recv:            return "Recv";
+        case TraceStage::Frame:           return "Frame";
+        case TraceStage::Parse:           return "Parse";
+        case TraceStage::SessionValidate: return "SessionValidate";
+        case TraceStage::Convert:         return "Convert";
+        case TraceStage::Enqueue:         return "Enqueue";
+        case TraceStage::Dequeue:         return "Dequeue";
+        case TraceStage::Match:           return "Match";
+        case TraceStage::Report:          return "Report";
+        case TraceStage::Encode:          return "Encode";
+        case TraceStage::Send:            return "Send";
+        default:                          return "Unknown";
+    }
+}
+
+uint64_t readTsc() noexcept {
+#ifdef MTS_HAS_RDTSC
+    return __rdtsc();
+#else
+    return steadyNowNs();
+#endif
+}
+
+// ===== TraceRing =====
+
+TraceRing::TraceRing(size_t capacity)
+    : capacity_(capacity), mask_(capacity - 1) {
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+        throw std::invalid_argument("TraceRing capacity must be a power of two >= 2");
+    }
+    events_ = std::make_unique<TraceEvent[]>(capacity);
+}
+
+size_t TraceRing::drain(std::vector<TraceEvent>& out) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    for (uint64_t i = tail; i < head; ++i) {
+        out.push_back(events_[i & mask_]);
+    }
+    tail_.store(head, std::memory_order_release);
+    return static_cast<size_t>(head - tail);
+}
+
+// ===== OrderTracer =====
+
+OrderTracer& OrderTracer::instance() {
+    static OrderTracer tracer;
+    return tracer;
+}
+
+void OrderTracer::enable() {
+    if (isEnabled()) {
+        return;
+    }
+#ifdef MTS_HAS_RDTSC
+    // 以 steady_clock 校正 TSC 頻率
+    uint64_t ns0 = steadyNowNs();
+    uint64_t tsc0 = readTsc();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    uint64_t ns1 = steadyNowNs();
+    uint64_t tsc1 = readTsc();
+    if (ns1 > ns0 && tsc1 > tsc0) {
+        ticksPerNs_ = static_cast<double>(tsc1 - tsc0) / static_cast<double>(ns1 - ns0);
+    }
+#endif
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void OrderTracer::markPending(TraceStage stage) noexcept {
+    OrderTracer& tracer = instance();
+    if (!tracer.isEnabled()) {
+        return;
+    }
+    uint64_t generation = tracer.generation_.load(std::memory_order_relaxed);
+    if (tlsPending.generation != generation) {
+        tlsPending.mask = 0;
+        tlsPending.generation = generation;
+    }
+    tlsPending.tsc[static_cast<size_t>(stage)] = readTsc();
+    tlsPending.mask |= stageBit(stage);
+}
+
+void OrderTracer::bindPending(OrderID orderId) noexcept {
+    OrderTracer& tracer = instance();
+    if (!tracer.isEnabled()) {
+        return;
+    }
+    uint64_t generation = tracer.generation_.load(std::memory_order_relaxed);
+    if (tlsPending.generation != generation) {
+        tlsPending.mask = 0;
+        tlsPending.generation = generation;
+    }
+    for (size_t i = 0; i < TRACE_STAGE_COUNT; ++i) {
+        if (tlsPending.mask & (uint32_t(1) << i)) {
+            tracer.record(orderId, static_cast<TraceStage>(i), tlsPending.tsc[i]);
+        }
+    }
+    tlsPending.mask &= stageBit(TraceStage::Recv);
+}
+
+void OrderTracer::takePending(PendingTrace& out) noexcept {
+    OrderTracer& tracer = instance();
+    out.mask = 0;
+    if (!tracer.isEnabled() || tlsPending.generation != tracer.generation_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    out.mask = tlsPending.mask;
+    for (size_t i = 0; i < TRACE_STAGE_COUNT; ++i) {
+        if (out.mask & (uint32_t(1) << i)) {
+            out.tsc[i] = tlsPending.tsc[i];
+        }
+    }
+    tlsPending.mask &= stageBit(TraceStage::Recv);
+}
+
+void OrderTracer::restorePending(const PendingTrace& in) noexcept {
+    OrderTracer& tracer = instance();
+    if (!tracer.isEnabled()) {
+        return;
+    }
+    tlsPending.generation = tracer.generation_.load(std::memory_order_relaxed);
+    tlsPending.mask = in.mask;
+    for (size_t i = 0; i < TRACE_STAGE_COUNT; ++i) {
+        if (in.mask & (uint32_t(1) << i)) {
+            tlsPending.tsc[i] = in.tsc[i];
+        }
+    }
+}
+
+void OrderTracer::record(OrderID orderId, TraceStage stage, uint64_t tsc) noexcept {
+    TraceRing* ring = tlsRing;
+    if (ring == nullptr) {
+        try {
+            ring = &localRing();
+        } catch (...) {
+            return;   // 配置失敗時放棄這筆追蹤
+        }
+    }
+    ring->push(TraceEvent{tsc, orderId, stage});
+}
+
+TraceRing& OrderTracer::localRing() {
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    rings_.push_back(std::make_unique<TraceRing>(DEFAULT_RING_CAPACITY));
+    tlsRing = rings_.back().get();
+    return *tlsRing;
+}
+
+size_t OrderTracer::drain(std::vector<TraceEvent>& out) {
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    size_t drained = 0;
+    for (auto& ring : rings_) {
+        drained += ring->drain(out);
+    }
+    return drained;
+}
+
+uint64_t OrderTracer::droppedEvents() const {
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    uint64_t dropped = 0;
+    for (const auto& ring : rings_) {
+        dropped += ring->dropped();
+    }
+    return dropped;
+}
+
+void OrderTracer::reset() {
+    std::vector<TraceEvent> discard;
+    drain(discard);
+    generation_.fetch_add(1, std::memory_order_relaxed);
+    tlsPending.mask = 0;
+}
+
+// ===== TraceFileWriter =====
+
+bool TraceFileWriter::open(const std::string& path, double ticksPerNs) {
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+        return false;
+    }
+    TraceFileHeader header{};
+    std::memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.eventSize = static_cast<uint32_t>(sizeof(TraceEvent));
+    header.ticksPerNs = ticksPerNs;
+    if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool TraceFileWriter::append(const std::vector<TraceEvent>& events) {
+    if (file_ == nullptr) {
+        return false;
+    }
+    if (events.empty()) {
+        return true;
+    }
+    return std::fwrite(events.data(), sizeof(TraceEvent), events.size(), file_) == events.size();
+}
+
+void TraceFileWriter::close() {
+    if (file_ != nullptr) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+bool readTraceFile(const std::string& path, std::vector<TraceEvent>& events,
+                   double& ticksPerNs, std::string& error) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    TraceFileHeader header{};
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1;
+    if (!ok || std::memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0) {
+        error = "not a trace file: " + path;
+        ok = false;
+    } else if (header.version != TRACE_VERSION || header.eventSize != sizeof(TraceEvent)) {
+        error = "unsupported trace version " + std::to_string(header.version);
+        ok = false;
+    } else {
+        ticksPerNs = header.ticksPerNs > 0 ? header.ticksPerNs : 1.0;
+        TraceEvent event;
+        while (std::fread(&event, sizeof(event), 1, file) == 1) {
+            if (static_cast<size_t>(event.stage) < TRACE_STAGE_COUNT) {
+                events.push_back(event);
+            }
+        }
+    }
+    std::fclose(file);
+    return ok;
+}
+
+// ===== 分析 =====
+
+TraceBreakdown analyzeTrace(const std::vector<TraceEvent>& events, double ticksPerNs) {
+    struct Stamps {
+        uint64_t tsc[TRACE_STAGE_COUNT];
+        uint32_t mask = 0;
+    };
+
+    std::unordered_map<OrderID, Stamps> orders;
+    orders.reserve(events.size() / TRACE_STAGE_COUNT + 1);
+    for (const auto& event : events) {
+        Stamps& stamps = orders[event.orderId];
+        size_t stage = static_cast<size_t>(event.stage);
+        // 不同執行緒的 ring 交錯取出，以最早的時間為該階段的第一次出現
+        if (!(stamps.mask & (uint32_t(1) << stage)) || event.tsc < stamps.tsc[stage]) {
+            stamps.tsc[stage] = event.tsc;
+            stamps.mask |= uint32_t(1) << stage;
+        }
+    }
+
+    auto toNs = [ticksPerNs](uint64_t from, uint64_t to) -> uint64_t {
+        if (to <= from) {
+            return 0;
+        }
+        return static_cast<uint64_t>(static_cast<double>(to - from) / ticksPerNs);
+    };
+
+    TraceBreakdown breakdown;
+    breakdown.orders = orders.size();
+    for (const auto& pair : orders) {
+        const Stamps& stamps = pair.second;
+        int previous = -1;
+        int first = -1;
+        for (size_t stage = 0; stage < TRACE_STAGE_COUNT; ++stage) {
+            if (!(stamps.mask & (uint32_t(1) << stage))) {
+                continue;
+            }
+            if (previous >= 0) {
+                breakdown.stages[stage].record(toNs(stamps.tsc[previous], stamps.tsc[stage]));
+            } else {
+                first = static_cast<int>(stage);
+            }
+            previous = static_cast<int>(stage);
+        }
+        if (first >= 0 && previous != first) {
+            breakdown.endToEnd.record(toNs(stamps.tsc[first], stamps.tsc[previous]));
+        }
+        uint32_t complete = stageBit(TraceStage::Recv) | stageBit(TraceStage::Send);
+        if ((stamps.mask & complete) == complete) {
+            ++breakdown.completeOrders;
+        }
+    }
+    return breakdown;
+}
+
+std::string TraceBreakdown::toString() const {
+    std::ostringstream oss;
+    oss << "Order trace: orders=" << orders << " complete=" << completeOrders << "\n";
+    for (size_t stage = 1; stage < TRACE_STAGE_COUNT; ++stage) {
+        if (stages[stage].count() == 0) {
+            continue;
+        }
+        std::string label = std::string("→ ") + traceStageToString(static_cast<TraceStage>(stage));
+        oss << "  " << std::left << std::setw(20) << label << stages[stage].toString() << "\n";
+    }
+    oss << "  " << std::left << std::setw(18) << "End-to-end" << endToEnd.toString();
+    return oss.str();
+}
+
+} // namespace core
+} // namespace mts
@@ -0,0 +1,218 @@
+#pragma once
+#include "latency_histogram.h"
+#include "order.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mts {
+namespace core {
+
+// ===== 訂單生命週期追蹤 =====
+
+// 一筆新訂單從收到位元組到送出回報依序經過的階段
+enum class TraceStage : uint8_t {
+    Recv,              // TCPServer recv() 回傳
+    Frame,             // FixStreamDecoder 切出完整訊息
+    Parse,             // FixMessageView::parse 完成
+    SessionValidate,   // FixSession 驗證通過，交給應用層
+    Convert,           // FIX → Order 轉換完成，取得 OrderID
+    Enqueue,           // 放入撮合引擎輸入佇列
+    Dequeue,           // 撮合執行緒取出
+    Match,             // 撮合完成
+    Report,            // ExecutionReport 交給回調
+    Encode,            // 編碼成 FIX ExecutionReport
+    Send,              // socket send 完成
+    COUNT
+};
+
+constexpr size_t TRACE_STAGE_COUNT = static_cast<size_t>(TraceStage::COUNT);
+
+const char* traceStageToString(TraceStage stage);
+
+// 讀取時間戳計數器：x86 上為 rdtsc，其他平台退回 steady_clock 奈秒
+uint64_t readTsc() noexcept;
+
+struct TraceEvent {
+    uint64_t tsc;
+    OrderID orderId;
+    TraceStage stage;
+};
+
+// 尚未取得 OrderID 的階段時間戳，隨訊息從一條執行緒交給下一條
+struct PendingTrace {
+    uint64_t tsc[TRACE_STAGE_COUNT];
+    uint32_t mask = 0;
+};
+
+/*
+┌──────────────────────────────────────────────┐
+│                  TraceRing                   │
+├──────────────────────────────────────────────┤
+│ • 單生產者 / 單消費者，固定容量（2 的次方）     │
+│ • 生產者：擁有此 ring 的執行緒，只寫 head_     │
+│ • 消費者：OrderTracer::drain，只寫 tail_       │
+│ • 已滿時丟棄新事件並計數，不阻塞熱路徑          │
+└──────────────────────────────────────────────┘
+*/
+class TraceRing {
+public:
+    explicit TraceRing(size_t capacity);
+
+    TraceRing(const TraceRing&) = delete;
+    TraceRing& operator=(const TraceRing&) = delete;
+
+    void push(const TraceEvent& event) noexcept {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= capacity_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events_[head & mask_] = event;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // 只能由單一消費者呼叫，回傳取出的事件數
+    size_t drain(std::vector<TraceEvent>& out);
+
+    uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    const uint64_t capacity_;
+    const uint64_t mask_;
+    std::unique_ptr<TraceEvent[]> events_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+/*
+┌──────────────────────────────────────────────────────────┐
+│                        OrderTracer                        │
+├──────────────────────────────────────────────────────────┤
+│ • 行程唯一；預設關閉，關閉時每個追蹤點只有一次 relaxed 讀取  │
+│ • 每條執行緒第一次追蹤時註冊自己的 TraceRing               │
+│ • 取得 OrderID 之前的階段先暫存在執行緒區域，               │
+│   bindPending(orderId) 時再補上 OrderID 寫入 ring          │
+└──────────────────────────────────────────────────────────┘
+   reactor 執行緒：Recv ─ Frame ─ takePending ─┐ (隨輸入事件交接)
+   Session 執行緒：restorePending ◀───────────┘
+                   Parse ─ SessionValidate ─┐ (暫存)
+                   Convert: bindPending(id) ◀┘
+                   Enqueue
+   撮合執行緒：    Dequeue ─ Match ─ Report
+   編碼 / IO 執行緒：Encode ─ Send
+   收集端：        drain() 合併所有 ring → TraceFileWriter / analyzeTrace
+*/
+class OrderTracer {
+public:
+    static constexpr size_t DEFAULT_RING_CAPACITY = 1 << 16;
+
+    static OrderTracer& instance();
+
+    // 開啟時校正 TSC 頻率（約 10ms）
+    void enable();
+    void disable() noexcept { enabled_.store(false, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    // 每奈秒的 TSC 計數
+    double ticksPerNs() const noexcept { return ticksPerNs_; }
+
+    // ===== 追蹤點 =====
+    static void trace(OrderID orderId, TraceStage stage) noexcept {
+        if (instance().isEnabled()) {
+            instance().record(orderId, stage, readTsc());
+        }
+    }
+
+    // 尚無 OrderID 的階段，記在目前執行緒
+    static void markPending(TraceStage stage) noexcept;
+
+    // 把目前執行緒暫存的階段掛到 orderId 上（Recv 保留給同一次 recv 的下一筆訊息）
+    static void bindPending(OrderID orderId) noexcept;
+
+    // 訊息交給其他執行緒處理時：取出目前執行緒的暫存（Recv 同樣保留），
+    // 接手的執行緒以 restorePending 取代自己的暫存，之後照常 markPending / bindPending
+    static void takePending(PendingTrace& out) noexcept;
+    static void restorePending(const PendingTrace& in) noexcept;
+
+    // ===== 收集 =====
+    // 取出所有執行緒目前累積的事件，回傳取出的數量
+    size_t drain(std::vector<TraceEvent>& out);
+    uint64_t droppedEvents() const;
+
+    // 清空所有 ring 與暫存（測試用；執行緒註冊保留）
+    void reset();
+
+private:
+    OrderTracer() = default;
+
+    void record(OrderID orderId, TraceStage stage, uint64_t tsc) noexcept;
+    TraceRing& localRing();
+
+    std::atomic<bool> enabled_{false};
+    double ticksPerNs_ = 1.0;
+
+    mutable std::mutex ringsMutex_;
+    std::vector<std::unique_ptr<TraceRing>> rings_;   // 執行緒結束後仍保留，直到行程結束
+    std::atomic<uint64_t> generation_{0};             // reset() 時遞增，讓暫存失效
+};
+
+// ===== 追蹤檔案 =====
+
+/*
+   檔案格式（本機位元組序）：
+     TraceFileHeader | TraceEvent * N
+   N 由檔案大小推得，寫入端可持續附加
+*/
+struct TraceFileHeader {
+    char magic[8];          // "MTSTRACE"
+    uint32_t version;
+    uint32_t eventSize;     // sizeof(TraceEvent)
+    double ticksPerNs;
+};
+
+class TraceFileWriter {
+public:
+    TraceFileWriter() = default;
+    ~TraceFileWriter() { close(); }
+
+    TraceFileWriter(const TraceFileWriter&) = delete;
+    TraceFileWriter& operator=(const TraceFileWriter&) = delete;
+
+    bool open(const std::string& path, double ticksPerNs);
+    bool append(const std::vector<TraceEvent>& events);
+    void close();
+    bool isOpen() const noexcept { return file_ != nullptr; }
+
+private:
+    std::FILE* file_ = nullptr;
+};
+
+// 讀取整個追蹤檔；格式不符時回傳 false 並填入 error
+bool readTraceFile(const std::string& path, std::vector<TraceEvent>& events,
+                   double& ticksPerNs, std::string& error);
+
+// ===== 分析 =====
+
+// 依 OrderID 重組事件，計算每個階段與前一個出現階段之間的延遲
+struct TraceBreakdown {
+    std::array<LatencyHistogram, TRACE_STAGE_COUNT> stages;   // stages[Recv] 恆為空
+    LatencyHistogram endToEnd;                                // 第一個 → 最後一個階段
+    uint64_t orders = 0;
+    uint64_t completeOrders = 0;                              // Recv 與 Send 皆有記錄
+
+    std::string toString() const;
+};
+
+// 每個階段取第一次出現的時間（後續成交回報不影響新單路徑）；
+// 跨核心 TSC 偏移造成的負值記為 0
+TraceBreakdown analyzeTrace(const std::vector<TraceEvent>& events, double ticksPerNs);
+
+} // namespace core
+} // namespace mts
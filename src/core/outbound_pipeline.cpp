@@ -0,0 +1,358 @@
+#include "outbound_pipeline.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace mts {
+namespace core {
+
+// ===== ReportEvent =====
+
+ReportEvent ReportEvent::fromReport(const ExecutionReport& report) noexcept {
+    ReportEvent event;
+    event.orderId = report.orderId;
+    event.counterOrderId = report.counterOrderId;
+    event.symbol = report.symbol;
+    event.side = report.side;
+    event.orderType = report.orderType;
+    event.status = report.status;
+    event.price = report.price;
+    event.originalQuantity = report.originalQuantity;
+    event.filledQuantity = report.filledQuantity;
+    event.remainingQuantity = report.remainingQuantity;
+    event.executionPrice = report.executionPrice;
+    event.executionQuantity = report.executionQuantity;
+    size_t length = std::min(report.rejectReason.size(), MAX_TEXT_LENGTH);
+    report.rejectReason.copy(event.text, length);
+    event.text[length] = '\0';
+    return event;
+}
+
+// ===== OverflowPolicy =====
+
+std::string overflowPolicyToString(OverflowPolicy policy) {
+    switch (policy) {
+        case OverflowPolicy::Disconnect: return "disconnect";
+        case OverflowPolicy::Block:      return "block";
+        default:                         return "unknown";
+    }
+}
+
+OverflowPolicy stringToOverflowPolicy(const std::string& str) {
+    if (str == "disconnect") return OverflowPolicy::Disconnect;
+    if (str == "block") return OverflowPolicy::Block;
+    throw std::invalid_argument("Unknown overflow policy: " + str);
+}
+
+std::string OutboundStatistics::toString() const {
+    std::ostringstream oss;
+    oss << "Outbound[events=" << eventsPosted.load()
+        << " ringFullWaits=" << ringFullWaits.load()
+        << " queued=" << messagesQueued.load()
+        << " written=" << messagesWritten.load()
+        << " writeFailures=" << writeFailures.load()
+        << " dropped=" << messagesDropped.load()
+        << " overflows=" << overflows.load() << "]";
+    return oss.str();
+}
+
+// ===== 建構 / 生命週期 =====
+
+OutboundPipeline::OutboundPipeline(size_t producerCount, const OutboundConfig& config)
+    : config_(config), encoderWaiter_(config.waitStrategy) {
+    if (producerCount == 0) {
+        throw std::invalid_argument("OutboundPipeline requires at least one producer");
+    }
+    if (config_.ioThreadCount == 0 || config_.sessionQueueLimit == 0) {
+        throw std::invalid_argument("OutboundPipeline requires at least one IO thread and a non-zero session queue limit");
+    }
+    rings_.reserve(producerCount);
+    for (size_t i = 0; i < producerCount; ++i) {
+        rings_.push_back(std::make_unique<SpscRing<ReportEvent>>(config_.ringCapacity));
+    }
+    ioWorkers_.reserve(config_.ioThreadCount);
+    for (size_t i = 0; i < config_.ioThreadCount; ++i) {
+        ioWorkers_.push_back(std::make_unique<IoWorker>());
+        ioWorkers_.back()->index = i;
+    }
+}
+
+OutboundPipeline::~OutboundPipeline() {
+    stop();
+}
+
+bool OutboundPipeline::start() {
+    if (running_.load()) {
+        return false;
+    }
+    if (!encodeHandler_) {
+        MTS_LOG_ERROR("OutboundPipeline requires an encode handler");
+        return false;
+    }
+
+    running_ = true;
+    encoderRunning_ = true;
+    ioRunning_ = true;
+    encoderThread_ = std::thread(&OutboundPipeline::encodeLoop, this);
+    for (auto& worker : ioWorkers_) {
+        worker->thread = std::thread(&OutboundPipeline::ioLoop, this, std::ref(*worker));
+    }
+    return true;
+}
+
+void OutboundPipeline::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    // 先讓編碼執行緒清空環形佇列，它產生的訊息再由 IO 執行緒寫完
+    encoderRunning_ = false;
+    encoderWaiter_.wakeAll();
+    if (encoderThread_.joinable()) {
+        encoderThread_.join();
+    }
+
+    ioRunning_ = false;
+    for (auto& worker : ioWorkers_) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->wakeup.notify_all();
+        }
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+// ===== 撮合執行緒端 =====
+
+void OutboundPipeline::post(size_t producer, const ExecutionReportPtr* reports, size_t count) {
+    SpscRing<ReportEvent>& ring = *rings_[producer];
+    for (size_t i = 0; i < count; ++i) {
+        ReportEvent event = ReportEvent::fromReport(*reports[i]);
+        if (!ring.tryPush(std::move(event))) {
+            // 編碼跟不上：喚醒編碼執行緒並讓出 CPU，直到有空位
+            stats_.ringFullWaits.fetch_add(1, std::memory_order_relaxed);
+            do {
+                encoderWaiter_.notify();
+                std::this_thread::yield();
+            } while (!ring.tryPush(std::move(event)));
+        }
+    }
+    stats_.eventsPosted.fetch_add(count, std::memory_order_relaxed);
+    encoderWaiter_.notify();
+}
+
+// ===== 編碼執行緒 =====
+
+bool OutboundPipeline::hasPendingEvents() const noexcept {
+    for (const auto& ring : rings_) {
+        if (!ring->empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void OutboundPipeline::encodeLoop() {
+    pinCurrentThread(config_.encoderCpu, "Encode");
+    std::vector<ReportEvent> batch;
+    batch.reserve(ENCODE_BATCH_SIZE);
+
+    while (true) {
+        bool any = false;
+        for (auto& ring : rings_) {
+            batch.clear();
+            ReportEvent event;
+            while (batch.size() < ENCODE_BATCH_SIZE && ring->tryPop(event)) {
+                batch.push_back(event);
+            }
+            if (batch.empty()) {
+                continue;
+            }
+            any = true;
+            try {
+                encodeHandler_(batch.data(), batch.size());
+            } catch (const std::exception& e) {
+                MTS_LOG_ERROR("❌ Outbound encode handler error: {}", e.what());
+            }
+        }
+
+        if (!any) {
+            // 停止時環形佇列已全部清空才離開
+            if (!encoderRunning_.load(std::memory_order_relaxed)) {
+                break;
+            }
+            encoderWaiter_.wait([this] {
+                return hasPendingEvents() || !encoderRunning_.load(std::memory_order_relaxed);
+            });
+        }
+    }
+}
+
+// ===== Session 輸出佇列 =====
+
+std::shared_ptr<OutboundSession> OutboundPipeline::openSession(uint64_t sessionId, SessionWriter writer) {
+    if (!writer) {
+        throw std::invalid_argument("OutboundSession requires a writer");
+    }
+    return std::make_shared<OutboundSession>(sessionId, static_cast<size_t>(sessionId % ioWorkers_.size()),
+                                             std::move(writer));
+}
+
+void OutboundPipeline::closeSession(OutboundSession& session) {
+    size_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(session.mutex_);
+        session.closed_.store(true, std::memory_order_release);
+        dropped = session.queue_.size();
+        session.queue_.clear();
+    }
+    session.spaceAvailable_.notify_all();
+    stats_.messagesDropped.fetch_add(dropped, std::memory_order_relaxed);
+}
+
+bool OutboundPipeline::send(const std::shared_ptr<OutboundSession>& sessionPtr, std::string_view message, OrderID orderId) {
+    OutboundSession& session = *sessionPtr;
+    bool overflow = false;
+    bool wake = false;
+    {
+        std::unique_lock<std::mutex> lock(session.mutex_);
+        if (session.isClosed()) {
+            stats_.messagesDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (session.queue_.size() >= config_.sessionQueueLimit) {
+            if (config_.overflowPolicy == OverflowPolicy::Block) {
+                auto hasSpace = [&session, this] {
+                    return session.queue_.size() < config_.sessionQueueLimit || session.isClosed();
+                };
+                while (!session.spaceAvailable_.wait_for(lock, MAX_IDLE_WAIT, hasSpace)) {
+                }
+                if (session.isClosed()) {
+                    stats_.messagesDropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            } else {
+                stats_.messagesDropped.fetch_add(session.queue_.size() + 1, std::memory_order_relaxed);
+                session.queue_.clear();
+                session.closed_.store(true, std::memory_order_release);
+                overflow = true;
+            }
+        }
+
+        if (!overflow) {
+            session.queue_.push_back(OutboundMessage{std::string(message), orderId});
+            if (!session.scheduled_) {
+                session.scheduled_ = true;
+                wake = true;
+            }
+        }
+    }
+
+    if (overflow) {
+        stats_.overflows.fetch_add(1, std::memory_order_relaxed);
+        MTS_LOG_WARN("⚠️ Outbound queue overflow for session {} ({} messages), disconnecting",
+                     session.id_, config_.sessionQueueLimit);
+        if (overflowHandler_) {
+            overflowHandler_(session.id_);
+        }
+        return false;
+    }
+
+    stats_.messagesQueued.fetch_add(1, std::memory_order_relaxed);
+    if (wake) {
+        schedule(sessionPtr);
+    }
+    return true;
+}
+
+// ===== IO 執行緒 =====
+
+void OutboundPipeline::schedule(const std::shared_ptr<OutboundSession>& session) {
+    IoWorker& worker = *ioWorkers_[session->ioThread_];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.ready.push_back(session);
+    }
+    worker.wakeup.notify_one();
+}
+
+void OutboundPipeline::ioLoop(IoWorker& worker) {
+    pinCurrentThread(cpuForThread(config_.ioCpus, worker.index), "Outbound IO");
+    std::vector<std::shared_ptr<OutboundSession>> ready;
+    std::vector<std::shared_ptr<OutboundSession>> again;
+    std::vector<OutboundMessage> scratch;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            auto hasWork = [&worker, this] {
+                return !worker.ready.empty() || !ioRunning_.load();
+            };
+            while (!worker.wakeup.wait_for(lock, MAX_IDLE_WAIT, hasWork)) {
+            }
+            if (worker.ready.empty()) {
+                break;   // 停止且所有佇列已寫完
+            }
+            ready.swap(worker.ready);
+        }
+
+        // 每個 Session 每輪只寫一批，持續有訊息的 Session 排到隊尾，不會餓死其他連線
+        for (auto& session : ready) {
+            if (drainSession(*session, scratch)) {
+                again.push_back(std::move(session));
+            }
+        }
+        ready.clear();
+
+        if (!again.empty()) {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.ready.insert(worker.ready.end(), std::make_move_iterator(again.begin()),
+                                std::make_move_iterator(again.end()));
+            again.clear();
+        }
+    }
+}
+
+bool OutboundPipeline::drainSession(OutboundSession& session, std::vector<OutboundMessage>& scratch) {
+    {
+        std::lock_guard<std::mutex> lock(session.mutex_);
+        scratch.swap(session.queue_);
+    }
+    if (config_.overflowPolicy == OverflowPolicy::Block) {
+        session.spaceAvailable_.notify_all();
+    }
+
+    if (!scratch.empty()) {
+        // Session 已關閉：整批丟棄（writer 綁定的連線關閉後本來也會寫出失敗）
+        if (session.isClosed()) {
+            stats_.messagesDropped.fetch_add(scratch.size(), std::memory_order_relaxed);
+        } else {
+            bool written = false;
+            try {
+                written = session.writer_(scratch.data(), scratch.size());
+            } catch (const std::exception& e) {
+                MTS_LOG_ERROR("❌ Outbound write handler error for session {}: {}", session.id_, e.what());
+            }
+            if (written) {
+                stats_.messagesWritten.fetch_add(scratch.size(), std::memory_order_relaxed);
+            } else {
+                stats_.writeFailures.fetch_add(scratch.size(), std::memory_order_relaxed);
+            }
+        }
+        scratch.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(session.mutex_);
+    if (session.queue_.empty() || session.isClosed()) {
+        session.scheduled_ = false;
+        return false;
+    }
+    return true;
+}
+
+} // namespace core
+} // namespace mts
@@ -0,0 +1,210 @@
+#pragma once
+#include "matching_engine.h"
+#include "spsc_ring.h"
+#include "thread_affinity.h"
+#include "wait_strategy.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace mts {
+namespace core {
+
+// ===== 輸出管線 =====
+
+// 撮合執行緒放入輸出環形佇列的精簡回報：固定大小、可平凡複製，不帶 shared_ptr
+struct ReportEvent {
+    static constexpr size_t MAX_TEXT_LENGTH = 63;
+
+    OrderID orderId = 0;
+    OrderID counterOrderId = 0;
+    SymbolId symbol;
+    Side side = Side::Buy;
+    OrderType orderType = OrderType::Limit;
+    OrderStatus status = OrderStatus::New;
+    Price price;
+    Quantity originalQuantity = 0;
+    Quantity filledQuantity = 0;
+    Quantity remainingQuantity = 0;
+    Price executionPrice;
+    Quantity executionQuantity = 0;
+    char text[MAX_TEXT_LENGTH + 1] = {};   // 拒絕原因，過長時截斷
+
+    std::string_view getText() const noexcept { return std::string_view(text); }
+
+    static ReportEvent fromReport(const ExecutionReport& report) noexcept;
+};
+
+// Session 輸出佇列已滿時的處理方式
+enum class OverflowPolicy {
+    Disconnect,   // 丟棄該 Session 未寫出的訊息並要求斷線：慢客戶端不拖累其他人
+    Block         // 送出端等待佇列有空位：不丟訊息，但壓力會一路傳回撮合執行緒
+};
+
+std::string overflowPolicyToString(OverflowPolicy policy);
+OverflowPolicy stringToOverflowPolicy(const std::string& str);   // 無法辨識時丟出 std::invalid_argument
+
+struct OutboundConfig {
+    size_t ringCapacity = 16384;        // 每個生產者（撮合分片）的回報環形佇列容量，2 的次方
+    size_t ioThreadCount = 1;           // 寫 socket 的執行緒數，Session 依 id 分配
+    size_t sessionQueueLimit = 8192;    // 每個 Session 尚未交給 IO 執行緒的訊息上限
+    OverflowPolicy overflowPolicy = OverflowPolicy::Disconnect;
+    WaitStrategy waitStrategy = WaitStrategy::Blocking;   // 編碼執行緒的等待策略
+    int encoderCpu = -1;                // 編碼執行緒綁定的 CPU，-1 表示不綁核
+    CpuList ioCpus;                     // IO 執行緒 i 綁到 cpuForThread(ioCpus, i)
+};
+
+struct OutboundStatistics {
+    std::atomic<uint64_t> eventsPosted{0};
+    std::atomic<uint64_t> ringFullWaits{0};      // 環形佇列已滿、撮合執行緒被迫等待的次數
+    std::atomic<uint64_t> messagesQueued{0};
+    std::atomic<uint64_t> messagesWritten{0};
+    std::atomic<uint64_t> writeFailures{0};
+    std::atomic<uint64_t> messagesDropped{0};    // Session 關閉或溢出時丟棄
+    std::atomic<uint64_t> overflows{0};
+
+    std::string toString() const;
+};
+
+// 已編碼、等待寫出的訊息
+struct OutboundMessage {
+    std::string bytes;
+    OrderID orderId = 0;   // 非 0 時交給寫出端記錄追蹤點
+};
+
+// 一次交出 Session 目前累積的所有訊息，讓寫出端合併成一次系統呼叫；在 IO 執行緒上呼叫。
+// 應綁定連線本身（而非 socket 編號），連線關閉後回傳 false，不會寫到重用同一編號的新連線
+using SessionWriter = std::function<bool(const OutboundMessage* messages, size_t count)>;
+
+class OutboundPipeline;
+
+// 單一連線的有界輸出佇列；由 OutboundPipeline::openSession 建立
+class OutboundSession {
+public:
+    OutboundSession(uint64_t id, size_t ioThread, SessionWriter writer)
+        : id_(id), ioThread_(ioThread), writer_(std::move(writer)) {}
+
+    OutboundSession(const OutboundSession&) = delete;
+    OutboundSession& operator=(const OutboundSession&) = delete;
+
+    uint64_t getId() const noexcept { return id_; }
+    bool isClosed() const noexcept { return closed_.load(std::memory_order_acquire); }
+
+private:
+    friend class OutboundPipeline;
+
+    const uint64_t id_;
+    const size_t ioThread_;
+    const SessionWriter writer_;               // 只由所屬 IO 執行緒呼叫
+    std::atomic<bool> closed_{false};
+
+    std::mutex mutex_;
+    std::condition_variable spaceAvailable_;   // Block 策略下等待 IO 執行緒取走訊息
+    std::vector<OutboundMessage> queue_;               // IO 執行緒以 swap 整批取走，緩衝區輪流重用
+    bool scheduled_ = false;                   // 已在所屬 IO 執行緒的待寫清單中
+};
+
+/*
+┌──────────────────────────────────────────────────────────────┐
+│                       OutboundPipeline                        │
+├──────────────────────────────────────────────────────────────┤
+│ 撮合執行緒 ×N ──post()──▶ SpscRing<ReportEvent> ×N（每分片一個）│
+│                                  │                            │
+│                                  ▼                            │
+│                    編碼執行緒：EncodeHandler                    │
+│          （訂單映射、Session 索引、FIX 編碼、send()）            │
+│                                  │                            │
+│                                  ▼                            │
+│              OutboundSession 佇列（每連線一個、有界）            │
+│                                  │                            │
+│                                  ▼                            │
+│          IO 執行緒 ×M：SessionWriter 一次寫出整批訊息          │
+└──────────────────────────────────────────────────────────────┘
+   • 撮合執行緒只複製固定大小的事件，不查表、不編碼、不碰 socket
+   • 同一 Session 的訊息依 send() 順序寫出；不同 Session 互不阻塞
+   • 佇列超過 sessionQueueLimit 時依 OverflowPolicy 斷線或等待
+   • 環形佇列滿時撮合執行緒讓出 CPU 等待（編碼跟不上的背壓）
+*/
+class OutboundPipeline {
+public:
+    using EncodeHandler = std::function<void(const ReportEvent* events, size_t count)>;
+    using OverflowHandler = std::function<void(uint64_t sessionId)>;
+
+    static constexpr size_t ENCODE_BATCH_SIZE = 256;
+    static constexpr std::chrono::milliseconds MAX_IDLE_WAIT{100};   // 條件變數單次等待上限，保險用
+
+    // producerCount：呼叫 post() 的執行緒數（撮合分片數），每個各用一個環形佇列
+    explicit OutboundPipeline(size_t producerCount, const OutboundConfig& config = OutboundConfig());
+    ~OutboundPipeline();
+
+    OutboundPipeline(const OutboundPipeline&) = delete;
+    OutboundPipeline& operator=(const OutboundPipeline&) = delete;
+
+    // ===== 設定（需在 start() 前呼叫）=====
+    void setEncodeHandler(EncodeHandler handler) { encodeHandler_ = std::move(handler); }
+    void setOverflowHandler(OverflowHandler handler) { overflowHandler_ = std::move(handler); }
+
+    // ===== 生命週期 =====
+    bool start();
+    // 先編碼完環形佇列中剩餘的事件、寫完所有佇列，再結束執行緒；需在生產者停止後呼叫
+    void stop();
+    bool isRunning() const noexcept { return running_.load(); }
+
+    // ===== 撮合執行緒端 =====
+    // 只能由 producer 對應的那一條執行緒呼叫
+    void post(size_t producer, const ExecutionReportPtr* reports, size_t count);
+
+    // ===== Session 輸出佇列 =====
+    // sessionId 只用於分配 IO 執行緒與記錄；寫出一律經由 writer
+    std::shared_ptr<OutboundSession> openSession(uint64_t sessionId, SessionWriter writer);
+    // 丟棄未寫出的訊息；之後的 send() 一律回傳 false
+    void closeSession(OutboundSession& session);
+    // 任意執行緒呼叫；Session 已關閉或溢出時回傳 false
+    bool send(const std::shared_ptr<OutboundSession>& session, std::string_view message, OrderID orderId = 0);
+
+    size_t getProducerCount() const noexcept { return rings_.size(); }
+    const OutboundConfig& getConfig() const noexcept { return config_; }
+    const OutboundStatistics& getStatistics() const noexcept { return stats_; }
+
+private:
+    struct IoWorker {
+        size_t index = 0;
+        std::mutex mutex;
+        std::condition_variable wakeup;
+        std::vector<std::shared_ptr<OutboundSession>> ready;   // 有訊息待寫的 Session
+        std::thread thread;
+    };
+
+    void encodeLoop();
+    bool hasPendingEvents() const noexcept;
+    void ioLoop(IoWorker& worker);
+    // 寫出 Session 目前佇列中的訊息；回傳 true 表示寫完後又有新訊息，需要再排程
+    bool drainSession(OutboundSession& session, std::vector<OutboundMessage>& scratch);
+    void schedule(const std::shared_ptr<OutboundSession>& session);
+
+    OutboundConfig config_;
+    std::vector<std::unique_ptr<SpscRing<ReportEvent>>> rings_;
+    std::vector<std::unique_ptr<IoWorker>> ioWorkers_;
+
+    EncodeHandler encodeHandler_;
+    OverflowHandler overflowHandler_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> encoderRunning_{false};
+    std::atomic<bool> ioRunning_{false};
+    IdleWaiter encoderWaiter_;
+    std::thread encoderThread_;
+
+    OutboundStatistics stats_;
+};
+
+} // namespace core
+} // namespace mts
@@ -0,0 +1,204 @@
+#include "price.h"
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+namespace mts {
+namespace core {
+
+namespace {
+
+    constexpr Price::Ticks pow10(uint8_t exponent) {
+        Price::Ticks result = 1;
+        for (uint8_t i = 0; i < exponent; ++i) {
+            result *= 10;
+        }
+        return result;
+    }
+
+    constexpr Price::Ticks TICKS_MAX = std::numeric_limits<Price::Ticks>::max();
+
+    constexpr uint8_t UNSET = 0xFF;
+
+    // 每個 SymbolId 一個位元組的精度；區塊只增不減，位址永不移動
+    struct Registry {
+        using Chunk = std::atomic<uint8_t>[InternTable::CHUNK_SIZE];
+
+        std::mutex mutex;   // set / clear
+        std::atomic<Chunk*> chunks[InternTable::MAX_CHUNKS] = {};
+
+        ~Registry() {
+            for (auto& chunk : chunks) {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // 各精度的 PriceScale 預先建好，forSymbol 只需查表
+    const PriceScale& scaleFor(uint8_t decimals) noexcept {
+        static const PriceScale scales[] = {
+            PriceScale(0), PriceScale(1), PriceScale(2), PriceScale(3), PriceScale(4)
+        };
+        static_assert(sizeof(scales) / sizeof(scales[0]) == PriceScale::MAX_DECIMALS + 1);
+        return scales[decimals];
+    }
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+} // namespace
+
+// ===== PriceScale =====
+
+PriceScale::PriceScale(uint8_t decimals)
+    : decimals_(decimals)
+    , ticksPerUnit_(pow10(decimals))
+    , normalizeFactor_(decimals <= MAX_DECIMALS ? pow10(static_cast<uint8_t>(MAX_DECIMALS - decimals)) : 1)
+{
+    if (decimals > MAX_DECIMALS) {
+        throw std::invalid_argument("Price scale exceeds maximum decimals: " + std::to_string(decimals));
+    }
+}
+
+bool PriceScale::parse(std::string_view text, Price& out) const noexcept {
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) {
+        negative = (text[pos] == '-');
+        ++pos;
+    }
+
+    // 整數部分
+    Price::Ticks whole = 0;
+    size_t wholeDigits = 0;
+    for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos, ++wholeDigits) {
+        Price::Ticks digit = text[pos] - '0';
+        if (whole > (TICKS_MAX - digit) / 10) {
+            return false;
+        }
+        whole = whole * 10 + digit;
+    }
+
+    // 小數部分：最多 decimals_ 位，多出的位數必須為 0
+    Price::Ticks fraction = 0;
+    size_t fractionDigits = 0;
+    if (pos < text.size() && text[pos] == '.') {
+        ++pos;
+        for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos, ++fractionDigits) {
+            if (fractionDigits < decimals_) {
+                fraction = fraction * 10 + (text[pos] - '0');
+            } else if (text[pos] != '0') {
+                return false;
+            }
+        }
+    }
+
+    if (pos != text.size() || (wholeDigits == 0 && fractionDigits == 0)) {
+        return false;
+    }
+
+    for (size_t i = fractionDigits; i < decimals_; ++i) {
+        fraction *= 10;
+    }
+
+    if (whole > (TICKS_MAX - fraction) / ticksPerUnit_) {
+        return false;
+    }
+
+    Price::Ticks ticks = whole * ticksPerUnit_ + fraction;
+    out = Price(negative ? -ticks : ticks);
+    return true;
+}
+
+char* PriceScale::format(char* first, Price price) const noexcept {
+    char* last = first + MAX_FORMATTED_SIZE;
+    Price::Ticks ticks = price.ticks();
+
+    // 以 unsigned 處理，避免 INT64_MIN 取負溢位
+    uint64_t magnitude = ticks < 0 ? 0 - static_cast<uint64_t>(ticks) : static_cast<uint64_t>(ticks);
+    if (ticks < 0) {
+        *first++ = '-';
+    }
+
+    uint64_t unit = static_cast<uint64_t>(ticksPerUnit_);
+    first = std::to_chars(first, last, magnitude / unit).ptr;
+
+    if (decimals_ > 0) {
+        *first++ = '.';
+        uint64_t fraction = magnitude % unit;
+        for (int i = decimals_ - 1; i >= 0; --i) {
+            first[i] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        first += decimals_;
+    }
+    return first;
+}
+
+std::string PriceScale::toString(Price price) const {
+    char buffer[MAX_FORMATTED_SIZE];
+    char* end = format(buffer, price);
+    return std::string(buffer, static_cast<size_t>(end - buffer));
+}
+
+Price PriceScale::fromDouble(double value) const noexcept {
+    return Price(static_cast<Price::Ticks>(std::llround(value * static_cast<double>(ticksPerUnit_))));
+}
+
+double PriceScale::toDouble(Price price) const noexcept {
+    return static_cast<double>(price.ticks()) / static_cast<double>(ticksPerUnit_);
+}
+
+// ===== PriceScaleRegistry =====
+
+void PriceScaleRegistry::set(const std::string& symbol, PriceScale scale) {
+    SymbolId::Value id = SymbolId(symbol).value();
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    auto& slot = reg.chunks[id / InternTable::CHUNK_SIZE];
+    Registry::Chunk* chunk = slot.load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new Registry::Chunk[1];
+        for (auto& decimals : *chunk) {
+            decimals.store(UNSET, std::memory_order_relaxed);
+        }
+        slot.store(chunk, std::memory_order_release);
+    }
+    (*chunk)[id % InternTable::CHUNK_SIZE].store(scale.decimals(), std::memory_order_relaxed);
+}
+
+PriceScale PriceScaleRegistry::get(const std::string& symbol) {
+    InternTable::Id id = SymbolId::table().find(symbol);
+    return id != InternTable::NOT_FOUND ? forSymbol(SymbolId::fromValue(id)) : PriceScale();
+}
+
+PriceScale PriceScaleRegistry::forSymbol(SymbolId symbol) noexcept {
+    SymbolId::Value id = symbol.value();
+    Registry::Chunk* chunk = registry().chunks[id / InternTable::CHUNK_SIZE].load(std::memory_order_acquire);
+    uint8_t decimals = chunk ? (*chunk)[id % InternTable::CHUNK_SIZE].load(std::memory_order_relaxed) : UNSET;
+    return decimals != UNSET ? scaleFor(decimals) : scaleFor(PriceScale::DEFAULT_DECIMALS);
+}
+
+void PriceScaleRegistry::clear() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& slot : reg.chunks) {
+        if (Registry::Chunk* chunk = slot.load(std::memory_order_relaxed)) {
+            for (auto& decimals : *chunk) {
+                decimals.store(UNSET, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+std::string formatPrice(const std::string& symbol, Price price) {
+    return PriceScaleRegistry::get(symbol).toString(price);
+}
+
+} // namespace core
+} // namespace mts
@@ -0,0 +1,127 @@
+#pragma once
+#include "checked_arithmetic.h"
+#include "interned_id.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace mts {
+namespace core {
+
+/*
+┌──────────────────────────────────────────────┐
+│                   Price                      │
+├──────────────────────────────────────────────┤
+│ • 以 int64 tick 表示的定點價格                  │
+│ • tick 的大小由標的的 PriceScale 決定            │
+│ • 比較、加減皆為整數運算，可直接當作 map 的 key    │
+│ • 不提供與 double 的隱式轉換                     │
+└──────────────────────────────────────────────┘
+   例：AAPL 精度 2 位 → 150.25 = Price(15025)
+*/
+class Price {
+public:
+    using Ticks = int64_t;
+
+    constexpr Price() noexcept = default;
+    constexpr explicit Price(Ticks ticks) noexcept : ticks_(ticks) {}
+    // 避免 Price(150.5) 被截斷成 150 tick；浮點數請經由 PriceScale::fromDouble
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+    Price(T) = delete;
+
+    constexpr Ticks ticks() const noexcept { return ticks_; }
+    constexpr bool isZero() const noexcept { return ticks_ == 0; }
+
+    // 市價單在價格層級中使用的極端值
+    static constexpr Price max() noexcept { return Price(std::numeric_limits<Ticks>::max()); }
+    static constexpr Price lowest() noexcept { return Price(std::numeric_limits<Ticks>::min()); }
+
+    constexpr bool operator==(Price other) const noexcept { return ticks_ == other.ticks_; }
+    constexpr bool operator!=(Price other) const noexcept { return ticks_ != other.ticks_; }
+    constexpr bool operator<(Price other) const noexcept { return ticks_ < other.ticks_; }
+    constexpr bool operator<=(Price other) const noexcept { return ticks_ <= other.ticks_; }
+    constexpr bool operator>(Price other) const noexcept { return ticks_ > other.ticks_; }
+    constexpr bool operator>=(Price other) const noexcept { return ticks_ >= other.ticks_; }
+
+    constexpr Price operator+(Price other) const noexcept { return Price(ticks_ + other.ticks_); }
+    constexpr Price operator-(Price other) const noexcept { return Price(ticks_ - other.ticks_); }
+
+private:
+    Ticks ticks_{0};
+};
+
+/*
+┌──────────────────────────────────────────────┐
+│                 PriceScale                   │
+├──────────────────────────────────────────────┤
+│ • 一個標的的小數位數（1 tick = 10^-decimals）    │
+│ • parse：十進位字串 → tick，不經過浮點數          │
+│ • format：tick → 十進位字串，固定輸出 decimals 位 │
+└──────────────────────────────────────────────┘
+*/
+class PriceScale {
+public:
+    static constexpr uint8_t DEFAULT_DECIMALS = 2;
+    static constexpr uint8_t MAX_DECIMALS = 4;
+
+    // 格式化後的最大長度："-9223372036854775808" + '.'
+    static constexpr size_t MAX_FORMATTED_SIZE = 24;
+
+    // decimals 超過 MAX_DECIMALS 時丟出 std::invalid_argument
+    explicit PriceScale(uint8_t decimals = DEFAULT_DECIMALS);
+
+    uint8_t decimals() const noexcept { return decimals_; }
+    Price::Ticks ticksPerUnit() const noexcept { return ticksPerUnit_; }
+
+    // 解析 "150"、"150.5"、"-0.25" 等十進位字串。
+    // 格式錯誤、溢位或小數位數超過精度（多出的位數非 0）時回傳 false
+    bool parse(std::string_view text, Price& out) const noexcept;
+
+    // 寫入 [first, first + MAX_FORMATTED_SIZE)，回傳結尾位置
+    char* format(char* first, Price price) const noexcept;
+    std::string toString(Price price) const;
+
+    // 換算成 MAX_DECIMALS 精度的 tick，用於跨標的比較與金額累計
+    Price::Ticks normalize(Price price) const noexcept {
+        return price.ticks() * normalizeFactor_;
+    }
+
+    // 同 normalize，但乘法溢位時回傳 false；用於未經範圍檢查的外部價格
+    bool checkedNormalize(Price price, Price::Ticks& out) const noexcept {
+        return checkedMul(price.ticks(), normalizeFactor_, out);
+    }
+
+    // 設定與測試用：四捨五入到最接近的 tick
+    Price fromDouble(double value) const noexcept;
+    // 顯示與統計用
+    double toDouble(Price price) const noexcept;
+
+    bool operator==(const PriceScale& other) const noexcept { return decimals_ == other.decimals_; }
+    bool operator!=(const PriceScale& other) const noexcept { return decimals_ != other.decimals_; }
+
+private:
+    uint8_t decimals_;
+    Price::Ticks ticksPerUnit_;
+    Price::Ticks normalizeFactor_;
+};
+
+// 各標的的價格精度；未設定的標的使用 PriceScale::DEFAULT_DECIMALS
+//   精度依 SymbolId 存於與 InternTable 同形的區塊陣列：
+//   chunks_[id / CHUNK_SIZE][id % CHUNK_SIZE] = decimals（UNSET = 未設定）
+//   forSymbol 不加鎖、不雜湊，供每筆訂單的熱路徑使用；get 以名稱查詢，不新增駐留項目
+class PriceScaleRegistry {
+public:
+    static void set(const std::string& symbol, PriceScale scale);
+    static PriceScale get(const std::string& symbol);
+    static PriceScale forSymbol(SymbolId symbol) noexcept;
+    static void clear();
+};
+
+// 依標的精度格式化（顯示用）
+std::string formatPrice(const std::string& symbol, Price price);
+
+} // namespace core
+} // namespace mts
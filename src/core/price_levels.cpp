@@ -0,0 +1,367 @@
+#include "price_levels.h"
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace mts {
+namespace core {
+
+namespace {
+
+    inline unsigned lowestBit(uint64_t word) noexcept {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+    }
+
+    inline unsigned highestBit(uint64_t word) noexcept {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, word);
+        return static_cast<unsigned>(index);
+#else
+        return 63u - static_cast<unsigned>(__builtin_clzll(word));
+#endif
+    }
+
+} // namespace
+
+// ===== 策略名稱轉換 =====
+
+std::string priceLevelPolicyToString(PriceLevelPolicy policy) {
+    switch (policy) {
+        case PriceLevelPolicy::Map: return "map";
+        case PriceLevelPolicy::Ladder: return "ladder";
+        case PriceLevelPolicy::FlatVector: return "flat";
+        default: return "unknown";
+    }
+}
+
+PriceLevelPolicy stringToPriceLevelPolicy(const std::string& str) {
+    if (str == "map") return PriceLevelPolicy::Map;
+    if (str == "ladder") return PriceLevelPolicy::Ladder;
+    if (str == "flat") return PriceLevelPolicy::FlatVector;
+    throw std::invalid_argument("Invalid price level policy: " + str);
+}
+
+// ===== PriceLevelPool =====
+
+LevelIndex PriceLevelPool::allocate(Price price) {
+    LevelIndex index;
+    if (!freeList_.empty()) {
+        index = freeList_.back();
+        freeList_.pop_back();
+    } else {
+        index = static_cast<LevelIndex>(levels_.size());
+        levels_.emplace_back();
+    }
+    levels_[index].reset(price);
+    return index;
+}
+
+// ===== MapPriceLevels =====
+
+MapPriceLevels::MapPriceLevels(Side side, const OrderBookConfig&) : side_(side) {}
+
+LevelIndex MapPriceLevels::acquire(Price price) {
+    auto [it, inserted] = index_.try_emplace(price, NO_LEVEL);
+    if (inserted) {
+        it->second = pool_.allocate(price);
+        if (positions_.size() <= it->second) {
+            positions_.resize(it->second + 1);
+        }
+        positions_[it->second] = it;
+    }
+    return it->second;
+}
+
+LevelIndex MapPriceLevels::find(Price price) const {
+    auto it = index_.find(price);
+    return it != index_.end() ? it->second : NO_LEVEL;
+}
+
+void MapPriceLevels::release(LevelIndex index) {
+    index_.erase(positions_[index]);
+    pool_.free(index);
+}
+
+LevelIndex MapPriceLevels::best() const noexcept {
+    if (index_.empty()) {
+        return NO_LEVEL;
+    }
+    return side_ == Side::Buy ? index_.rbegin()->second : index_.begin()->second;
+}
+
+void MapPriceLevels::clear() {
+    index_.clear();
+    pool_.clear();
+    positions_.clear();
+}
+
+// ===== FlatPriceLevels =====
+
+FlatPriceLevels::FlatPriceLevels(Side side, const OrderBookConfig&) : side_(side) {}
+
+std::vector<FlatPriceLevels::Entry>::const_iterator FlatPriceLevels::lowerBound(Price price) const {
+    return std::lower_bound(levels_.begin(), levels_.end(), price,
+        [this](const Entry& entry, Price value) { return worse(entry.first, value); });
+}
+
+LevelIndex FlatPriceLevels::acquire(Price price) {
+    // 新價格多半落在最佳價附近，先檢查尾端
+    if (!levels_.empty() && levels_.back().first == price) {
+        return levels_.back().second;
+    }
+
+    auto it = lowerBound(price);
+    if (it != levels_.end() && it->first == price) {
+        return it->second;
+    }
+
+    LevelIndex index = pool_.allocate(price);
+    levels_.insert(it, Entry{price, index});
+    return index;
+}
+
+LevelIndex FlatPriceLevels::find(Price price) const {
+    auto it = lowerBound(price);
+    return (it != levels_.end() && it->first == price) ? it->second : NO_LEVEL;
+}
+
+void FlatPriceLevels::release(LevelIndex index) {
+    Price price = pool_[index].price();
+    if (!levels_.empty() && levels_.back().second == index) {
+        levels_.pop_back();
+    } else {
+        auto it = lowerBound(price);
+        if (it != levels_.end() && it->second == index) {
+            levels_.erase(it);
+        }
+    }
+    pool_.free(index);
+}
+
+void FlatPriceLevels::clear() {
+    levels_.clear();
+    pool_.clear();
+}
+
+// ===== LadderPriceLevels =====
+
+LadderPriceLevels::LadderPriceLevels(Side side, const OrderBookConfig& config)
+    : side_(side)
+    , minPrice_(config.ladderMinPrice)
+    , maxPrice_(config.ladderMaxPrice)
+{
+    if (maxPrice_ < minPrice_) {
+        throw std::invalid_argument("Ladder max price must not be below min price");
+    }
+
+    // 以 unsigned 計算避免溢位
+    uint64_t span = static_cast<uint64_t>(maxPrice_.ticks()) - static_cast<uint64_t>(minPrice_.ticks());
+    if (span >= MAX_LEVELS) {
+        throw std::invalid_argument("Ladder price range too wide: " + std::to_string(span + 1) + " ticks");
+    }
+
+    size_t count = static_cast<size_t>(span) + 1;
+    levels_.resize(count);
+    occupied_.assign((count + 63) / 64, 0);
+}
+
+LevelIndex LadderPriceLevels::acquire(Price price) {
+    if (!accepts(price)) {
+        return NO_LEVEL;
+    }
+
+    LevelIndex index = static_cast<LevelIndex>(price.ticks() - minPrice_.ticks());
+    if (!isOccupied(index)) {
+        levels_[index].reset(price);
+        occupied_[index >> 6] |= uint64_t(1) << (index & 63);
+        ++count_;
+
+        bool better = best_ == NO_LEVEL ||
+                      (side_ == Side::Buy ? index > best_ : index < best_);
+        if (better) {
+            best_ = index;
+        }
+    }
+    return index;
+}
+
+LevelIndex LadderPriceLevels::find(Price price) const noexcept {
+    if (!accepts(price)) {
+        return NO_LEVEL;
+    }
+    LevelIndex index = static_cast<LevelIndex>(price.ticks() - minPrice_.ticks());
+    return isOccupied(index) ? index : NO_LEVEL;
+}
+
+void LadderPriceLevels::release(LevelIndex index) {
+    occupied_[index >> 6] &= ~(uint64_t(1) << (index & 63));
+    --count_;
+
+    if (index == best_) {
+        best_ = nextWorse(index);
+    }
+}
+
+LevelIndex LadderPriceLevels::nextWorse(LevelIndex index) const noexcept {
+    if (side_ == Side::Buy) {
+        return index == 0 ? NO_LEVEL : findAtOrBelow(index - 1);
+    }
+    return index + 1 >= levels_.size() ? NO_LEVEL : findAtOrAbove(index + 1);
+}
+
+LevelIndex LadderPriceLevels::findAtOrBelow(LevelIndex index) const noexcept {
+    size_t word = index >> 6;
+    // 只保留 index 以下（含）的位元
+    uint64_t bits = occupied_[word] & (~uint64_t(0) >> (63 - (index & 63)));
+    while (true) {
+        if (bits) {
+            return static_cast<LevelIndex>((word << 6) + highestBit(bits));
+        }
+        if (word == 0) {
+            return NO_LEVEL;
+        }
+        bits = occupied_[--word];
+    }
+}
+
+LevelIndex LadderPriceLevels::findAtOrAbove(LevelIndex index) const noexcept {
+    size_t word = index >> 6;
+    // 只保留 index 以上（含）的位元
+    uint64_t bits = occupied_[word] & (~uint64_t(0) << (index & 63));
+    while (true) {
+        if (bits) {
+            return static_cast<LevelIndex>((word << 6) + lowestBit(bits));
+        }
+        if (++word >= occupied_.size()) {
+            return NO_LEVEL;
+        }
+        bits = occupied_[word];
+    }
+}
+
+void LadderPriceLevels::clear() {
+    std::fill(occupied_.begin(), occupied_.end(), 0);
+    best_ = NO_LEVEL;
+    count_ = 0;
+}
+
+// ===== OrderNodeTable =====
+
+OrderNodeTable::OrderNodeTable(size_t initialCapacity) {
+    addBlock(std::max<size_t>(initialCapacity, 16));
+}
+
+void OrderNodeTable::addBlock(size_t count) {
+    auto block = std::make_unique<OrderNode[]>(count);
+    for (size_t i = 0; i < count; ++i) {
+        block[i].next = freeList_;
+        freeList_ = &block[i];
+    }
+    blocks_.push_back(std::move(block));
+    capacity_ += count;
+    rebuildIndex();
+}
+
+void OrderNodeTable::rebuildIndex() {
+    // 槽位數為 2 的次方且至少為節點總數的兩倍
+    size_t slotCount = 2;
+    unsigned bits = 1;
+    while (slotCount < capacity_ * 2) {
+        slotCount <<= 1;
+        ++bits;
+    }
+    std::unique_ptr<Slot[]> previous = std::move(slots_);
+    size_t previousCount = previous ? mask_ + 1 : 0;
+    slots_ = std::make_unique<Slot[]>(slotCount);
+    mask_ = slotCount - 1;
+    shift_ = 64 - bits;
+    for (size_t i = 0; i < previousCount; ++i) {
+        if (previous[i].node != nullptr) {
+            size_t j = slotOf(previous[i].orderId);
+            while (slots_[j].node != nullptr) {
+                j = (j + 1) & mask_;
+            }
+            slots_[j] = previous[i];
+        }
+    }
+}
+
+OrderNode* OrderNodeTable::insert(OrderID orderId) {
+    if (find(orderId) != nullptr) {
+        return nullptr;
+    }
+    if (freeList_ == nullptr) {
+        addBlock(capacity_);   // 加倍；既有節點不搬移
+    }
+    OrderNode* node = freeList_;
+    freeList_ = node->next;
+    *node = OrderNode{};
+
+    size_t i = slotOf(orderId);
+    while (slots_[i].node != nullptr) {
+        i = (i + 1) & mask_;
+    }
+    slots_[i] = Slot{orderId, node};
+    ++size_;
+    return node;
+}
+
+bool OrderNodeTable::erase(OrderID orderId) {
+    size_t hole = slotOf(orderId);
+    while (true) {
+        if (slots_[hole].node == nullptr) {
+            return false;
+        }
+        if (slots_[hole].orderId == orderId) {
+            break;
+        }
+        hole = (hole + 1) & mask_;
+    }
+    OrderNode* node = slots_[hole].node;
+
+    // 後移：把探測鏈上、理想位置不在 (hole, i] 之間的項目往前補洞
+    for (size_t i = (hole + 1) & mask_;; i = (i + 1) & mask_) {
+        Slot& slot = slots_[i];
+        if (slot.node == nullptr) {
+            break;
+        }
+        size_t home = slotOf(slot.orderId);
+        if (((i - home) & mask_) >= ((i - hole) & mask_)) {
+            slots_[hole] = slot;
+            hole = i;
+        }
+    }
+    slots_[hole] = Slot{};
+    --size_;
+
+    *node = OrderNode{};
+    node->next = freeList_;
+    freeList_ = node;
+    return true;
+}
+
+void OrderNodeTable::clear() {
+    for (size_t i = 0; i <= mask_; ++i) {
+        if (slots_[i].node != nullptr) {
+            OrderNode* node = slots_[i].node;
+            *node = OrderNode{};
+            node->next = freeList_;
+            freeList_ = node;
+            slots_[i] = Slot{};
+        }
+    }
+    size_ = 0;
+}
+
+} // namespace core
+} // namespace mts
@@ -0,0 +1,319 @@
+#pragma once
+#include "order.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace mts {
+namespace core {
+
+// ===== 價格層級容器策略 =====
+
+enum class PriceLevelPolicy {
+    Map,          // std::map：任意價格範圍（預設）
+    Ladder,       // 以 tick 位移索引的固定陣列 + 最佳價 bitmap：價格範圍有界的標的
+    FlatVector    // 依價格排序的連續 vector：層級稀疏的標的
+};
+
+// 建立 OrderBook 時使用的設定
+struct OrderBookConfig {
+    PriceLevelPolicy policy = PriceLevelPolicy::Map;
+    Price ladderMinPrice;   // Ladder 可掛單的最低價（含）
+    Price ladderMaxPrice;   // Ladder 可掛單的最高價（含）
+    size_t orderCapacity = 1024;   // 每側預先配置的掛單節點數，用完時加倍
+};
+
+std::string priceLevelPolicyToString(PriceLevelPolicy policy);
+PriceLevelPolicy stringToPriceLevelPolicy(const std::string& str);
+
+using LevelIndex = uint32_t;
+constexpr LevelIndex NO_LEVEL = UINT32_MAX;
+
+struct OrderNode;
+
+// 同一價格的訂單，依到達順序串成雙向鏈結；不擁有節點
+// totalQuantity_ 隨掛單 / 成交 / 減量 / 移除即時維護，等於層級內所有訂單的剩餘量總和
+class PriceLevel {
+public:
+    Price price() const noexcept { return price_; }
+    OrderNode* front() const noexcept { return head_; }
+    bool empty() const noexcept { return head_ == nullptr; }
+    size_t size() const noexcept { return size_; }
+    Quantity totalQuantity() const noexcept { return totalQuantity_; }
+
+    void reset(Price price) noexcept {
+        head_ = tail_ = nullptr;
+        size_ = 0;
+        totalQuantity_ = 0;
+        price_ = price;
+    }
+
+    // 加入 / 移除時以節點當下的剩餘量調整總量
+    inline void pushBack(OrderNode* node) noexcept;
+    inline void erase(OrderNode* node) noexcept;
+
+    // 節點仍在層級內、剩餘量減少時（成交或減量）呼叫
+    void reduceQuantity(Quantity delta) noexcept { totalQuantity_ -= delta; }
+
+private:
+    OrderNode* head_ = nullptr;
+    OrderNode* tail_ = nullptr;
+    size_t size_ = 0;
+    Quantity totalQuantity_ = 0;
+    Price price_;
+};
+
+// 簿上的一筆訂單；level 為所屬層級在容器中的索引（層級存在期間不變）
+struct OrderNode {
+    Order* order = nullptr;   // 不擁有
+    LevelIndex level = NO_LEVEL;
+    OrderNode* prev = nullptr;
+    OrderNode* next = nullptr;
+};
+
+void PriceLevel::pushBack(OrderNode* node) noexcept {
+    node->prev = tail_;
+    node->next = nullptr;
+    if (tail_) {
+        tail_->next = node;
+    } else {
+        head_ = node;
+    }
+    tail_ = node;
+    ++size_;
+    totalQuantity_ += node->order->getRemainingQuantity();
+}
+
+void PriceLevel::erase(OrderNode* node) noexcept {
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        head_ = node->next;
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    } else {
+        tail_ = node->prev;
+    }
+    node->prev = nullptr;
+    node->next = nullptr;
+    --size_;
+    totalQuantity_ -= node->order->getRemainingQuantity();
+}
+
+/*
+┌──────────────────────────────────────────────┐
+│                OrderNodeTable                │
+├──────────────────────────────────────────────┤
+│ • 簿側的節點儲存 + OrderID → 節點索引          │
+│ • 節點整塊配置，空閒節點以 next 串成 free list  │
+│ • 索引為開放定址 + 線性探測，負載率 ≤ 0.5，刪除採後移│
+│ • 節點用完時新增一塊（容量加倍）並重建索引；      │
+│   穩態下掛單 / 成交移除 / 取消都不配置記憶體      │
+└──────────────────────────────────────────────┘
+   blocks_[0]: [node][node][node] ...   blocks_[1]: [node] ...（位址在移除前不變）
+   slots_:     [空][#7→node][#12→node][空] ...
+*/
+class OrderNodeTable {
+public:
+    explicit OrderNodeTable(size_t initialCapacity);
+
+    OrderNodeTable(const OrderNodeTable&) = delete;
+    OrderNodeTable& operator=(const OrderNodeTable&) = delete;
+
+    // 取得空節點並登記；重複的 OrderID 回傳 nullptr
+    OrderNode* insert(OrderID orderId);
+
+    OrderNode* find(OrderID orderId) const noexcept {
+        for (size_t i = slotOf(orderId);; i = (i + 1) & mask_) {
+            const Slot& slot = slots_[i];
+            if (slot.node == nullptr) {
+                return nullptr;
+            }
+            if (slot.orderId == orderId) {
+                return slot.node;
+            }
+        }
+    }
+
+    // 移除登記並歸還節點；不存在時回傳 false
+    bool erase(OrderID orderId);
+
+    void clear();
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    size_t capacity() const noexcept { return capacity_; }
+
+private:
+    struct Slot {
+        OrderID orderId = 0;
+        OrderNode* node = nullptr;   // nullptr 表示空槽
+    };
+
+    size_t slotOf(OrderID orderId) const noexcept {
+        return static_cast<size_t>((orderId * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+    void addBlock(size_t count);
+    void rebuildIndex();
+
+    std::vector<std::unique_ptr<OrderNode[]>> blocks_;
+    OrderNode* freeList_ = nullptr;
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    unsigned shift_ = 64;
+    size_t size_ = 0;
+    size_t capacity_ = 0;   // 所有區塊的節點總數
+};
+
+/*
+   容器策略共同介面（OrderBookSide<Levels> 依此呼叫）：
+
+     bool       accepts(Price) const          價格是否落在容器可表示的範圍
+     LevelIndex acquire(Price)                取得（必要時建立）該價格的層級
+     LevelIndex find(Price) const             查詢層級，不存在回傳 NO_LEVEL
+     void       release(LevelIndex)           層級已空時移除
+     PriceLevel& at(LevelIndex)               索引 → 層級
+     LevelIndex best() const                  最佳價層級，空時 NO_LEVEL
+     size_t     levelCount() const
+     void       clear()
+     forEachBestFirst(f)                      由最佳價往外走訪，f(const PriceLevel&) 回傳 false 停止
+
+   索引在層級被 release 之前保持不變，因此節點可以只記索引。
+*/
+
+// 層級物件池：以索引存取，釋放的槽位重複使用
+class PriceLevelPool {
+public:
+    LevelIndex allocate(Price price);
+    void free(LevelIndex index) { freeList_.push_back(index); }
+    PriceLevel& operator[](LevelIndex index) noexcept { return levels_[index]; }
+    const PriceLevel& operator[](LevelIndex index) const noexcept { return levels_[index]; }
+    void clear() { levels_.clear(); freeList_.clear(); }
+
+private:
+    std::vector<PriceLevel> levels_;
+    std::vector<LevelIndex> freeList_;
+};
+
+// std::map 版本：價格範圍不限
+class MapPriceLevels {
+public:
+    MapPriceLevels(Side side, const OrderBookConfig& config);
+
+    bool accepts(Price) const noexcept { return true; }
+    LevelIndex acquire(Price price);
+    LevelIndex find(Price price) const;
+    void release(LevelIndex index);
+    PriceLevel& at(LevelIndex index) noexcept { return pool_[index]; }
+    const PriceLevel& at(LevelIndex index) const noexcept { return pool_[index]; }
+    LevelIndex best() const noexcept;
+    size_t levelCount() const noexcept { return index_.size(); }
+    void clear();
+
+    template <typename Visitor>
+    void forEachBestFirst(Visitor&& visit) const {
+        if (side_ == Side::Buy) {
+            for (auto it = index_.rbegin(); it != index_.rend(); ++it) {
+                if (!visit(pool_[it->second])) return;
+            }
+        } else {
+            for (auto it = index_.begin(); it != index_.end(); ++it) {
+                if (!visit(pool_[it->second])) return;
+            }
+        }
+    }
+
+private:
+    using IndexMap = std::map<Price, LevelIndex>;
+
+    Side side_;
+    IndexMap index_;
+    PriceLevelPool pool_;
+    std::vector<IndexMap::iterator> positions_;   // 層級索引 → map 節點，release 時免搜尋
+};
+
+// 排序 vector 版本：最佳價放在尾端，成交清空最佳層級時只需 pop_back
+class FlatPriceLevels {
+public:
+    FlatPriceLevels(Side side, const OrderBookConfig& config);
+
+    bool accepts(Price) const noexcept { return true; }
+    LevelIndex acquire(Price price);
+    LevelIndex find(Price price) const;
+    void release(LevelIndex index);
+    PriceLevel& at(LevelIndex index) noexcept { return pool_[index]; }
+    const PriceLevel& at(LevelIndex index) const noexcept { return pool_[index]; }
+    LevelIndex best() const noexcept { return levels_.empty() ? NO_LEVEL : levels_.back().second; }
+    size_t levelCount() const noexcept { return levels_.size(); }
+    void clear();
+
+    template <typename Visitor>
+    void forEachBestFirst(Visitor&& visit) const {
+        for (auto it = levels_.rbegin(); it != levels_.rend(); ++it) {
+            if (!visit(pool_[it->second])) return;
+        }
+    }
+
+private:
+    using Entry = std::pair<Price, LevelIndex>;
+
+    // 排序鍵：較差的價格在前
+    bool worse(Price a, Price b) const noexcept { return side_ == Side::Buy ? a < b : a > b; }
+    std::vector<Entry>::const_iterator lowerBound(Price price) const;
+
+    Side side_;
+    std::vector<Entry> levels_;
+    PriceLevelPool pool_;
+};
+
+/*
+   Ladder 版本：levels_[price - min] 直接定址，occupied_ 每個 bit 對應一個層級。
+   最佳價快取在 best_；最佳層級清空時才以 64 位元為單位往外掃描下一個非空層級。
+
+     occupied_:  ...0000 1010 0000...      bid 往低價掃描，ask 往高價掃描
+                        ▲ best_
+*/
+class LadderPriceLevels {
+public:
+    static constexpr size_t MAX_LEVELS = size_t(1) << 22;   // 約 4M 個 tick
+
+    // 價格範圍無效或超過 MAX_LEVELS 時丟出 std::invalid_argument
+    LadderPriceLevels(Side side, const OrderBookConfig& config);
+
+    bool accepts(Price price) const noexcept { return price >= minPrice_ && price <= maxPrice_; }
+    LevelIndex acquire(Price price);
+    LevelIndex find(Price price) const noexcept;
+    void release(LevelIndex index);
+    PriceLevel& at(LevelIndex index) noexcept { return levels_[index]; }
+    const PriceLevel& at(LevelIndex index) const noexcept { return levels_[index]; }
+    LevelIndex best() const noexcept { return best_; }
+    size_t levelCount() const noexcept { return count_; }
+    void clear();
+
+    template <typename Visitor>
+    void forEachBestFirst(Visitor&& visit) const {
+        for (LevelIndex index = best_; index != NO_LEVEL; index = nextWorse(index)) {
+            if (!visit(levels_[index])) return;
+        }
+    }
+
+private:
+    bool isOccupied(LevelIndex index) const noexcept {
+        return (occupied_[index >> 6] >> (index & 63)) & 1u;
+    }
+    LevelIndex findAtOrBelow(LevelIndex index) const noexcept;   // index 以下最高的非空層級
+    LevelIndex findAtOrAbove(LevelIndex index) const noexcept;   // index 以上最低的非空層級
+    LevelIndex nextWorse(LevelIndex index) const noexcept;
+
+    Side side_;
+    Price minPrice_;
+    Price maxPrice_;
+    std::vector<PriceLevel> levels_;
+    std::vector<uint64_t> occupied_;
+    LevelIndex best_ = NO_LEVEL;
+    size_t count_ = 0;
+};
+
+} // namespace core
+} // namespace mts
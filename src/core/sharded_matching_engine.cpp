@@ -0,0 +1,322 @@
+#include "sharded_matching_engine.h"
+#include <sstream>
+
+namespace mts {
+namespace core {
+
+namespace {
+
+    // FNV-1a：跨平台、跨執行一致，重播時標的仍落在同一分片
+    uint64_t fnv1a(std::string_view text) noexcept {
+        uint64_t hash = 14695981039346656037ULL;
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+} // namespace
+
+ShardedMatchingEngine::ShardedMatchingEngine(size_t shardCount, size_t orderPoolCapacity, size_t queueCapacity) {
+    if (shardCount == 0 || shardCount > MAX_SHARDS) {
+        throw std::invalid_argument("Shard count must be between 1 and 256");
+    }
+    if (orderPoolCapacity > LOCAL_HANDLE_MASK) {
+        throw std::invalid_argument("Order pool capacity per shard exceeds handle range");
+    }
+
+    shards_.reserve(shardCount);
+    for (size_t i = 0; i < shardCount; ++i) {
+        shards_.push_back(std::make_unique<MatchingEngine>(orderPoolCapacity, queueCapacity));
+    }
+}
+
+ShardedMatchingEngine::~ShardedMatchingEngine() {
+    stop();
+}
+
+// ===== 生命週期 =====
+
+bool ShardedMatchingEngine::start() {
+    if (running_) {
+        return false;
+    }
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        if (!shards_[i]->start()) {
+            for (size_t j = 0; j < i; ++j) {
+                shards_[j]->stop();
+            }
+            return false;
+        }
+    }
+    running_ = true;
+    return true;
+}
+
+void ShardedMatchingEngine::stop() {
+    for (auto& shard : shards_) {
+        shard->stop();
+    }
+    running_ = false;
+}
+
+// ===== 分片路由 =====
+
+size_t ShardedMatchingEngine::shardForSymbol(std::string_view symbol) const noexcept {
+    return shards_.size() == 1 ? 0 : static_cast<size_t>(fnv1a(symbol) % shards_.size());
+}
+
+OrderID ShardedMatchingEngine::tagOrderId(OrderID sequence, std::string_view symbol) const {
+    if (sequence >> SHARD_TAG_SHIFT) {
+        throw std::overflow_error("OrderID sequence exceeds 56 bits");
+    }
+    return (static_cast<OrderID>(shardForSymbol(symbol)) << SHARD_TAG_SHIFT) | sequence;
+}
+
+MatchingEngine* ShardedMatchingEngine::shardForHandle(OrderHandle handle) const noexcept {
+    size_t shard = shardOfHandle(handle);
+    return (handle != INVALID_ORDER_HANDLE && shard < shards_.size()) ? shards_[shard].get() : nullptr;
+}
+
+MatchingEngine* ShardedMatchingEngine::shardForOrderId(OrderID orderId) const noexcept {
+    size_t shard = shardOfOrderId(orderId);
+    return shard < shards_.size() ? shards_[shard].get() : nullptr;
+}
+
+// ===== 主要介面 =====
+
+void ShardedMatchingEngine::discardOrder(OrderHandle handle) {
+    MatchingEngine* shard = shardForHandle(handle);
+    if (!shard) {
+        throw std::logic_error("Invalid order handle");
+    }
+    shard->discardOrder(localHandle(handle));
+}
+
+Order& ShardedMatchingEngine::getOrder(OrderHandle handle) {
+    MatchingEngine* shard = shardForHandle(handle);
+    if (!shard) {
+        throw std::out_of_range("Invalid order handle");
+    }
+    return shard->getOrder(localHandle(handle));
+}
+
+bool ShardedMatchingEngine::submitOrder(OrderHandle handle) {
+    MatchingEngine* shard = shardForHandle(handle);
+    return shard ? shard->submitOrder(localHandle(handle)) : false;
+}
+
+bool ShardedMatchingEngine::cancelOrder(OrderID orderId, const std::string& reason) {
+    MatchingEngine* shard = shardForOrderId(orderId);
+    return shard ? shard->cancelOrder(orderId, reason) : false;
+}
+
+bool ShardedMatchingEngine::modifyOrder(OrderID orderId, Price newPrice, Quantity newQuantity) {
+    MatchingEngine* shard = shardForOrderId(orderId);
+    return shard ? shard->modifyOrder(orderId, newPrice, newQuantity) : false;
+}
+
+ExecutionReportPtr ShardedMatchingEngine::processOrderSync(OrderHandle handle) {
+    MatchingEngine* shard = shardForHandle(handle);
+    return shard ? shard->processOrderSync(localHandle(handle)) : nullptr;
+}
+
+ExecutionReportPtr ShardedMatchingEngine::cancelOrderSync(OrderID orderId, const std::string& reason) {
+    MatchingEngine* shard = shardForOrderId(orderId);
+    return shard ? shard->cancelOrderSync(orderId, reason) : nullptr;
+}
+
+// ===== 查詢介面 =====
+
+std::shared_ptr<const OrderBook> ShardedMatchingEngine::getOrderBook(const Symbol& symbol) const {
+    return shards_[shardForSymbol(symbol)]->getOrderBook(symbol);
+}
+
+MarketDataPtr ShardedMatchingEngine::getMarketData(const Symbol& symbol) const {
+    return shards_[shardForSymbol(symbol)]->getMarketData(symbol);
+}
+
+std::vector<Symbol> ShardedMatchingEngine::getAllSymbols() const {
+    std::vector<Symbol> symbols;
+    for (const auto& shard : shards_) {
+        auto shardSymbols = shard->getAllSymbols();
+        symbols.insert(symbols.end(), shardSymbols.begin(), shardSymbols.end());
+    }
+    return symbols;
+}
+
+const Order* ShardedMatchingEngine::findOrder(OrderID orderId) const {
+    MatchingEngine* shard = shardForOrderId(orderId);
+    return shard ? shard->findOrder(orderId) : nullptr;
+}
+
+// ===== 回調與設定 =====
+
+void ShardedMatchingEngine::setExecutionCallback(MatchingEngine::ExecutionCallback callback) {
+    for (auto& shard : shards_) {
+        shard->setExecutionCallback(callback);
+    }
+}
+
+void ShardedMatchingEngine::setMarketDataCallback(MatchingEngine::MarketDataCallback callback) {
+    for (auto& shard : shards_) {
+        shard->setMarketDataCallback(callback);
+    }
+}
+
+void ShardedMatchingEngine::setExecutionBatchCallback(MatchingEngine::ExecutionBatchCallback callback) {
+    for (auto& shard : shards_) {
+        shard->setExecutionBatchCallback(callback);
+    }
+}
+
+void ShardedMatchingEngine::setShardExecutionBatchCallback(ShardExecutionBatchCallback callback) {
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        if (!callback) {
+            shards_[i]->setExecutionBatchCallback(nullptr);
+            continue;
+        }
+        shards_[i]->setExecutionBatchCallback(
+            [callback, i](const ExecutionReportPtr* reports, size_t count) {
+                callback(i, reports, count);
+            }
+        );
+    }
+}
+
+void ShardedMatchingEngine::setMarketDataBatchCallback(MatchingEngine::MarketDataBatchCallback callback) {
+    for (auto& shard : shards_) {
+        shard->setMarketDataBatchCallback(callback);
+    }
+}
+
+void ShardedMatchingEngine::setErrorCallback(MatchingEngine::ErrorCallback callback) {
+    for (auto& shard : shards_) {
+        shard->setErrorCallback(callback);
+    }
+}
+
+bool ShardedMatchingEngine::setOrderBookConfig(const Symbol& symbol, const OrderBookConfig& config) {
+    return shards_[shardForSymbol(symbol)]->setOrderBookConfig(symbol, config);
+}
+
+bool ShardedMatchingEngine::setWaitStrategy(WaitStrategy strategy) {
+    bool ok = true;
+    for (auto& shard : shards_) {
+        ok = shard->setWaitStrategy(strategy) && ok;
+    }
+    return ok;
+}
+
+bool ShardedMatchingEngine::setBatchSize(size_t batchSize) {
+    bool ok = true;
+    for (auto& shard : shards_) {
+        ok = shard->setBatchSize(batchSize) && ok;
+    }
+    return ok;
+}
+
+bool ShardedMatchingEngine::setCpuAffinity(const CpuList& cpus) {
+    bool ok = true;
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        ok = shards_[i]->setCpuAffinity(cpuForThread(cpus, i)) && ok;
+    }
+    return ok;
+}
+
+bool ShardedMatchingEngine::enableJournal(const JournalConfig& config) {
+    bool ok = true;
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        JournalConfig shardConfig = config;
+        shardConfig.directory = journalShardDirectory(config.directory, i);
+        ok = shards_[i]->enableJournal(shardConfig) && ok;
+    }
+    return ok;
+}
+
+bool ShardedMatchingEngine::requestSnapshot() {
+    bool ok = true;
+    for (auto& shard : shards_) {
+        ok = shard->requestSnapshot() && ok;
+    }
+    return ok;
+}
+
+bool ShardedMatchingEngine::recover(const std::string& directory, RecoveryResult& result) {
+    result = RecoveryResult{};
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        RecoveryResult shardResult;
+        if (!shards_[i]->recover(journalShardDirectory(directory, i), shardResult)) {
+            return false;
+        }
+        shardResult.maxOrderId &= (OrderID(1) << SHARD_TAG_SHIFT) - 1;
+        result.merge(shardResult);
+    }
+    return true;
+}
+
+void ShardedMatchingEngine::enableRiskCheck(bool enable) {
+    for (auto& shard : shards_) {
+        shard->enableRiskCheck(enable);
+    }
+}
+
+void ShardedMatchingEngine::enableMarketData(bool enable) {
+    for (auto& shard : shards_) {
+        shard->enableMarketData(enable);
+    }
+}
+
+void ShardedMatchingEngine::setMaxProcessingTime(std::chrono::microseconds maxTime) {
+    for (auto& shard : shards_) {
+        shard->setMaxProcessingTime(maxTime);
+    }
+}
+
+void ShardedMatchingEngine::setMaxOrderPrice(Price maxPrice, PriceScale scale) {
+    for (auto& shard : shards_) {
+        shard->setMaxOrderPrice(maxPrice, scale);
+    }
+}
+
+void ShardedMatchingEngine::setMaxOrderQuantity(Quantity maxQty) {
+    for (auto& shard : shards_) {
+        shard->setMaxOrderQuantity(maxQty);
+    }
+}
+
+void ShardedMatchingEngine::setMaxOrdersPerSymbol(uint32_t maxOrders) {
+    for (auto& shard : shards_) {
+        shard->setMaxOrdersPerSymbol(maxOrders);
+    }
+}
+
+// ===== 統計資訊 =====
+
+void ShardedMatchingEngine::getStatistics(EngineStatistics& out) const {
+    out.reset();
+    out.startTime = std::chrono::steady_clock::time_point::max();
+    for (const auto& shard : shards_) {
+        out.merge(shard->getStatistics());
+    }
+}
+
+void ShardedMatchingEngine::resetStatistics() {
+    for (auto& shard : shards_) {
+        shard->resetStatistics();
+    }
+}
+
+std::string ShardedMatchingEngine::toString() const {
+    std::ostringstream oss;
+    oss << "ShardedMatchingEngine[Shards=" << shards_.size()
+        << ", Running=" << (running_ ? "YES" : "NO") << "]";
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        oss << "\n  #" << i << " " << shards_[i]->toString();
+    }
+    return oss.str();
+}
+
+} // namespace core
+} // namespace mts
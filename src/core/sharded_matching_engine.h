@@ -0,0 +1,156 @@
+#pragma once
+#include "matching_engine.h"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mts {
+namespace core {
+
+// ===== 依標的分片的撮合引擎 =====
+
+/*
+┌──────────────────────────────────────────────────────────┐
+│                   ShardedMatchingEngine                   │
+├──────────────────────────────────────────────────────────┤
+│ • N 個 MatchingEngine 分片，各自擁有撮合執行緒、輸入佇列、   │
+│   訂單池、OrderBook 與統計；分片之間不共享可變狀態           │
+│ • 新訂單依標的雜湊 (FNV-1a) 分派，同一標的永遠在同一分片     │
+│ • OrderID 高 8 位元為分片編號，取消 / 修改直接依此分派       │
+│ • 回調在各分片的撮合執行緒上呼叫，可能同時發生               │
+└──────────────────────────────────────────────────────────┘
+   submitOrder("AAPL") ──hash──▶ shard 1 ─▶ [ring] ─▶ thread 1 ─▶ books{AAPL, MSFT}
+   submitOrder("TSLA") ──hash──▶ shard 0 ─▶ [ring] ─▶ thread 0 ─▶ books{TSLA}
+   cancelOrder(0x01000000_0000002A) ──tag 1──▶ shard 1
+
+   OrderID   = [shard:8][sequence:56]         （tagOrderId 產生）
+   OrderHandle = [shard:8][分片內 handle:24]   （createOrder 產生）
+*/
+class ShardedMatchingEngine {
+public:
+    static constexpr unsigned SHARD_TAG_SHIFT = 56;
+    static constexpr size_t MAX_SHARDS = 256;
+    static constexpr unsigned LOCAL_HANDLE_BITS = 24;
+    static constexpr OrderHandle LOCAL_HANDLE_MASK = (OrderHandle(1) << LOCAL_HANDLE_BITS) - 1;
+
+    // orderPoolCapacity / queueCapacity 為每個分片的容量
+    explicit ShardedMatchingEngine(size_t shardCount = 1,
+                                   size_t orderPoolCapacity = OrderPool::DEFAULT_CAPACITY,
+                                   size_t queueCapacity = MatchingEngine::DEFAULT_QUEUE_CAPACITY);
+    ~ShardedMatchingEngine();
+
+    ShardedMatchingEngine(const ShardedMatchingEngine&) = delete;
+    ShardedMatchingEngine& operator=(const ShardedMatchingEngine&) = delete;
+
+    // ===== 生命週期 =====
+    bool start();
+    void stop();
+    bool isRunning() const noexcept { return running_; }
+
+    // ===== 分片路由 =====
+    size_t getShardCount() const noexcept { return shards_.size(); }
+    size_t shardForSymbol(std::string_view symbol) const noexcept;
+    static size_t shardOfOrderId(OrderID orderId) noexcept {
+        return static_cast<size_t>(orderId >> SHARD_TAG_SHIFT);
+    }
+    static size_t shardOfHandle(OrderHandle handle) noexcept {
+        return static_cast<size_t>(handle >> LOCAL_HANDLE_BITS);
+    }
+
+    // 把序號加上標的所屬分片的標記；sequence 須小於 2^56
+    OrderID tagOrderId(OrderID sequence, std::string_view symbol) const;
+
+    // 分片的日誌目錄
+    static std::string journalShardDirectory(const std::string& directory, size_t shard) {
+        return directory + "/shard-" + std::to_string(shard);
+    }
+
+    MatchingEngine& getShard(size_t index) { return *shards_.at(index); }
+    const MatchingEngine& getShard(size_t index) const { return *shards_.at(index); }
+
+    // ===== 主要介面 =====
+
+    // 在標的所屬分片的訂單池建立訂單（參數同 Order 建構函式）
+    // OrderID 的分片標記與標的不符時丟出 std::invalid_argument；池已滿時回傳 INVALID_ORDER_HANDLE
+    template <typename... Args>
+    OrderHandle createOrder(OrderID orderId, const ClientID& clientId, const Symbol& symbol, Args&&... rest) {
+        size_t shard = shardForSymbol(symbol);
+        if (shardOfOrderId(orderId) != shard) {
+            throw std::invalid_argument("OrderID shard tag does not match symbol " + symbol);
+        }
+        OrderHandle local = shards_[shard]->createOrder(orderId, clientId, symbol, std::forward<Args>(rest)...);
+        return local == INVALID_ORDER_HANDLE ? INVALID_ORDER_HANDLE : makeHandle(shard, local);
+    }
+
+    void discardOrder(OrderHandle handle);
+    Order& getOrder(OrderHandle handle);
+
+    bool submitOrder(OrderHandle handle);
+    bool cancelOrder(OrderID orderId, const std::string& reason = "User requested");
+    bool modifyOrder(OrderID orderId, Price newPrice, Quantity newQuantity);
+
+    ExecutionReportPtr processOrderSync(OrderHandle handle);
+    ExecutionReportPtr cancelOrderSync(OrderID orderId, const std::string& reason = "User requested");
+
+    // ===== 查詢介面 =====
+    std::shared_ptr<const OrderBook> getOrderBook(const Symbol& symbol) const;
+    MarketDataPtr getMarketData(const Symbol& symbol) const;
+    std::vector<Symbol> getAllSymbols() const;
+    const Order* findOrder(OrderID orderId) const;
+
+    // ===== 回調設定（套用到所有分片）=====
+    void setExecutionCallback(MatchingEngine::ExecutionCallback callback);
+    void setMarketDataCallback(MatchingEngine::MarketDataCallback callback);
+    void setExecutionBatchCallback(MatchingEngine::ExecutionBatchCallback callback);
+    // 額外帶出分片編號：每個分片的撮合執行緒是各自的單一生產者（例如每分片一個 SPSC 佇列）
+    using ShardExecutionBatchCallback = std::function<void(size_t shard, const ExecutionReportPtr* reports, size_t count)>;
+    void setShardExecutionBatchCallback(ShardExecutionBatchCallback callback);
+    void setMarketDataBatchCallback(MatchingEngine::MarketDataBatchCallback callback);
+    void setErrorCallback(MatchingEngine::ErrorCallback callback);
+
+    // ===== 設定（套用到所有分片）=====
+    bool setOrderBookConfig(const Symbol& symbol, const OrderBookConfig& config);
+    bool setWaitStrategy(WaitStrategy strategy);
+    bool setBatchSize(size_t batchSize);
+    // 分片 i 的撮合執行緒綁到 cpuForThread(cpus, i)；空清單表示不綁核
+    bool setCpuAffinity(const CpuList& cpus);
+    // 每個分片各自寫入 <directory>/shard-<i>
+    bool enableJournal(const JournalConfig& config);
+    
+    // ===== 快照與重啟（套用到所有分片）=====
+    bool requestSnapshot();
+    // 各分片由 <directory>/shard-<i> 重建；result.maxOrderId 為去掉分片標記後的最大序號
+    bool recover(const std::string& directory, RecoveryResult& result);
+    void enableRiskCheck(bool enable);
+    void enableMarketData(bool enable);
+    void setMaxProcessingTime(std::chrono::microseconds maxTime);
+    void setMaxOrderPrice(Price maxPrice, PriceScale scale = PriceScale());
+    void setMaxOrderQuantity(Quantity maxQty);
+    void setMaxOrdersPerSymbol(uint32_t maxOrders);
+
+    // ===== 統計資訊 =====
+    const EngineStatistics& getShardStatistics(size_t index) const { return getShard(index).getStatistics(); }
+    // 呼叫時把所有分片彙總到 out（先重設）；out 由呼叫端持有，多個執行緒同時查詢互不影響
+    void getStatistics(EngineStatistics& out) const;
+    void resetStatistics();
+
+    std::string toString() const;
+
+private:
+    static OrderHandle makeHandle(size_t shard, OrderHandle local) noexcept {
+        return static_cast<OrderHandle>(shard << LOCAL_HANDLE_BITS) | local;
+    }
+    static OrderHandle localHandle(OrderHandle handle) noexcept { return handle & LOCAL_HANDLE_MASK; }
+
+    // 無效 handle / 標記時回傳 nullptr
+    MatchingEngine* shardForHandle(OrderHandle handle) const noexcept;
+    MatchingEngine* shardForOrderId(OrderID orderId) const noexcept;
+
+    std::vector<std::unique_ptr<MatchingEngine>> shards_;
+    bool running_{false};
+};
+
+} // namespace core
+} // namespace mts
@@ -0,0 +1,363 @@
+#include "snapshot.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace mts {
+namespace core {
+
+namespace {
+
+    constexpr char SNAPSHOT_MAGIC[8] = {'M', 'T', 'S', 'S', 'N', 'A', 'P', '\0'};
+    constexpr uint32_t SNAPSHOT_VERSION = 1;
+    constexpr const char* SNAPSHOT_PREFIX = "snapshot-";
+    constexpr const char* SNAPSHOT_SUFFIX = ".snap";
+
+    struct SnapshotHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t bookCount;
+        uint64_t journalSequence;
+        uint64_t engineSequence;
+        uint64_t orderCount;
+        uint64_t timestampNs;
+        uint64_t bodySize;
+        uint64_t checksum;
+    };
+    static_assert(sizeof(SnapshotHeader) == 64, "SnapshotHeader must stay 64 bytes");
+
+    struct BookHeader {
+        uint32_t bidCount;
+        uint32_t askCount;
+        uint8_t policy;
+        uint8_t symbolLength;
+        uint8_t reserved[6];
+        int64_t ladderMinPrice;
+        int64_t ladderMaxPrice;
+    };
+    static_assert(sizeof(BookHeader) == 32, "BookHeader must stay 32 bytes");
+
+    struct OrderRecord {
+        uint64_t orderId;
+        int64_t price;
+        uint64_t quantity;
+        uint64_t remainingQuantity;
+        uint64_t sequence;
+        uint8_t side;
+        uint8_t orderType;
+        uint8_t timeInForce;
+        uint8_t status;
+        uint8_t clientIdLength;
+        uint8_t reserved[3];
+    };
+    static_assert(sizeof(OrderRecord) == 48, "OrderRecord must stay 48 bytes");
+
+    constexpr size_t align8(size_t size) noexcept { return (size + 7) & ~size_t(7); }
+
+    // 以 8 位元組為單位的 FNV-1a 變體（本體長度必為 8 的倍數）
+    uint64_t bodyChecksum(const char* data, size_t size) noexcept {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t offset = 0; offset < size; offset += 8) {
+            uint64_t word;
+            std::memcpy(&word, data + offset, sizeof(word));
+            hash = (hash ^ word) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // 附加 text 並補零到 8 的倍數
+    void appendPadded(std::vector<char>& out, const std::string& text, size_t length) {
+        size_t offset = out.size();
+        out.resize(offset + align8(length), '\0');
+        std::memcpy(out.data() + offset, text.data(), length);
+    }
+
+    template <typename T>
+    void appendRaw(std::vector<char>& out, const T& value) {
+        size_t offset = out.size();
+        out.resize(offset + sizeof(T));
+        std::memcpy(out.data() + offset, &value, sizeof(T));
+    }
+
+    std::vector<std::string> listSnapshots(const std::string& directory) {
+        std::vector<std::string> snapshots;
+        std::error_code ec;
+        if (!std::filesystem::is_directory(directory, ec)) {
+            return snapshots;
+        }
+        const size_t suffixLength = std::strlen(SNAPSHOT_SUFFIX);
+        for (const auto& item : std::filesystem::directory_iterator(directory, ec)) {
+            std::string name = item.path().filename().string();
+            if (item.is_regular_file(ec) && name.rfind(SNAPSHOT_PREFIX, 0) == 0 && name.size() > suffixLength &&
+                name.compare(name.size() - suffixLength, std::string::npos, SNAPSHOT_SUFFIX) == 0) {
+                snapshots.push_back(item.path().string());
+            }
+        }
+        std::sort(snapshots.begin(), snapshots.end());
+        return snapshots;
+    }
+
+    // 讀取本體中的一側掛單；格式錯誤時回傳 false
+    bool readOrders(const std::vector<char>& body, size_t& offset, uint32_t count,
+                    std::vector<SnapshotOrder>& orders) {
+        orders.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (body.size() - offset < sizeof(OrderRecord)) {
+                return false;
+            }
+            OrderRecord record;
+            std::memcpy(&record, body.data() + offset, sizeof(record));
+            offset += sizeof(record);
+            size_t padded = align8(record.clientIdLength);
+            if (body.size() - offset < padded) {
+                return false;
+            }
+            SnapshotOrder order;
+            order.orderId = record.orderId;
+            order.clientId.assign(body.data() + offset, record.clientIdLength);
+            order.side = static_cast<Side>(record.side);
+            order.orderType = static_cast<OrderType>(record.orderType);
+            order.timeInForce = static_cast<TimeInForce>(record.timeInForce);
+            order.status = static_cast<OrderStatus>(record.status);
+            order.price = Price(record.price);
+            order.quantity = record.quantity;
+            order.remainingQuantity = record.remainingQuantity;
+            order.sequence = record.sequence;
+            orders.push_back(std::move(order));
+            offset += padded;
+        }
+        return true;
+    }
+
+#ifndef _WIN32
+    void syncDirectory(const std::string& directory) {
+        int fd = ::open(directory.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            ::fsync(fd);
+            ::close(fd);
+        }
+    }
+#endif
+
+} // namespace
+
+size_t SnapshotData::orderCount() const {
+    size_t count = 0;
+    for (const auto& book : books) {
+        count += book.bids.size() + book.asks.size();
+    }
+    return count;
+}
+
+// ===== SnapshotImage =====
+
+void SnapshotImage::beginBook(const std::string& symbol, const OrderBookConfig& config) {
+    BookHeader header{};
+    header.policy = static_cast<uint8_t>(config.policy);
+    header.symbolLength = static_cast<uint8_t>(std::min<size_t>(symbol.size(), 255));
+    header.ladderMinPrice = config.ladderMinPrice.ticks();
+    header.ladderMaxPrice = config.ladderMaxPrice.ticks();
+    bookOffset_ = body_.size();
+    appendRaw(body_, header);
+    appendPadded(body_, symbol, header.symbolLength);
+    ++bookCount_;
+}
+
+void SnapshotImage::addOrder(const Order& order) {
+    OrderRecord record{};
+    record.orderId = order.getOrderId();
+    record.price = order.getPrice().ticks();
+    record.quantity = order.getQuantity();
+    record.remainingQuantity = order.getRemainingQuantity();
+    record.sequence = order.getSequence();
+    record.side = static_cast<uint8_t>(order.getSide());
+    record.orderType = static_cast<uint8_t>(order.getOrderType());
+    record.timeInForce = static_cast<uint8_t>(order.getTimeInForce());
+    record.status = static_cast<uint8_t>(order.getStatus());
+    const std::string& clientId = order.getClientId();
+    record.clientIdLength = static_cast<uint8_t>(std::min<size_t>(clientId.size(), 255));
+    appendRaw(body_, record);
+    appendPadded(body_, clientId, record.clientIdLength);
+
+    // 更新目前 BookHeader 的計數
+    size_t countOffset = bookOffset_ + (order.isBuyOrder() ? offsetof(BookHeader, bidCount)
+                                                           : offsetof(BookHeader, askCount));
+    uint32_t count;
+    std::memcpy(&count, body_.data() + countOffset, sizeof(count));
+    ++count;
+    std::memcpy(body_.data() + countOffset, &count, sizeof(count));
+    ++orderCount_;
+}
+
+// ===== 檔案 =====
+
+bool writeSnapshotFile(const std::string& directory, const SnapshotImage& image,
+                       std::string& path, std::string& error) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        error = "cannot create snapshot directory " + directory + ": " + ec.message();
+        return false;
+    }
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s%020llu%s", SNAPSHOT_PREFIX,
+                  static_cast<unsigned long long>(image.journalSequence), SNAPSHOT_SUFFIX);
+    path = (std::filesystem::path(directory) / name).string();
+    std::string tempPath = path + ".tmp";
+
+    const std::vector<char>& body = image.body();
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.bookCount = image.bookCount();
+    header.journalSequence = image.journalSequence;
+    header.engineSequence = image.engineSequence;
+    header.orderCount = image.orderCount();
+    header.timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    header.bodySize = body.size();
+    header.checksum = bodyChecksum(body.data(), body.size());
+
+    std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) {
+        error = "cannot create " + tempPath;
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (body.empty() || std::fwrite(body.data(), 1, body.size(), file) == body.size()) &&
+              std::fflush(file) == 0;
+#ifndef _WIN32
+    ok = ok && ::fsync(fileno(file)) == 0;
+#endif
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        error = "cannot write " + tempPath;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    // 完整寫入後才以 rename 原子地出現，讀者不會看到寫到一半的快照
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        error = "cannot rename " + tempPath + ": " + ec.message();
+        std::remove(tempPath.c_str());
+        return false;
+    }
+#ifndef _WIN32
+    syncDirectory(directory);
+#endif
+    return true;
+}
+
+bool readSnapshotFile(const std::string& path, SnapshotData& data, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    SnapshotHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        error = path + " is not a snapshot file";
+        return false;
+    }
+    if (header.version != SNAPSHOT_VERSION || header.bodySize % 8 != 0) {
+        error = path + ": unsupported snapshot version";
+        return false;
+    }
+    std::vector<char> body(header.bodySize);
+    if (!body.empty() && !in.read(body.data(), static_cast<std::streamsize>(body.size()))) {
+        error = path + ": truncated snapshot";
+        return false;
+    }
+    if (bodyChecksum(body.data(), body.size()) != header.checksum) {
+        error = path + ": snapshot checksum mismatch";
+        return false;
+    }
+
+    data = SnapshotData{};
+    data.journalSequence = header.journalSequence;
+    data.engineSequence = header.engineSequence;
+    data.timestampNs = header.timestampNs;
+    data.books.reserve(header.bookCount);
+    size_t offset = 0;
+    for (uint32_t i = 0; i < header.bookCount; ++i) {
+        if (body.size() - offset < sizeof(BookHeader)) {
+            error = path + ": corrupt book header";
+            return false;
+        }
+        BookHeader bookHeader;
+        std::memcpy(&bookHeader, body.data() + offset, sizeof(bookHeader));
+        offset += sizeof(bookHeader);
+        if (body.size() - offset < align8(bookHeader.symbolLength)) {
+            error = path + ": corrupt book header";
+            return false;
+        }
+        SnapshotBook book;
+        book.symbol.assign(body.data() + offset, bookHeader.symbolLength);
+        offset += align8(bookHeader.symbolLength);
+        book.config.policy = static_cast<PriceLevelPolicy>(bookHeader.policy);
+        book.config.ladderMinPrice = Price(bookHeader.ladderMinPrice);
+        book.config.ladderMaxPrice = Price(bookHeader.ladderMaxPrice);
+        if (!readOrders(body, offset, bookHeader.bidCount, book.bids) ||
+            !readOrders(body, offset, bookHeader.askCount, book.asks)) {
+            error = path + ": corrupt order records in " + book.symbol;
+            return false;
+        }
+        data.books.push_back(std::move(book));
+    }
+    if (data.orderCount() != header.orderCount) {
+        error = path + ": order count mismatch";
+        return false;
+    }
+    return true;
+}
+
+std::string findLatestSnapshot(const std::string& directory) {
+    auto snapshots = listSnapshots(directory);
+    return snapshots.empty() ? std::string() : snapshots.back();
+}
+
+void pruneSnapshots(const std::string& directory, size_t keep) {
+    auto snapshots = listSnapshots(directory);
+    if (snapshots.size() <= keep) {
+        return;
+    }
+    for (size_t i = 0; i + keep < snapshots.size(); ++i) {
+        std::remove(snapshots[i].c_str());
+    }
+}
+
+// ===== RecoveryResult =====
+
+void RecoveryResult::merge(const RecoveryResult& other) {
+    snapshotSequence = std::max(snapshotSequence, other.snapshotSequence);
+    restoredOrders += other.restoredOrders;
+    replayedRecords += other.replayedRecords;
+    lastSequence = std::max(lastSequence, other.lastSequence);
+    maxOrderId = std::max(maxOrderId, other.maxOrderId);
+    elapsedMs = std::max(elapsedMs, other.elapsedMs);
+}
+
+std::string RecoveryResult::toString() const {
+    std::ostringstream oss;
+    oss << "restored " << restoredOrders << " resting orders from snapshot @" << snapshotSequence
+        << ", replayed " << replayedRecords << " journal records (last seq " << lastSequence
+        << ") in " << std::fixed << std::setprecision(1) << elapsedMs << " ms";
+    return oss.str();
+}
+
+} // namespace core
+} // namespace mts
@@ -0,0 +1,110 @@
+#pragma once
+#include "order.h"
+#include "price_levels.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mts {
+namespace core {
+
+// ===== OrderBook 二進位快照 =====
+
+/*
+┌──────────────────────────────────────────────────────────┐
+│                      OrderBook 快照                       │
+├──────────────────────────────────────────────────────────┤
+│ • 撮合執行緒在批次之間（序號屏障）把所有掛單依優先順序      │
+│   複製成緊湊的二進位影像 SnapshotImage，只有線性複製的成本   │
+│ • 校驗和、寫檔、fsync、rename 由背景執行緒完成              │
+│ • 影像涵蓋日誌序號 ≤ journalSequence 的所有輸入             │
+│ • 重啟：最新快照 + 日誌中序號 > journalSequence 的記錄       │
+└──────────────────────────────────────────────────────────┘
+   <dir>/snapshot-00000000000000052417.snap   ← 檔名為涵蓋到的日誌序號
+
+   [SnapshotHeader 64B]
+   [BookHeader][symbol → 8B][SnapshotOrder][clientId → 8B]...   ← 買單（最佳價起、同價先到先）
+                            [SnapshotOrder][clientId → 8B]...   ← 賣單
+   [BookHeader]...
+*/
+
+// 快照中的一筆掛單
+struct SnapshotOrder {
+    OrderID orderId = 0;
+    std::string clientId;
+    Side side = Side::Buy;
+    OrderType orderType = OrderType::Limit;
+    TimeInForce timeInForce = TimeInForce::Day;
+    OrderStatus status = OrderStatus::New;
+    Price price;
+    Quantity quantity = 0;
+    Quantity remainingQuantity = 0;
+    uint64_t sequence = 0;         // 撮合引擎接受順序
+};
+
+struct SnapshotBook {
+    std::string symbol;
+    OrderBookConfig config;
+    std::vector<SnapshotOrder> bids;   // 優先順序
+    std::vector<SnapshotOrder> asks;
+};
+
+// 讀回的快照內容
+struct SnapshotData {
+    uint64_t journalSequence = 0;      // 已涵蓋的最後一筆日誌序號
+    uint64_t engineSequence = 0;       // 撮合引擎的接受序號計數
+    uint64_t timestampNs = 0;
+    std::vector<SnapshotBook> books;
+
+    size_t orderCount() const;
+};
+
+// 撮合執行緒產生的影像：只含編碼後的本體，標頭與校驗和在寫檔時補上
+class SnapshotImage {
+public:
+    uint64_t journalSequence = 0;
+    uint64_t engineSequence = 0;
+
+    // 先 beginBook，再依優先順序 addOrder（買單全部在賣單之前）
+    void beginBook(const std::string& symbol, const OrderBookConfig& config);
+    void addOrder(const Order& order);
+
+    uint32_t bookCount() const noexcept { return bookCount_; }
+    uint64_t orderCount() const noexcept { return orderCount_; }
+    const std::vector<char>& body() const noexcept { return body_; }
+    void reserve(size_t bytes) { body_.reserve(bytes); }
+
+private:
+    std::vector<char> body_;
+    size_t bookOffset_ = 0;     // 目前 BookHeader 在 body_ 中的位置
+    uint32_t bookCount_ = 0;
+    uint64_t orderCount_ = 0;
+};
+
+// 寫入 <directory>/snapshot-<journalSequence>.snap（先寫暫存檔再 rename）；失敗時回傳 false 並填入 error
+bool writeSnapshotFile(const std::string& directory, const SnapshotImage& image,
+                       std::string& path, std::string& error);
+
+bool readSnapshotFile(const std::string& path, SnapshotData& data, std::string& error);
+
+// 目錄內最新（涵蓋序號最大）的快照；沒有時回傳空字串
+std::string findLatestSnapshot(const std::string& directory);
+
+// 只保留最新的 keep 個快照
+void pruneSnapshots(const std::string& directory, size_t keep);
+
+// 從快照 + 日誌尾端重建的結果
+struct RecoveryResult {
+    uint64_t snapshotSequence = 0;     // 使用的快照涵蓋到的日誌序號（0 表示沒有快照）
+    size_t restoredOrders = 0;         // 由快照恢復的掛單數
+    size_t replayedRecords = 0;        // 重播的日誌記錄數
+    uint64_t lastSequence = 0;         // 恢復後的最後一筆日誌序號
+    OrderID maxOrderId = 0;            // 快照與日誌中出現過的最大 OrderID
+    double elapsedMs = 0;
+
+    void merge(const RecoveryResult& other);
+    std::string toString() const;
+};
+
+} // namespace core
+} // namespace mts
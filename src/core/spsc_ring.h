@@ -0,0 +1,100 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace mts {
+namespace core {
+
+// ===== 無鎖單生產者 / 單消費者環形佇列 =====
+
+/*
+┌──────────────────────────────────────────────┐
+│                  SpscRing<T>                 │
+├──────────────────────────────────────────────┤
+│ • 固定容量（2 的次方），啟動時一次配置          │
+│ • 只有一個生產者、一個消費者：不需 CAS          │
+│ • tail_ 由生產者獨佔寫入，head_ 由消費者獨佔寫入 │
+│ • 各自快取對方的位置，只在看似已滿 / 已空時重讀   │
+│ • 已滿時 tryPush 回傳 false，由呼叫端決定退路    │
+└──────────────────────────────────────────────┘
+   生產者：寫入 slots_[tail & mask] → tail_.store(release)
+   消費者：head_ < tail_(acquire) 時讀取 → head_.store(release)
+
+   生產者與消費者的欄位各自佔一條快取線，避免互相失效。
+*/
+template <typename T>
+class SpscRing {
+    static_assert(std::is_nothrow_move_assignable<T>::value,
+                  "SpscRing element must be nothrow move assignable");
+
+public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    explicit SpscRing(size_t capacity)
+        : capacity_(capacity), mask_(capacity - 1) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("SpscRing capacity must be a power of two >= 2");
+        }
+        slots_ = std::make_unique<T[]>(capacity);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // 只能由唯一的生產者執行緒呼叫；佇列已滿時回傳 false，value 保持不變
+    bool tryPush(T&& value) noexcept {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ >= capacity_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ >= capacity_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只能由唯一的消費者執行緒呼叫
+    bool tryPop(T& out) noexcept {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return false;
+            }
+        }
+        out = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 任意執行緒可呼叫的近似判斷
+    bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    size_t size() const noexcept {
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t head = head_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const noexcept { return capacity_; }
+
+private:
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};   // 生產者寫入
+    size_t cachedHead_ = 0;                                   // 生產者快取的 head_
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};   // 消費者寫入
+    size_t cachedTail_ = 0;                                   // 消費者快取的 tail_
+};
+
+} // namespace core
+} // namespace mts
@@ -0,0 +1,88 @@
+#include "thread_affinity.h"
+#include "async_logger.h"
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+namespace mts {
+namespace core {
+
+namespace {
+    int parseCpu(const std::string& token, const std::string& spec) {
+        size_t used = 0;
+        int cpu = -1;
+        try {
+            cpu = std::stoi(token, &used);
+        } catch (const std::exception&) {
+            used = 0;
+        }
+        if (token.empty() || used != token.size() || cpu < 0) {
+            throw std::invalid_argument("Invalid CPU list: " + spec);
+        }
+        return cpu;
+    }
+}
+
+CpuList parseCpuList(const std::string& spec) {
+    CpuList cpus;
+    std::istringstream iss(spec);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        size_t dash = item.find('-');
+        if (dash == std::string::npos) {
+            cpus.push_back(parseCpu(item, spec));
+            continue;
+        }
+        int first = parseCpu(item.substr(0, dash), spec);
+        int last = parseCpu(item.substr(dash + 1), spec);
+        if (last < first) {
+            throw std::invalid_argument("Invalid CPU range: " + item);
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    if (cpus.empty()) {
+        throw std::invalid_argument("Empty CPU list");
+    }
+    return cpus;
+}
+
+std::string cpuListToString(const CpuList& cpus) {
+    if (cpus.empty()) {
+        return "any";
+    }
+    std::ostringstream oss;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        oss << (i ? "," : "") << cpus[i];
+    }
+    return oss.str();
+}
+
+bool pinCurrentThread(int cpu, const char* threadName) {
+    if (cpu < 0) {
+        return true;
+    }
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        MTS_LOG_WARN("⚠️ Cannot pin {} thread to CPU {} (error {})", threadName, cpu, rc);
+        return false;
+    }
+    MTS_LOG_INFO("📌 {} thread pinned to CPU {}", threadName, cpu);
+    return true;
+#else
+    MTS_LOG_WARN("⚠️ CPU pinning not supported on this platform ({} thread, CPU {})", threadName, cpu);
+    return false;
+#endif
+}
+
+} // namespace core
+} // namespace mts
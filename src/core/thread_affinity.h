@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace mts {
+namespace core {
+
+// ===== 執行緒綁核 =====
+
+// 一個管線階段可用的 CPU 編號；空表示不綁核，交給作業系統排程
+using CpuList = std::vector<int>;
+
+// "0,2,4-7" → {0, 2, 4, 5, 6, 7}；格式錯誤時丟出 std::invalid_argument
+CpuList parseCpuList(const std::string& spec);
+std::string cpuListToString(const CpuList& cpus);
+
+// 階段內第 index 條執行緒使用的 CPU（輪流分配）；清單為空時回傳 -1
+inline int cpuForThread(const CpuList& cpus, size_t index) noexcept {
+    return cpus.empty() ? -1 : cpus[index % cpus.size()];
+}
+
+// 把目前執行緒綁到單一 CPU；cpu < 0 時不做事並回傳 true
+// 不支援的平台或呼叫失敗時記錄警告並回傳 false，執行緒照常執行
+bool pinCurrentThread(int cpu, const char* threadName);
+
+} // namespace core
+} // namespace mts
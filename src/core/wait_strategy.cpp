@@ -0,0 +1,40 @@
+#include "wait_strategy.h"
+#include <stdexcept>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
+
+namespace mts {
+namespace core {
+
+std::string waitStrategyToString(WaitStrategy strategy) {
+    switch (strategy) {
+        case WaitStrategy::BusySpin:  return "busy-spin";
+        case WaitStrategy::SpinYield: return "spin-yield";
+        case WaitStrategy::Blocking:  return "blocking";
+        default:                      return "unknown";
+    }
+}
+
+WaitStrategy stringToWaitStrategy(const std::string& str) {
+    if (str == "busy-spin") return WaitStrategy::BusySpin;
+    if (str == "spin-yield") return WaitStrategy::SpinYield;
+    if (str == "blocking") return WaitStrategy::Blocking;
+    throw std::invalid_argument("Unknown wait strategy: " + str);
+}
+
+void cpuRelax() noexcept {
+#if defined(_MSC_VER)
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+} // namespace core
+} // namespace mts
@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace mts {
+namespace core {
+
+// ===== 消費者等待策略 =====
+
+// 佇列為空時撮合執行緒如何等待
+enum class WaitStrategy {
+    BusySpin,     // 持續輪詢：延遲最低，獨佔一顆核心
+    SpinYield,    // 先輪詢一段時間，之後讓出 CPU
+    Blocking      // 短暫輪詢後在條件變數上休眠，需要生產者喚醒
+};
+
+std::string waitStrategyToString(WaitStrategy strategy);
+WaitStrategy stringToWaitStrategy(const std::string& str);   // 無法辨識時丟出 std::invalid_argument
+
+// CPU 提示：自旋迴圈中降低功耗並讓出超執行緒資源
+void cpuRelax() noexcept;
+
+/*
+┌──────────────────────────────────────────────┐
+│                   IdleWaiter                  │
+├──────────────────────────────────────────────┤
+│ 消費者：wait(ready) 直到 ready() 為 true        │
+│ 生產者：寫入佇列後呼叫 notify()                 │
+└──────────────────────────────────────────────┘
+   Blocking 的喚醒協定（避免遺失喚醒）：
+     消費者：sleeping_ = true → fence → 再檢查 ready() → 休眠
+     生產者：寫入佇列 → fence → 讀 sleeping_ → 為 true 才加鎖通知
+   非 Blocking 策略下 notify() 只有一次 fence 與 relaxed 讀取。
+*/
+class IdleWaiter {
+public:
+    static constexpr int SPIN_LIMIT = 256;
+    static constexpr std::chrono::milliseconds MAX_SLEEP{10};   // 休眠上限，保險用
+
+    explicit IdleWaiter(WaitStrategy strategy = WaitStrategy::Blocking) : strategy_(strategy) {}
+
+    void setStrategy(WaitStrategy strategy) noexcept { strategy_ = strategy; }
+    WaitStrategy getStrategy() const noexcept { return strategy_; }
+
+    template <typename Ready>
+    void wait(Ready&& ready) {
+        switch (strategy_) {
+            case WaitStrategy::BusySpin:
+                while (!ready()) {
+                    cpuRelax();
+                }
+                return;
+
+            case WaitStrategy::SpinYield:
+                for (int i = 0; !ready(); ++i) {
+                    if (i < SPIN_LIMIT) {
+                        cpuRelax();
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                return;
+
+            case WaitStrategy::Blocking:
+                for (int i = 0; i < SPIN_LIMIT; ++i) {
+                    if (ready()) {
+                        return;
+                    }
+                    cpuRelax();
+                }
+                sleeping_.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    cv_.wait_for(lock, MAX_SLEEP, ready);
+                }
+                sleeping_.store(false, std::memory_order_relaxed);
+                return;
+        }
+    }
+
+    // 生產者在寫入後呼叫
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_one();
+        }
+    }
+
+    // 停止時使用：無論狀態一律喚醒
+    void wakeAll() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cv_.notify_all();
+    }
+
+private:
+    WaitStrategy strategy_;
+    std::atomic<bool> sleeping_{false};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+} // namespace core
+} // namespace mts
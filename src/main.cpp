@@ -272,18 +272,116 @@ int main(int argc, char* argv[]) {
     
     // 解析命令列參數
     int port = 8080;
+    size_t reactorThreads = 2;
+    size_t matchingThreads = 1;
+    size_t batchSize = 64;
+    mts::core::WaitStrategy waitStrategy = mts::core::WaitStrategy::Blocking;
+    std::string traceFile;
+    std::string journalDirectory;
+    long snapshotInterval = 60;
+    mts::core::OutboundConfig outboundConfig;
+    size_t sessionThreads = 1;
+    mts::core::CpuList decodeCpus, sessionCpus, matchingCpus, encodeCpus, ioCpus;
     bool enableTestClient = false;
     
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
         if (arg == "--port" && i + 1 < argc) {
             port = std::stoi(argv[++i]);
+        } else if (arg == "--reactor-threads" && i + 1 < argc) {
+            reactorThreads = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--matching-threads" && i + 1 < argc) {
+            matchingThreads = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--batch-size" && i + 1 < argc) {
+            batchSize = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--wait-strategy" && i + 1 < argc) {
+            try {
+                waitStrategy = mts::core::stringToWaitStrategy(argv[++i]);
+            } catch (const std::invalid_argument& e) {
+                std::cerr << "❌ " << e.what() << " (expected busy-spin, spin-yield or blocking)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--price-scale" && i + 1 < argc) {
+            // SYMBOL=DECIMALS，例如 EURUSD=4
+            std::string spec = argv[++i];
+            size_t eq = spec.find('=');
+            if (eq == std::string::npos || eq == 0) {
+                std::cerr << "❌ Invalid --price-scale: " << spec << " (expected SYMBOL=DECIMALS)" << std::endl;
+                return 1;
+            }
+            // 只接受單一位數字且不超過 MAX_DECIMALS，避免 stoul 截斷成 uint8_t 後悄悄套用錯誤精度
+            std::string decimals = spec.substr(eq + 1);
+            if (decimals.size() != 1 || decimals[0] < '0' ||
+                decimals[0] > static_cast<char>('0' + mts::core::PriceScale::MAX_DECIMALS)) {
+                std::cerr << "❌ Invalid --price-scale decimals: " << spec << " (expected 0-"
+                          << static_cast<int>(mts::core::PriceScale::MAX_DECIMALS) << ")" << std::endl;
+                return 1;
+            }
+            mts::core::PriceScaleRegistry::set(spec.substr(0, eq),
+                mts::core::PriceScale(static_cast<uint8_t>(decimals[0] - '0')));
+        } else if (arg == "--log-file" && i + 1 < argc) {
+            std::string logFile = argv[++i];
+            if (!mts::core::AsyncLogger::instance().setOutputFile(logFile)) {
+                std::cerr << "❌ Cannot open log file: " << logFile << std::endl;
+                return 1;
+            }
+        } else if (arg == "--trace" && i + 1 < argc) {
+            traceFile = argv[++i];
+        } else if (arg == "--journal" && i + 1 < argc) {
+            journalDirectory = argv[++i];
+        } else if (arg == "--snapshot-interval" && i + 1 < argc) {
+            snapshotInterval = std::stol(argv[++i]);
+        } else if (arg == "--io-threads" && i + 1 < argc) {
+            outboundConfig.ioThreadCount = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--outbound-queue" && i + 1 < argc) {
+            outboundConfig.sessionQueueLimit = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--outbound-overflow" && i + 1 < argc) {
+            try {
+                outboundConfig.overflowPolicy = mts::core::stringToOverflowPolicy(argv[++i]);
+            } catch (const std::invalid_argument& e) {
+                std::cerr << "❌ " << e.what() << " (expected disconnect or block)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--session-threads" && i + 1 < argc) {
+            sessionThreads = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if ((arg == "--cpus-decode" || arg == "--cpus-session" || arg == "--cpus-match" ||
+                    arg == "--cpus-encode" || arg == "--cpus-io") && i + 1 < argc) {
+            mts::core::CpuList cpus;
+            try {
+                cpus = mts::core::parseCpuList(argv[++i]);
+            } catch (const std::invalid_argument& e) {
+                std::cerr << "❌ " << e.what() << " (expected e.g. 2,3 or 4-7)" << std::endl;
+                return 1;
+            }
+            if (arg == "--cpus-decode") decodeCpus = cpus;
+            else if (arg == "--cpus-session") sessionCpus = cpus;
+            else if (arg == "--cpus-match") matchingCpus = cpus;
+            else if (arg == "--cpus-encode") encodeCpus = cpus;
+            else ioCpus = cpus;
         } else if (arg == "--test") {
             enableTestClient = true;
         } else if (arg == "--help") {
             std::cout << "Usage: " << argv[0] << " [options]" << std::endl;
             std::cout << "Options:" << std::endl;
             std::cout << "  --port <port>    Set server port (default: 8080)" << std::endl;
+            std::cout << "  --reactor-threads <n>  Network reactor threads (Linux epoll, default: 2)" << std::endl;
+            std::cout << "  --matching-threads <n>  Matching engine shards, one thread each (default: 1)" << std::endl;
+            std::cout << "  --batch-size <n>  Max messages drained per matching wakeup (default: 64)" << std::endl;
+            std::cout << "  --wait-strategy <busy-spin|spin-yield|blocking>  Matching thread idle strategy (default: blocking)" << std::endl;
+            std::cout << "  --price-scale <SYMBOL=DECIMALS>  Price decimals for a symbol (default: 2, max: 4)" << std::endl;
+            std::cout << "  --log-file <file>  Write log records to a file instead of stdout/stderr" << std::endl;
+            std::cout << "  --trace <file>   Record per-order lifecycle timestamps (inspect with trace_dump)" << std::endl;
+            std::cout << "  --journal <dir>  Write-ahead journal of accepted engine input (mmap segments); restart recovers from it" << std::endl;
+            std::cout << "  --snapshot-interval <sec>  Order book snapshot interval with --journal (default: 60, 0: off)" << std::endl;
+            std::cout << "  --io-threads <n>  Threads writing execution reports to client sockets (default: 1)" << std::endl;
+            std::cout << "  --outbound-queue <n>  Max unsent messages queued per session (default: 8192)" << std::endl;
+            std::cout << "  --outbound-overflow <disconnect|block>  Policy when a session queue is full (default: disconnect)" << std::endl;
+            std::cout << "  --session-threads <n>  Threads parsing, validating and submitting orders (default: 1)" << std::endl;
+            std::cout << "  --cpus-decode <list>  Pin reactor (recv + framing) threads, e.g. 2,3 or 2-3" << std::endl;
+            std::cout << "  --cpus-session <list>  Pin session / risk stage threads" << std::endl;
+            std::cout << "  --cpus-match <list>  Pin matching shard threads" << std::endl;
+            std::cout << "  --cpus-encode <cpu>  Pin the execution report encoder thread" << std::endl;
+            std::cout << "  --cpus-io <list>  Pin outbound socket writer threads" << std::endl;
             std::cout << "  --test           Enable test client simulation" << std::endl;
             std::cout << "  --help           Show this help message" << std::endl;
             return 0;
@@ -297,6 +395,22 @@ int main(int argc, char* argv[]) {
         
         // 建立交易系統
         g_tradingSystem = std::make_unique<TradingSystem>(port);
+        g_tradingSystem->setReactorThreadCount(reactorThreads);
+        g_tradingSystem->setWaitStrategy(waitStrategy);
+        g_tradingSystem->setMatchingThreadCount(matchingThreads);
+        g_tradingSystem->setBatchSize(batchSize);
+        g_tradingSystem->setTraceFile(traceFile);
+        g_tradingSystem->setJournalDirectory(journalDirectory);
+        g_tradingSystem->setSnapshotInterval(std::chrono::seconds(snapshotInterval));
+        g_tradingSystem->setOutboundIoThreadCount(outboundConfig.ioThreadCount);
+        g_tradingSystem->setOutboundQueueLimit(outboundConfig.sessionQueueLimit);
+        g_tradingSystem->setOutboundOverflowPolicy(outboundConfig.overflowPolicy);
+        g_tradingSystem->setSessionThreadCount(sessionThreads);
+        g_tradingSystem->setDecodeCpus(decodeCpus);
+        g_tradingSystem->setSessionCpus(sessionCpus);
+        g_tradingSystem->setMatchingCpus(matchingCpus);
+        g_tradingSystem->setEncodeCpus(encodeCpus);
+        g_tradingSystem->setOutboundIoCpus(ioCpus);
         
         // 啟動系統
         if (!g_tradingSystem->start()) {
@@ -0,0 +1,133 @@
+// epoll_reactor.cpp
+#include "epoll_reactor.h"
+
+#if defined(ENABLE_EPOLL_REACTOR) && defined(__linux__)
+
+#include "../core/async_logger.h"
+#include "../core/thread_affinity.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <cstring>
+#include <iostream>
+
+namespace mts::tcp_server {
+
+    EpollReactor::EpollReactor(size_t index, EventHandler handler, int cpu)
+        : index_(index), handler_(std::move(handler)), cpu_(cpu) {}
+
+    EpollReactor::~EpollReactor() {
+        stop();
+    }
+
+    // ===== 生命週期 =====
+    bool EpollReactor::start() {
+        epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ < 0) {
+            last_error_ = "epoll_create1 failed: " + std::string(std::strerror(errno));
+            return false;
+        }
+
+        wakeup_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeup_fd_ < 0) {
+            last_error_ = "eventfd failed: " + std::string(std::strerror(errno));
+            ::close(epoll_fd_);
+            epoll_fd_ = -1;
+            return false;
+        }
+
+        // wakeup fd 以 nullptr 作為上下文辨識
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr;
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &ev) != 0) {
+            last_error_ = "epoll_ctl(wakeup) failed: " + std::string(std::strerror(errno));
+            ::close(wakeup_fd_);
+            ::close(epoll_fd_);
+            wakeup_fd_ = epoll_fd_ = -1;
+            return false;
+        }
+
+        running_ = true;
+        thread_ = std::thread(&EpollReactor::run, this);
+        return true;
+    }
+
+    void EpollReactor::stop() {
+        if (running_.exchange(false)) {
+            uint64_t one = 1;
+            [[maybe_unused]] ssize_t n = ::write(wakeup_fd_, &one, sizeof(one));
+        }
+
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+
+        if (wakeup_fd_ >= 0) {
+            ::close(wakeup_fd_);
+            wakeup_fd_ = -1;
+        }
+        if (epoll_fd_ >= 0) {
+            ::close(epoll_fd_);
+            epoll_fd_ = -1;
+        }
+    }
+
+    // ===== 註冊管理 =====
+    bool EpollReactor::add(SOCKET socket, void* context, uint32_t events) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.ptr = context;
+        return ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, socket, &ev) == 0;
+    }
+
+    bool EpollReactor::modify(SOCKET socket, void* context, uint32_t events) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.ptr = context;
+        return ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, socket, &ev) == 0;
+    }
+
+    void EpollReactor::remove(SOCKET socket) {
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, socket, nullptr);
+    }
+
+    // ===== 事件迴圈 =====
+    void EpollReactor::run() {
+        MTS_LOG_INFO("🔄 Reactor {} started", index_);
+        mts::core::pinCurrentThread(cpu_, "Reactor");
+
+        epoll_event events[MAX_EVENTS];
+
+        while (running_.load(std::memory_order_acquire)) {
+            int count = ::epoll_wait(epoll_fd_, events, MAX_EVENTS, -1);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                MTS_LOG_ERROR("❌ epoll_wait failed on reactor {}: {}", index_, std::strerror(errno));
+                break;
+            }
+
+            for (int i = 0; i < count; ++i) {
+                void* context = events[i].data.ptr;
+                if (context == nullptr) {
+                    // stop() 喚醒
+                    uint64_t value;
+                    [[maybe_unused]] ssize_t n = ::read(wakeup_fd_, &value, sizeof(value));
+                    continue;
+                }
+
+                try {
+                    handler_(context, events[i].events);
+                } catch (const std::exception& e) {
+                    MTS_LOG_ERROR("❌ Reactor {} handler error: {}", index_, e.what());
+                }
+            }
+        }
+
+        MTS_LOG_INFO("🔄 Reactor {} ended", index_);
+    }
+
+} // namespace mts::tcp_server
+
+#endif // ENABLE_EPOLL_REACTOR && __linux__
@@ -0,0 +1,67 @@
+// epoll_reactor.h
+#pragma once
+
+#if defined(ENABLE_EPOLL_REACTOR) && defined(__linux__)
+
+#include "posix_socket.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+/*
+┌──────────────────────────────────────────────┐
+│                 EpollReactor                 │
+├──────────────────────────────────────────────┤
+│ • 一個 epoll 實例 + 一條執行緒                 │
+│ • Edge-triggered，事件只通知一次               │
+│ • eventfd 用於 stop() 喚醒                     │
+└──────────────────────────────────────────────┘
+   TCPServer 持有 N 個 reactor，連線以 round-robin 分配，
+   每條連線之後只會在它所屬的 reactor 執行緒上被存取。
+*/
+namespace mts::tcp_server {
+
+class EpollReactor {
+public:
+    // (連線上下文, epoll 事件遮罩)
+    using EventHandler = std::function<void(void* context, uint32_t events)>;
+
+    // cpu >= 0 時事件迴圈執行緒綁到該 CPU
+    EpollReactor(size_t index, EventHandler handler, int cpu = -1);
+    ~EpollReactor();
+
+    EpollReactor(const EpollReactor&) = delete;
+    EpollReactor& operator=(const EpollReactor&) = delete;
+
+    // ===== 生命週期 =====
+    bool start();
+    void stop();
+
+    // ===== 註冊管理（可從任意執行緒呼叫）=====
+    bool add(SOCKET socket, void* context, uint32_t events);
+    bool modify(SOCKET socket, void* context, uint32_t events);
+    void remove(SOCKET socket);
+
+    size_t getIndex() const { return index_; }
+    const std::string& getLastError() const { return last_error_; }
+
+private:
+    static constexpr int MAX_EVENTS = 256;
+
+    size_t index_;
+    EventHandler handler_;
+    int cpu_;
+    int epoll_fd_ = -1;
+    int wakeup_fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::string last_error_;
+
+    void run();
+};
+
+} // namespace mts::tcp_server
+
+#endif // ENABLE_EPOLL_REACTOR && __linux__
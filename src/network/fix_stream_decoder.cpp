@@ -0,0 +1,208 @@
+// fix_stream_decoder.cpp
+#include "fix_stream_decoder.h"
+#include <algorithm>
+#include <cstring>
+
+namespace mts::tcp_server {
+
+    namespace {
+        // 欄位分隔符：標準 SOH，或測試/文字檔使用的 '|'
+        inline bool is_delimiter(char c) {
+            return c == '\x01' || c == '|';
+        }
+
+        inline bool is_line_break(char c) {
+            return c == '\r' || c == '\n';
+        }
+
+        inline bool is_digit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        constexpr size_t MAX_BEGIN_STRING_LENGTH = 32;   // "8=FIXT.1.1" 之類，保留餘裕
+        constexpr size_t MAX_BODY_LENGTH_DIGITS = 7;
+        constexpr size_t TRAILER_LENGTH = 7;             // "10=" + 3 位數 + 分隔符
+    }
+
+    FixStreamDecoder::FixStreamDecoder(size_t initial_size, size_t max_message_size)
+        : buffer_(std::max<size_t>(initial_size, 256))
+        , max_message_size_(max_message_size) {}
+
+    // ===== 寫入端 =====
+
+    FixStreamDecoder::WriteSpace FixStreamDecoder::prepare(size_t min_space) {
+        if (read_pos_ == write_pos_) {
+            read_pos_ = write_pos_ = 0;
+        }
+
+        if (buffer_.size() - write_pos_ < min_space && read_pos_ > 0) {
+            // 把尚未處理的尾段搬回開頭
+            size_t pending = write_pos_ - read_pos_;
+            std::memmove(buffer_.data(), buffer_.data() + read_pos_, pending);
+            read_pos_ = 0;
+            write_pos_ = pending;
+        }
+
+        if (buffer_.size() - write_pos_ < min_space) {
+            buffer_.resize(std::max(buffer_.size() * 2, write_pos_ + min_space));
+        }
+
+        return WriteSpace{buffer_.data() + write_pos_, buffer_.size() - write_pos_};
+    }
+
+    void FixStreamDecoder::commit(size_t bytes) {
+        write_pos_ = std::min(write_pos_ + bytes, buffer_.size());
+    }
+
+    void FixStreamDecoder::reset() {
+        read_pos_ = write_pos_ = 0;
+        resyncing_ = false;
+    }
+
+    // ===== 讀取端 =====
+
+    bool FixStreamDecoder::next(std::string_view& frame) {
+        while (true) {
+            size_t start = find_begin_string(read_pos_);
+            if (start == write_pos_) {
+                return false;
+            }
+
+            size_t frame_length = 0;
+            switch (parse_frame(start, frame_length)) {
+                case ParseResult::Complete:
+                    frame = std::string_view(buffer_.data() + start, frame_length);
+                    read_pos_ = start + frame_length;
+                    resyncing_ = false;
+                    stats_.frames++;
+                    return true;
+
+                case ParseResult::NeedMore:
+                    return false;
+
+                case ParseResult::Invalid:
+                    // 跳過這個 "8=" 並往後找下一個
+                    discard(start, start + 2);
+                    read_pos_ = start + 2;
+                    break;
+            }
+        }
+    }
+
+    // 從 from 開始尋找 "8="，之前的位元組全部丟棄；找不到時回傳 write_pos_
+    size_t FixStreamDecoder::find_begin_string(size_t from) {
+        const char* data = buffer_.data();
+        size_t pos = from;
+
+        while (pos < write_pos_) {
+            const void* hit = std::memchr(data + pos, '8', write_pos_ - pos);
+            if (hit == nullptr) {
+                break;
+            }
+            pos = static_cast<size_t>(static_cast<const char*>(hit) - data);
+
+            if (pos + 1 == write_pos_) {
+                // '8' 落在緩衝區尾端，保留等待下一次 recv
+                discard(from, pos);
+                read_pos_ = pos;
+                return write_pos_;
+            }
+            if (data[pos + 1] == '=' && (pos == 0 || !is_digit(data[pos - 1]))) {
+                discard(from, pos);
+                read_pos_ = pos;
+                return pos;
+            }
+            ++pos;
+        }
+
+        discard(from, write_pos_);
+        read_pos_ = write_pos_;
+        return write_pos_;
+    }
+
+    FixStreamDecoder::ParseResult FixStreamDecoder::parse_frame(size_t start, size_t& frame_length) const {
+        const char* data = buffer_.data();
+        const size_t end = write_pos_;
+
+        // 8=BeginString<SOH>
+        size_t pos = start + 2;
+        while (pos < end && !is_delimiter(data[pos])) {
+            if (is_line_break(data[pos]) || pos - start > MAX_BEGIN_STRING_LENGTH) {
+                return ParseResult::Invalid;
+            }
+            ++pos;
+        }
+        if (pos >= end) {
+            return ParseResult::NeedMore;
+        }
+        ++pos;
+
+        // 9=BodyLength<SOH>
+        if (end - pos < 2) {
+            return ParseResult::NeedMore;
+        }
+        if (data[pos] != '9' || data[pos + 1] != '=') {
+            return ParseResult::Invalid;
+        }
+        pos += 2;
+
+        size_t body_length = 0;
+        size_t digits = 0;
+        while (pos < end && is_digit(data[pos])) {
+            body_length = body_length * 10 + static_cast<size_t>(data[pos] - '0');
+            if (++digits > MAX_BODY_LENGTH_DIGITS) {
+                return ParseResult::Invalid;
+            }
+            ++pos;
+        }
+        if (pos >= end) {
+            return ParseResult::NeedMore;
+        }
+        if (digits == 0 || !is_delimiter(data[pos]) || body_length > max_message_size_) {
+            return ParseResult::Invalid;
+        }
+        ++pos;
+
+        // Body + 10=XXX<SOH>
+        size_t trailer = pos + body_length;
+        if (end - pos < body_length + TRAILER_LENGTH) {
+            return ParseResult::NeedMore;
+        }
+        if (data[trailer] != '1' || data[trailer + 1] != '0' || data[trailer + 2] != '=' ||
+            !is_digit(data[trailer + 3]) || !is_digit(data[trailer + 4]) || !is_digit(data[trailer + 5])) {
+            return ParseResult::Invalid;
+        }
+
+        char terminator = data[trailer + 6];
+        if (is_delimiter(terminator)) {
+            frame_length = trailer + TRAILER_LENGTH - start;
+        } else if (is_line_break(terminator)) {
+            // 省略最後分隔符的文字格式，行尾交給下一輪略過
+            frame_length = trailer + TRAILER_LENGTH - 1 - start;
+        } else {
+            return ParseResult::Invalid;
+        }
+        return ParseResult::Complete;
+    }
+
+    void FixStreamDecoder::discard(size_t from, size_t to) {
+        const char* data = buffer_.data();
+        size_t garbage = 0;
+        for (size_t i = from; i < to; ++i) {
+            if (!is_line_break(data[i])) {
+                ++garbage;
+            }
+        }
+        if (garbage == 0) {
+            return;
+        }
+
+        // 同一段連續的垃圾只計一次錯誤
+        stats_.discarded_bytes += garbage;
+        if (!resyncing_) {
+            stats_.framing_errors++;
+            resyncing_ = true;
+        }
+    }
+
+} // namespace mts::tcp_server
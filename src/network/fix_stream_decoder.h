@@ -0,0 +1,80 @@
+// fix_stream_decoder.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/*
+┌──────────────────────────────────────────────┐
+│              FixStreamDecoder                │
+├──────────────────────────────────────────────┤
+│ • 依 8= / 9=BodyLength / 10= 切出完整訊息      │
+│ • recv 直接寫入內部緩衝區，不經過暫存陣列       │
+│ • 取出的訊息為指向緩衝區的 string_view          │
+│ • 格式錯誤時丟棄位元組並重新同步到下一個 8=      │
+└──────────────────────────────────────────────┘
+   每條連線一個 decoder。緩衝區以讀寫游標管理，空間不足時才
+   把未處理的尾段搬回開頭（compaction），因此訊息永遠是連續的，
+   不會像環狀緩衝區那樣被切成兩段。
+
+   使用方式：
+       auto space = decoder.prepare();
+       n = recv(socket, space.data, space.size, 0);
+       decoder.commit(n);
+       std::string_view frame;
+       while (decoder.next(frame)) { ... }
+
+   next() 回傳的 view 只在下一次 prepare() 之前有效。
+*/
+namespace mts::tcp_server {
+
+class FixStreamDecoder {
+public:
+    struct WriteSpace {
+        char* data;
+        size_t size;
+    };
+
+    struct Statistics {
+        uint64_t frames = 0;            // 成功切出的訊息數
+        uint64_t framing_errors = 0;    // 重新同步的次數
+        uint64_t discarded_bytes = 0;   // 因格式錯誤而丟棄的位元組（不含行尾 \r\n）
+    };
+
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 16 * 1024;
+    static constexpr size_t DEFAULT_MAX_MESSAGE_SIZE = 64 * 1024;
+
+    explicit FixStreamDecoder(size_t initial_size = DEFAULT_BUFFER_SIZE,
+                              size_t max_message_size = DEFAULT_MAX_MESSAGE_SIZE);
+
+    // ===== 寫入端（recv）=====
+    // 取得至少 min_space 位元組的可寫空間，必要時 compaction 或擴充
+    WriteSpace prepare(size_t min_space = 4096);
+    void commit(size_t bytes);
+
+    // ===== 讀取端（分幀）=====
+    // 取出下一則完整訊息；資料不足時回傳 false
+    bool next(std::string_view& frame);
+
+    // ===== 狀態查詢 =====
+    size_t buffered() const { return write_pos_ - read_pos_; }
+    const Statistics& getStatistics() const { return stats_; }
+    void reset();
+
+private:
+    enum class ParseResult { Complete, NeedMore, Invalid };
+
+    std::vector<char> buffer_;
+    size_t read_pos_ = 0;
+    size_t write_pos_ = 0;
+    size_t max_message_size_;
+    bool resyncing_ = false;    // 正在略過一段連續的錯誤資料
+    Statistics stats_;
+
+    ParseResult parse_frame(size_t start, size_t& frame_length) const;
+    size_t find_begin_string(size_t from);
+    void discard(size_t from, size_t to);
+};
+
+} // namespace mts::tcp_server
@@ -0,0 +1,38 @@
+#pragma once
+// POSIX 對應 win_socket.h 的薄抽象層：讓 TCPServer 與測試客戶端在 Linux 上沿用 Winsock 的命名
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+
+using SOCKET = int;
+
+#ifndef INVALID_SOCKET
+#define INVALID_SOCKET (-1)
+#endif
+
+#ifndef SOCKET_ERROR
+#define SOCKET_ERROR (-1)
+#endif
+
+inline int closesocket(SOCKET s) {
+    return ::close(s);
+}
+
+inline int WSAGetLastError() {
+    return errno;
+}
+
+// 設定為非阻塞模式（epoll edge-triggered 必須）
+inline bool setSocketNonBlocking(SOCKET s) {
+    int flags = ::fcntl(s, F_GETFL, 0);
+    if (flags < 0) {
+        return false;
+    }
+    return ::fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+}
@@ -1,5 +1,7 @@
 // tcp_server.h
 #include "tcp_server.h"
+#include "../core/async_logger.h"
+#include "../core/order_trace.h"
 #include <iostream>
 #include <thread>
 #include <vector>
@@ -8,15 +10,101 @@
 #include <unordered_map>
 #include <mutex>
 #include <string>
+#include <algorithm>
+
+#ifdef MTS_EPOLL_REACTOR
+#include <sys/epoll.h>
+#include <sys/uio.h>
+#endif
 
 namespace mts::tcp_server {
 
+#ifndef _WIN32
+    // POSIX 上寫入已關閉的連線不應觸發 SIGPIPE
+    static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    static constexpr int SEND_FLAGS = 0;
+#endif
+
+    // 關閉雙向傳輸但保留 socket 編號：阻塞中的 recv / send 會返回，由讀取路徑清理
+    static int shutdown_socket(SOCKET socket) {
+#ifdef _WIN32
+        return ::shutdown(socket, SD_BOTH);
+#else
+        return ::shutdown(socket, SHUT_RDWR);
+#endif
+    }
+
+#ifdef MTS_EPOLL_REACTOR
+    // 一次 sendmsg 最多帶的 iovec 數（低於 IOV_MAX）
+    static constexpr size_t MAX_GATHER = 256;
+    // 輸出佇列中小訊息合併成的區塊大小
+    static constexpr size_t PENDING_CHUNK_SIZE = 64 * 1024;
+
+    // 非阻塞 gather 寫出：回傳寫出的位元組數，核心緩衝已滿時回傳 0，錯誤時回傳 -1
+    static ssize_t gather_send(SOCKET socket, iovec* iov, size_t count) {
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        while (true) {
+            ssize_t n = ::sendmsg(socket, &msg, SEND_FLAGS);
+            if (n >= 0) {
+                return n;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 0;
+            }
+            return -1;
+        }
+    }
+#else
+    // 阻塞 socket：send 可能只寫出一部分，迴圈直到寫完
+    static int send_all(SOCKET socket, const char* data, size_t length) {
+        size_t sent = 0;
+        while (sent < length) {
+            int n = send(socket, data + sent, static_cast<int>(length - sent), SEND_FLAGS);
+            if (n == SOCKET_ERROR) {
+                return SOCKET_ERROR;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return static_cast<int>(sent);
+    }
+#endif
+
     TCPServer::TCPServer(int port) : port_(port) {
-        std::cout << "🌐 Enhanced TCP Server created on port " << port << std::endl;
+        MTS_LOG_INFO("🌐 Enhanced TCP Server created on port {}", port);
     }
     TCPServer::~TCPServer() {
         stop();
     }
+
+    void TCPServer::setReactorThreadCount(size_t count) {
+#ifdef MTS_EPOLL_REACTOR
+        reactor_threads_ = std::max<size_t>(1, count);
+#else
+        (void)count;
+#endif
+    }
+
+    void TCPServer::setReactorCpus(const std::vector<int>& cpus) {
+#ifdef MTS_EPOLL_REACTOR
+        reactor_cpus_ = cpus;
+#else
+        (void)cpus;
+#endif
+    }
+
+    size_t TCPServer::getReactorThreadCount() const {
+#ifdef MTS_EPOLL_REACTOR
+        return reactor_threads_;
+#else
+        return 0;
+#endif
+    }
     
     // ===== 回調函式設定 =====
     void TCPServer::setConnectionCallback(ConnectionCallback callback) {
@@ -27,6 +115,10 @@ namespace mts::tcp_server {
         on_message_ = std::move(callback);
     }
 
+    void TCPServer::setFrameCallback(FrameCallback callback) {
+        on_frame_ = std::move(callback);
+    }
+
     void TCPServer::setDisconnectionCallback(DisconnectionCallback callback) {
         on_disconnection_ = std::move(callback);
     }
@@ -39,7 +131,7 @@ namespace mts::tcp_server {
     // ===== 服務器生命週期 =====
     bool TCPServer::start() {
         try {
-            std::cout << "🚀 Starting Enhanced TCP Server on port " << port_ << std::endl;
+            MTS_LOG_INFO("🚀 Starting Enhanced TCP Server on port {}", port_);
             
             struct addrinfo hints = {0};
             struct addrinfo* result = nullptr;
@@ -69,8 +161,8 @@ namespace mts::tcp_server {
             }
             
             // 設定 socket 選項
-            char opt = 1;
-            setsockopt(listen_socket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+            int opt = 1;
+            setsockopt(listen_socket_, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&opt), sizeof(opt));
             
             // Bind
             res = bind(listen_socket_, result->ai_addr, (int)result->ai_addrlen);
@@ -91,11 +183,40 @@ namespace mts::tcp_server {
             }
             
             running_ = true;
-            std::cout << "✅ Server listening on port " << port_ << std::endl;
+            MTS_LOG_INFO("✅ Server listening on port {}", port_);
+            
+#ifdef MTS_EPOLL_REACTOR
+            // 啟動 reactor 執行緒，監聽 socket 由第一個 reactor 負責 accept
+            setSocketNonBlocking(listen_socket_);
+            
+            for (size_t i = 0; i < reactor_threads_; ++i) {
+                int cpu = reactor_cpus_.empty() ? -1 : reactor_cpus_[i % reactor_cpus_.size()];
+                auto reactor = std::make_unique<EpollReactor>(i, [this](void* context, uint32_t events) {
+                    on_reactor_event(context, events);
+                }, cpu);
+                if (!reactor->start()) {
+                    notifyError("reactor start failed: " + reactor->getLastError());
+                    stop();
+                    return false;
+                }
+                reactors_.push_back(std::move(reactor));
+            }
             
+            listen_connection_.socket = listen_socket_;
+            listen_connection_.reactor = reactors_.front().get();
+            listen_connection_.listener = true;
+            if (!reactors_.front()->add(listen_socket_, &listen_connection_, EPOLLIN | EPOLLET)) {
+                notifyError("epoll_ctl(listen) failed: " + std::to_string(WSAGetLastError()));
+                stop();
+                return false;
+            }
+            
+            MTS_LOG_INFO("⚡ epoll reactor mode: {} thread(s)", reactor_threads_);
+#else
             // 啟動 accept 執行緒
             std::thread accept_thread(&TCPServer::accept_loop, this);
             accept_thread.detach();
+#endif
             
             return true;
             
@@ -110,24 +231,45 @@ namespace mts::tcp_server {
             return;
         }
         
-        std::cout << "🛑 Stopping Enhanced TCP Server..." << std::endl;
+        MTS_LOG_INFO("🛑 Stopping Enhanced TCP Server...");
         running_ = false;
         
+#ifdef MTS_EPOLL_REACTOR
+        // 先停止所有 reactor，之後連線只剩本執行緒存取
+        for (auto& reactor : reactors_) {
+            reactor->stop();
+        }
+        reactors_.clear();
+#endif
+        
         // 關閉監聽 socket
         if (listen_socket_ != INVALID_SOCKET) {
             closesocket(listen_socket_);
             listen_socket_ = INVALID_SOCKET;
         }
         
-        // 關閉所有客戶端連線
+#ifdef MTS_EPOLL_REACTOR
+        std::vector<SOCKET> remaining;
         {
             std::lock_guard<std::mutex> lock(clients_mutex_);
-            for (const auto& pair : active_clients_) {
-                closesocket(pair.second);
-                std::cout << "📴 Closed client connection: " << pair.first << std::endl;
+            for (const auto& pair : connections_) {
+                remaining.push_back(pair.first);
             }
-            active_clients_.clear();
         }
+        for (SOCKET socket : remaining) {
+            close_connection(socket);
+        }
+#else
+        // 只 shutdown 不關閉：各客戶端執行緒的 recv 隨即返回，由該執行緒清理並關閉 socket，
+        // 不會有兩處關閉同一個編號（關閉後編號可能已被重用）
+        {
+            std::lock_guard<std::mutex> lock(clients_mutex_);
+            for (const auto& pair : connections_) {
+                shutdown_socket(pair.first);
+                MTS_LOG_INFO("📴 Closing client connection: {}", pair.first);
+            }
+        }
+#endif
         
         // 等待所有客戶端執行緒結束
         for (auto& t : client_threads_) {
@@ -137,58 +279,159 @@ namespace mts::tcp_server {
         }
         client_threads_.clear();
         
-        std::cout << "✅ Enhanced TCP Server stopped" << std::endl;
+        MTS_LOG_INFO("✅ Enhanced TCP Server stopped");
     }
     
 
 
     // ===== 訊息發送 =====
-    bool TCPServer::sendMessage(int clientId, const std::string& message) {
-        std::lock_guard<std::mutex> lock(clients_mutex_);
+#ifdef _WIN32
+    bool TCPServer::sendMessage(int clientId, std::string_view message) {
+        SOCKET clientSocket = getClientSocket(clientId);
+        if (clientSocket == INVALID_SOCKET) {
+            MTS_LOG_WARN("❌ Client {} not found", clientId);
+            return false;
+        }
+        return sendMessages(clientSocket, &message, 1);
+    }
+#endif
+    
+    bool TCPServer::sendMessage(SOCKET clientSocket, std::string_view message) {
+        return sendMessages(clientSocket, &message, 1);
+    }
+
+    bool TCPServer::sendMessages(SOCKET clientSocket, const std::string_view* messages, size_t count) {
+        ConnectionPtr connection = getConnection(clientSocket);
+        if (!connection) {
+            MTS_LOG_WARN("❌ Socket {} not found", clientSocket);
+            return false;
+        }
+        return sendMessages(connection, messages, count);
+    }
+
+#ifdef MTS_EPOLL_REACTOR
+    bool TCPServer::sendMessages(const ConnectionPtr& connection, const std::string_view* messages, size_t count) {
+        if (!connection) {
+            return false;
+        }
+        const SOCKET clientSocket = connection->socket;
+        send_stats_.messages.fetch_add(count, std::memory_order_relaxed);
         
-        auto it = active_clients_.find(clientId);
-        if (it == active_clients_.end()) {
-            std::cerr << "❌ Client " << clientId << " not found" << std::endl;
+        std::lock_guard<std::mutex> lock(connection->write_mutex);
+        if (connection->closed) {
             return false;
         }
         
-        try {
-            int result = send(it->second, message.c_str(), message.length(), 0);
-            if (result == SOCKET_ERROR) {
-                std::cerr << "❌ Send failed for client " << clientId << ": " << WSAGetLastError() << std::endl;
-                return false;
+        if (!connection->pending.empty()) {
+            // 已有積壓：排在後面保持順序，由 reactor 執行緒在可寫時一起寫出
+            enqueue_pending(*connection, messages, count, 0);
+        } else {
+            // index / offset：第一筆尚未寫完的訊息及其已寫出的位元組數
+            size_t index = 0;
+            size_t offset = 0;
+            while (index < count) {
+                iovec iov[MAX_GATHER];
+                size_t n = 0;
+                for (size_t i = index; i < count && n < MAX_GATHER; ++i, ++n) {
+                    size_t skip = (i == index) ? offset : 0;
+                    iov[n].iov_base = const_cast<char*>(messages[i].data() + skip);
+                    iov[n].iov_len = messages[i].size() - skip;
+                }
+                
+                ssize_t written = gather_send(clientSocket, iov, n);
+                send_stats_.write_calls.fetch_add(1, std::memory_order_relaxed);
+                if (written < 0) {
+                    MTS_LOG_ERROR("❌ Send failed for socket {}: {}", clientSocket, WSAGetLastError());
+                    return false;
+                }
+                if (written == 0) {
+                    break;
+                }
+                
+                size_t remaining = static_cast<size_t>(written);
+                while (index < count && remaining >= messages[index].size() - offset) {
+                    remaining -= messages[index].size() - offset;
+                    offset = 0;
+                    ++index;
+                }
+                offset += remaining;
             }
             
-            std::cout << "📤 Sent to client " << clientId << ": " << message.substr(0, 50) << "..." << std::endl;
-            return true;
-            
-        } catch (const std::exception& e) {
-            std::cerr << "❌ Send exception for client " << clientId << ": " << e.what() << std::endl;
+            if (index < count) {
+                send_stats_.would_block.fetch_add(1, std::memory_order_relaxed);
+                enqueue_pending(*connection, messages + index, count - index, offset);
+            }
+        }
+        
+        if (connection->pending_bytes > MAX_PENDING_BYTES) {
+            MTS_LOG_WARN("⚠️ Socket {} has {} unsent bytes, disconnecting slow client",
+                         clientSocket, connection->pending_bytes);
+            // 之後的寫出直接失敗，不再對這個 socket 累積；關閉由讀取路徑偵測 shutdown 後完成
+            connection->closed = true;
+            connection->pending.clear();
+            connection->pending_offset = 0;
+            connection->pending_bytes = 0;
+            shutdown_socket(clientSocket);
             return false;
         }
+        
+        if (!connection->pending.empty() && !connection->write_armed) {
+            set_write_interest(*connection, true);
+        }
+        
+        MTS_LOG_DEBUG("📤 Sent {} message(s) to socket {}", count, clientSocket);
+        return true;
     }
-    
-    bool TCPServer::sendMessage(SOCKET clientSocket, const std::string& message) {
-        std::lock_guard<std::mutex> lock(clients_mutex_);
+#else
+    bool TCPServer::sendMessages(const ConnectionPtr& connection, const std::string_view* messages, size_t count) {
+        if (!connection) {
+            return false;
+        }
+        const SOCKET clientSocket = connection->socket;
+        send_stats_.messages.fetch_add(count, std::memory_order_relaxed);
         
-        // 直接使用 socket 發送，避免重複鎖定
-        try {
-            int result = send(clientSocket, message.c_str(), message.length(), 0);
+        // 每連線一條執行緒的模式使用阻塞 socket，逐筆寫完；
+        // 只鎖這條連線，寫給慢客戶端時不會擋住其他連線的寫出與連線管理
+        std::lock_guard<std::mutex> lock(connection->write_mutex);
+        if (connection->closed) {
+            return false;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            int result = send_all(clientSocket, messages[i].data(), messages[i].length());
+            send_stats_.write_calls.fetch_add(1, std::memory_order_relaxed);
             if (result == SOCKET_ERROR) {
-                std::cerr << "❌ Send failed for socket " << clientSocket 
-                        << ": " << WSAGetLastError() << std::endl;
+                MTS_LOG_ERROR("❌ Send failed for socket {}: {}", clientSocket, WSAGetLastError());
                 return false;
             }
-            
-            std::cout << "📤 Sent to socket " << clientSocket << ": " 
-                    << message.substr(0, 50) << "..." << std::endl;
-            return true;
-            
-        } catch (const std::exception& e) {
-            std::cerr << "❌ Send exception for socket " << clientSocket 
-                    << ": " << e.what() << std::endl;
+        }
+        
+        MTS_LOG_DEBUG("📤 Sent {} message(s) to socket {}", count, clientSocket);
+        return true;
+    }
+#endif
+    
+    bool TCPServer::disconnectClient(SOCKET clientSocket) {
+        return disconnectClient(getConnection(clientSocket));
+    }
+    
+    bool TCPServer::disconnectClient(const ConnectionPtr& connection) {
+        if (!connection) {
             return false;
         }
+        const SOCKET clientSocket = connection->socket;
+        
+        // 與 cleanup_client 互斥：未標記關閉前 socket 編號必定仍屬於這條連線
+        std::lock_guard<std::mutex> lock(connection->write_mutex);
+        if (connection->closed) {
+            return false;
+        }
+        if (shutdown_socket(clientSocket) == SOCKET_ERROR) {
+            MTS_LOG_ERROR("❌ Shutdown failed for socket {}: {}", clientSocket, WSAGetLastError());
+            return false;
+        }
+        
+        MTS_LOG_INFO("🔌 Disconnecting socket {}", clientSocket);
+        return true;
     }
 
 
@@ -213,6 +456,12 @@ namespace mts::tcp_server {
     
 
 
+    TCPServer::ConnectionPtr TCPServer::getConnection(SOCKET clientSocket) {
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        auto it = connections_.find(clientSocket);
+        return it != connections_.end() ? it->second : nullptr;
+    }
+
     // 新增：根據 clientId 取得 socket
     SOCKET TCPServer::getClientSocket(int clientId) {
         std::lock_guard<std::mutex> lock(clients_mutex_); 
@@ -236,7 +485,7 @@ namespace mts::tcp_server {
     // ===== 網路處理 =====
 
     void TCPServer::accept_loop() {
-        std::cout << "🔄 Accept loop started" << std::endl;
+        MTS_LOG_INFO("🔄 Accept loop started");
         
         while (running_) {
             SOCKET client_socket = accept(listen_socket_, nullptr, nullptr);
@@ -249,128 +498,360 @@ namespace mts::tcp_server {
             }
             
             // 設定 TCP 選項...
-            char nodelay = 1;
-            setsockopt(client_socket, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+            int nodelay = 1;
+            setsockopt(client_socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&nodelay), sizeof(nodelay));
             
-            char keepalive = 1;
-            setsockopt(client_socket, SOL_SOCKET, SO_KEEPALIVE, &keepalive, sizeof(keepalive));
+            int keepalive = 1;
+            setsockopt(client_socket, SOL_SOCKET, SO_KEEPALIVE, reinterpret_cast<const char*>(&keepalive), sizeof(keepalive));
             
             // 🔧 修改：直接使用 Socket 編號，不再分配內部 Client ID
             // int client_id = next_client_id_.fetch_add(1);  // 刪除這行
             
+            auto connection = std::make_shared<Connection>();
+            connection->id = next_connection_id_.fetch_add(1);
+            connection->socket = client_socket;
+            
             // 註冊客戶端（使用 Socket 作為 Key）
             {
                 std::lock_guard<std::mutex> lock(clients_mutex_);
                 active_clients_[static_cast<int>(client_socket)] = client_socket;  // 🔧 修改
+                connections_[client_socket] = connection;
             }
             
-            std::cout << "📞 New client connected: Socket=" << client_socket << std::endl;  // 🔧 簡化日誌
+            MTS_LOG_INFO("📞 New client connected: Socket={} Connection={}", client_socket, connection->id);
             
             // 通知新連線
             if (on_connection_) {
                 try {
-                    on_connection_(client_socket);
+                    on_connection_(connection);
                 } catch (const std::exception& e) {
-                    std::cerr << "❌ Connection callback error: " << e.what() << std::endl;
+                    MTS_LOG_ERROR("❌ Connection callback error: {}", e.what());
                 }
             }
             
             // 建立客戶端處理執行緒（使用 Socket 作為識別）
-            client_threads_.emplace_back(&TCPServer::handle_client, this, 
-                                        static_cast<int>(client_socket), client_socket);  // 🔧 修改
+            client_threads_.emplace_back(&TCPServer::handle_client, this, std::move(connection));
         }
         
-        std::cout << "🔄 Accept loop ended" << std::endl;
+        MTS_LOG_INFO("🔄 Accept loop ended");
     }
 
-    void TCPServer::handle_client(int client_id, SOCKET client_socket) {
-        // 🔧 修改：client_id 現在就是 socket 編號
-        std::cout << "🔗 Client handler started for Socket=" << client_socket << std::endl;
+    void TCPServer::handle_client(ConnectionPtr connection) {
+        const SOCKET client_socket = connection->socket;
+        MTS_LOG_INFO("🔗 Client handler started for Socket={}", client_socket);
         
-        char buffer[4096];
-        std::string message_buffer;
+        FixStreamDecoder decoder;
         
         while (running_) {
-            int result = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
+            auto space = decoder.prepare();
+            int result = recv(client_socket, space.data, static_cast<int>(space.size), 0);
             
             if (result > 0) {
-                buffer[result] = '\0';
-                message_buffer += std::string(buffer, result);
-                
-                // 處理完整的訊息...
-                size_t pos = 0;
-                while ((pos = message_buffer.find('\n')) != std::string::npos || 
-                    (pos = message_buffer.find('\r')) != std::string::npos) {
-                    
-                    std::string complete_message = message_buffer.substr(0, pos);
-                    message_buffer.erase(0, pos + 1);
-                    
-                    if (!complete_message.empty()) {
-                        complete_message.erase(
-                            std::remove(complete_message.begin(), complete_message.end(), '\r'), 
-                            complete_message.end()
-                        );
-                        
-                        std::cout << "📨 Received from Socket " << client_socket << ": " << complete_message << std::endl;  // 🔧 修改
-                        
-                        if (on_message_) {
-                            try {
-                                on_message_(client_socket, complete_message);
-                            } catch (const std::exception& e) {
-                                std::cerr << "❌ Message callback error: " << e.what() << std::endl;
-                            }
-                        }
-                    }
-                }
-                
-                if (message_buffer.size() > 8192) {
-                    std::cout << "⚠️ Message buffer too large for Socket " << client_socket << ", clearing" << std::endl;  // 🔧 修改
-                    message_buffer.clear();
-                }
+                mts::core::OrderTracer::markPending(mts::core::TraceStage::Recv);
+                decoder.commit(static_cast<size_t>(result));
+                dispatch_frames(*connection, decoder);
                 
             } else if (result == 0) {
-                std::cout << "📴 Socket " << client_socket << " disconnected normally" << std::endl;  // 🔧 修改
+                MTS_LOG_INFO("📴 Socket {} disconnected normally", client_socket);  // 🔧 修改
                 break;
             } else {
-                std::cerr << "❌ recv failed for Socket " << client_socket << ": " << WSAGetLastError() << std::endl;  // 🔧 修改
+                MTS_LOG_ERROR("❌ recv failed for Socket {}: {}", client_socket, WSAGetLastError());  // 🔧 修改
                 break;
             }
         }
         
-        cleanup_client(client_id, client_socket);
+        cleanup_client(*connection);
     }
 
-    void TCPServer::cleanup_client(int client_id, SOCKET client_socket) {
-        std::cout << "🧹 Cleaning up Socket " << client_socket << std::endl;  // 🔧 修改
+    void TCPServer::cleanup_client(Connection& connection) {
+        const SOCKET client_socket = connection.socket;
+        MTS_LOG_INFO("🧹 Cleaning up Socket {}", client_socket);  // 🔧 修改
         
         // 從活躍客戶端列表中移除
         {
             std::lock_guard<std::mutex> lock(clients_mutex_);
-            active_clients_.erase(client_id);  // client_id 現在就是 socket 編號
+            active_clients_.erase(static_cast<int>(client_socket));
+            auto it = connections_.find(client_socket);
+            if (it != connections_.end() && it->second.get() == &connection) {
+                connections_.erase(it);
+            }
         }
         
-        closesocket(client_socket);
+        // 持有 ConnectionPtr 的發送端可能正要寫入：先標記關閉，之後不會再寫入這個 socket 編號
+        {
+            std::lock_guard<std::mutex> lock(connection.write_mutex);
+            connection.closed = true;
+#ifdef MTS_EPOLL_REACTOR
+            connection.pending.clear();
+            connection.pending_offset = 0;
+            connection.pending_bytes = 0;
+#endif
+        }
         
+        // 先通知再關閉：socket 編號關閉後可能立刻被新連線重用，
+        // 上層若以非同步方式處理斷線，舊連線的通知必須排在新連線之前
         if (on_disconnection_) {
             try {
-                on_disconnection_(client_socket);
+                on_disconnection_(connection.id);
             } catch (const std::exception& e) {
-                std::cerr << "❌ Disconnection callback error: " << e.what() << std::endl;
+                MTS_LOG_ERROR("❌ Disconnection callback error: {}", e.what());
             }
         }
         
-        std::cout << "✅ Socket " << client_socket << " cleanup completed" << std::endl;  // 🔧 修改
+        closesocket(client_socket);
+        
+        MTS_LOG_INFO("✅ Socket {} cleanup completed", client_socket);  // 🔧 修改
     }
     
+    void TCPServer::dispatch_frames(const Connection& connection, FixStreamDecoder& decoder) {
+        const uint64_t errors_before = decoder.getStatistics().framing_errors;
+        
+        std::string_view frame;
+        while (decoder.next(frame)) {
+            mts::core::OrderTracer::markPending(mts::core::TraceStage::Frame);
+            try {
+                if (on_frame_) {
+                    on_frame_(connection.id, frame);
+                } else if (on_message_) {
+                    on_message_(connection.id, std::string(frame));
+                }
+            } catch (const std::exception& e) {
+                MTS_LOG_ERROR("❌ Message callback error: {}", e.what());
+            }
+        }
+        
+        const auto& stats = decoder.getStatistics();
+        if (stats.framing_errors != errors_before) {
+            MTS_LOG_WARN("⚠️ Framing error on Socket {}, resynchronizing ({} bytes discarded so far)",
+                         connection.socket, stats.discarded_bytes);
+        }
+    }
+
+#ifdef MTS_EPOLL_REACTOR
+    // ===== Reactor 處理 =====
+
+    void TCPServer::on_reactor_event(void* context, uint32_t events) {
+        auto* connection = static_cast<Connection*>(context);
+        
+        if (connection->listener) {
+            accept_pending();
+            return;
+        }
+        
+        bool open = true;
+        if (events & EPOLLOUT) {
+            std::lock_guard<std::mutex> lock(connection->write_mutex);
+            if (!connection->closed && !flush_pending(*connection)) {
+                MTS_LOG_ERROR("❌ Send failed for Socket {}: {}", connection->socket, WSAGetLastError());
+                open = false;
+            }
+        }
+        
+        if (open && (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+            open = read_connection(*connection, events);
+        }
+        
+        if (!open) {
+            close_connection(connection->socket);
+        }
+    }
+
+    void TCPServer::accept_pending() {
+        // Edge-triggered：必須 accept 到 EAGAIN 為止
+        while (running_) {
+            SOCKET client_socket = ::accept(listen_socket_, nullptr, nullptr);
+            
+            if (client_socket == INVALID_SOCKET) {
+                int err = WSAGetLastError();
+                if (err == EINTR) {
+                    continue;
+                }
+                if (err != EAGAIN && err != EWOULDBLOCK && running_) {
+                    notifyError("accept failed: " + std::to_string(err));
+                }
+                return;
+            }
+            
+            setSocketNonBlocking(client_socket);
+            
+            int nodelay = 1;
+            setsockopt(client_socket, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+            
+            int keepalive = 1;
+            setsockopt(client_socket, SOL_SOCKET, SO_KEEPALIVE, &keepalive, sizeof(keepalive));
+            
+            auto connection = std::make_shared<Connection>();
+            connection->id = next_connection_id_.fetch_add(1);
+            connection->socket = client_socket;
+            connection->reactor = reactors_[next_reactor_.fetch_add(1) % reactors_.size()].get();
+            Connection* raw = connection.get();
+            
+            {
+                std::lock_guard<std::mutex> lock(clients_mutex_);
+                active_clients_[static_cast<int>(client_socket)] = client_socket;
+                connections_[client_socket] = connection;
+            }
+            
+            MTS_LOG_INFO("📞 New client connected: Socket={} Connection={} (reactor {})",
+                         client_socket, raw->id, raw->reactor->getIndex());
+            
+            // 先通知上層建立 Session，再讓 reactor 開始讀取
+            if (on_connection_) {
+                try {
+                    on_connection_(connection);
+                } catch (const std::exception& e) {
+                    MTS_LOG_ERROR("❌ Connection callback error: {}", e.what());
+                }
+            }
+            
+            if (!raw->reactor->add(client_socket, raw, EPOLLIN | EPOLLRDHUP | EPOLLET)) {
+                notifyError("epoll_ctl(client) failed: " + std::to_string(WSAGetLastError()));
+                close_connection(client_socket);
+            }
+        }
+    }
+
+    bool TCPServer::read_connection(Connection& connection, uint32_t events) {
+        bool open = true;
+        // 對端已關閉（資料與 FIN 可能在同一次事件中到達）：FIN 之後不會再有新的 edge，
+        // 必須讀到 recv 回傳 0 為止，否則連線永遠不會被清理
+        const bool hangup = (events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0;
+        
+        // recv 直接寫入 decoder 緩衝區，每次讀完立刻分幀。
+        // 讀到的量小於可寫空間代表核心緩衝已清空，之後再有資料會觸發新的 edge，
+        // 因此沒有 hangup 時每次喚醒只需一次 recv，不必再多呼叫一次等 EAGAIN。
+        while (true) {
+            auto space = connection.decoder.prepare();
+            ssize_t result = ::recv(connection.socket, space.data, space.size, 0);
+            
+            if (result > 0) {
+                mts::core::OrderTracer::markPending(mts::core::TraceStage::Recv);
+                connection.decoder.commit(static_cast<size_t>(result));
+                dispatch_frames(connection, connection.decoder);
+                if (static_cast<size_t>(result) < space.size && !hangup) {
+                    break;
+                }
+                continue;
+            }
+            
+            if (result == 0) {
+                MTS_LOG_INFO("📴 Socket {} disconnected normally", connection.socket);
+                open = false;
+                break;
+            }
+            
+            int err = WSAGetLastError();
+            if (err == EINTR) {
+                continue;
+            }
+            if (err != EAGAIN && err != EWOULDBLOCK) {
+                MTS_LOG_ERROR("❌ recv failed for Socket {}: {}", connection.socket, err);
+                open = false;
+            }
+            break;
+        }
+        
+        return open;
+    }
+
+    void TCPServer::close_connection(SOCKET client_socket) {
+        // 先從連線表取出，重複呼叫時第二次找不到即返回
+        ConnectionPtr connection;
+        {
+            std::lock_guard<std::mutex> lock(clients_mutex_);
+            auto it = connections_.find(client_socket);
+            if (it == connections_.end()) {
+                return;
+            }
+            connection = std::move(it->second);
+            connections_.erase(it);
+        }
+        
+        if (connection->reactor && !reactors_.empty()) {
+            connection->reactor->remove(client_socket);
+        }
+        
+        cleanup_client(*connection);
+    }
+
+    // ===== 連線輸出佇列 =====
+
+    void TCPServer::enqueue_pending(Connection& connection, const std::string_view* messages, size_t count, size_t offset) {
+        for (size_t i = 0; i < count; ++i) {
+            std::string_view data = messages[i].substr(i == 0 ? offset : 0);
+            if (data.empty()) {
+                continue;
+            }
+            // 小訊息接在最後一個區塊之後，續寫時的 iovec 數量維持很少
+            if (!connection.pending.empty() && connection.pending.back().size() + data.size() <= PENDING_CHUNK_SIZE) {
+                connection.pending.back().append(data);
+            } else {
+                connection.pending.emplace_back(data);
+            }
+            connection.pending_bytes += data.size();
+            send_stats_.queued_bytes.fetch_add(data.size(), std::memory_order_relaxed);
+        }
+    }
+
+    bool TCPServer::flush_pending(Connection& connection) {
+        while (!connection.pending.empty()) {
+            iovec iov[MAX_GATHER];
+            size_t n = 0;
+            for (auto it = connection.pending.begin(); it != connection.pending.end() && n < MAX_GATHER; ++it, ++n) {
+                size_t skip = (n == 0) ? connection.pending_offset : 0;
+                iov[n].iov_base = it->data() + skip;
+                iov[n].iov_len = it->size() - skip;
+            }
+            
+            ssize_t written = gather_send(connection.socket, iov, n);
+            send_stats_.write_calls.fetch_add(1, std::memory_order_relaxed);
+            if (written < 0) {
+                return false;
+            }
+            if (written == 0) {
+                return true;   // 仍不可寫，EPOLLOUT 維持註冊，等下一次 edge
+            }
+            
+            size_t remaining = static_cast<size_t>(written);
+            connection.pending_bytes -= remaining;
+            while (remaining > 0) {
+                size_t left = connection.pending.front().size() - connection.pending_offset;
+                if (remaining < left) {
+                    connection.pending_offset += remaining;
+                    break;
+                }
+                remaining -= left;
+                connection.pending.pop_front();
+                connection.pending_offset = 0;
+            }
+        }
+        
+        // 全部寫完：取消 EPOLLOUT，避免每次可寫都被喚醒
+        if (connection.write_armed) {
+            set_write_interest(connection, false);
+        }
+        return true;
+    }
+
+    void TCPServer::set_write_interest(Connection& connection, bool enabled) {
+        uint32_t events = EPOLLIN | EPOLLRDHUP | EPOLLET | (enabled ? EPOLLOUT : 0u);
+        if (connection.reactor && connection.reactor->modify(connection.socket, &connection, events)) {
+            connection.write_armed = enabled;
+        } else {
+            notifyError("epoll_ctl(modify) failed: " + std::to_string(WSAGetLastError()));
+        }
+    }
+#endif
+
     // ===== 工具方法 =====
     void TCPServer::notifyError(const std::string& error) {
-        std::cerr << "🚨 TCP Server Error: " << error << std::endl;
+        MTS_LOG_ERROR("🚨 TCP Server Error: {}", error);
         
         if (on_error_) {
             try {
                 on_error_(error);
             } catch (const std::exception& e) {
-                std::cerr << "❌ Error callback exception: " << e.what() << std::endl;
+                MTS_LOG_ERROR("❌ Error callback exception: {}", e.what());
             }
         }
     }
@@ -1,14 +1,28 @@
 // tcp_server.h
 #pragma once
+#ifdef _WIN32
 #include "win_socket.h"
+#else
+#include "posix_socket.h"
+#endif
+#include "epoll_reactor.h"
+#include "fix_stream_decoder.h"
 #include <iostream>
 #include <thread>
 #include <vector>
 #include <atomic>
 #include <functional>
 #include <unordered_map>
+#include <deque>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <memory>
+
+// Linux 上預設使用 epoll reactor，其餘平台維持每連線一條執行緒
+#if defined(ENABLE_EPOLL_REACTOR) && defined(__linux__)
+#define MTS_EPOLL_REACTOR 1
+#endif
 
 /*  
 ┌─────────────────┐
@@ -33,11 +47,51 @@ namespace mts::tcp_server {
     
 class TCPServer {
 public:
+    // socket 編號關閉後可能立刻被新連線重用；ConnectionId 在伺服器生命週期內不重複，
+    // 上層以它識別連線，不會把舊連線的事件或回報交給新連線
+    using ConnectionId = uint64_t;
+
+    // 每條連線的狀態。寫出端由 write_mutex 保護；closed 設定後 socket 即將（或已經）關閉，
+    // 編號可能被新連線重用，之後經此物件的寫出與斷線一律失敗。
+    // reactor 模式下讀取端（decoder）只由所屬 reactor 執行緒存取
+    struct Connection {
+        ConnectionId id = 0;
+        SOCKET socket = INVALID_SOCKET;
+        
+        std::mutex write_mutex;
+        bool closed = false;
+#ifdef MTS_EPOLL_REACTOR
+        EpollReactor* reactor = nullptr;
+        bool listener = false;
+        FixStreamDecoder decoder;
+        
+        std::deque<std::string> pending;   // 尚未寫出的位元組，小訊息合併成區塊
+        size_t pending_offset = 0;         // pending.front() 已寫出的位元組數
+        size_t pending_bytes = 0;
+        bool write_armed = false;          // 已註冊 EPOLLOUT，等待可寫
+#endif
+    };
+    // 上層可在連線期間持有，寫出與斷線直接透過它，不必每次到連線表查找
+    using ConnectionPtr = std::shared_ptr<Connection>;
+
     // 回調函式類型定義
-    using ConnectionCallback = std::function<void(SOCKET clientSocket)>;
-    using MessageCallback = std::function<void(SOCKET clientSocket, const std::string& message)>;
-    using DisconnectionCallback = std::function<void(SOCKET clientSocket)>;
+    // 連線建立時在 reactor / accept 執行緒上呼叫，此時 socket 尚未開始讀取，可安全保存 ConnectionPtr
+    using ConnectionCallback = std::function<void(const ConnectionPtr& connection)>;
+    using MessageCallback = std::function<void(ConnectionId connectionId, const std::string& message)>;
+    // 零複製版本：view 指向連線的接收緩衝區，只在回調期間有效
+    using FrameCallback = std::function<void(ConnectionId connectionId, std::string_view frame)>;
+    using DisconnectionCallback = std::function<void(ConnectionId connectionId)>;
     using ErrorCallback = std::function<void(const std::string& error)>;
+    
+    struct SendStatistics {
+        std::atomic<uint64_t> messages{0};       // sendMessage(s) 交付的訊息數
+        std::atomic<uint64_t> write_calls{0};    // 實際的 send / sendmsg 系統呼叫數
+        std::atomic<uint64_t> would_block{0};    // 核心緩衝已滿、改為排隊等待可寫的次數
+        std::atomic<uint64_t> queued_bytes{0};   // 曾進入連線輸出佇列的位元組數
+    };
+    
+    // 每條連線輸出佇列的上限：客戶端長時間不讀時主動斷線，不無限制累積
+    static constexpr size_t MAX_PENDING_BYTES = 16 * 1024 * 1024;
 
 private:
 
@@ -45,21 +99,40 @@ private:
     int port_;
     std::atomic<bool> running_{false};
     std::vector<std::thread> client_threads_;
-    
-    // 客戶端管理
+    std::atomic<ConnectionId> next_connection_id_{1};
+
+#ifdef MTS_EPOLL_REACTOR
+    size_t reactor_threads_ = 2;
+    std::vector<int> reactor_cpus_;   // reactor i 綁到 reactor_cpus_[i % size]，空表示不綁核
+    std::vector<std::unique_ptr<EpollReactor>> reactors_;
+    std::atomic<size_t> next_reactor_{0};
+    Connection listen_connection_;
+#endif
+    
+    // 客戶端管理：受 clients_mutex_ 保護，只在連線建立 / 關閉與以 socket 查找時持鎖
     std::unordered_map<int, SOCKET> active_clients_;
+    std::unordered_map<SOCKET, ConnectionPtr> connections_;
     std::mutex clients_mutex_;
     
     // 回調函式
     ConnectionCallback on_connection_;
     MessageCallback on_message_;
+    FrameCallback on_frame_;
     DisconnectionCallback on_disconnection_;
     ErrorCallback on_error_;
     
+    SendStatistics send_stats_;
+    
 public:
     explicit TCPServer(int port);
     ~TCPServer();
 
+    // reactor 執行緒數量（需在 start() 前設定；非 epoll 平台忽略）
+    void setReactorThreadCount(size_t count);
+    size_t getReactorThreadCount() const;
+    // reactor 執行緒綁定的 CPU，依序輪流分配（需在 start() 前設定；非 epoll 平台忽略）
+    void setReactorCpus(const std::vector<int>& cpus);
+
     // 根據 clientId 取得 socket
     SOCKET getClientSocket(int clientId) ;
     
@@ -70,6 +143,9 @@ public:
     void setConnectionCallback(ConnectionCallback callback) ;
 
     void setMessageCallback(MessageCallback callback) ;
+
+    // 設定後優先於 MessageCallback，訊息不再複製成 std::string
+    void setFrameCallback(FrameCallback callback) ;
     
     void setDisconnectionCallback(DisconnectionCallback callback) ;
     
@@ -81,9 +157,26 @@ public:
     void stop() ;
     
     // ===== 訊息發送 =====
-    bool sendMessage(int clientId, const std::string& message) ;
-    
-    bool sendMessage(SOCKET clientSocket, const std::string& message);
+#ifdef _WIN32
+    // POSIX 上 SOCKET 即 int，clientId 與 socket 相同，由下方多載處理
+    bool sendMessage(int clientId, std::string_view message) ;
+#endif
+    
+    bool sendMessage(SOCKET clientSocket, std::string_view message);
+    
+    // 多筆訊息依序寫出：epoll 模式下合併成一次 sendmsg（gather），寫不完的部分
+    // 放入連線的輸出佇列並註冊 EPOLLOUT，由 reactor 執行緒在可寫時續寫，呼叫端不會阻塞。
+    // 以 socket 呼叫時每次都要查連線表；持續寫出的呼叫端應保存 getConnection() 的結果
+    bool sendMessages(SOCKET clientSocket, const std::string_view* messages, size_t count);
+    bool sendMessages(const ConnectionPtr& connection, const std::string_view* messages, size_t count);
+    
+    // 主動斷線：shutdown 後由既有的讀取路徑偵測並觸發 DisconnectionCallback
+    bool disconnectClient(SOCKET clientSocket);
+    bool disconnectClient(const ConnectionPtr& connection);
+    
+    // 取得 socket 目前對應的連線；找不到時回傳 nullptr。
+    // 在 ConnectionCallback 中呼叫一定取得該次連線；其他時候 socket 編號可能已屬於新連線
+    ConnectionPtr getConnection(SOCKET clientSocket);
 
     // ===== 狀態查詢 =====
     bool isRunning() const ;
@@ -92,13 +185,31 @@ public:
     
     std::vector<int> getActiveClientIds() ;
     
+    const SendStatistics& getSendStatistics() const { return send_stats_; }
+    
 private:
     // ===== 網路處理 =====
     void accept_loop() ;
     
-    void handle_client(int client_id, SOCKET client_socket) ;
+    void handle_client(ConnectionPtr connection) ;
     
-    void cleanup_client(int client_id, SOCKET client_socket) ;
+    // 標記連線關閉、通知上層後關閉 socket
+    void cleanup_client(Connection& connection) ;
+
+    // 依 BodyLength 切出緩衝區內所有完整訊息並分發
+    void dispatch_frames(const Connection& connection, FixStreamDecoder& decoder) ;
+
+#ifdef MTS_EPOLL_REACTOR
+    // ===== Reactor 處理 =====
+    void on_reactor_event(void* context, uint32_t events) ;
+    void accept_pending() ;
+    bool read_connection(Connection& connection, uint32_t events) ;
+    void close_connection(SOCKET client_socket) ;
+    // 以下需持有 connection.write_mutex
+    void enqueue_pending(Connection& connection, const std::string_view* messages, size_t count, size_t offset) ;
+    bool flush_pending(Connection& connection) ;
+    void set_write_interest(Connection& connection, bool enabled) ;
+#endif
     
     // ===== 工具方法 =====
     void notifyError(const std::string& error) ;
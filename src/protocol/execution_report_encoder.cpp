@@ -0,0 +1,203 @@
+#include "execution_report_encoder.h"
+#include "fix_message.h"
+#include <charconv>
+#include <cstring>
+#include <ctime>
+
+namespace mts::protocol {
+
+namespace {
+
+    constexpr char SOH = FixMessage::SOH;
+
+    // ===== 預先編好的標頭與 tag 前綴 =====
+    constexpr std::string_view HEADER_PREFIX = "8=FIX.4.2\x01" "9=";
+    constexpr std::string_view MSG_TYPE      = "35=8\x01";
+    constexpr std::string_view TAG_CL_ORD_ID = "11=";
+    constexpr std::string_view TAG_CUM_QTY   = "14=";
+    constexpr std::string_view TAG_EXEC_ID   = "17=";
+    constexpr std::string_view TAG_LAST_PX   = "31=";
+    constexpr std::string_view TAG_LAST_QTY  = "32=";
+    constexpr std::string_view TAG_SEQ_NUM   = "34=";
+    constexpr std::string_view TAG_ORDER_QTY = "38=";
+    constexpr std::string_view TAG_ORD_STATUS = "39=";
+    constexpr std::string_view TAG_PRICE     = "44=";
+    constexpr std::string_view TAG_SENDING_TIME = "52=";
+    constexpr std::string_view TAG_SIDE      = "54=";
+    constexpr std::string_view TAG_SYMBOL    = "55=";
+    constexpr std::string_view TAG_TEXT      = "58=";
+    constexpr std::string_view TAG_TRANSACT_TIME = "60=";
+    constexpr std::string_view TAG_EXEC_TYPE = "150=";
+    constexpr std::string_view TAG_LEAVES_QTY = "151=";
+    constexpr std::string_view TAG_CHECKSUM  = "10=";
+
+    // body 起點：標頭前綴 + 最大位數 + SOH
+    constexpr size_t BODY_OFFSET = HEADER_PREFIX.size() + ExecutionReportEncoder::MAX_BODY_LENGTH_DIGITS + 1;
+    constexpr size_t TRAILER_SIZE = 7;                 // "10=XXX\x01"
+    constexpr size_t TIMESTAMP_SECONDS_SIZE = 17;      // YYYYMMDD-HH:MM:SS
+    constexpr size_t FIXED_BODY_BOUND = 320;           // 固定欄位（tag、數字、時間）上限
+
+    inline void write2(char* out, int value) {
+        out[0] = static_cast<char>('0' + value / 10);
+        out[1] = static_cast<char>('0' + value % 10);
+    }
+
+    // YYYYMMDD-HH:MM:SS；同一秒內重複使用上次的結果，避免每則訊息都呼叫 gmtime
+    const char* secondsTimestamp(std::time_t seconds) {
+        thread_local std::time_t cachedSecond = -1;
+        thread_local char cached[TIMESTAMP_SECONDS_SIZE];
+
+        if (seconds != cachedSecond) {
+            std::tm tm{};
+#ifdef _WIN32
+            gmtime_s(&tm, &seconds);
+#else
+            gmtime_r(&seconds, &tm);
+#endif
+            int year = tm.tm_year + 1900;
+            write2(cached, year / 100);
+            write2(cached + 2, year % 100);
+            write2(cached + 4, tm.tm_mon + 1);
+            write2(cached + 6, tm.tm_mday);
+            cached[8] = '-';
+            write2(cached + 9, tm.tm_hour);
+            cached[11] = ':';
+            write2(cached + 12, tm.tm_min);
+            cached[14] = ':';
+            write2(cached + 15, tm.tm_sec);
+            cachedSecond = seconds;
+        }
+        return cached;
+    }
+
+    // 依序寫入欄位的游標
+    struct Writer {
+        char* pos;
+
+        void raw(std::string_view bytes) {
+            std::memcpy(pos, bytes.data(), bytes.size());
+            pos += bytes.size();
+        }
+
+        void field(std::string_view prefix, std::string_view value) {
+            raw(prefix);
+            raw(value);
+            *pos++ = SOH;
+        }
+
+        void field(std::string_view prefix, char value) {
+            raw(prefix);
+            *pos++ = value;
+            *pos++ = SOH;
+        }
+
+        void field(std::string_view prefix, uint64_t value) {
+            raw(prefix);
+            pos = std::to_chars(pos, pos + 20, value).ptr;
+            *pos++ = SOH;
+        }
+
+        void priceField(std::string_view prefix, core::Price value, const core::PriceScale& scale) {
+            raw(prefix);
+            pos = scale.format(pos, value);
+            *pos++ = SOH;
+        }
+
+        void timeField(std::string_view prefix, const char* seconds, int millis) {
+            raw(prefix);
+            raw(std::string_view(seconds, TIMESTAMP_SECONDS_SIZE));
+            if (millis >= 0) {
+                *pos++ = '.';
+                *pos++ = static_cast<char>('0' + millis / 100);
+                write2(pos, millis % 100);
+                pos += 2;
+            }
+            *pos++ = SOH;
+        }
+    };
+
+} // namespace
+
+size_t ExecutionReportEncoder::maxEncodedSize(const ExecutionReportFields& fields) {
+    return BODY_OFFSET + FIXED_BODY_BOUND
+         + fields.clOrdId.size() + fields.execId.size() + fields.symbol.size() + fields.text.size()
+         + TRAILER_SIZE;
+}
+
+std::string_view ExecutionReportEncoder::encode(const ExecutionReportFields& fields, char* buffer, size_t capacity) {
+    return encode(fields, buffer, capacity, FixMessage::nextSequenceNumber(), std::chrono::system_clock::now());
+}
+
+std::string_view ExecutionReportEncoder::encode(const ExecutionReportFields& fields, char* buffer, size_t capacity,
+                                                uint32_t msgSeqNum, std::chrono::system_clock::time_point now) {
+    if (capacity < maxEncodedSize(fields)) {
+        return {};
+    }
+
+    auto sinceEpoch = now.time_since_epoch();
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch);
+    int millis = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(sinceEpoch - seconds).count());
+    const char* timestamp = secondsTimestamp(static_cast<std::time_t>(seconds.count()));
+
+    // ===== Body：35 在前，其餘依 tag 遞增 =====
+    char* bodyBegin = buffer + BODY_OFFSET;
+    Writer out{bodyBegin};
+
+    out.raw(MSG_TYPE);
+    out.field(TAG_CL_ORD_ID, fields.clOrdId);
+    out.field(TAG_CUM_QTY, fields.cumQty);
+    out.field(TAG_EXEC_ID, fields.execId);
+    if (fields.lastQty > 0) {
+        if (fields.lastPx > core::Price()) {
+            out.priceField(TAG_LAST_PX, fields.lastPx, fields.priceScale);
+        }
+        out.field(TAG_LAST_QTY, fields.lastQty);
+    }
+    out.field(TAG_SEQ_NUM, static_cast<uint64_t>(msgSeqNum));
+    out.field(TAG_ORDER_QTY, fields.orderQty);
+    out.field(TAG_ORD_STATUS, fields.ordStatus);
+    if (fields.price > core::Price()) {
+        out.priceField(TAG_PRICE, fields.price, fields.priceScale);
+    }
+    out.timeField(TAG_SENDING_TIME, timestamp, millis);
+    out.field(TAG_SIDE, fields.side);
+    out.field(TAG_SYMBOL, fields.symbol);
+    if (!fields.text.empty()) {
+        out.field(TAG_TEXT, fields.text);
+    }
+    out.timeField(TAG_TRANSACT_TIME, timestamp, -1);
+    out.field(TAG_EXEC_TYPE, fields.execType);
+    out.field(TAG_LEAVES_QTY, fields.leavesQty);
+
+    const size_t bodyLength = static_cast<size_t>(out.pos - bodyBegin);
+
+    // ===== 回填標頭：BodyLength 靠右貼齊 body =====
+    char digits[MAX_BODY_LENGTH_DIGITS + 1];
+    auto [digitsEnd, ec] = std::to_chars(digits, digits + sizeof(digits), bodyLength);
+    const size_t digitCount = static_cast<size_t>(digitsEnd - digits);
+    if (ec != std::errc() || digitCount > MAX_BODY_LENGTH_DIGITS) {
+        return {};
+    }
+
+    char* start = bodyBegin - 1 - digitCount - HEADER_PREFIX.size();
+    std::memcpy(start, HEADER_PREFIX.data(), HEADER_PREFIX.size());
+    std::memcpy(start + HEADER_PREFIX.size(), digits, digitCount);
+    bodyBegin[-1] = SOH;
+
+    // ===== CheckSum =====
+    unsigned int sum = 0;
+    for (const char* p = start; p < out.pos; ++p) {
+        sum += static_cast<unsigned char>(*p);
+    }
+    sum %= 256;
+
+    out.raw(TAG_CHECKSUM);
+    *out.pos++ = static_cast<char>('0' + sum / 100);
+    write2(out.pos, static_cast<int>(sum % 100));
+    out.pos += 2;
+    *out.pos++ = SOH;
+
+    return std::string_view(start, static_cast<size_t>(out.pos - start));
+}
+
+} // namespace mts::protocol
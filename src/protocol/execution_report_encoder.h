@@ -0,0 +1,64 @@
+// ============================================================================
+// execution_report_encoder.h - 直接編碼 35=8 到呼叫端緩衝區
+// ============================================================================
+#pragma once
+#include "../core/price.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace mts::protocol {
+
+// ExecutionReport 的欄位值；字串皆為 view，編碼期間需保持有效
+struct ExecutionReportFields {
+    std::string_view clOrdId;       // 11
+    std::string_view execId;        // 17
+    char execType = '0';            // 150
+    char ordStatus = '0';           // 39
+    std::string_view symbol;        // 55
+    char side = '1';                // 54
+    uint64_t orderQty = 0;          // 38
+    uint64_t leavesQty = 0;         // 151
+    uint64_t cumQty = 0;            // 14
+    uint64_t lastQty = 0;           // 32（> 0 才輸出）
+    core::Price price;              // 44（> 0 才輸出）
+    core::Price lastPx;             // 31（lastQty > 0 且 > 0 才輸出）
+    core::PriceScale priceScale;    // 44/31 的小數位數
+    std::string_view text;          // 58（非空才輸出）
+};
+
+/*
+┌──────────────────────────────────────────────┐
+│           ExecutionReportEncoder             │
+├──────────────────────────────────────────────┤
+│ • 單次寫入，不配置記憶體                        │
+│ • tag 前綴預先編好，數值以 to_chars 格式化       │
+│ • 價格以 PriceScale 由 tick 直接格式化           │
+│ • BodyLength 預留固定寬度，寫完 body 後回填      │
+│ • CheckSum 於結尾計算並附加                     │
+└──────────────────────────────────────────────┘
+   緩衝區配置：
+
+     [ 預留 ][8=FIX.4.2|9=NNN|][35=8|11=...|...|151=...|][10=XXX|]
+             ^ 回傳的 view 起點
+
+   body 從固定位移開始寫；完成後依實際位數把 "8=...|9=NNN|" 靠右
+   寫在 body 前方，回傳的 view 由該起點開始，因此不需要搬移 body。
+   欄位與 FixMessage::serialize() 相同：35 在前，其餘依 tag 遞增。
+*/
+class ExecutionReportEncoder {
+public:
+    static constexpr size_t MAX_BODY_LENGTH_DIGITS = 4;   // body 上限 9999 位元組
+
+    // 緩衝區所需大小上限（呼叫端可據此準備緩衝區）
+    static size_t maxEncodedSize(const ExecutionReportFields& fields);
+
+    // 編碼到 buffer；容量不足時回傳空 view。
+    // MsgSeqNum 取自 FixMessage 共用的序號計數器，SendingTime/TransactTime 取 now。
+    static std::string_view encode(const ExecutionReportFields& fields, char* buffer, size_t capacity);
+    static std::string_view encode(const ExecutionReportFields& fields, char* buffer, size_t capacity,
+                                   uint32_t msgSeqNum, std::chrono::system_clock::time_point now);
+};
+
+} // namespace mts::protocol
@@ -1,4 +1,6 @@
 #include "fix_message.h"
+#include "fix_scanner.h"
+#include "../core/async_logger.h"
 #include <string>
 #include <chrono>
 #include <atomic>
@@ -12,37 +14,37 @@
 
 // ===== DEBUG 配置 =====
 #ifdef ENABLE_FIX_DEBUG
-    #define FIX_DEBUG(msg) std::cout << "[FIX_DEBUG] " << msg << std::endl
+    #define FIX_DEBUG(msg) MTS_LOG_DEBUG_STREAM("[FIX_DEBUG] " << msg)
 #else
     #define FIX_DEBUG(msg) do {} while(0)
 #endif
 
 #ifdef ENABLE_FIX_CHECKSUM_DEBUG
-    #define FIX_CHECKSUM_DEBUG(msg) std::cout << "[FIX_CHECKSUM] " << msg << std::endl
+    #define FIX_CHECKSUM_DEBUG(msg) MTS_LOG_DEBUG_STREAM("[FIX_CHECKSUM] " << msg)
 #else
     #define FIX_CHECKSUM_DEBUG(msg) do {} while(0)
 #endif
 
 #ifdef ENABLE_FIX_PARSE_DEBUG
-    #define FIX_PARSE_DEBUG(msg) std::cout << "[FIX_PARSE] " << msg << std::endl
+    #define FIX_PARSE_DEBUG(msg) MTS_LOG_DEBUG_STREAM("[FIX_PARSE] " << msg)
 #else
     #define FIX_PARSE_DEBUG(msg) do {} while(0)
 #endif
 
 #ifdef ENABLE_FIX_SERIALIZE_DEBUG
-    #define FIX_SERIALIZE_DEBUG(msg) std::cout << "[FIX_SERIALIZE] " << msg << std::endl
+    #define FIX_SERIALIZE_DEBUG(msg) MTS_LOG_DEBUG_STREAM("[FIX_SERIALIZE] " << msg)
 #else
     #define FIX_SERIALIZE_DEBUG(msg) do {} while(0)
 #endif
 
 #ifdef ENABLE_FIX_VALIDATION_DEBUG
-    #define FIX_VALIDATION_DEBUG(msg) std::cout << "[FIX_VALIDATION] " << msg << std::endl
+    #define FIX_VALIDATION_DEBUG(msg) MTS_LOG_DEBUG_STREAM("[FIX_VALIDATION] " << msg)
 #else
     #define FIX_VALIDATION_DEBUG(msg) do {} while(0)
 #endif
 
 #ifdef ENABLE_FIX_FACTORY_DEBUG
-    #define FIX_FACTORY_DEBUG(msg) std::cout << "[FIX_FACTORY] " << msg << std::endl
+    #define FIX_FACTORY_DEBUG(msg) MTS_LOG_DEBUG_STREAM("[FIX_FACTORY] " << msg)
 #else
     #define FIX_FACTORY_DEBUG(msg) do {} while(0)
 #endif
@@ -75,12 +77,16 @@ FixMessage::FixMessage(char msgType) {
     
     setField(BeginString, "FIX.4.2");
     setField(MsgType, std::string(1, msgType));
-    setField(MsgSeqNum, std::to_string(g_msgSeqNum.fetch_add(1)));
+    setField(MsgSeqNum, std::to_string(nextSequenceNumber()));
     setField(SendingTime, getCurrentFixTime());
     
     FIX_DEBUG("FixMessage created with " << fields_.size() << " fields");
 }
 
+uint32_t FixMessage::nextSequenceNumber() {
+    return g_msgSeqNum.fetch_add(1);
+}
+
 // 解析 FIX 訊息 (預設驗證 checksum)
 FixMessage FixMessage::parse(const std::string& rawMessage) {
     return parseWithValidation(rawMessage, true);
@@ -102,83 +108,58 @@ FixMessage FixMessage::parseWithValidation(const std::string& rawMessage, bool v
     }
     
     FixMessage msg;
-    size_t pos = 0;
-    int fieldCount = 0;
-    
-    while (pos < rawMessage.length()) {
-        // 尋找等號
-        size_t equalPos = rawMessage.find('=', pos);
-        if (equalPos == std::string::npos) {
-            // FIX_PARSE_DEBUG("No more '=' found, ending parse at position: " << pos);
-            break;
-        }
+    
+    // 以 FixScanner 一次找出所有欄位邊界，同時累加 checksum
+    constexpr size_t INLINE_SPANS = 64;
+    FixFieldSpan spans[INLINE_SPANS];
+    FixScanSummary summary = FixScanner::scan(rawMessage, spans, INLINE_SPANS);
+    
+    const FixFieldSpan* fields = spans;
+    std::vector<FixFieldSpan> largeSpans;
+    if (summary.fieldCount > INLINE_SPANS) {
+        largeSpans.resize(summary.fieldCount);
+        FixScanner::scan(rawMessage, largeSpans.data(), largeSpans.size());
+        fields = largeSpans.data();
+    }
+    
+    for (size_t i = 0; i < summary.fieldCount; ++i) {
+        const FixFieldSpan& span = fields[i];
         
-        // 尋找 SOH 分隔符 (可能是 \x01 或 | 用於測試)
-        size_t sohPos = rawMessage.find(SOH, equalPos);
-        if (sohPos == std::string::npos) {
-            // 嘗試尋找 | 分隔符 (測試用)
-            sohPos = rawMessage.find('|', equalPos);
-            if (sohPos == std::string::npos) {
-                sohPos = rawMessage.length();  // 最後一個欄位
-                // FIX_PARSE_DEBUG("Last field detected (no SOH found)");
-            }
+        if (!span.hasEqual() && i + 1 == summary.fieldCount) {
+            // 最後一段沒有 '='（例如行尾），結束解析
+            break;
         }
         
-        // 提取 tag 和 value
-        std::string tagStr = rawMessage.substr(pos, equalPos - pos);
-        int tag = 0;
-        bool validTag = true;
-        for (size_t i = pos; i < equalPos && validTag; ++i) {
-            char c = rawMessage[i];
-            if (c >= '0' && c <= '9') {
-                tag = tag * 10 + (c - '0');
-            } else {
-                validTag = false;
-            }
-        }
-
-        if (!validTag || tag == 0) {
+        int tag = FixScanner::parseTag(rawMessage, span);
+        if (tag == 0) {
             FIX_PARSE_DEBUG("ERROR: Invalid tag");
             throw std::runtime_error("Invalid tag in FIX message");
         }
-
-        // 直接建構 value，避免額外拷貝
-        std::string value(rawMessage.data() + equalPos + 1, sohPos - equalPos - 1);
-        msg.setField(tag, value);
-        // std::string value = rawMessage.substr(equalPos + 1, sohPos - equalPos - 1);
         
-        // FIX_PARSE_DEBUG("Field #" << ++fieldCount << ": Tag=" << tagStr << ", Value=" << value);
-        
-        // try {
-        //     int tag = std::stoi(tagStr);
-        //     msg.setField(tag, value);
-        // } catch (const std::exception& e) {
-        //     FIX_PARSE_DEBUG("ERROR: Invalid tag '" << tagStr << "': " << e.what());
-        //     throw std::runtime_error("Invalid tag in FIX message: " + tagStr);
-        // }
-        
-        pos = sohPos + 1;  // 移到下一個欄位
+        msg.setField(tag, std::string(span.value(rawMessage)));
     }
     
-    // FIX_PARSE_DEBUG("Parse completed. Total fields: " << msg.getFieldCount());
-    
     // 🎯 關鍵改進：解析後立即驗證 checksum
     if (validateChecksum) {
         FIX_PARSE_DEBUG("Performing checksum validation...");
         
-        if (!msg.hasField(CheckSum)) {
+        if (!msg.hasField(CheckSum) || !summary.hasChecksumField()) {
             FIX_PARSE_DEBUG("ERROR: Missing CheckSum field");
             throw std::runtime_error("FIX message missing CheckSum field");
         }
         
-        if (!msg.validateChecksum()) {
+        // 直接比對掃描時累加的原始位元組總和，不再重新序列化
+        const char expected[3] = {
+            static_cast<char>('0' + summary.checksum / 100),
+            static_cast<char>('0' + summary.checksum / 10 % 10),
+            static_cast<char>('0' + summary.checksum % 10)
+        };
+        if (msg.getFieldRef(CheckSum) != std::string_view(expected, 3)) {
             FIX_PARSE_DEBUG("ERROR: Checksum validation failed");
             throw std::runtime_error("FIX message checksum validation failed");
         }
         
         FIX_PARSE_DEBUG("Checksum validation PASSED");
-    } else {
-        // FIX_PARSE_DEBUG("Skipping checksum validation (unsafe mode)");
     }
     
     return msg;
@@ -45,7 +45,8 @@ public:
         Logout = '5',
         NewOrderSingle = 'D',
         ExecutionReport = '8',
-        OrderCancelRequest = 'F'
+        OrderCancelRequest = 'F',
+        OrderStatusRequest = 'H'
     
     };
 
@@ -97,6 +98,9 @@ public:
     std::string toString() const;
     size_t getFieldCount() const { return fields_.size(); }
 
+    // 取得下一個 MsgSeqNum（與建構函式共用同一個計數器）
+    static uint32_t nextSequenceNumber();
+
 private:
     static const std::string EMPTY_STRING_;
     // 內部輔助方法
@@ -88,10 +88,11 @@ FixMessage FixMessageBuilder::createNewOrderSingle(
     mts::core::Side side,
     uint64_t quantity,
     mts::core::OrderType orderType,
-    double price,
+    mts::core::Price price,
     mts::core::TimeInForce tif) {
     
     FixMessage msg = createBaseMessage('D');  // NewOrderSingle message
+    mts::core::PriceScale scale = mts::core::PriceScaleRegistry::get(symbol);
     
     // 必填欄位
     msg.setField(11, clOrdId);                           // ClOrdID
@@ -104,17 +105,13 @@ FixMessage FixMessageBuilder::createNewOrderSingle(
     // 價格欄位（限價單才需要）
     if (orderType == mts::core::OrderType::Limit || 
         orderType == mts::core::OrderType::StopLimit) {
-        std::ostringstream priceStr;
-        priceStr << std::fixed << std::setprecision(2) << price;
-        msg.setField(44, priceStr.str());               // Price
+        msg.setField(44, scale.toString(price));        // Price
     }
     
     // 停損價格（停損單才需要）
     if (orderType == mts::core::OrderType::Stop || 
         orderType == mts::core::OrderType::StopLimit) {
-        std::ostringstream stopPriceStr;
-        stopPriceStr << std::fixed << std::setprecision(2) << price;
-        msg.setField(99, stopPriceStr.str());           // StopPx
+        msg.setField(99, scale.toString(price));        // StopPx
     }
     
     // 交易時間（當前時間）
@@ -156,7 +153,7 @@ FixMessage FixMessageBuilder::createExecutionReport(
     const std::string& execId,
     char execType,
     uint64_t lastQty,
-    double lastPx) {
+    mts::core::Price lastPx) {
     
     FixMessage msg = createBaseMessage('8');  // ExecutionReport message
     
@@ -190,10 +187,9 @@ FixMessage FixMessageBuilder::createExecutionReport(
     msg.setField(40, std::string(1, orderTypeToFixChar(order.getOrderType()))); // OrdType
     
     // 價格資訊
+    mts::core::PriceScale scale = mts::core::PriceScaleRegistry::get(order.getSymbol());
     if (order.getOrderType() != mts::core::OrderType::Market) {
-        std::ostringstream priceStr;
-        priceStr << std::fixed << std::setprecision(2) << order.getPrice();
-        msg.setField(44, priceStr.str());                 // Price
+        msg.setField(44, scale.toString(order.getPrice()));   // Price
     }
     
     // 執行資訊
@@ -204,10 +200,8 @@ FixMessage FixMessageBuilder::createExecutionReport(
     if (lastQty > 0) {
         msg.setField(32, std::to_string(lastQty));         // LastQty
         
-        if (lastPx > 0.0) {
-            std::ostringstream lastPxStr;
-            lastPxStr << std::fixed << std::setprecision(2) << lastPx;
-            msg.setField(31, lastPxStr.str());             // LastPx
+        if (lastPx > mts::core::Price()) {
+            msg.setField(31, scale.toString(lastPx));      // LastPx
         }
     }
     
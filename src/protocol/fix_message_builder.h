@@ -29,7 +29,7 @@ public:
         mts::core::Side side,
         uint64_t quantity,
         mts::core::OrderType orderType,
-        double price = 0.0,
+        mts::core::Price price = mts::core::Price(),   // 以 symbol 的 PriceScale 格式化
         mts::core::TimeInForce tif = mts::core::TimeInForce::Day
     );
 
@@ -45,7 +45,7 @@ public:
         const std::string& execId,
         char execType,  // '0'=New, '1'=PartialFill, '2'=Fill, '4'=Canceled
         uint64_t lastQty = 0,
-        double lastPx = 0.0
+        mts::core::Price lastPx = mts::core::Price()
     );
 
 private:
@@ -0,0 +1,237 @@
+#include "fix_message_view.h"
+#include "fix_scanner.h"
+#include "../core/async_logger.h"
+#include <charconv>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef ENABLE_FIX_PARSE_DEBUG
+    #define FIX_VIEW_DEBUG(msg) MTS_LOG_DEBUG_STREAM("[FIX_VIEW] " << msg)
+#else
+    #define FIX_VIEW_DEBUG(msg) do {} while(0)
+#endif
+
+namespace mts::protocol {
+
+namespace {
+    inline bool isAllDigits(std::string_view value) {
+        if (value.empty()) return false;
+        for (char c : value) {
+            if (c < '0' || c > '9') return false;
+        }
+        return true;
+    }
+}
+
+// ===== 解析 =====
+
+FixMessageView FixMessageView::parse(std::string_view rawMessage) {
+    return parseWithValidation(rawMessage, true);
+}
+
+FixMessageView FixMessageView::parseUnsafe(std::string_view rawMessage) {
+    return parseWithValidation(rawMessage, false);
+}
+
+FixMessageView FixMessageView::parseWithValidation(std::string_view rawMessage, bool validateChecksum) {
+    if (rawMessage.empty()) {
+        throw std::runtime_error("Empty FIX message");
+    }
+
+    FixMessageView view;
+    view.raw_ = rawMessage;
+
+    // 一次掃描取得所有欄位邊界與 CheckSum；欄位數超過內嵌容量時才配置並重掃
+    FixFieldSpan spans[INLINE_FIELDS];
+    FixScanSummary summary = FixScanner::scan(rawMessage, spans, INLINE_FIELDS);
+
+    const FixFieldSpan* fields = spans;
+    std::vector<FixFieldSpan> largeSpans;
+    if (summary.fieldCount > INLINE_FIELDS) {
+        largeSpans.resize(summary.fieldCount);
+        FixScanner::scan(rawMessage, largeSpans.data(), largeSpans.size());
+        fields = largeSpans.data();
+    }
+
+    for (size_t i = 0; i < summary.fieldCount; ++i) {
+        const FixFieldSpan& span = fields[i];
+        int tag = FixScanner::parseTag(rawMessage, span);
+        if (tag == 0) {
+            // 最後一段只剩行尾時忽略
+            if (i + 1 == summary.fieldCount && !span.hasEqual() &&
+                span.tag(rawMessage).find_first_not_of("\r\n") == std::string_view::npos) {
+                break;
+            }
+            throw std::runtime_error("Invalid tag in FIX message");
+        }
+        view.addField(tag, span.value(rawMessage));
+    }
+
+    view.checksum_offset_ = summary.checksumOffset;
+    view.computed_checksum_ = summary.checksum;
+
+    if (validateChecksum) {
+        if (!view.hasField(FixMessage::CheckSum)) {
+            FIX_VIEW_DEBUG("ERROR: Missing CheckSum field");
+            throw std::runtime_error("FIX message missing CheckSum field");
+        }
+        if (!view.validateChecksum()) {
+            FIX_VIEW_DEBUG("ERROR: Checksum validation failed");
+            throw std::runtime_error("FIX message checksum validation failed");
+        }
+    }
+
+    return view;
+}
+
+void FixMessageView::addField(FieldTag tag, std::string_view value) {
+    if (count_ < INLINE_FIELDS) {
+        inline_[count_] = Field{tag, value};
+    } else {
+        overflow_.push_back(Field{tag, value});
+    }
+    ++count_;
+}
+
+const FixMessageView::Field* FixMessageView::findField(FieldTag tag) const {
+    const size_t inlineCount = count_ < INLINE_FIELDS ? count_ : INLINE_FIELDS;
+    for (size_t i = 0; i < inlineCount; ++i) {
+        if (inline_[i].tag == tag) {
+            return &inline_[i];
+        }
+    }
+    for (const auto& field : overflow_) {
+        if (field.tag == tag) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+// ===== 欄位存取 =====
+
+std::string_view FixMessageView::getField(FieldTag tag) const {
+    const Field* field = findField(tag);
+    return field ? field->value : std::string_view{};
+}
+
+std::optional<std::string_view> FixMessageView::getFieldOptional(FieldTag tag) const {
+    const Field* field = findField(tag);
+    if (field) {
+        return field->value;
+    }
+    return std::nullopt;
+}
+
+// ===== 驗證 =====
+
+bool FixMessageView::isValid() const {
+    return validateWithDetails().first;
+}
+
+std::pair<bool, std::string> FixMessageView::validateWithDetails() const {
+    for (FieldTag tag : {FixMessage::BeginString, FixMessage::BodyLength, FixMessage::MsgType, FixMessage::CheckSum}) {
+        if (getField(tag).empty()) {
+            return {false, "Missing required field: " + std::to_string(tag)};
+        }
+    }
+
+    std::string_view beginString = getField(FixMessage::BeginString);
+    if (beginString != "FIX.4.2" && beginString != "FIX.4.4" && beginString != "FIX.5.0") {
+        return {false, "Invalid BeginString: " + std::string(beginString)};
+    }
+
+    std::string_view bodyLength = getField(FixMessage::BodyLength);
+    if (!isAllDigits(bodyLength)) {
+        return {false, "Invalid BodyLength: " + std::string(bodyLength)};
+    }
+
+    if (!validateChecksum()) {
+        return {false, "Invalid checksum"};
+    }
+
+    return {true, "Valid"};
+}
+
+bool FixMessageView::validateChecksum() const {
+    std::string_view checksum = getField(FixMessage::CheckSum);
+    if (checksum.size() != 3 || !isAllDigits(checksum) || checksum_offset_ == FixScanSummary::NPOS) {
+        return false;
+    }
+
+    // 總和已在掃描時算好（"10=" 之前的原始位元組，'|' 以 SOH 計）
+    unsigned int expected = static_cast<unsigned int>((checksum[0] - '0') * 100 + (checksum[1] - '0') * 10 + (checksum[2] - '0'));
+    return computed_checksum_ == expected;
+}
+
+// ===== 便利方法 =====
+
+std::optional<char> FixMessageView::getMsgType() const {
+    std::string_view msgType = getField(FixMessage::MsgType);
+    if (msgType.empty()) {
+        return std::nullopt;
+    }
+    return msgType[0];
+}
+
+std::optional<int> FixMessageView::getMsgSeqNum() const {
+    auto seqNum = getFieldOptional(FixMessage::MsgSeqNum);
+    if (!seqNum) {
+        return std::nullopt;
+    }
+    int value = 0;
+    auto [ptr, ec] = std::from_chars(seqNum->data(), seqNum->data() + seqNum->size(), value);
+    if (ec != std::errc() || ptr != seqNum->data() + seqNum->size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+bool FixMessageView::isAdminMessage() const {
+    auto msgType = getMsgType();
+    if (!msgType) return false;
+
+    return *msgType == FixMessage::Heartbeat || *msgType == FixMessage::TestRequest ||
+           *msgType == FixMessage::Logon || *msgType == FixMessage::Logout;
+}
+
+bool FixMessageView::isApplicationMessage() const {
+    auto msgType = getMsgType();
+    if (!msgType) return false;
+
+    return *msgType == FixMessage::NewOrderSingle || *msgType == FixMessage::ExecutionReport ||
+           *msgType == FixMessage::OrderCancelRequest;
+}
+
+// ===== 轉換 =====
+
+FixMessage FixMessageView::toFixMessage() const {
+    FixMessage msg;
+    for (size_t i = 0; i < count_; ++i) {
+        const Field& field = fieldAt(i);
+        msg.setField(field.tag, std::string(field.value));
+    }
+    return msg;
+}
+
+std::string FixMessageView::toString() const {
+    std::ostringstream oss;
+    oss << "FixMessageView[";
+
+    if (auto msgType = getMsgType()) {
+        oss << "MsgType=" << *msgType;
+    }
+    if (auto sender = getSenderCompID()) {
+        oss << ", Sender=" << *sender;
+    }
+    if (auto target = getTargetCompID()) {
+        oss << ", Target=" << *target;
+    }
+    if (auto seqNum = getMsgSeqNum()) {
+        oss << ", SeqNum=" << *seqNum;
+    }
+    oss << ", Fields=" << count_ << "]";
+    return oss.str();
+}
+
+} // namespace mts::protocol
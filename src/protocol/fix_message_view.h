@@ -0,0 +1,88 @@
+// ============================================================================
+// fix_message_view.h - 零複製的 FIX 訊息檢視
+// ============================================================================
+#pragma once
+#include "fix_message.h"
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace mts::protocol {
+
+/*
+┌──────────────────────────────────────────────┐
+│               FixMessageView                 │
+├──────────────────────────────────────────────┤
+│ • 不擁有資料，欄位值是指向原始緩衝區的 view     │
+│ • (tag, string_view) 存放在固定大小的內嵌陣列   │
+│ • 超過內嵌容量才配置溢位 vector                 │
+│ • 分隔符定位與 CheckSum 由 FixScanner 一次完成 │
+└──────────────────────────────────────────────┘
+   生命週期與原始緩衝區綁定：TCPServer 的 frame 只在回調期間有效，
+   需要保存時請用 toFixMessage() 轉成擁有資料的 FixMessage。
+   欄位依出現順序保存，查詢為線性搜尋；一般訂單訊息不超過 20 個欄位，
+   比 std::map 的節點走訪更快。
+*/
+class FixMessageView {
+public:
+    struct Field {
+        FieldTag tag;
+        std::string_view value;
+    };
+
+    static constexpr size_t INLINE_FIELDS = 32;
+
+    FixMessageView() = default;
+
+    // ===== 解析 =====
+    // 與 FixMessage::parse 相同：格式錯誤或 checksum 不符時拋出 std::runtime_error
+    static FixMessageView parse(std::string_view rawMessage);
+    static FixMessageView parseUnsafe(std::string_view rawMessage);
+
+    // ===== 欄位存取 =====
+    std::string_view getField(FieldTag tag) const;   // 不存在時回傳空 view
+    std::optional<std::string_view> getFieldOptional(FieldTag tag) const;
+    bool hasField(FieldTag tag) const { return findField(tag) != nullptr; }
+
+    size_t getFieldCount() const { return count_; }
+    const Field& fieldAt(size_t index) const {
+        return index < INLINE_FIELDS ? inline_[index] : overflow_[index - INLINE_FIELDS];
+    }
+    std::string_view raw() const { return raw_; }
+
+    // ===== 驗證 =====
+    bool isValid() const;
+    std::pair<bool, std::string> validateWithDetails() const;
+    bool validateChecksum() const;
+
+    // ===== 便利方法（與 FixMessage 對應）=====
+    std::optional<char> getMsgType() const;
+    std::optional<std::string_view> getSenderCompID() const { return getFieldOptional(FixMessage::SenderCompID); }
+    std::optional<std::string_view> getTargetCompID() const { return getFieldOptional(FixMessage::TargetCompID); }
+    std::optional<int> getMsgSeqNum() const;
+
+    bool isAdminMessage() const;
+    bool isApplicationMessage() const;
+
+    // ===== 轉換 =====
+    // 複製成擁有資料的 FixMessage（管理訊息或需要跨越回調保存時使用）
+    FixMessage toFixMessage() const;
+    std::string toString() const;
+
+private:
+    std::string_view raw_;
+    size_t checksum_offset_ = static_cast<size_t>(-1);  // "10=" 在 raw_ 中的位置
+    uint8_t computed_checksum_ = 0;   // 掃描時算出的 [0, checksum_offset_) 總和
+    size_t count_ = 0;
+    std::array<Field, INLINE_FIELDS> inline_{};
+    std::vector<Field> overflow_;
+
+    void addField(FieldTag tag, std::string_view value);
+    const Field* findField(FieldTag tag) const;
+    static FixMessageView parseWithValidation(std::string_view rawMessage, bool validateChecksum);
+};
+
+} // namespace mts::protocol
@@ -0,0 +1,227 @@
+#include "fix_scanner.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define MTS_FIX_SCAN_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define MTS_FIX_SCAN_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace mts::protocol {
+
+namespace {
+
+    constexpr char SOH = '\x01';
+    constexpr unsigned PIPE_ADJUST = static_cast<unsigned char>('|') - static_cast<unsigned char>(SOH);
+
+    inline unsigned countTrailingZeros(uint32_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, value);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+    }
+
+    inline unsigned popCount(uint32_t value) {
+#ifdef _MSC_VER
+        return static_cast<unsigned>(__popcnt(value));
+#else
+        return static_cast<unsigned>(__builtin_popcount(value));
+#endif
+    }
+
+    // 逐一處理分隔符事件，組出欄位邊界
+    struct ScanState {
+        const char* data;
+        FixFieldSpan* spans;
+        size_t capacity;
+        size_t count = 0;
+        uint32_t tagBegin = 0;
+        uint32_t equalPos = FixFieldSpan::NO_EQUAL;
+        size_t checksumOffset = FixScanSummary::NPOS;
+
+        void onEqual(uint32_t pos) {
+            // 只有欄位中的第一個 '=' 是 tag 分隔，value 中的 '=' 略過
+            if (equalPos == FixFieldSpan::NO_EQUAL) {
+                equalPos = pos;
+            }
+        }
+
+        void onDelimiter(uint32_t pos) {
+            emit(pos);
+            tagBegin = pos + 1;
+            equalPos = FixFieldSpan::NO_EQUAL;
+        }
+
+        void emit(uint32_t end) {
+            if (equalPos == tagBegin + 2 && data[tagBegin] == '1' && data[tagBegin + 1] == '0') {
+                checksumOffset = tagBegin;
+            }
+            if (count < capacity) {
+                spans[count] = FixFieldSpan{tagBegin, equalPos, end};
+            }
+            ++count;
+        }
+
+        // base 起算的區塊遮罩：bit i 代表 data[base + i]
+        void consume(uint32_t base, uint32_t equalMask, uint32_t delimiterMask) {
+            uint32_t bits = equalMask | delimiterMask;
+            while (bits != 0) {
+                unsigned bit = countTrailingZeros(bits);
+                uint32_t pos = base + bit;
+                if (delimiterMask & (1u << bit)) {
+                    onDelimiter(pos);
+                } else {
+                    onEqual(pos);
+                }
+                bits &= bits - 1;
+            }
+        }
+
+        void scalarByte(uint32_t pos) {
+            char c = data[pos];
+            if (c == '=') {
+                onEqual(pos);
+            } else if (c == SOH || c == '|') {
+                onDelimiter(pos);
+            }
+        }
+    };
+
+    // 收尾：最後一段（沒有分隔符）、扣除 CheckSum 欄位本身
+    FixScanSummary finish(ScanState& state, std::string_view raw, uint64_t byteSum, uint64_t pipeCount) {
+        const uint32_t length = static_cast<uint32_t>(raw.size());
+        if (state.tagBegin < length) {
+            state.emit(length);
+        }
+
+        uint64_t mappedSum = byteSum - PIPE_ADJUST * pipeCount;
+        if (state.checksumOffset != FixScanSummary::NPOS) {
+            for (size_t i = state.checksumOffset; i < raw.size(); ++i) {
+                char c = raw[i];
+                mappedSum -= (c == '|') ? static_cast<unsigned char>(SOH) : static_cast<unsigned char>(c);
+            }
+        }
+
+        FixScanSummary summary;
+        summary.fieldCount = state.count;
+        summary.checksumOffset = state.checksumOffset;
+        summary.checksum = static_cast<uint8_t>(mappedSum % 256);
+        return summary;
+    }
+
+} // namespace
+
+FixScanSummary FixScanner::scan(std::string_view raw, FixFieldSpan* spans, size_t capacity) {
+    ScanState state{raw.data(), spans, capacity};
+    const size_t length = raw.size();
+    const char* data = raw.data();
+    uint64_t byteSum = 0;
+    uint64_t pipeCount = 0;
+    size_t i = 0;
+
+#if defined(MTS_FIX_SCAN_AVX2)
+    const __m256i equalVec = _mm256_set1_epi8('=');
+    const __m256i sohVec = _mm256_set1_epi8(SOH);
+    const __m256i pipeVec = _mm256_set1_epi8('|');
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sumVec = zero;
+
+    for (; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t equalMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, equalVec)));
+        uint32_t pipeMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, pipeVec)));
+        uint32_t sohMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, sohVec)));
+
+        sumVec = _mm256_add_epi64(sumVec, _mm256_sad_epu8(block, zero));
+        pipeCount += popCount(pipeMask);
+        state.consume(static_cast<uint32_t>(i), equalMask, pipeMask | sohMask);
+    }
+
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sumVec);
+    byteSum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+#elif defined(MTS_FIX_SCAN_SSE2)
+    const __m128i equalVec = _mm_set1_epi8('=');
+    const __m128i sohVec = _mm_set1_epi8(SOH);
+    const __m128i pipeVec = _mm_set1_epi8('|');
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sumVec = zero;
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        uint32_t equalMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, equalVec)));
+        uint32_t pipeMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, pipeVec)));
+        uint32_t sohMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, sohVec)));
+
+        sumVec = _mm_add_epi64(sumVec, _mm_sad_epu8(block, zero));
+        pipeCount += popCount(pipeMask);
+        state.consume(static_cast<uint32_t>(i), equalMask, pipeMask | sohMask);
+    }
+
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sumVec);
+    byteSum = lanes[0] + lanes[1];
+#endif
+
+    // 剩餘不足一個區塊的位元組
+    for (; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        byteSum += c;
+        pipeCount += (c == '|');
+        state.scalarByte(static_cast<uint32_t>(i));
+    }
+
+    return finish(state, raw, byteSum, pipeCount);
+}
+
+FixScanSummary FixScanner::scanScalar(std::string_view raw, FixFieldSpan* spans, size_t capacity) {
+    ScanState state{raw.data(), spans, capacity};
+    uint64_t byteSum = 0;
+    uint64_t pipeCount = 0;
+
+    for (size_t i = 0; i < raw.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(raw[i]);
+        byteSum += c;
+        pipeCount += (c == '|');
+        state.scalarByte(static_cast<uint32_t>(i));
+    }
+
+    return finish(state, raw, byteSum, pipeCount);
+}
+
+int FixScanner::parseTag(std::string_view raw, const FixFieldSpan& span) {
+    if (!span.hasEqual() || span.equalPos == span.tagBegin) {
+        return 0;
+    }
+
+    int tag = 0;
+    for (uint32_t i = span.tagBegin; i < span.equalPos; ++i) {
+        char c = raw[i];
+        if (c < '0' || c > '9' || tag > 100000000) {
+            return 0;
+        }
+        tag = tag * 10 + (c - '0');
+    }
+    return tag;
+}
+
+const char* FixScanner::backend() {
+#if defined(MTS_FIX_SCAN_AVX2)
+    return "avx2";
+#elif defined(MTS_FIX_SCAN_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace mts::protocol
@@ -0,0 +1,69 @@
+// ============================================================================
+// fix_scanner.h - 單次掃描的 FIX 分隔符定位與 CheckSum 累加
+// ============================================================================
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace mts::protocol {
+
+/*
+┌──────────────────────────────────────────────┐
+│                 FixScanner                   │
+├──────────────────────────────────────────────┤
+│ • 一次走訪同時找出所有 '=' 與 SOH/'|'         │
+│ • 同一趟累加 mod-256 CheckSum                 │
+│ • AVX2 (32B) / SSE2 (16B) / 純量，編譯期選擇   │
+└──────────────────────────────────────────────┘
+   每個區塊以 cmpeq + movemask 取得 '=' 與分隔符的位元遮罩，
+   再用 ctz 依序走訪；位元組總和以 psadbw 累加。
+   CheckSum 只涵蓋 "10=" 欄位之前的位元組：掃描時先算整段總和，
+   結束後再扣掉尾端 CheckSum 欄位本身（固定 7 個位元組左右）。
+   '|' 是 SOH 的文字替身，計算 CheckSum 時以 SOH (0x01) 計。
+*/
+
+// 單一欄位在原始訊息中的位置
+struct FixFieldSpan {
+    static constexpr uint32_t NO_EQUAL = UINT32_MAX;
+
+    uint32_t tagBegin;   // tag 第一個字元
+    uint32_t equalPos;   // '=' 位置；NO_EQUAL 表示該段沒有 '='
+    uint32_t valueEnd;   // 分隔符位置（最後一段沒有分隔符時為訊息長度）
+
+    bool hasEqual() const { return equalPos != NO_EQUAL; }
+    std::string_view tag(std::string_view raw) const {
+        return raw.substr(tagBegin, (hasEqual() ? equalPos : valueEnd) - tagBegin);
+    }
+    std::string_view value(std::string_view raw) const {
+        return hasEqual() ? raw.substr(equalPos + 1, valueEnd - equalPos - 1) : std::string_view{};
+    }
+};
+
+struct FixScanSummary {
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    size_t fieldCount = 0;          // 欄位總數（可能超過輸出容量）
+    size_t checksumOffset = NPOS;   // 最後一個 "10=" 欄位的起點
+    uint8_t checksum = 0;           // [0, checksumOffset) 的 mod-256 和；沒有 10= 時為整段
+
+    bool hasChecksumField() const { return checksumOffset != NPOS; }
+};
+
+class FixScanner {
+public:
+    // 掃描 raw，最多寫入 capacity 個欄位到 spans；回傳值的 fieldCount 為實際欄位數，
+    // 大於 capacity 時呼叫端應以足夠的容量重新掃描
+    static FixScanSummary scan(std::string_view raw, FixFieldSpan* spans, size_t capacity);
+
+    // 純量版本（測試與基準比較用）
+    static FixScanSummary scanScalar(std::string_view raw, FixFieldSpan* spans, size_t capacity);
+
+    // 解析 tag 數字；非數字、空白或 0 回傳 0
+    static int parseTag(std::string_view raw, const FixFieldSpan& span);
+
+    // 編譯時選用的實作："avx2" / "sse2" / "scalar"
+    static const char* backend();
+};
+
+} // namespace mts::protocol
@@ -1,12 +1,13 @@
 // src/protocol/fix_session.cpp
 #include "fix_session.h"
+#include "../core/async_logger.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 
 // Debug 巨集
 #ifdef ENABLE_FIX_DEBUG
-    #define SESSION_DEBUG(msg) std::cout << "[SESSION_DEBUG] " << sessionID_ << ": " << msg << std::endl
+    #define SESSION_DEBUG(msg) MTS_LOG_DEBUG_STREAM("[SESSION_DEBUG] " << sessionID_ << ": " << msg)
 #else
     #define SESSION_DEBUG(msg) do {} while(0)
 #endif
@@ -181,8 +182,8 @@ bool FixSession::canAcceptNewLogin() const {
 // ===== 訊息處理 =====
 bool FixSession::processIncomingMessage(const std::string& rawMessage) {
     try {
-        FixMessage msg = FixMessage::parse(rawMessage);
-        return processIncomingMessage(msg);
+        FixMessageView view = FixMessageView::parse(rawMessage);
+        return processIncomingMessage(view);
     } catch (const std::exception& e) {
         notifyError("Failed to parse incoming message: " + std::string(e.what()));
         return false;
@@ -211,7 +212,6 @@ bool FixSession::processIncomingMessage(const FixMessage& msg) {
         return false;
     }
     
-    // 🎯 修改：如果是 Logon 訊息且 Session 可以接受新登入，允許重新綁定 CompID
     auto msgType = msg.getMsgType();
 
     if (!msgType) {
@@ -219,46 +219,105 @@ bool FixSession::processIncomingMessage(const FixMessage& msg) {
         return false;
     }
     
-    if (msgType && *msgType == FixMessage::Logon && canAcceptNewLogin()) {
+    if (!admitIncoming(*msgType, *msgSender, *msgTarget, msg.getMsgSeqNum())) {
+        return false;
+    }
+    
+    if (msg.isAdminMessage()) {
+        return handleAdminMessage(msg);
+    } else {
+        // 只有在登入狀態才能處理應用訊息
+        if (state_ != SessionState::LoggedIn) {
+            notifyError("Received application message but not logged in");
+            return false;
+        }
+        
+        if (applicationMessageHandler_) {
+            applicationMessageHandler_(msg);
+        }
+        return true;
+    }
+}
+
+bool FixSession::processIncomingMessage(const FixMessageView& view) {
+    SESSION_DEBUG("Processing incoming message: " << view.toString());
+    
+    messagesReceived_.fetch_add(1);
+    updateHeartbeatTimers();
+    
+    // 驗證訊息格式
+    auto [valid, reason] = view.validateWithDetails();
+    if (!valid) {
+        notifyError("Invalid message: " + reason);
+        return false;
+    }
+    
+    // 檢查 CompID
+    auto msgSender = view.getSenderCompID();
+    auto msgTarget = view.getTargetCompID();
+    
+    if (!msgSender || !msgTarget) {
+        notifyError("Message missing SenderCompID or TargetCompID");
+        return false;
+    }
+    
+    auto msgType = view.getMsgType();
+    if (!msgType) {
+        notifyError("Message missing MsgType");
+        return false;
+    }
+    
+    if (!admitIncoming(*msgType, *msgSender, *msgTarget, view.getMsgSeqNum())) {
+        return false;
+    }
+    
+    if (view.isAdminMessage()) {
+        // 管理訊息頻率低且需要保存欄位，轉為 FixMessage 沿用既有流程
+        return handleAdminMessage(view.toFixMessage());
+    }
+    
+    // 只有在登入狀態才能處理應用訊息
+    if (state_ != SessionState::LoggedIn) {
+        notifyError("Received application message but not logged in");
+        return false;
+    }
+    
+    if (applicationViewHandler_) {
+        applicationViewHandler_(view);
+    } else if (applicationMessageHandler_) {
+        applicationMessageHandler_(view.toFixMessage());
+    }
+    return true;
+}
+
+bool FixSession::admitIncoming(char msgType, std::string_view msgSender, std::string_view msgTarget,
+                               std::optional<int> seqNum) {
+    // 🎯 修改：如果是 Logon 訊息且 Session 可以接受新登入，允許重新綁定 CompID
+    if (msgType == FixMessage::Logon && canAcceptNewLogin()) {
         // 允許重新設定 CompID
-        if (targetCompID_.empty() || targetCompID_ != *msgSender) {
-            targetCompID_ = *msgSender;
+        if (targetCompID_.empty() || targetCompID_ != msgSender) {
+            targetCompID_ = std::string(msgSender);
             sessionID_ = generateSessionID(); // 重新生成 SessionID
             SESSION_DEBUG("CompID rebound for new login: target=" + targetCompID_);
         } // if 
     } // if 
     
-    
-    if (*msgSender != targetCompID_ || *msgTarget != senderCompID_) {
+    if (msgSender != targetCompID_ || msgTarget != senderCompID_) {
         notifyError("CompID mismatch in message");
         return false;
     }
     
     // 驗證序號
-    if (!validateSequenceNumber(msg)) {
+    if (!validateSequenceNumber(seqNum)) {
         return false;
     }
     
     // 更新期望的下一個序號
-    if (auto seqNum = msg.getMsgSeqNum()) {
+    if (seqNum) {
         expectedIncomingSeqNum_.store(*seqNum + 1);
     }
     
-    
-    if (msg.isAdminMessage()) {
-        return handleAdminMessage(msg);
-    } else {
-        // 只有在登入狀態才能處理應用訊息
-        if (state_ != SessionState::LoggedIn) {
-            notifyError("Received application message but not logged in");
-            return false;
-        }
-        
-        if (applicationMessageHandler_) {
-            applicationMessageHandler_(msg);
-        }
-        return true;
-    }
+    return true;
 }
 
 bool FixSession::sendApplicationMessage(const FixMessage& msg) {
@@ -472,7 +531,10 @@ void FixSession::handleSequenceReset(const FixMessage& msg) {
 
 // ===== 序號驗證 =====
 bool FixSession::validateSequenceNumber(const FixMessage& msg) {
-    auto seqNumOpt = msg.getMsgSeqNum();
+    return validateSequenceNumber(msg.getMsgSeqNum());
+}
+
+bool FixSession::validateSequenceNumber(std::optional<int> seqNumOpt) {
     if (!seqNumOpt) {
         notifyError("Message missing sequence number");
         return false;
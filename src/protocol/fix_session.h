@@ -1,6 +1,7 @@
 // src/protocol/fix_session.h
 #pragma once
 #include "fix_message.h"
+#include "fix_message_view.h"
 #include "fix_message_builder.h"
 #include "fix_tags.h"
 #include <string>
@@ -10,6 +11,8 @@
 #include <queue>
 #include <mutex>
 #include <iostream>
+#include <optional>
+#include <string_view>
 
 namespace mts::protocol {
 
@@ -44,6 +47,9 @@ public:
     /// 應用訊息處理回調（處理業務邏輯，如新訂單、執行回報）
     using MessageHandler = std::function<void(const FixMessage&)>;
     
+    /// 零複製應用訊息處理回調（view 只在回調期間有效）
+    using ViewMessageHandler = std::function<void(const FixMessageView&)>;
+    
     /// 錯誤處理回調（記錄錯誤、告警等）
     using ErrorHandler = std::function<void(const std::string&)>;
     
@@ -100,6 +106,9 @@ private:
     /// 應用訊息處理器（處理訂單、成交回報等業務訊息）
     MessageHandler applicationMessageHandler_;
     
+    /// 零複製應用訊息處理器（設定後優先於 applicationMessageHandler_）
+    ViewMessageHandler applicationViewHandler_;
+    
     /// 錯誤處理器（處理協議錯誤、網路錯誤等）
     ErrorHandler errorHandler_;
     
@@ -184,10 +193,20 @@ public:
      * @param rawMessage FIX 格式的原始訊息
      * @return 是否成功處理
      * 
-     * 解析 FIX 字串並調用 processIncomingMessage(FixMessage)
+     * 解析為 FixMessageView 並調用 processIncomingMessage(FixMessageView)
      */
     bool processIncomingMessage(const std::string& rawMessage);
     
+    /**
+     * @brief 處理收到的零複製訊息檢視
+     * @param view 指向接收緩衝區的訊息
+     * @return 是否成功處理
+     * 
+     * 驗證與路由規則同 FixMessage 版本；管理訊息轉成 FixMessage 處理，
+     * 應用訊息直接以 view 交給 applicationViewHandler_
+     */
+    bool processIncomingMessage(const FixMessageView& view);
+    
     /**
      * @brief 處理收到的 FIX 訊息物件
      * @param msg 已解析的 FIX 訊息
@@ -290,6 +309,11 @@ public:
         applicationMessageHandler_ = handler; 
     }
     
+    /// 設定零複製業務訊息處理器
+    void setApplicationViewHandler(ViewMessageHandler handler) { 
+        applicationViewHandler_ = handler; 
+    }
+    
     /// 設定錯誤處理器
     void setErrorHandler(ErrorHandler handler) { 
         errorHandler_ = handler; 
@@ -351,6 +375,16 @@ private:
      * 檢查是否有訊息遺失、重複或亂序
      */
     bool validateSequenceNumber(const FixMessage& msg);
+    bool validateSequenceNumber(std::optional<int> seqNumOpt);
+    
+    /**
+     * @brief 檢查訊息標頭（CompID 綁定、序號）並更新期望序號
+     * @return 訊息是否可以繼續路由
+     * 
+     * FixMessage 與 FixMessageView 兩條路徑共用
+     */
+    bool admitIncoming(char msgType, std::string_view msgSender, std::string_view msgTarget,
+                       std::optional<int> seqNum);
     
     /**
      * @brief 處理序號間隔（訊息遺失）
@@ -4,6 +4,22 @@
 #include <iomanip>
 #include <chrono>
 #include <thread>
+#include <charconv>
+#include <cstring>
+#include <vector>
+
+namespace {
+    // 以 from_chars 解析 FIX 數值欄位，不經過 std::string
+    template <typename T>
+    T parseFixNumber(std::string_view value, const char* fieldName) {
+        T result{};
+        auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (value.empty() || ec != std::errc() || ptr != value.data() + value.size()) {
+            throw std::invalid_argument(std::string("Invalid FIX ") + fieldName + ": " + std::string(value));
+        }
+        return result;
+    }
+}
    
     
 
@@ -11,34 +27,55 @@
 
 TradingSystem::TradingSystem(int port) 
     : serverPort_(port) {
-    std::cout << "🌐 Trading System created on port " << port << std::endl;
+    MTS_LOG_INFO("🌐 Trading System created on port {}", port);
 }
 
 TradingSystem:: ~TradingSystem(){
     stop();
-    std::cout << "🧹 Trading System destroyed" << std::endl;
+    MTS_LOG_INFO("🧹 Trading System destroyed");
 }
 
 // ===== 系統生命週期 =====
 
 bool TradingSystem::start() {
-    std::cout << "🚀 Starting Trading System on port " << serverPort_ << std::endl;
+    MTS_LOG_INFO("🚀 Starting Trading System on port {}", serverPort_);
     
     // 1. 初始化撮合引擎
     if (!initializeMatchingEngine()) {
-        std::cerr << "❌ Failed to initialize MatchingEngine" << std::endl;
+        MTS_LOG_ERROR("❌ Failed to initialize MatchingEngine");
+        return false;
+    }
+    
+    // 追蹤需在網路與撮合開始處理前開啟
+    if (!traceFile_.empty() && !startTraceWriter()) {
+        MTS_LOG_ERROR("❌ Failed to open trace file {}", traceFile_);
         return false;
     }
     
-    // 2. 初始化 TCP 服務器
+    // 2. Session 執行緒需在 reactor 開始投遞事件前就緒
+    if (!initializeInboundPipeline()) {
+        MTS_LOG_ERROR("❌ Failed to initialize inbound pipeline");
+        stopTraceWriter();
+        return false;
+    }
+    
+    // 3. 初始化 TCP 服務器
     if (!initializeTcpServer()) {
-        std::cerr << "❌ Failed to initialize TCP Server" << std::endl;
+        MTS_LOG_ERROR("❌ Failed to initialize TCP Server");
+        inbound_->stop();
+        stopTraceWriter();
         return false;
     }
     
     running_ = true;
-    std::cout << "✅ Trading System started successfully!" << std::endl;
-    std::cout << "📊 Waiting for client connections..." << std::endl;
+    MTS_LOG_INFO("🧵 Pipeline: decode x{} [cpus {}] → session x{} [cpus {}] → match x{} [cpus {}] → encode [cpu {}] → io x{} [cpus {}]",
+                 tcpServer_->getReactorThreadCount(), cpuListToString(decodeCpus_),
+                 inbound_->getStageCount(), cpuListToString(inboundConfig_.stageCpus),
+                 matchingEngine_->getShardCount(), cpuListToString(matchingCpus_),
+                 outboundConfig_.encoderCpu < 0 ? std::string("any") : std::to_string(outboundConfig_.encoderCpu),
+                 outboundConfig_.ioThreadCount, cpuListToString(outboundConfig_.ioCpus));
+    MTS_LOG_INFO("✅ Trading System started successfully!");
+    MTS_LOG_INFO("📊 Waiting for client connections...");
     return true;
 }
 
@@ -47,7 +84,7 @@ void TradingSystem::stop() {
         return;
     }
     
-    std::cout << "🛑 Stopping Trading System..." << std::endl;
+    MTS_LOG_INFO("🛑 Stopping Trading System...");
     running_ = false;
     
     // 1. 停止 TCP 服務器 (不再接受新連線)
@@ -55,27 +92,51 @@ void TradingSystem::stop() {
         tcpServer_->stop();
     }
     
-    // 2. 清理所有客戶端 Session
+    // 2. 處理完已解碼的訊息與斷線事件，Session 執行緒結束
+    if (inbound_) {
+        inbound_->stop();
+        MTS_LOG_INFO("📥 {}", inbound_->getStatistics().toString());
+    }
+    
+    // 3. 清理所有客戶端 Session
     cleanupResources();
     
-    // 3. 停止撮合引擎
+    // 4. 停止撮合引擎
+    stopSnapshotTimer();
     if (matchingEngine_) {
         matchingEngine_->stop();
     }
     
-    std::cout << "✅ Trading System stopped" << std::endl;
+    // 5. 撮合執行緒停止後才停止輸出管線，剩餘回報在此編碼完畢
+    if (outbound_) {
+        outbound_->stop();
+        MTS_LOG_INFO("📤 {}", outbound_->getStatistics().toString());
+    }
+    
+    // 6. 寫出剩餘的追蹤事件
+    stopTraceWriter();
+    
+    MTS_LOG_INFO("✅ Trading System stopped");
 }
 
 // ===== 初始化方法 =====
 
 bool TradingSystem::initializeMatchingEngine() {
     try {
-        matchingEngine_ = std::make_unique<MatchingEngine>();
+        matchingEngine_ = std::make_unique<ShardedMatchingEngine>(matchingThreads_);
+        matchingEngine_->setWaitStrategy(waitStrategy_);
+        matchingEngine_->setCpuAffinity(matchingCpus_);
+        
+        // 撮合執行緒只把回報放進所屬分片的輸出佇列，編碼與寫出交給輸出管線
+        if (!initializeOutboundPipeline()) {
+            return false;
+        }
         
         // 設定回調函式
-        matchingEngine_->setExecutionCallback(
-            [this](const ExecutionReportPtr& report) {
-                handleExecutionReport(report);
+        matchingEngine_->setBatchSize(batchSize_);
+        matchingEngine_->setShardExecutionBatchCallback(
+            [this](size_t shard, const ExecutionReportPtr* reports, size_t count) {
+                outbound_->post(shard, reports, count);
             }
         );
         
@@ -86,71 +147,178 @@ bool TradingSystem::initializeMatchingEngine() {
         );
         
         // 設定風險參數
-        matchingEngine_->setMaxOrderPrice(10000.0);
+        matchingEngine_->setMaxOrderPrice(Price(1000000));   // 10000.00
         matchingEngine_->setMaxOrderQuantity(1000000);
         matchingEngine_->enableRiskCheck(true);
         matchingEngine_->enableMarketData(true);
         
+        if (!journalDirectory_.empty()) {
+            if (!recoverMatchingEngine()) {
+                return false;
+            }
+            JournalConfig journalConfig;
+            journalConfig.directory = journalDirectory_;
+            if (!matchingEngine_->enableJournal(journalConfig)) {
+                return false;
+            }
+            MTS_LOG_INFO("📒 Journaling engine input to {}", journalDirectory_);
+        }
+        
         // 啟動撮合引擎
-        return matchingEngine_->start();
+        if (!matchingEngine_->start()) {
+            return false;
+        }
+        startSnapshotTimer();
+        return true;
         
     } catch (const std::exception& e) {
-        std::cerr << "MatchingEngine initialization error: " << e.what() << std::endl;
+        MTS_LOG_ERROR("MatchingEngine initialization error: {}", e.what());
         return false;
     }
 }
 
+bool TradingSystem::initializeOutboundPipeline() {
+    try {
+        outbound_ = std::make_unique<OutboundPipeline>(matchingEngine_->getShardCount(), outboundConfig_);
+        
+        outbound_->setEncodeHandler([this](const ReportEvent* events, size_t count) {
+            encodeExecutionReports(events, count);
+        });
+        
+        // 慢客戶端：佇列滿時斷線，由既有的斷線流程清理 Session（Session id 即連線編號）
+        outbound_->setOverflowHandler([this](uint64_t sessionId) {
+            TCPServer::ConnectionPtr connection;
+            {
+                std::lock_guard<std::mutex> lock(sessionsMutex_);
+                auto it = sessions_.find(sessionId);
+                if (it != sessions_.end()) {
+                    connection = it->second->context.connection.lock();
+                }
+            }
+            if (tcpServer_ && connection) {
+                tcpServer_->disconnectClient(connection);
+            }
+        });
+        
+        if (!outbound_->start()) {
+            return false;
+        }
+        MTS_LOG_INFO("📤 Outbound pipeline started ({} IO threads, queue limit {}, overflow {})",
+                     outboundConfig_.ioThreadCount, outboundConfig_.sessionQueueLimit,
+                     overflowPolicyToString(outboundConfig_.overflowPolicy));
+        return true;
+        
+    } catch (const std::exception& e) {
+        MTS_LOG_ERROR("Outbound pipeline initialization error: {}", e.what());
+        return false;
+    }
+}
+
+bool TradingSystem::initializeInboundPipeline() {
+    try {
+        inbound_ = std::make_unique<InboundPipeline>(inboundConfig_);
+        inbound_->setEventHandler([this](const InboundEvent& event) {
+            handleInboundEvent(event);
+        });
+        
+        if (!inbound_->start()) {
+            return false;
+        }
+        MTS_LOG_INFO("📥 Inbound pipeline started ({} session threads, ring {})",
+                     inbound_->getStageCount(), inboundConfig_.ringCapacity);
+        return true;
+        
+    } catch (const std::exception& e) {
+        MTS_LOG_ERROR("Inbound pipeline initialization error: {}", e.what());
+        return false;
+    }
+}
 
 bool TradingSystem::initializeTcpServer() {
     try {
-        std::cout << "🌐 初始化增強版 TCP 服務器..." << std::endl;
+        MTS_LOG_INFO("🌐 初始化增強版 TCP 服務器...");
         
         // 建立增強版 TCP 服務器
         tcpServer_ = std::make_unique<TCPServer>(serverPort_);
+        tcpServer_->setReactorThreadCount(reactorThreads_);
+        tcpServer_->setReactorCpus(decodeCpus_);
         
-        // 🔄 修改：連線回調參數改為 SOCKET
-        tcpServer_->setConnectionCallback([this](SOCKET clientSocket) {  // 改為 SOCKET
-            std::cout << "🎉 新客戶端連線: " << clientSocket << std::endl;
-            handleNewConnection(clientSocket);
+        // reactor 執行緒只負責接收與分幀，連線事件與訊息依序交給連線所屬的 Session 執行緒；
+        // 一律以不重複的連線編號識別，socket 編號被重用時不會把事件交給錯誤的 Session
+        tcpServer_->setConnectionCallback([this](const TCPServer::ConnectionPtr& connection) {
+            MTS_LOG_INFO("🎉 新客戶端連線: {} (連線 {})", connection->socket, connection->id);
+            {
+                std::lock_guard<std::mutex> lock(acceptedMutex_);
+                acceptedConnections_[connection->id] = connection;
+            }
+            inbound_->postConnect(connection->id);
         });
         
-        // 🔄 修改：訊息回調參數改為 SOCKET
-        tcpServer_->setMessageCallback([this](SOCKET clientSocket, const std::string& message) {  // 改為 SOCKET
-            std::cout << "📨 收到客戶端 " << clientSocket << " 訊息: " << message << std::endl;
-            handleClientMessage(clientSocket, message);
+        // 訊息以 BodyLength 分幀，複製進輸入佇列的槽位後接收緩衝區即可重用
+        tcpServer_->setFrameCallback([this](TCPServer::ConnectionId connectionId, std::string_view frame) {
+            MTS_LOG_DEBUG("📨 收到連線 {} 訊息: {}", connectionId, frame);
+            inbound_->postFrame(connectionId, frame);
         });
         
-        // 🔄 修改：斷線回調參數改為 SOCKET
-        tcpServer_->setDisconnectionCallback([this](SOCKET clientSocket) {  // 改為 SOCKET
-            std::cout << "📴 客戶端斷線: " << clientSocket << std::endl;
-            handleClientDisconnection(clientSocket);
+        tcpServer_->setDisconnectionCallback([this](TCPServer::ConnectionId connectionId) {
+            MTS_LOG_INFO("📴 連線 {} 斷線", connectionId);
+            inbound_->postDisconnect(connectionId);
         });
         
         // 錯誤回調保持不變
         tcpServer_->setErrorCallback([this](const std::string& error) {
-            std::cerr << "🚨 TCP 服務器錯誤: " << error << std::endl;
+            MTS_LOG_ERROR("🚨 TCP 服務器錯誤: {}", error);
         });
         
         // 啟動服務器
         bool success = tcpServer_->start();
         if (success) {
-            std::cout << "✅ TCP 服務器啟動成功，監聽 port " << serverPort_ << std::endl;
+            MTS_LOG_INFO("✅ TCP 服務器啟動成功，監聽 port {}", serverPort_);
         } else {
-            std::cerr << "❌ TCP 服務器啟動失敗" << std::endl;
+            MTS_LOG_ERROR("❌ TCP 服務器啟動失敗");
         }
         
         return success;
         
     } catch (const std::exception& e) {
-        std::cerr << "TCP Server initialization error: " << e.what() << std::endl;
+        MTS_LOG_ERROR("TCP Server initialization error: {}", e.what());
         return false;
     }
 }
 
 
-// ===== TCP 連線處理 =====
-void TradingSystem::handleNewConnection(SOCKET clientSocket) {
-    std::cout << "📞 New client connected: " << clientSocket << std::endl;
+// ===== TCP 連線處理（Session 執行緒）=====
+
+void TradingSystem::handleInboundEvent(const InboundEvent& event) {
+    switch (event.type) {
+        case InboundEventType::Connect:
+            handleNewConnection(event.sessionId);
+            break;
+        case InboundEventType::Frame:
+            handleClientMessage(event.sessionId, event.frame());
+            break;
+        case InboundEventType::Disconnect:
+            handleClientDisconnection(event.sessionId);
+            break;
+    }
+}
+
+void TradingSystem::handleNewConnection(TCPServer::ConnectionId connectionId) {
+    TCPServer::ConnectionPtr connection;
+    {
+        std::lock_guard<std::mutex> lock(acceptedMutex_);
+        auto it = acceptedConnections_.find(connectionId);
+        if (it != acceptedConnections_.end()) {
+            connection = std::move(it->second);
+            acceptedConnections_.erase(it);
+        }
+    }
+    if (!connection) {
+        MTS_LOG_WARN("No accepted connection found for connection {}", connectionId);
+        return;
+    }
+    const SOCKET clientSocket = connection->socket;
+    MTS_LOG_INFO("📞 New client connected: {} (connection {})", clientSocket, connectionId);
     
     try {
         // 更新統計
@@ -161,39 +329,41 @@ void TradingSystem::handleNewConnection(SOCKET clientSocket) {
         // 不預設 targetCompID，讓 FixSession 從 LOGON 訊息中提取
         
         auto fixSession = std::make_unique<FixSession>(senderCompID);
+        SessionContext context;
+        context.connectionId = connectionId;
+        context.socket = clientSocket;
+        context.connection = connection;
+        context.orders = std::make_shared<SessionOrderIndex>();
+        // 輸出佇列綁定連線本身：連線關閉後 IO 執行緒寫出即失敗，不會寫到重用同一 socket 編號的新連線
+        std::weak_ptr<TCPServer::Connection> weakConnection = connection;
+        context.outbound = outbound_->openSession(connectionId,
+            [this, weakConnection](const OutboundMessage* messages, size_t count) {
+                return writeOutbound(weakConnection.lock(), messages, count);
+            });
         
         // 設定 FIX Session 回調
-        fixSession->setApplicationMessageHandler(
-            [this, clientSocket](const FixMessage& msg) {
+        fixSession->setApplicationViewHandler(
+            [this, context](const FixMessageView& msg) {
                 try {
-                    handleFixApplicationMessage(clientSocket, msg);
+                    handleFixApplicationMessage(context, msg);
                 } catch (const std::exception& e) {
-                    std::cerr << "❌ Error in application message handler: " << e.what() << std::endl;
+                    MTS_LOG_ERROR("❌ Error in application message handler: {}", e.what());
                 }
             }
         );
         
         fixSession->setErrorHandler(
             [this, clientSocket](const std::string& error) {
-                std::cerr << "🚨 Session " << clientSocket << " error: " << error << std::endl;
+                MTS_LOG_ERROR("🚨 Session {} error: {}", clientSocket, error);
                 // 可以考慮在嚴重錯誤時斷開連線
             }
         );
         
-        // 設定發送函式
+        // 設定發送函式：Session 層訊息（Logon、Heartbeat、Reject…）與執行回報共用同一輸出佇列，
+        // 保持送出順序，並套用相同的溢出策略
         fixSession->setSendFunction(
-            [this, clientSocket](const std::string& message) -> bool {
-                if (!tcpServer_ || !tcpServer_->isRunning()) {
-                    std::cerr << "❌ TCP Server not available" << std::endl;
-                    return false;
-                }
-                
-                try {
-                    return tcpServer_->sendMessage(clientSocket, message);
-                } catch (const std::exception& e) {
-                    std::cerr << "❌ Send error: " << e.what() << std::endl;
-                    return false;
-                }
+            [this, outbound = context.outbound](const std::string& message) -> bool {
+                return outbound_->send(outbound, message);
             }
         );
         
@@ -201,178 +371,320 @@ void TradingSystem::handleNewConnection(SOCKET clientSocket) {
         fixSession->setHeartbeatInterval(std::chrono::seconds(30));
         
         // 建立並保存 Session
-        std::string clientInfo = "Socket_" + std::to_string(static_cast<int64_t>(clientSocket));
+        std::string clientInfo = "Connection_" + std::to_string(connectionId) +
+                                 "_Socket_" + std::to_string(static_cast<int64_t>(clientSocket));
         
         {
             std::lock_guard<std::mutex> lock(sessionsMutex_);
-            sessions_[clientSocket] = std::make_unique<ClientSession>(
-                std::move(fixSession), 
+            sessions_[connectionId] = std::make_unique<ClientSession>(
+                std::move(fixSession),
+                std::move(context),
                 clientInfo
             );
         }
         
-        std::cout << "✅ FIX Session created for client " << clientSocket 
-                  << " (" << senderCompID << " -> dynamic)" << std::endl;
+        MTS_LOG_INFO("✅ FIX Session created for client {} ({} -> dynamic)", clientSocket, senderCompID);
         
     } catch (const std::exception& e) {
-        std::cerr << "❌ Error handling new connection " << clientSocket 
-                  << ": " << e.what() << std::endl;
+        MTS_LOG_ERROR("❌ Error handling new connection {}: {}", clientSocket, e.what());
         
         // 清理可能已建立的資源
-        cleanupSession(clientSocket);
+        cleanupSession(connectionId);
     }
 }
 
 
-void TradingSystem::handleClientDisconnection(SOCKET clientSocket) {  // 參數類型改為 SOCKET
-    std::cout << "📴 Client disconnected: " << clientSocket << std::endl;
-    cleanupSession(clientSocket);
+void TradingSystem::handleClientDisconnection(TCPServer::ConnectionId connectionId) {
+    MTS_LOG_INFO("📴 Client disconnected: connection {}", connectionId);
+    cleanupSession(connectionId);
 }
 
-void TradingSystem::handleClientMessage(SOCKET clientSocket, const std::string& rawMessage) {
-    std::lock_guard<std::mutex> lock(sessionsMutex_);
-    
-    auto it = sessions_.find(clientSocket);
-    if (it == sessions_.end()) {
-        std::cerr << "No session found for client: " << clientSocket << std::endl;
+void TradingSystem::handleClientMessage(TCPServer::ConnectionId connectionId, std::string_view rawMessage) {
+    // 同一連線的事件都由本執行緒依序處理，Session 只會在本執行緒上移除：查到後即可放鎖
+    ClientSession* session = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex_);
+        auto it = sessions_.find(connectionId);
+        if (it != sessions_.end()) {
+            session = it->second.get();
+        }
+    }
+    if (session == nullptr) {
+        MTS_LOG_WARN("No session found for connection: {}", connectionId);
         return;
     }
     
-    // 交給 FIX Session 處理
+    // 直接在輸入佇列的槽位上解析，交給 FIX Session 處理
     try {
-        it->second->fixSession->processIncomingMessage(rawMessage);
+        FixMessageView view = FixMessageView::parse(rawMessage);
+        OrderTracer::markPending(TraceStage::Parse);
+        session->fixSession->processIncomingMessage(view);
     } catch (const std::exception& e) {
-        std::cerr << "Error processing message from " << clientSocket << ": " << e.what() << std::endl;
+        MTS_LOG_ERROR("Error processing message from connection {}: {}", connectionId, e.what());
     }
 }
 
 // ===== FIX 訊息處理 =====
 
-void TradingSystem::handleFixApplicationMessage(SOCKET clientSocket, const FixMessage& fixMsg) {
+void TradingSystem::handleFixApplicationMessage(const SessionContext& session, const FixMessageView& fixMsg) {
+    OrderTracer::markPending(TraceStage::SessionValidate);   // FixSession 已驗證通過
+    
     auto msgType = fixMsg.getMsgType();
     if (!msgType) {
-        std::cerr << "Invalid message type from client " << clientSocket << std::endl;
+        MTS_LOG_WARN("Invalid message type from client {}", session.socket);
         return;
     }
     
-    std::cout << "📨 Received FIX message type '" << *msgType << "' from client " << clientSocket << std::endl;
+    MTS_LOG_DEBUG("📨 Received FIX message type '{}' from client {}", *msgType, session.socket);
     
     switch (*msgType) {
         case FixMessage::NewOrderSingle:
-            handleNewOrderSingle(clientSocket, fixMsg);
+            handleNewOrderSingle(session, fixMsg);
             break;
             
         case FixMessage::OrderCancelRequest:
-            handleOrderCancelRequest(clientSocket, fixMsg);
+            handleOrderCancelRequest(session, fixMsg);
+            break;
+            
+        case FixMessage::OrderStatusRequest:
+            handleOrderStatusRequest(session, fixMsg);
             break;
             
         default:
-            std::cerr << "Unsupported message type: " << *msgType << std::endl;
+            MTS_LOG_WARN("Unsupported message type: {}", *msgType);
             break;
     }
 }
 
-void TradingSystem::handleNewOrderSingle(SOCKET clientSocket, const FixMessage& fixMsg) {
+void TradingSystem::handleNewOrderSingle(const SessionContext& session, const FixMessageView& fixMsg) {
     try {
-        std::cout << "📋 Processing New Order Single from client " << clientSocket << std::endl;
+        MTS_LOG_DEBUG("📋 Processing New Order Single from client {}", session.socket);
         
-        // 轉換 FIX 訊息為 Order 物件
-        auto order = convertFixToOrder(fixMsg, clientSocket);
+        // 轉換 FIX 訊息為訂單池中的 Order
+        OrderHandle order = convertFixToOrder(fixMsg, session);
+        OrderID orderId = matchingEngine_->getOrder(order).getOrderId();
         
-        // 提交到撮合引擎
+        // 提交到撮合引擎（之後由撮合執行緒管理該訂單）
         if (matchingEngine_->submitOrder(order)) {
-            std::cout << "✅ Order " << order->getOrderId() << " submitted to MatchingEngine" << std::endl;
+            MTS_LOG_DEBUG("✅ Order {} submitted to MatchingEngine", orderId);
         } else {
-            std::cout << "❌ Failed to submit order to MatchingEngine" << std::endl;
-            sendOrderReject(clientSocket, fixMsg, "MatchingEngine unavailable");
+            // 訂單未進入撮合（handle 已由引擎歸還）：撤回 convertFixToOrder 登記的索引與映射，ClOrdID 可再使用
+            MTS_LOG_WARN("❌ Failed to submit order to MatchingEngine");
+            {
+                std::lock_guard<std::mutex> lock(session.orders->mutex);
+                auto it = session.orders->byClOrdId.find(std::string(fixMsg.getField(11)));
+                if (it != session.orders->byClOrdId.end() && it->second.orderId == orderId) {
+                    session.orders->byClOrdId.erase(it);
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mappingsMutex_);
+                orderMappings_.erase(orderId);
+            }
+            sendOrderReject(session, fixMsg, "MatchingEngine unavailable");
         }
         
     } catch (const std::exception& e) {
-        std::cerr << "Error processing new order: " << e.what() << std::endl;
-        sendOrderReject(clientSocket, fixMsg, e.what());
+        MTS_LOG_ERROR("Error processing new order: {}", e.what());
+        sendOrderReject(session, fixMsg, e.what());
     }
 }
 
-void TradingSystem::handleOrderCancelRequest(SOCKET clientSocket, const FixMessage& fixMsg) {
+void TradingSystem::handleOrderCancelRequest(const SessionContext& session, const FixMessageView& fixMsg) {
     try {
-        std::cout << "❌ Processing Order Cancel Request from client " << clientSocket << std::endl;
+        MTS_LOG_DEBUG("❌ Processing Order Cancel Request from client {}", session.socket);
         
-        std::string origClOrdId = fixMsg.getField(41);  // OrigClOrdID
+        SessionOrderIndex& orders = *session.orders;
+        std::string origClOrdId(fixMsg.getField(41));  // OrigClOrdID
         
-        // 找到對應的 OrderID
+        // 由本 Session 的 ClOrdID 索引找到對應的 OrderID
         OrderID targetOrderId = 0;
         {
-            std::lock_guard<std::mutex> lock(mappingsMutex_);
-            for (const auto& pair : orderMappings_) {
-                if (pair.second.clientSocket == clientSocket && 
-                    pair.second.clOrdId == origClOrdId) {
-                    targetOrderId = pair.first;
-                    break;
-                }
+            std::lock_guard<std::mutex> lock(orders.mutex);
+            auto it = orders.byClOrdId.find(origClOrdId);
+            if (it != orders.byClOrdId.end()) {
+                targetOrderId = it->second.orderId;
             }
         }
         
         if (targetOrderId == 0) {
-            sendOrderReject(clientSocket, fixMsg, "Original order not found");
+            sendOrderReject(session, fixMsg, "Original order not found");
             return;
         }
         
         // 提交取消請求
         if (matchingEngine_->cancelOrder(targetOrderId, "Client requested")) {
-            std::cout << "✅ Cancel request for Order " << targetOrderId << " submitted" << std::endl;
+            MTS_LOG_DEBUG("✅ Cancel request for Order {} submitted", targetOrderId);
         } else {
-            sendOrderReject(clientSocket, fixMsg, "Failed to submit cancel request");
+            sendOrderReject(session, fixMsg, "Failed to submit cancel request");
         }
         
     } catch (const std::exception& e) {
-        std::cerr << "Error processing cancel request: " << e.what() << std::endl;
-        sendOrderReject(clientSocket, fixMsg, e.what());
+        MTS_LOG_ERROR("Error processing cancel request: {}", e.what());
+        sendOrderReject(session, fixMsg, e.what());
     }
 }
 
-// ===== 撮合引擎回調 =====
-
-void TradingSystem::handleExecutionReport(const ExecutionReportPtr& report) {
-    std::cout << "📊 Received ExecutionReport: " << report->toString() << std::endl;
-    
+void TradingSystem::handleOrderStatusRequest(const SessionContext& session, const FixMessageView& fixMsg) {
     try {
-        // 找到對應的客戶端
-        OrderMapping mapping{0, "", ""};
+        MTS_LOG_DEBUG("🔎 Processing Order Status Request from client {}", session.socket);
+        
+        SessionOrderIndex& orders = *session.orders;
+        std::string clOrdId(fixMsg.getField(11));   // ClOrdID
+        SessionOrderIndex::Entry entry;
+        bool found = false;
         {
-            std::lock_guard<std::mutex> lock(mappingsMutex_);
-            auto it = orderMappings_.find(report->orderId);
+            std::lock_guard<std::mutex> lock(orders.mutex);
+            auto it = orders.byClOrdId.find(clOrdId);
+            if (it != orders.byClOrdId.end()) {
+                entry = it->second;
+                found = true;
+            }
+        }
+        
+        // 回覆 ExecType = I (Order Status)；已終止或不存在的訂單以 OrdStatus = Rejected 回覆
+        char execId[EXEC_ID_BUFFER_SIZE];
+        ExecutionReportFields fields;
+        fields.clOrdId = clOrdId;
+        fields.execId = generateExecId(execId);
+        fields.execType = 'I';
+        if (found) {
+            fields.ordStatus = getFixOrdStatus(entry.status);
+            fields.symbol = entry.symbol;
+            fields.side = (entry.side == Side::Buy) ? '1' : '2';
+            fields.orderQty = entry.orderQty;
+            fields.leavesQty = entry.leavesQty;
+            fields.cumQty = entry.cumQty;
+            fields.price = entry.price;
+            fields.priceScale = PriceScaleRegistry::get(entry.symbol);
+        } else {
+            fields.ordStatus = '8';
+            fields.symbol = fixMsg.getField(55);
+            std::string_view side = fixMsg.getField(54);
+            if (!side.empty()) {
+                fields.side = side[0];
+            }
+            fields.text = "Unknown order";
+        }
+        sendExecutionReport(session.outbound, fields, found ? entry.orderId : 0);
+        
+    } catch (const std::exception& e) {
+        MTS_LOG_ERROR("Error processing order status request: {}", e.what());
+    }
+}
+
+// ===== 輸出管線 =====
+
+void TradingSystem::encodeExecutionReports(const ReportEvent* events, size_t count) {
+    // 一個批次只取一次映射鎖
+    std::vector<OrderMapping> mappings;
+    mappings.reserve(count);
+    {
+        std::lock_guard<std::mutex> lock(mappingsMutex_);
+        for (size_t i = 0; i < count; ++i) {
+            const ReportEvent& report = events[i];
+            auto it = orderMappings_.find(report.orderId);
             if (it == orderMappings_.end()) {
-                std::cerr << "No mapping found for OrderID: " << report->orderId << std::endl;
-                return;
+                MTS_LOG_WARN("No mapping found for OrderID: {}", report.orderId);
+                mappings.emplace_back(SessionContext{}, "", "");
+                continue;
             }
-            mapping = it->second;
+            mappings.push_back(it->second);
             
             // 如果訂單已完成，清理映射
-            if (report->status == OrderStatus::Filled || 
-                report->status == OrderStatus::Cancelled ||
-                report->status == OrderStatus::Rejected) {
+            if (isTerminalStatus(report.status)) {
                 orderMappings_.erase(it);
             }
         }
+    }
+    
+    for (size_t i = 0; i < count; ++i) {
+        const ReportEvent& report = events[i];
+        const OrderMapping& mapping = mappings[i];
+        if (!mapping.outbound) {
+            continue;
+        }
         
-        // 轉換為 FIX ExecutionReport
-        auto fixReport = convertReportToFix(report);
-        
-        // 設定客戶端特定的欄位
-        fixReport.setField(11, mapping.clOrdId);  // ClOrdID
-        
-        // 發送給對應的客戶端
-        if (!sendFixMessage(mapping.clientSocket, fixReport)) {
-            std::cerr << "Failed to send ExecutionReport to client " << mapping.clientSocket << std::endl;
+        // 同步 Session 的 ClOrdID 索引：更新狀態，終止時移除
+        if (mapping.sessionOrders) {
+            SessionOrderIndex& orders = *mapping.sessionOrders;
+            std::lock_guard<std::mutex> lock(orders.mutex);
+            auto it = orders.byClOrdId.find(mapping.clOrdId);
+            if (it != orders.byClOrdId.end() && it->second.orderId == report.orderId) {
+                if (isTerminalStatus(report.status)) {
+                    orders.byClOrdId.erase(it);
+                } else {
+                    it->second.status = report.status;
+                    it->second.cumQty = report.filledQuantity;
+                    it->second.leavesQty = report.remainingQuantity;
+                }
+            }
         }
+        MTS_LOG_DEBUG("📊 Received ExecutionReport: OrderID={} Symbol={} Status={} Filled={} Remaining={} ExecQty={} ExecPx={}",
+                      report.orderId, report.symbol.str(), orderStatusToString(report.status),
+                      report.filledQuantity, report.remainingQuantity,
+                      report.executionQuantity, report.executionPrice.ticks());
         
-    } catch (const std::exception& e) {
-        std::cerr << "Error handling execution report: " << e.what() << std::endl;
+        try {
+            // 直接編碼為 FIX ExecutionReport，不經過 FixMessage
+            char execId[EXEC_ID_BUFFER_SIZE];
+            ExecutionReportFields fields;
+            fields.clOrdId = mapping.clOrdId;
+            fields.execId = generateExecId(execId);
+            fields.execType = getFixExecType(report.status);
+            fields.ordStatus = getFixOrdStatus(report.status);
+            fields.symbol = report.symbol.str();
+            fields.side = (report.side == Side::Buy) ? '1' : '2';
+            fields.orderQty = report.originalQuantity;
+            fields.leavesQty = report.remainingQuantity;
+            fields.cumQty = report.filledQuantity;
+            fields.lastQty = report.executionQuantity;
+            fields.price = report.price;
+            fields.lastPx = report.executionPrice;
+            fields.priceScale = PriceScaleRegistry::forSymbol(report.symbol);
+            fields.text = report.getText();
+            
+            // 放入對應客戶端的輸出佇列
+            if (!sendExecutionReport(mapping.outbound, fields, report.orderId)) {
+                MTS_LOG_DEBUG("ExecutionReport for client {} dropped (session closed)", mapping.clientSocket);
+            }
+            
+        } catch (const std::exception& e) {
+            MTS_LOG_ERROR("Error handling execution report: {}", e.what());
+        }
+    }
+}
+
+bool TradingSystem::writeOutbound(const TCPServer::ConnectionPtr& connection, const OutboundMessage* messages, size_t count) {
+    if (!connection || !tcpServer_ || !tcpServer_->isRunning()) {
+        return false;
+    }
+    const SOCKET clientSocket = connection->socket;
+    
+    // 同一 Session 累積的回報一次交給 TCPServer，合併成一次 gather 寫出
+    thread_local std::vector<std::string_view> views;
+    views.clear();
+    for (size_t i = 0; i < count; ++i) {
+        MTS_LOG_DEBUG("📤 Sending ExecutionReport to client {}: {}", clientSocket, messages[i].bytes);
+        views.push_back(messages[i].bytes);
+    }
+    
+    if (!tcpServer_->sendMessages(connection, views.data(), views.size())) {
+        MTS_LOG_ERROR("Failed to send {} ExecutionReport(s) to client {}", count, clientSocket);
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (messages[i].orderId != 0) {
+            OrderTracer::trace(messages[i].orderId, TraceStage::Send);
+        }
     }
+    return true;
 }
 
+// ===== 撮合引擎回調 =====
+
 void TradingSystem::handleMatchingEngineError(const std::string& error) {
-    std::cerr << "🚨 MatchingEngine Error: " << error << std::endl;
+    MTS_LOG_ERROR("🚨 MatchingEngine Error: {}", error);
     // 這裡可以加入更多的錯誤處理邏輯，例如：
     // - 記錄到日誌文件
     // - 發送系統警報
@@ -381,14 +693,14 @@ void TradingSystem::handleMatchingEngineError(const std::string& error) {
 
 // ===== 訊息轉換 =====
 
-std::shared_ptr<Order> TradingSystem::convertFixToOrder(const FixMessage& fixMsg, SOCKET clientSocket) {
-    // 提取 FIX 欄位
-    std::string clOrdId = fixMsg.getField(11);      // ClOrdID
-    std::string symbol = fixMsg.getField(55);       // Symbol
-    std::string sideStr = fixMsg.getField(54);      // Side
-    std::string qtyStr = fixMsg.getField(38);       // OrderQty
-    std::string typeStr = fixMsg.getField(40);      // OrdType
-    std::string priceStr = fixMsg.getField(44);     // Price (限價單才有)
+OrderHandle TradingSystem::convertFixToOrder(const FixMessageView& fixMsg, const SessionContext& session) {
+    // 提取 FIX 欄位（指向接收緩衝區，需要保存的才複製）
+    std::string_view clOrdId = fixMsg.getField(11);      // ClOrdID
+    std::string_view symbol = fixMsg.getField(55);       // Symbol
+    std::string_view sideStr = fixMsg.getField(54);      // Side
+    std::string_view qtyStr = fixMsg.getField(38);       // OrderQty
+    std::string_view typeStr = fixMsg.getField(40);      // OrdType
+    std::string_view priceStr = fixMsg.getField(44);     // Price (限價單才有)
     
     // 驗證必要欄位
     if (clOrdId.empty() || symbol.empty() || sideStr.empty() || qtyStr.empty() || typeStr.empty()) {
@@ -396,74 +708,61 @@ std::shared_ptr<Order> TradingSystem::convertFixToOrder(const FixMessage& fixMsg
     }
     
     // 轉換為業務物件
-    OrderID orderId = generateOrderId();
+    OrderID orderId = matchingEngine_->tagOrderId(generateOrderId(), symbol);  // 高位元標記所屬分片
     Side side = parseFixSide(sideStr);
     OrderType orderType = parseFixOrderType(typeStr);
-    Quantity quantity = std::stoull(qtyStr);
-    Price price = (orderType == OrderType::Market) ? 0.0 : std::stod(priceStr);
+    Quantity quantity = parseFixNumber<Quantity>(qtyStr, "OrderQty");
+    SymbolId symbolId(symbol);   // 駐留一次，精度查詢與建立訂單共用
+    Price price;
+    if (orderType != OrderType::Market) {
+        // 依標的精度直接把 44= 轉成 tick，不經過浮點數
+        if (!PriceScaleRegistry::forSymbol(symbolId).parse(priceStr, price)) {
+            throw std::invalid_argument("Invalid FIX Price: " + std::string(priceStr));
+        }
+    }
     
-    // 建立 Order 物件
-    auto order = std::make_shared<Order>(
+    // 從訂單池建立 Order
+    OrderHandle order = matchingEngine_->createOrder(
         orderId,
-        std::to_string(clientSocket), // 使用 clientSocket 作為 ClientID
-        symbol,
+        std::to_string(session.socket), // 使用 clientSocket 作為 ClientID
+        symbolId.str(),
         side,
         orderType,
         price,
         quantity
     );
-    
-    // 保存映射關係
-    {
-        std::lock_guard<std::mutex> lock(mappingsMutex_);
-        orderMappings_.emplace(orderId, OrderMapping(clientSocket, clOrdId, symbol));
+    if (order == INVALID_ORDER_HANDLE) {
+        throw std::runtime_error("Order pool exhausted");
     }
     
-    std::cout << "🔄 Converted FIX → Order: " << order->toString() << std::endl;
-    return order;
-}
-
-FixMessage TradingSystem::convertReportToFix(const ExecutionReportPtr& report) {
-    // 建立基本的 ExecutionReport
-    FixMessage fixMsg('8');  // MsgType = ExecutionReport
-    
-    // 設定標準欄位
-    fixMsg.setField(17, generateExecId());                    // ExecID
-    fixMsg.setField(150, std::string(1, getFixExecType(report->status))); // ExecType
-    fixMsg.setField(39, std::string(1, getFixOrdStatus(report->status)));  // OrdStatus
-    fixMsg.setField(55, report->symbol);                      // Symbol
-    fixMsg.setField(54, std::string(1, (report->side == Side::Buy) ? '1' : '2')); // Side
-    fixMsg.setField(38, std::to_string(report->originalQuantity)); // OrderQty
-    fixMsg.setField(151, std::to_string(report->remainingQuantity)); // LeavesQty
-    fixMsg.setField(14, std::to_string(report->filledQuantity));     // CumQty
-    
-    // 設定價格欄位
-    if (report->price > 0.0) {
-        std::ostringstream priceStr;
-        priceStr << std::fixed << std::setprecision(2) << report->price;
-        fixMsg.setField(44, priceStr.str());                  // Price
-    }
-    
-    // 如果有成交，設定成交資訊
-    if (report->executionQuantity > 0) {
-        fixMsg.setField(32, std::to_string(report->executionQuantity)); // LastQty
-        
-        if (report->executionPrice > 0.0) {
-            std::ostringstream execPriceStr;
-            execPriceStr << std::fixed << std::setprecision(2) << report->executionPrice;
-            fixMsg.setField(31, execPriceStr.str());          // LastPx
+    // 登記到 Session 的 ClOrdID 索引；同一 Session 內未終止的 ClOrdID 不可重複
+    std::string clOrdIdKey(clOrdId);
+    {
+        SessionOrderIndex::Entry entry;
+        entry.orderId = orderId;
+        entry.symbol = std::string(symbol);
+        entry.side = side;
+        entry.price = price;
+        entry.orderQty = quantity;
+        entry.leavesQty = quantity;
+        std::lock_guard<std::mutex> lock(session.orders->mutex);
+        if (!session.orders->byClOrdId.try_emplace(clOrdIdKey, std::move(entry)).second) {
+            matchingEngine_->discardOrder(order);
+            throw std::invalid_argument("Duplicate ClOrdID: " + clOrdIdKey);
         }
     }
+    OrderTracer::bindPending(orderId);
+    OrderTracer::trace(orderId, TraceStage::Convert);
     
-    // 如果有拒絕原因，設定 Text 欄位
-    if (!report->rejectReason.empty()) {
-        fixMsg.setField(58, report->rejectReason);            // Text
+    // 保存映射關係
+    {
+        std::lock_guard<std::mutex> lock(mappingsMutex_);
+        orderMappings_.emplace(orderId, OrderMapping(session, clOrdIdKey, std::string(symbol)));
     }
     
-    // 設定時間欄位
-    fixMsg.setField(60, formatCurrentTime());                // TransactTime
-    
-    return fixMsg;
+    MTS_LOG_DEBUG("🔄 Converted FIX → Order: OrderID={} ClOrdID={} Symbol={} Side={} Qty={} Price={}",
+                  orderId, clOrdId, symbol, sideStr, quantity, price.ticks());
+    return order;
 }
 
 // ===== 發送方法 =====
@@ -471,56 +770,88 @@ FixMessage TradingSystem::convertReportToFix(const ExecutionReportPtr& report) {
 bool TradingSystem::sendFixMessage(SOCKET clientSocket, const FixMessage& fixMsg) {
     try {
         std::string serialized = fixMsg.serialize();
-        std::cout << "📤 Sending FIX message to client " << clientSocket << ": " << serialized << std::endl;
+        MTS_LOG_DEBUG("📤 Sending FIX message to client {}: {}", clientSocket, serialized);
         
         return tcpServer_->sendMessage(static_cast<SOCKET>(clientSocket), serialized);
         
     } catch (const std::exception& e) {
-        std::cerr << "Error sending FIX message: " << e.what() << std::endl;
+        MTS_LOG_ERROR("Error sending FIX message: {}", e.what());
+        return false;
+    }
+}
+
+bool TradingSystem::sendExecutionReport(const std::shared_ptr<OutboundSession>& outbound,
+                                        const ExecutionReportFields& fields, OrderID orderId) {
+    // 一般回報放得進堆疊緩衝區；Text 過長時才改用 heap
+    char stackBuffer[1024];
+    std::vector<char> heapBuffer;
+    char* buffer = stackBuffer;
+    size_t capacity = sizeof(stackBuffer);
+    
+    size_t required = ExecutionReportEncoder::maxEncodedSize(fields);
+    if (required > capacity) {
+        heapBuffer.resize(required);
+        buffer = heapBuffer.data();
+        capacity = heapBuffer.size();
+    }
+    
+    std::string_view wire = ExecutionReportEncoder::encode(fields, buffer, capacity);
+    if (wire.empty()) {
+        MTS_LOG_ERROR("Failed to encode ExecutionReport for ClOrdID {}", fields.clOrdId);
         return false;
     }
+    
+    if (orderId != 0) {
+        OrderTracer::trace(orderId, TraceStage::Encode);
+    }
+    
+    return outbound_->send(outbound, wire, orderId);
 }
 
-void TradingSystem::sendOrderReject(SOCKET clientSocket, const FixMessage& originalMsg, const std::string& reason) {
+void TradingSystem::sendOrderReject(const SessionContext& session, const FixMessageView& originalMsg, const std::string& reason) {
     try {
-        std::cout << "❌ Sending Order Reject to client " << clientSocket << ": " << reason << std::endl;
-        
-        // 建立 ExecutionReport 表示拒絕
-        FixMessage rejectMsg('8');  // ExecutionReport
+        MTS_LOG_INFO("❌ Sending Order Reject to client {}: {}", session.socket, reason);
         
-        // 複製原始訊息的關鍵欄位
-        rejectMsg.setField(11, originalMsg.getField(11));     // ClOrdID
-        rejectMsg.setField(55, originalMsg.getField(55));     // Symbol
-        rejectMsg.setField(54, originalMsg.getField(54));     // Side
-        rejectMsg.setField(38, originalMsg.getField(38));     // OrderQty
+        // 建立 ExecutionReport 表示拒絕，欄位直接指向原始訊息
+        char execId[EXEC_ID_BUFFER_SIZE];
+        ExecutionReportFields fields;
+        fields.clOrdId = originalMsg.getField(11);            // ClOrdID
+        fields.symbol = originalMsg.getField(55);             // Symbol
+        std::string_view side = originalMsg.getField(54);     // Side
+        if (!side.empty()) {
+            fields.side = side[0];
+        }
+        std::string_view qty = originalMsg.getField(38);      // OrderQty（無法解析時為 0）
+        std::from_chars(qty.data(), qty.data() + qty.size(), fields.orderQty);
         
         // 設定拒絕狀態
-        rejectMsg.setField(17, generateExecId());             // ExecID
-        rejectMsg.setField(150, "8");                         // ExecType = Rejected
-        rejectMsg.setField(39, "8");                          // OrdStatus = Rejected
-        rejectMsg.setField(151, "0");                         // LeavesQty = 0
-        rejectMsg.setField(14, "0");                          // CumQty = 0
-        rejectMsg.setField(58, reason);                       // Text (拒絕原因)
-        rejectMsg.setField(60, formatCurrentTime());          // TransactTime
+        fields.execId = generateExecId(execId);               // ExecID
+        fields.execType = '8';                                // ExecType = Rejected
+        fields.ordStatus = '8';                               // OrdStatus = Rejected
+        fields.text = reason;                                 // Text (拒絕原因)
         
-        sendFixMessage(clientSocket, rejectMsg);
+        sendExecutionReport(session.outbound, fields);
         
     } catch (const std::exception& e) {
-        std::cerr << "Error sending order reject: " << e.what() << std::endl;
+        MTS_LOG_ERROR("Error sending order reject: {}", e.what());
     }
 }
 
 // ===== 工具方法 =====
 
-std::string TradingSystem::generateExecId() {
+std::string_view TradingSystem::generateExecId(char* buffer) {
     uint64_t execNum = nextExecId_.fetch_add(1);
     auto now = std::chrono::system_clock::now();
     auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()).count();
     
-    std::ostringstream oss;
-    oss << "EXEC_" << timestamp << "_" << execNum;
-    return oss.str();
+    // EXEC_<timestamp>_<序號>
+    char* end = buffer + EXEC_ID_BUFFER_SIZE;
+    std::memcpy(buffer, "EXEC_", 5);
+    char* p = std::to_chars(buffer + 5, end, timestamp).ptr;
+    *p++ = '_';
+    p = std::to_chars(p, end, execNum).ptr;
+    return std::string_view(buffer, static_cast<size_t>(p - buffer));
 }
 
 char TradingSystem::getFixExecType(OrderStatus status) {
@@ -545,19 +876,125 @@ char TradingSystem::getFixOrdStatus(OrderStatus status) {
     }
 }
 
+// ===== 訂單追蹤 =====
+
+bool TradingSystem::startTraceWriter() {
+    OrderTracer& tracer = OrderTracer::instance();
+    tracer.enable();
+    if (!traceWriter_.open(traceFile_, tracer.ticksPerNs())) {
+        tracer.disable();
+        return false;
+    }
+    
+    traceRunning_ = true;
+    traceThread_ = std::thread([this] {
+        std::vector<TraceEvent> events;
+        while (traceRunning_.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            events.clear();
+            OrderTracer::instance().drain(events);
+            traceWriter_.append(events);
+        }
+    });
+    
+    MTS_LOG_INFO("🔬 Order tracing enabled → {} ({} ticks/ns)", traceFile_, tracer.ticksPerNs());
+    return true;
+}
+
+void TradingSystem::stopTraceWriter() {
+    if (!traceWriter_.isOpen()) {
+        return;
+    }
+    
+    traceRunning_ = false;
+    if (traceThread_.joinable()) {
+        traceThread_.join();
+    }
+    
+    OrderTracer& tracer = OrderTracer::instance();
+    tracer.disable();
+    std::vector<TraceEvent> events;
+    tracer.drain(events);
+    traceWriter_.append(events);
+    traceWriter_.close();
+    
+    MTS_LOG_INFO("🔬 Order trace written to {} ({} events dropped)", traceFile_, tracer.droppedEvents());
+}
+
+// ===== 快照 =====
+
+bool TradingSystem::recoverMatchingEngine() {
+    RecoveryResult result;
+    if (!matchingEngine_->recover(journalDirectory_, result)) {
+        MTS_LOG_ERROR("❌ Failed to recover matching engine from {}", journalDirectory_);
+        return false;
+    }
+    // 新的 OrderID 不可與恢復的訂單重複
+    if (result.maxOrderId >= nextOrderId_.load()) {
+        nextOrderId_ = result.maxOrderId + 1;
+    }
+    if (result.lastSequence > 0) {
+        MTS_LOG_INFO("♻️ Recovered matching engine: {}", result.toString());
+    }
+    return true;
+}
+
+void TradingSystem::startSnapshotTimer() {
+    if (journalDirectory_.empty() || snapshotInterval_.count() <= 0) {
+        return;
+    }
+    snapshotRunning_ = true;
+    snapshotThread_ = std::thread([this] {
+        auto next = std::chrono::steady_clock::now() + snapshotInterval_;
+        while (snapshotRunning_.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (std::chrono::steady_clock::now() >= next) {
+                matchingEngine_->requestSnapshot();
+                next += snapshotInterval_;
+            }
+        }
+    });
+    MTS_LOG_INFO("📸 Snapshots every {}s into {}", snapshotInterval_.count(), journalDirectory_);
+}
+
+void TradingSystem::stopSnapshotTimer() {
+    snapshotRunning_ = false;
+    if (snapshotThread_.joinable()) {
+        snapshotThread_.join();
+    }
+}
+
 // ===== 清理方法 =====
 
-void TradingSystem::cleanupSession(SOCKET clientSocket) {
+void TradingSystem::cleanupSession(TCPServer::ConnectionId connectionId) {
     std::lock_guard<std::mutex> lock(sessionsMutex_);
-    sessions_.erase(clientSocket);
+    auto it = sessions_.find(connectionId);
+    if (it == sessions_.end()) {
+        return;
+    }
+    // 關閉輸出佇列：在途的回報直接丟棄，不再排給 IO 執行緒
+    if (it->second->context.outbound) {
+        outbound_->closeSession(*it->second->context.outbound);
+    }
+    sessions_.erase(it);
 }
 
 void TradingSystem::cleanupResources() {
     {
         std::lock_guard<std::mutex> lock(sessionsMutex_);
+        for (auto& pair : sessions_) {
+            if (pair.second->context.outbound) {
+                outbound_->closeSession(*pair.second->context.outbound);
+            }
+        }
         sessions_.clear();
     }
     
+    {
+        std::lock_guard<std::mutex> lock(acceptedMutex_);
+        acceptedConnections_.clear();
+    }
+    
     {
         std::lock_guard<std::mutex> lock(mappingsMutex_);
         orderMappings_.clear();
@@ -571,7 +1008,9 @@ void TradingSystem::printStatistics() {
     std::cout << "================================" << std::endl;
     
     if (matchingEngine_) {
-        std::cout << matchingEngine_->getStatistics().toString() << std::endl;
+        EngineStatistics statistics;
+        matchingEngine_->getStatistics(statistics);
+        std::cout << statistics.toString() << std::endl;
     }
     
     {
@@ -584,23 +1023,37 @@ void TradingSystem::printStatistics() {
         std::cout << "Pending Orders: " << orderMappings_.size() << std::endl;
     }
     
+    if (inbound_) {
+        std::cout << inbound_->getStatistics().toString() << std::endl;
+    }
+    if (outbound_) {
+        std::cout << outbound_->getStatistics().toString() << std::endl;
+    }
+    if (tcpServer_) {
+        const auto& send = tcpServer_->getSendStatistics();
+        std::cout << "Socket Writes: messages=" << send.messages.load()
+                  << " syscalls=" << send.write_calls.load()
+                  << " wouldBlock=" << send.would_block.load()
+                  << " queuedBytes=" << send.queued_bytes.load() << std::endl;
+    }
+    
     std::cout << "================================\n" << std::endl;
 }
 
 // ===== 工具函式 =====
 
-Side parseFixSide(const std::string& sideStr) {
+Side parseFixSide(std::string_view sideStr) {
     if (sideStr == "1") return Side::Buy;
     if (sideStr == "2") return Side::Sell;
-    throw std::invalid_argument("Invalid FIX side: " + sideStr);
+    throw std::invalid_argument("Invalid FIX side: " + std::string(sideStr));
 }
 
-OrderType parseFixOrderType(const std::string& typeStr) {
+OrderType parseFixOrderType(std::string_view typeStr) {
     if (typeStr == "1") return OrderType::Market;
     if (typeStr == "2") return OrderType::Limit;
     if (typeStr == "3") return OrderType::Stop;
     if (typeStr == "4") return OrderType::StopLimit;
-    throw std::invalid_argument("Invalid FIX order type: " + typeStr);
+    throw std::invalid_argument("Invalid FIX order type: " + std::string(typeStr));
 }
 
 std::string formatCurrentTime() {
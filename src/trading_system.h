@@ -1,34 +1,75 @@
 #pragma once
-#include "core/matching_engine.h"
+#include "core/sharded_matching_engine.h"
+#include "core/order_trace.h"
+#include "core/inbound_pipeline.h"
+#include "core/outbound_pipeline.h"
+#include "core/async_logger.h"
 #include "protocol/fix_message.h"
+#include "protocol/fix_message_view.h"
+#include "protocol/execution_report_encoder.h"
 #include "protocol/fix_message_builder.h"
 #include "protocol/fix_session.h"
 #include "network/tcp_server.h"
 #include <map>
+#include <unordered_map>
 #include <memory>
 #include <mutex>
 #include <atomic>
 #include <chrono>
+#include <string_view>
 
 using namespace mts::core;
 using namespace mts::protocol;
 using namespace mts::tcp_server;
 
+// ===== 每個 Session 的 ClOrdID 索引 =====
+// 閘道執行緒查詢（取消 / 狀態查詢）與登記，回報處理時更新狀態並在訂單終止時移除；
+// 每個 Session 各自一把鎖，不會碰到其他 Session 的資料
+struct SessionOrderIndex {
+    struct Entry {
+        OrderID orderId = 0;
+        std::string symbol;
+        Side side = Side::Buy;
+        Price price;
+        Quantity orderQty = 0;
+        Quantity cumQty = 0;
+        Quantity leavesQty = 0;
+        OrderStatus status = OrderStatus::New;
+    };
+    
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> byClOrdId;   // 只含尚未終止的訂單
+};
+
+// ===== 閘道處理單一連線時使用的資源 =====
+// FIX Session 的應用層回調持有一份，訂單映射也共用其中的索引與輸出佇列，
+// Session 關閉後仍在途的回報可安全處理（輸出佇列已關閉時直接丟棄）
+struct SessionContext {
+    TCPServer::ConnectionId connectionId = 0;          // 不重複的連線編號；socket 編號可能被重用，只用於記錄
+    SOCKET socket = INVALID_SOCKET;
+    std::weak_ptr<TCPServer::Connection> connection;   // 連線關閉後寫出與斷線一律失敗
+    std::shared_ptr<SessionOrderIndex> orders;
+    std::shared_ptr<OutboundSession> outbound;   // 回報、拒絕、狀態回覆都經此佇列，保持送出順序
+};
+
 // ===== 簡化的 ClientSession =====
 struct ClientSession {
     std::unique_ptr<FixSession> fixSession;
+    SessionContext context;
     std::atomic<bool> active{true};
     std::chrono::steady_clock::time_point connectTime;
     std::string clientInfo;  // 可選：客戶端資訊
     
-    explicit ClientSession(std::unique_ptr<FixSession> session, const std::string& info = "")
+    explicit ClientSession(std::unique_ptr<FixSession> session,
+                           SessionContext sessionContext, const std::string& info = "")
         : fixSession(std::move(session))
+        , context(std::move(sessionContext))
         , connectTime(std::chrono::steady_clock::now())
         , clientInfo(info) {}
     
     ~ClientSession() {
         active = false;
-        std::cout << "🧹 ClientSession destroyed for " << clientInfo << std::endl;
+        MTS_LOG_INFO("🧹 ClientSession destroyed for {}", clientInfo);
     }
     
     // 檢查 Session 是否健康
@@ -49,23 +90,33 @@ struct OrderMapping {
     SOCKET clientSocket;
     std::string clOrdId;
     std::string symbol;
+    std::shared_ptr<SessionOrderIndex> sessionOrders;   // 所屬 Session 的 ClOrdID 索引
+    std::shared_ptr<OutboundSession> outbound;           // 所屬 Session 的輸出佇列
     std::chrono::steady_clock::time_point createTime;
     
-    OrderMapping(SOCKET socket, const std::string& clOrd, const std::string& sym)
-        : clientSocket(socket), clOrdId(clOrd), symbol(sym)
+    OrderMapping(const SessionContext& session, const std::string& clOrd, const std::string& sym)
+        : clientSocket(session.socket), clOrdId(clOrd), symbol(sym)
+        , sessionOrders(session.orders), outbound(session.outbound)
         , createTime(std::chrono::steady_clock::now()) {}
 };
 
 class TradingSystem {
 private:
     // 核心組件
-    std::unique_ptr<MatchingEngine> matchingEngine_;
+    std::unique_ptr<ShardedMatchingEngine> matchingEngine_;
     std::unique_ptr<TCPServer> tcpServer_;
+    std::unique_ptr<InboundPipeline> inbound_;     // 解碼後的訊息交給 Session 執行緒，不佔用 reactor 執行緒
+    std::unique_ptr<OutboundPipeline> outbound_;   // 回報編碼與 socket 寫出，不佔用撮合執行緒
     
-    // Session 管理
-    std::map<SOCKET, std::unique_ptr<ClientSession>> sessions_;
+    // Session 管理：新增 / 移除只在連線所屬的 Session 執行緒上發生，
+    // 鎖只保護 map 結構（統計查詢、停止時清理），處理訊息時不持有
+    std::map<TCPServer::ConnectionId, std::unique_ptr<ClientSession>> sessions_;
     std::mutex sessionsMutex_;
     
+    // reactor 執行緒接受連線時登記，Session 執行緒處理對應的 Connect 事件時取走
+    std::unordered_map<TCPServer::ConnectionId, TCPServer::ConnectionPtr> acceptedConnections_;
+    std::mutex acceptedMutex_;
+    
     // 訂單映射
     std::map<OrderID, OrderMapping> orderMappings_;
     std::mutex mappingsMutex_;
@@ -77,6 +128,17 @@ private:
     // 系統狀態
     std::atomic<bool> running_{false};
     int serverPort_;
+    size_t reactorThreads_{2};  // TCPServer reactor 執行緒數 (僅 epoll 模式)
+    WaitStrategy waitStrategy_{WaitStrategy::Blocking};  // 撮合執行緒等待策略
+    size_t matchingThreads_{1};  // 撮合分片數（每個分片一條撮合執行緒）
+    size_t batchSize_{64};       // 撮合執行緒每次喚醒最多處理的訊息數
+    std::string traceFile_;      // 非空時開啟訂單生命週期追蹤並寫入此檔
+    std::string journalDirectory_;   // 非空時撮合引擎把輸入寫入此目錄的日誌，啟動時由此重建
+    std::chrono::seconds snapshotInterval_{60};   // 開啟日誌時定期快照的間隔，0 表示關閉
+    OutboundConfig outboundConfig_;               // 每分片的回報佇列、IO 執行緒數、Session 佇列上限與溢出策略
+    InboundConfig inboundConfig_;                 // Session 執行緒數、輸入佇列容量與綁核
+    CpuList decodeCpus_;                          // reactor（解碼）執行緒綁核
+    CpuList matchingCpus_;                        // 撮合分片執行緒綁核
     
     // 統計資訊
     std::atomic<uint64_t> totalConnections_{0};
@@ -96,6 +158,26 @@ public:
     void stop();
     bool isRunning() const { return running_.load(); }
     
+    // ===== 設定 (需在 start() 前呼叫) =====
+    void setReactorThreadCount(size_t count) { reactorThreads_ = count; }
+    void setWaitStrategy(WaitStrategy strategy) { waitStrategy_ = strategy; }
+    void setMatchingThreadCount(size_t count) { matchingThreads_ = count; }
+    void setBatchSize(size_t size) { batchSize_ = size; }
+    void setTraceFile(const std::string& path) { traceFile_ = path; }
+    void setJournalDirectory(const std::string& path) { journalDirectory_ = path; }
+    void setSnapshotInterval(std::chrono::seconds interval) { snapshotInterval_ = interval; }
+    void setOutboundIoThreadCount(size_t count) { outboundConfig_.ioThreadCount = count; }
+    void setOutboundQueueLimit(size_t messages) { outboundConfig_.sessionQueueLimit = messages; }
+    void setOutboundOverflowPolicy(OverflowPolicy policy) { outboundConfig_.overflowPolicy = policy; }
+    void setSessionThreadCount(size_t count) { inboundConfig_.stageThreadCount = count; }
+    
+    // ===== 管線各階段綁核（空清單表示不綁核；執行緒 i 使用 cpus[i % size]）=====
+    void setDecodeCpus(const CpuList& cpus) { decodeCpus_ = cpus; }
+    void setSessionCpus(const CpuList& cpus) { inboundConfig_.stageCpus = cpus; }
+    void setMatchingCpus(const CpuList& cpus) { matchingCpus_ = cpus; }
+    void setEncodeCpus(const CpuList& cpus) { outboundConfig_.encoderCpu = cpuForThread(cpus, 0); }
+    void setOutboundIoCpus(const CpuList& cpus) { outboundConfig_.ioCpus = cpus; }
+    
     // ===== 統計和監控 =====
     void printStatistics();
     void printSessionDetails();
@@ -105,36 +187,59 @@ public:
 private:
     // ===== 初始化 =====
     bool initializeMatchingEngine();
+    bool initializeOutboundPipeline();
+    bool initializeInboundPipeline();
     bool initializeTcpServer();
     
-    // ===== 連線處理 =====
-    void handleNewConnection(SOCKET clientSocket);
-    void handleClientDisconnection(SOCKET clientSocket);
-    void handleClientMessage(SOCKET clientSocket, const std::string& rawMessage);
+    // ===== 連線處理（Session 執行緒）=====
+    void handleInboundEvent(const InboundEvent& event);
+    void handleNewConnection(TCPServer::ConnectionId connectionId);
+    void handleClientDisconnection(TCPServer::ConnectionId connectionId);
+    void handleClientMessage(TCPServer::ConnectionId connectionId, std::string_view rawMessage);
     
     // ===== FIX 訊息處理 =====
-    void handleFixApplicationMessage(SOCKET clientSocket, const FixMessage& fixMsg);
-    void handleNewOrderSingle(SOCKET clientSocket, const FixMessage& fixMsg);
-    void handleOrderCancelRequest(SOCKET clientSocket, const FixMessage& fixMsg);
+    // 訊息以 FixMessageView 傳入，只在接收回調期間有效
+    void handleFixApplicationMessage(const SessionContext& session, const FixMessageView& fixMsg);
+    void handleNewOrderSingle(const SessionContext& session, const FixMessageView& fixMsg);
+    void handleOrderCancelRequest(const SessionContext& session, const FixMessageView& fixMsg);
+    void handleOrderStatusRequest(const SessionContext& session, const FixMessageView& fixMsg);
     
     // ===== 撮合引擎回調 =====
-    void handleExecutionReport(const ExecutionReportPtr& report);
     void handleMatchingEngineError(const std::string& error);
     
+    // ===== 輸出管線（編碼執行緒 / IO 執行緒）=====
+    // 訂單映射查詢、Session 索引更新、FIX 編碼後放入各 Session 的輸出佇列
+    void encodeExecutionReports(const ReportEvent* events, size_t count);
+    // IO 執行緒：經由連線本身寫出，連線已關閉（connection 為空或已標記關閉）時回傳 false
+    bool writeOutbound(const TCPServer::ConnectionPtr& connection, const OutboundMessage* messages, size_t count);
+    
     // ===== 轉換和工具 =====
-    std::shared_ptr<Order> convertFixToOrder(const FixMessage& fixMsg, SOCKET clientSocket);
-    FixMessage convertReportToFix(const ExecutionReportPtr& report);
+    // 同時登記到 Session 的 ClOrdID 索引；ClOrdID 與未終止的訂單重複時丟出例外
+    OrderHandle convertFixToOrder(const FixMessageView& fixMsg, const SessionContext& session);
     bool sendFixMessage(SOCKET clientSocket, const FixMessage& fixMsg);
-    void sendOrderReject(SOCKET clientSocket, const FixMessage& originalMsg, const std::string& reason);
+    // 編碼後放入 Session 的輸出佇列；orderId 非 0 時記錄 Encode 追蹤點（Send 由 IO 執行緒記錄）
+    bool sendExecutionReport(const std::shared_ptr<OutboundSession>& outbound, const ExecutionReportFields& fields,
+                             OrderID orderId = 0);
+    void sendOrderReject(const SessionContext& session, const FixMessageView& originalMsg, const std::string& reason);
     
     // ===== 輔助方法 =====
     OrderID generateOrderId() { return nextOrderId_.fetch_add(1); }
-    std::string generateExecId();
+    static constexpr size_t EXEC_ID_BUFFER_SIZE = 48;
+    std::string_view generateExecId(char* buffer);   // buffer 至少 EXEC_ID_BUFFER_SIZE
     char getFixExecType(OrderStatus status);
     char getFixOrdStatus(OrderStatus status);
     
+    // ===== 訂單追蹤 =====
+    bool startTraceWriter();
+    void stopTraceWriter();
+    
+    // ===== 快照 =====
+    bool recoverMatchingEngine();
+    void startSnapshotTimer();
+    void stopSnapshotTimer();
+    
     // ===== 清理 =====
-    void cleanupSession(SOCKET clientSocket);
+    void cleanupSession(TCPServer::ConnectionId connectionId);
     void cleanupResources();
     
     // ===== Session 健康檢查 =====
@@ -146,9 +251,18 @@ private:
     // 週期性任務
     std::unique_ptr<std::thread> healthCheckThread_;
     std::atomic<bool> healthCheckRunning_{false};
+    
+    // 追蹤事件定期從各執行緒 ring 取出寫檔
+    TraceFileWriter traceWriter_;
+    std::thread traceThread_;
+    std::atomic<bool> traceRunning_{false};
+    
+    // 定期要求撮合引擎快照
+    std::thread snapshotThread_;
+    std::atomic<bool> snapshotRunning_{false};
 };
 
 // ===== 工具函式 =====
-Side parseFixSide(const std::string& sideStr);
-OrderType parseFixOrderType(const std::string& typeStr);
+Side parseFixSide(std::string_view sideStr);
+OrderType parseFixOrderType(std::string_view typeStr);
 std::string formatCurrentTime();
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "../src/core/async_logger.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mts::core;
+
+namespace {
+
+    template <typename... Args>
+    std::string render(const char* format, const Args&... args) {
+        char buffer[LogRecord::ARG_CAPACITY];
+        LogArgWriter writer(buffer, sizeof(buffer));
+        (encodeLogArg(writer, args), ...);
+        std::string out;
+        AsyncLogger::formatMessage(format, buffer, writer.size(), writer.truncated(), out);
+        return out;
+    }
+
+    std::vector<std::string> readLines(const std::string& path) {
+        std::ifstream in(path);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(in, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    enum class Color { Red = 3 };
+
+} // namespace
+
+// 測試各型別參數的編碼與格式化
+TEST(AsyncLoggerTest, FormatsTypedArguments) {
+    std::string name = "AAPL";
+    std::string_view view = "view";
+    const char* nullText = nullptr;
+    EXPECT_EQ(render("i={} u={} c={} b={} s={} v={} n={} e={}",
+                     -42, 7ull, 'x', true, name, view, nullText, Color::Red),
+              "i=-42 u=7 c=x b=true s=AAPL v=view n=(null) e=3");
+    EXPECT_EQ(render("px={}", 1.5), "px=1.5");
+    EXPECT_EQ(render("missing {} {}", 1), "missing 1 {}");
+    EXPECT_EQ(render("no args"), "no args");
+}
+
+// 測試字元陣列：字串常值與未以 '\0' 結尾的固定長度欄位
+TEST(AsyncLoggerTest, FormatsCharArrays) {
+    char symbol[8] = "MSFT";
+    char packed[4] = {'A', 'B', 'C', 'D'};
+    const char literal[] = "lit";
+    EXPECT_EQ(render("{} {} {}", symbol, packed, literal), "MSFT ABCD lit");
+}
+
+// 測試過長字串截斷，後續參數捨棄
+TEST(AsyncLoggerTest, TruncatesLongArguments) {
+    std::string big(LogRecord::ARG_CAPACITY * 2, 'a');
+    std::string out = render("{} {}", big, 5);
+    EXPECT_LT(out.size(), big.size());
+    EXPECT_EQ(out.substr(out.size() - std::string("{}…").size()), "{}…");
+}
+
+// 測試 ring 已滿時丟棄並計數
+TEST(AsyncLoggerTest, RingDropsWhenFull) {
+    LogRing ring(2, 0);
+    ASSERT_NE(ring.claim(), nullptr);
+    ring.publish();
+    ASSERT_NE(ring.claim(), nullptr);
+    ring.publish();
+    EXPECT_EQ(ring.claim(), nullptr);
+    EXPECT_EQ(ring.dropped(), 1u);
+
+    EXPECT_EQ(ring.available(), 2u);
+    ring.release(2);
+    EXPECT_EQ(ring.available(), 0u);
+    EXPECT_NE(ring.claim(), nullptr);
+}
+
+// 測試執行緒結束後 ring 清空即給新執行緒沿用，ring 數量不隨執行緒總數成長
+TEST(AsyncLoggerTest, RecyclesRingsOfExitedThreads) {
+    const std::string path = "test_async_logger_recycle.log";
+    std::remove(path.c_str());
+    AsyncLogger& logger = AsyncLogger::instance();
+    ASSERT_TRUE(logger.setOutputFile(path));
+
+    std::thread([] { AsyncLogger::write(LogLevel::Info, "warm up"); }).join();
+    logger.flush();
+    size_t rings = logger.ringCount();
+
+    for (int t = 0; t < 20; ++t) {
+        std::thread([t] { AsyncLogger::write(LogLevel::Info, "short-lived {}", t); }).join();
+        logger.flush();
+    }
+    EXPECT_EQ(logger.ringCount(), rings);
+
+    // 尚未讀完的 ring 不可被重用：兩條執行緒先後結束但不 flush，記錄都要保留
+    std::thread([] { AsyncLogger::write(LogLevel::Info, "pending a"); }).join();
+    std::thread([] { AsyncLogger::write(LogLevel::Info, "pending b"); }).join();
+    logger.flush();
+    ASSERT_TRUE(logger.setOutputFile(""));
+
+    auto lines = readLines(path);
+    ASSERT_EQ(lines.size(), 23u);
+    EXPECT_NE(lines[21].find("pending"), std::string::npos);
+    EXPECT_NE(lines[22].find("pending"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+// 測試多執行緒寫入後 flush 到檔案，並套用執行期等級
+TEST(AsyncLoggerTest, WritesAllThreadsToFile) {
+    const std::string path = "test_async_logger.log";
+    std::remove(path.c_str());
+    AsyncLogger& logger = AsyncLogger::instance();
+    ASSERT_TRUE(logger.setOutputFile(path));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 100; ++i) {
+                AsyncLogger::write(LogLevel::Info, "thread {} record {}", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    logger.setLevel(LogLevel::Warn);
+    AsyncLogger::write(LogLevel::Info, "filtered");
+    AsyncLogger::write(LogLevel::Error, "kept {}", "error");
+    logger.setLevel(LogLevel::Debug);
+
+    logger.flush();
+    ASSERT_TRUE(logger.setOutputFile(""));
+
+    auto lines = readLines(path);
+    ASSERT_EQ(lines.size(), 401u);
+    EXPECT_NE(lines[0].find("[INFO ]"), std::string::npos);
+    EXPECT_NE(lines.back().find("[ERROR] "), std::string::npos);
+    EXPECT_NE(lines.back().find("kept error"), std::string::npos);
+    for (const auto& line : lines) {
+        EXPECT_EQ(line.find("filtered"), std::string::npos);
+    }
+    EXPECT_EQ(logger.droppedRecords(), 0u);
+    std::remove(path.c_str());
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
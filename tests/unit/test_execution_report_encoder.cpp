@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "../src/protocol/execution_report_encoder.h"
+#include "../src/protocol/fix_message.h"
+#include "../src/protocol/fix_message_view.h"
+#include <string>
+#include <vector>
+
+using namespace mts::protocol;
+
+class ExecutionReportEncoderTest : public ::testing::Test {
+protected:
+    // 2023-08-17 10:01:00.123 UTC
+    const std::chrono::system_clock::time_point fixedTime =
+        std::chrono::system_clock::time_point(std::chrono::milliseconds(1692266460123LL));
+
+    ExecutionReportFields partialFill() const {
+        ExecutionReportFields fields;
+        fields.clOrdId = "BUY_001";
+        fields.execId = "EXEC_1692266460123_1";
+        fields.execType = '1';
+        fields.ordStatus = '1';
+        fields.symbol = "AAPL";
+        fields.side = '1';
+        fields.orderQty = 100;
+        fields.leavesQty = 40;
+        fields.cumQty = 60;
+        fields.lastQty = 60;
+        fields.price = mts::core::Price(15050);
+        fields.lastPx = mts::core::Price(15025);
+        return fields;
+    }
+
+    std::string encode(const ExecutionReportFields& fields, uint32_t seqNum = 7) const {
+        std::vector<char> buffer(ExecutionReportEncoder::maxEncodedSize(fields));
+        return std::string(ExecutionReportEncoder::encode(fields, buffer.data(), buffer.size(), seqNum, fixedTime));
+    }
+};
+
+TEST_F(ExecutionReportEncoderTest, ProducesValidMessage) {
+    std::string wire = encode(partialFill());
+    ASSERT_FALSE(wire.empty());
+
+    FixMessageView view = FixMessageView::parse(wire);   // checksum 不符會丟例外
+    EXPECT_TRUE(view.isValid());
+    EXPECT_EQ(view.getField(8), "FIX.4.2");
+    EXPECT_EQ(view.getMsgType(), '8');
+    EXPECT_EQ(view.getMsgSeqNum(), 7);
+    EXPECT_EQ(view.getField(11), "BUY_001");
+    EXPECT_EQ(view.getField(17), "EXEC_1692266460123_1");
+    EXPECT_EQ(view.getField(150), "1");
+    EXPECT_EQ(view.getField(39), "1");
+    EXPECT_EQ(view.getField(55), "AAPL");
+    EXPECT_EQ(view.getField(54), "1");
+    EXPECT_EQ(view.getField(38), "100");
+    EXPECT_EQ(view.getField(151), "40");
+    EXPECT_EQ(view.getField(14), "60");
+    EXPECT_EQ(view.getField(32), "60");
+    EXPECT_EQ(view.getField(44), "150.50");
+    EXPECT_EQ(view.getField(31), "150.25");
+    EXPECT_EQ(view.getField(52), "20230817-10:01:00.123");
+    EXPECT_EQ(view.getField(60), "20230817-10:01:00");
+    EXPECT_FALSE(view.hasField(58));
+}
+
+TEST_F(ExecutionReportEncoderTest, BodyLengthMatchesWire) {
+    std::string wire = encode(partialFill());
+
+    size_t bodyStart = wire.find("\x01" "35=") + 1;
+    size_t bodyEnd = wire.rfind("10=");
+    FixMessageView view = FixMessageView::parse(wire);
+    EXPECT_EQ(view.getField(9), std::to_string(bodyEnd - bodyStart));
+    EXPECT_EQ(wire.back(), FixMessage::SOH);
+}
+
+TEST_F(ExecutionReportEncoderTest, MatchesFixMessageSerialize) {
+    ExecutionReportFields fields = partialFill();
+    fields.text = "partial";
+    std::string wire = encode(fields, 42);
+
+    FixMessage msg(FixMessage::ExecutionReport);
+    msg.setField(FixMessage::MsgSeqNum, "42");
+    msg.setField(FixMessage::SendingTime, "20230817-10:01:00.123");
+    msg.setField(11, "BUY_001");
+    msg.setField(17, "EXEC_1692266460123_1");
+    msg.setField(150, "1");
+    msg.setField(39, "1");
+    msg.setField(55, "AAPL");
+    msg.setField(54, "1");
+    msg.setField(38, "100");
+    msg.setField(151, "40");
+    msg.setField(14, "60");
+    msg.setField(32, "60");
+    msg.setField(44, "150.50");
+    msg.setField(31, "150.25");
+    msg.setField(58, "partial");
+    msg.setField(60, "20230817-10:01:00");
+
+    EXPECT_EQ(wire, msg.serialize());
+}
+
+TEST_F(ExecutionReportEncoderTest, OptionalFieldsOmitted) {
+    ExecutionReportFields fields;
+    fields.clOrdId = "MKT_1";
+    fields.execId = "E1";
+    fields.symbol = "TSLA";
+    fields.side = '2';
+    fields.orderQty = 10;
+    fields.leavesQty = 10;
+
+    FixMessageView view = FixMessageView::parse(encode(fields));
+    EXPECT_FALSE(view.hasField(44));
+    EXPECT_FALSE(view.hasField(31));
+    EXPECT_FALSE(view.hasField(32));
+    EXPECT_EQ(view.getField(14), "0");
+}
+
+TEST_F(ExecutionReportEncoderTest, UsesSymbolPriceScale) {
+    ExecutionReportFields fields = partialFill();
+    fields.priceScale = mts::core::PriceScale(4);
+    fields.price = mts::core::Price(1234567);     // 123.4567
+    fields.lastPx = mts::core::Price(5);          // 0.0005
+
+    FixMessageView view = FixMessageView::parse(encode(fields));
+    EXPECT_EQ(view.getField(44), "123.4567");
+    EXPECT_EQ(view.getField(31), "0.0005");
+}
+
+TEST_F(ExecutionReportEncoderTest, RejectsSmallBuffer) {
+    ExecutionReportFields fields = partialFill();
+    std::vector<char> buffer(ExecutionReportEncoder::maxEncodedSize(fields) - 1);
+    EXPECT_TRUE(ExecutionReportEncoder::encode(fields, buffer.data(), buffer.size(), 1, fixedTime).empty());
+}
+
+TEST_F(ExecutionReportEncoderTest, RejectsOversizedBody) {
+    ExecutionReportFields fields = partialFill();
+    std::string text(10000, 'x');
+    fields.text = text;
+    std::vector<char> buffer(ExecutionReportEncoder::maxEncodedSize(fields));
+    EXPECT_TRUE(ExecutionReportEncoder::encode(fields, buffer.data(), buffer.size(), 1, fixedTime).empty());
+}
+
+TEST_F(ExecutionReportEncoderTest, DefaultOverloadUsesSharedSequence) {
+    ExecutionReportFields fields = partialFill();
+    std::vector<char> buffer(ExecutionReportEncoder::maxEncodedSize(fields));
+
+    int first = *FixMessageView::parse(ExecutionReportEncoder::encode(fields, buffer.data(), buffer.size())).getMsgSeqNum();
+    int next = *FixMessage(FixMessage::Heartbeat).getMsgSeqNum();
+    EXPECT_EQ(next, first + 1);
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "../src/protocol/fix_message_view.h"
+#include <stdexcept>
+#include <string>
+
+using namespace mts::protocol;
+
+class FixMessageViewTest : public ::testing::Test {
+protected:
+    // fix_messages_only.txt 中的 NewOrderSingle（BodyLength 與 CheckSum 皆為線上正確值）
+    const std::string newOrder =
+        "8=FIX.4.4|9=115|35=D|49=CLIENT1|56=SERVER|34=2|52=20230817-10:01:00|11=BUY_001|17=EXEC_001|"
+        "55=AAPL|54=1|38=100|40=2|44=150.00|59=0|10=151|";
+    const std::string logon =
+        "8=FIX.4.4|9=70|35=A|49=CLIENT1|56=SERVER|34=1|52=20230817-10:00:00|98=0|108=30|141=Y|10=027|";
+};
+
+TEST_F(FixMessageViewTest, ParseNewOrderSingle) {
+    FixMessageView view = FixMessageView::parse(newOrder);
+
+    EXPECT_EQ(view.getFieldCount(), 16u);
+    EXPECT_EQ(view.getMsgType(), 'D');
+    EXPECT_EQ(view.getField(11), "BUY_001");
+    EXPECT_EQ(view.getField(55), "AAPL");
+    EXPECT_EQ(view.getField(44), "150.00");
+    EXPECT_EQ(view.getMsgSeqNum(), 2);
+    EXPECT_EQ(*view.getSenderCompID(), "CLIENT1");
+    EXPECT_TRUE(view.isApplicationMessage());
+    EXPECT_FALSE(view.isAdminMessage());
+    EXPECT_TRUE(view.isValid());
+}
+
+TEST_F(FixMessageViewTest, ValuesPointIntoBuffer) {
+    FixMessageView view = FixMessageView::parse(newOrder);
+
+    // 零複製：欄位值位於原始字串內
+    std::string_view symbol = view.getField(55);
+    EXPECT_GE(symbol.data(), newOrder.data());
+    EXPECT_LT(symbol.data(), newOrder.data() + newOrder.size());
+    EXPECT_EQ(view.raw().data(), newOrder.data());
+}
+
+TEST_F(FixMessageViewTest, MissingField) {
+    FixMessageView view = FixMessageView::parse(logon);
+
+    EXPECT_FALSE(view.hasField(55));
+    EXPECT_TRUE(view.getField(55).empty());
+    EXPECT_FALSE(view.getFieldOptional(55).has_value());
+    EXPECT_TRUE(view.isAdminMessage());
+}
+
+TEST_F(FixMessageViewTest, ChecksumMismatchThrows) {
+    std::string broken = newOrder;
+    broken.replace(broken.find("10=151"), 6, "10=152");
+
+    EXPECT_THROW(FixMessageView::parse(broken), std::runtime_error);
+    EXPECT_NO_THROW(FixMessageView::parseUnsafe(broken));
+    EXPECT_FALSE(FixMessageView::parseUnsafe(broken).validateChecksum());
+}
+
+TEST_F(FixMessageViewTest, InvalidTagThrows) {
+    EXPECT_THROW(FixMessageView::parse(""), std::runtime_error);
+    EXPECT_THROW(FixMessageView::parseUnsafe("8=FIX.4.4|ABC=1|"), std::runtime_error);
+    EXPECT_THROW(FixMessageView::parseUnsafe("8=FIX.4.4|0=1|"), std::runtime_error);
+}
+
+TEST_F(FixMessageViewTest, SerializedMessageRoundTrip) {
+    FixMessage original('D');
+    original.setField(FixMessage::SenderCompID, "CLIENT1");
+    original.setField(FixMessage::TargetCompID, "SERVER");
+    original.setField(11, "ORDER123");
+    original.setField(55, "MSFT");
+
+    std::string wire = original.serialize();  // SOH 分隔
+    FixMessageView view = FixMessageView::parse(wire);
+    EXPECT_TRUE(view.isValid());
+    EXPECT_EQ(view.getField(55), "MSFT");
+
+    FixMessage copy = view.toFixMessage();
+    EXPECT_EQ(copy.getField(11), "ORDER123");
+    EXPECT_EQ(copy.getFieldCount(), view.getFieldCount());
+    EXPECT_TRUE(copy.validateChecksum());
+}
+
+TEST_F(FixMessageViewTest, OverflowBeyondInlineCapacity) {
+    std::string raw = "8=FIX.4.4|35=D|";
+    for (int tag = 5000; tag < 5000 + static_cast<int>(FixMessageView::INLINE_FIELDS) + 8; ++tag) {
+        raw += std::to_string(tag) + "=" + std::to_string(tag) + "|";
+    }
+
+    FixMessageView view = FixMessageView::parseUnsafe(raw);
+    EXPECT_EQ(view.getFieldCount(), FixMessageView::INLINE_FIELDS + 10);
+    EXPECT_EQ(view.getField(5039), "5039");
+    EXPECT_EQ(view.getField(5000), "5000");
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
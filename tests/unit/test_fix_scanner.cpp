@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "../src/protocol/fix_scanner.h"
+#include "../src/protocol/fix_message.h"
+#include <string>
+#include <vector>
+
+using namespace mts::protocol;
+
+class FixScannerTest : public ::testing::Test {
+protected:
+    const std::string newOrder =
+        "8=FIX.4.4|9=115|35=D|49=CLIENT1|56=SERVER|34=2|52=20230817-10:01:00|11=BUY_001|17=EXEC_001|"
+        "55=AAPL|54=1|38=100|40=2|44=150.00|59=0|10=151|";
+
+    static unsigned referenceChecksum(const std::string& raw, size_t end) {
+        unsigned sum = 0;
+        for (size_t i = 0; i < end; ++i) {
+            sum += (raw[i] == '|') ? 1u : static_cast<unsigned char>(raw[i]);
+        }
+        return sum % 256;
+    }
+};
+
+TEST_F(FixScannerTest, FieldBoundaries) {
+    FixFieldSpan spans[32];
+    FixScanSummary summary = FixScanner::scan(newOrder, spans, 32);
+
+    ASSERT_EQ(summary.fieldCount, 16u);
+    EXPECT_EQ(spans[0].tag(newOrder), "8");
+    EXPECT_EQ(spans[0].value(newOrder), "FIX.4.4");
+    EXPECT_EQ(FixScanner::parseTag(newOrder, spans[9]), 55);
+    EXPECT_EQ(spans[9].value(newOrder), "AAPL");
+    EXPECT_EQ(spans[15].value(newOrder), "151");
+}
+
+TEST_F(FixScannerTest, ChecksumMatchesWireValue) {
+    FixFieldSpan spans[32];
+    FixScanSummary summary = FixScanner::scan(newOrder, spans, 32);
+
+    ASSERT_TRUE(summary.hasChecksumField());
+    EXPECT_EQ(summary.checksumOffset, newOrder.find("10=151"));
+    EXPECT_EQ(summary.checksum, 151);
+}
+
+TEST_F(FixScannerTest, SimdMatchesScalarAtEveryLength) {
+    // 涵蓋所有區塊邊界與尾端長度組合，並在 value 中放入額外的 '='
+    std::string raw = "8=FIX.4.4\x01" "9=5\x01" "58=a=b\x01";
+    for (int i = 0; raw.size() < 200; ++i) {
+        raw += std::to_string(100 + i) + "=" + std::string(static_cast<size_t>(i % 7), 'x') + ((i % 2) ? "|" : "\x01");
+    }
+    raw += "10=000|";
+
+    for (size_t length = 0; length <= raw.size(); ++length) {
+        std::string_view prefix(raw.data(), length);
+        FixFieldSpan fast[128];
+        FixFieldSpan slow[128];
+        FixScanSummary a = FixScanner::scan(prefix, fast, 128);
+        FixScanSummary b = FixScanner::scanScalar(prefix, slow, 128);
+
+        ASSERT_EQ(a.fieldCount, b.fieldCount) << "length " << length;
+        ASSERT_EQ(a.checksumOffset, b.checksumOffset) << "length " << length;
+        ASSERT_EQ(a.checksum, b.checksum) << "length " << length;
+        for (size_t i = 0; i < a.fieldCount; ++i) {
+            ASSERT_EQ(fast[i].tagBegin, slow[i].tagBegin);
+            ASSERT_EQ(fast[i].equalPos, slow[i].equalPos);
+            ASSERT_EQ(fast[i].valueEnd, slow[i].valueEnd);
+        }
+
+        size_t end = a.hasChecksumField() ? a.checksumOffset : length;
+        ASSERT_EQ(a.checksum, referenceChecksum(raw, end)) << "length " << length;
+    }
+}
+
+TEST_F(FixScannerTest, EqualsInsideValueIsNotTagSeparator) {
+    std::string raw = "58=x=y|10=000|";
+    FixFieldSpan spans[4];
+    FixScanSummary summary = FixScanner::scan(raw, spans, 4);
+
+    ASSERT_EQ(summary.fieldCount, 2u);
+    EXPECT_EQ(spans[0].value(raw), "x=y");
+}
+
+TEST_F(FixScannerTest, CapacityOverflowReportsTotal) {
+    FixFieldSpan spans[4];
+    FixScanSummary summary = FixScanner::scan(newOrder, spans, 4);
+
+    EXPECT_EQ(summary.fieldCount, 16u);
+    EXPECT_EQ(spans[3].value(newOrder), "CLIENT1");
+}
+
+TEST_F(FixScannerTest, MatchesSerializedMessageChecksum) {
+    FixMessage msg('D');
+    msg.setField(11, "ORDER123");
+    msg.setField(55, "AAPL");
+    std::string wire = msg.serialize();
+
+    FixFieldSpan spans[32];
+    FixScanSummary summary = FixScanner::scan(wire, spans, 32);
+    std::string expected = std::to_string(1000 + summary.checksum).substr(1);  // 補零到 3 位
+    EXPECT_EQ(FixMessage::parse(wire).getField(10), expected);
+}
+
+TEST_F(FixScannerTest, InvalidTags) {
+    std::string raw = "abc=1|=2|0=3|";
+    FixFieldSpan spans[4];
+    FixScanSummary summary = FixScanner::scan(raw, spans, 4);
+
+    ASSERT_EQ(summary.fieldCount, 3u);
+    EXPECT_EQ(FixScanner::parseTag(raw, spans[0]), 0);
+    EXPECT_EQ(FixScanner::parseTag(raw, spans[1]), 0);
+    EXPECT_EQ(FixScanner::parseTag(raw, spans[2]), 0);
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    std::cout << "FixScanner backend: " << FixScanner::backend() << std::endl;
+    return RUN_ALL_TESTS();
+}
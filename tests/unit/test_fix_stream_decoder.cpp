@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include "../src/network/fix_stream_decoder.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace mts::tcp_server;
+
+class FixStreamDecoderTest : public ::testing::Test {
+protected:
+    // fix_messages_only.txt 中的 Logon 與 NewOrderSingle
+    const std::string logon =
+        "8=FIX.4.4|9=70|35=A|49=CLIENT1|56=SERVER|34=1|52=20230817-10:00:00|98=0|108=30|141=Y|10=027|";
+    const std::string newOrder =
+        "8=FIX.4.4|9=115|35=D|49=CLIENT1|56=SERVER|34=2|52=20230817-10:01:00|11=BUY_001|17=EXEC_001|"
+        "55=AAPL|54=1|38=100|40=2|44=150.00|59=0|10=151|";
+
+    FixStreamDecoder decoder;
+
+    void feed(const std::string& bytes) {
+        auto space = decoder.prepare(bytes.size());
+        ASSERT_GE(space.size, bytes.size());
+        std::memcpy(space.data, bytes.data(), bytes.size());
+        decoder.commit(bytes.size());
+    }
+
+    std::vector<std::string> drain() {
+        std::vector<std::string> frames;
+        std::string_view frame;
+        while (decoder.next(frame)) {
+            frames.emplace_back(frame);
+        }
+        return frames;
+    }
+};
+
+TEST_F(FixStreamDecoderTest, SingleMessage) {
+    feed(logon);
+    auto frames = drain();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0], logon);
+    EXPECT_EQ(decoder.buffered(), 0u);
+}
+
+TEST_F(FixStreamDecoderTest, PipelinedMessagesInOneRead) {
+    std::string burst;
+    for (int i = 0; i < 100; ++i) {
+        burst += newOrder + "\r\n";
+    }
+    feed(logon + "\n" + burst);
+
+    auto frames = drain();
+    ASSERT_EQ(frames.size(), 101u);
+    EXPECT_EQ(frames.front(), logon);
+    EXPECT_EQ(frames.back(), newOrder);
+    EXPECT_EQ(decoder.getStatistics().framing_errors, 0u);
+}
+
+TEST_F(FixStreamDecoderTest, MessageSplitAcrossReads) {
+    // 逐位元組送入，只有最後一個位元組到達時才完成
+    for (size_t i = 0; i + 1 < newOrder.size(); ++i) {
+        feed(newOrder.substr(i, 1));
+        EXPECT_TRUE(drain().empty()) << "premature frame at byte " << i;
+    }
+    feed(newOrder.substr(newOrder.size() - 1));
+
+    auto frames = drain();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0], newOrder);
+}
+
+TEST_F(FixStreamDecoderTest, SohDelimiter) {
+    std::string soh = logon;
+    for (auto& c : soh) {
+        if (c == '|') c = '\x01';
+    }
+    feed(soh + soh);
+
+    auto frames = drain();
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[1], soh);
+}
+
+TEST_F(FixStreamDecoderTest, TrailingDelimiterOmittedBeforeNewline) {
+    std::string line = logon.substr(0, logon.size() - 1) + "\r\n";
+    feed(line);
+
+    auto frames = drain();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0], logon.substr(0, logon.size() - 1));
+}
+
+TEST_F(FixStreamDecoderTest, ResyncAfterGarbage) {
+    feed("garbage\n" + logon + "XYZ" + newOrder);
+
+    auto frames = drain();
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[0], logon);
+    EXPECT_EQ(frames[1], newOrder);
+    EXPECT_EQ(decoder.getStatistics().framing_errors, 2u);
+    EXPECT_EQ(decoder.getStatistics().discarded_bytes, 10u);
+}
+
+TEST_F(FixStreamDecoderTest, ResyncAfterWrongBodyLength) {
+    // BodyLength 少算 5 位元組，10= 不在預期位置
+    std::string broken = logon;
+    broken.replace(broken.find("9=70"), 4, "9=65");
+    feed(broken + newOrder);
+
+    auto frames = drain();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0], newOrder);
+    EXPECT_EQ(decoder.getStatistics().framing_errors, 1u);
+}
+
+TEST_F(FixStreamDecoderTest, OversizedBodyLengthRejected) {
+    FixStreamDecoder small(256, 64);
+    std::string header = "8=FIX.4.4|9=100000|35=D|";
+    auto space = small.prepare(header.size());
+    std::memcpy(space.data, header.data(), header.size());
+    small.commit(header.size());
+
+    std::string_view frame;
+    EXPECT_FALSE(small.next(frame));
+    EXPECT_EQ(small.getStatistics().framing_errors, 1u);
+}
+
+TEST_F(FixStreamDecoderTest, BufferCompactsAndGrows) {
+    FixStreamDecoder small(256);
+    std::string_view frame;
+    size_t frames = 0;
+
+    // 每次只送入半則訊息，迫使緩衝區反覆 compaction
+    std::string stream;
+    for (int i = 0; i < 50; ++i) {
+        stream += newOrder;
+    }
+    const size_t chunk = newOrder.size() / 2;
+    for (size_t offset = 0; offset < stream.size(); offset += chunk) {
+        size_t n = std::min(chunk, stream.size() - offset);
+        auto space = small.prepare(n);
+        std::memcpy(space.data, stream.data() + offset, n);
+        small.commit(n);
+        while (small.next(frame)) {
+            EXPECT_EQ(frame, newOrder);
+            ++frames;
+        }
+    }
+    EXPECT_EQ(frames, 50u);
+    EXPECT_EQ(small.buffered(), 0u);
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "../src/core/inbound_pipeline.h"
+#include "../src/core/thread_affinity.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mts::core;
+
+// ===== 綁核設定 =====
+
+// 測試 CPU 清單解析與輪流分配
+TEST(ThreadAffinityTest, ParsesCpuLists) {
+    EXPECT_EQ(parseCpuList("3"), (CpuList{3}));
+    EXPECT_EQ(parseCpuList("0,2,4-6"), (CpuList{0, 2, 4, 5, 6}));
+    EXPECT_EQ(cpuListToString(parseCpuList("1-2")), "1,2");
+    EXPECT_EQ(cpuListToString(CpuList{}), "any");
+    EXPECT_THROW(parseCpuList(""), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("a"), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("5-2"), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("-1"), std::invalid_argument);
+
+    EXPECT_EQ(cpuForThread(CpuList{}, 3), -1);
+    EXPECT_EQ(cpuForThread(CpuList{4, 5}, 3), 5);
+    EXPECT_TRUE(pinCurrentThread(-1, "Test"));
+}
+
+// ===== InboundPipeline =====
+
+namespace {
+    struct Recorded {
+        std::vector<std::string> events;   // "C"、訊息內容、"D"
+        std::thread::id thread;
+        bool mixedThreads = false;
+    };
+}
+
+// 測試同一連線的 Connect / Frame / Disconnect 依序在同一條 Session 執行緒上處理
+TEST(InboundPipelineTest, PreservesPerSessionOrder) {
+    constexpr uint64_t PRODUCERS = 4;
+    constexpr uint64_t SESSIONS_PER_PRODUCER = 3;
+    constexpr int FRAMES = 2000;
+
+    InboundConfig config;
+    config.ringCapacity = 16;                 // 小容量：逼出環形佇列已滿的背壓路徑
+    config.stageThreadCount = 2;
+    InboundPipeline pipeline(config);
+
+    std::map<uint64_t, Recorded> recorded;
+    std::mutex recordedMutex;
+    pipeline.setEventHandler([&](const InboundEvent& event) {
+        std::lock_guard<std::mutex> lock(recordedMutex);
+        Recorded& r = recorded[event.sessionId];
+        if (r.events.empty()) {
+            r.thread = std::this_thread::get_id();
+        } else if (r.thread != std::this_thread::get_id()) {
+            r.mixedThreads = true;
+        }
+        switch (event.type) {
+            case InboundEventType::Connect:    r.events.push_back("C"); break;
+            case InboundEventType::Frame:      r.events.emplace_back(event.frame()); break;
+            case InboundEventType::Disconnect: r.events.push_back("D"); break;
+        }
+    });
+    ASSERT_TRUE(pipeline.start());
+
+    // 每個生產者（模擬一條 reactor 執行緒）交錯送出自己負責的幾條連線
+    std::vector<std::thread> producers;
+    for (uint64_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&pipeline, p]() {
+            for (uint64_t s = 0; s < SESSIONS_PER_PRODUCER; ++s) {
+                pipeline.postConnect(p * SESSIONS_PER_PRODUCER + s);
+            }
+            for (int i = 0; i < FRAMES; ++i) {
+                for (uint64_t s = 0; s < SESSIONS_PER_PRODUCER; ++s) {
+                    pipeline.postFrame(p * SESSIONS_PER_PRODUCER + s, std::to_string(i));
+                }
+            }
+            for (uint64_t s = 0; s < SESSIONS_PER_PRODUCER; ++s) {
+                pipeline.postDisconnect(p * SESSIONS_PER_PRODUCER + s);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    pipeline.stop();   // 停止時處理完剩餘事件
+
+    ASSERT_EQ(recorded.size(), PRODUCERS * SESSIONS_PER_PRODUCER);
+    for (const auto& [sessionId, r] : recorded) {
+        ASSERT_EQ(r.events.size(), static_cast<size_t>(FRAMES + 2)) << sessionId;
+        EXPECT_EQ(r.events.front(), "C");
+        EXPECT_EQ(r.events.back(), "D");
+        for (int i = 0; i < FRAMES; ++i) {
+            ASSERT_EQ(r.events[i + 1], std::to_string(i)) << sessionId;
+        }
+        EXPECT_FALSE(r.mixedThreads) << sessionId;
+    }
+
+    const auto& stats = pipeline.getStatistics();
+    uint64_t sessions = PRODUCERS * SESSIONS_PER_PRODUCER;
+    EXPECT_EQ(stats.connects.load(), sessions);
+    EXPECT_EQ(stats.disconnects.load(), sessions);
+    EXPECT_EQ(stats.framesPosted.load(), sessions * FRAMES);
+    EXPECT_EQ(stats.eventsProcessed.load(), sessions * (FRAMES + 2));
+}
+
+// 測試超過內嵌容量的訊息完整送達，槽位之後仍可放一般訊息
+TEST(InboundPipelineTest, LargeFramesUseHeap) {
+    InboundConfig config;
+    config.ringCapacity = 2;
+    InboundPipeline pipeline(config);
+
+    std::vector<std::string> frames;
+    pipeline.setEventHandler([&frames](const InboundEvent& event) {
+        frames.emplace_back(event.frame());
+    });
+
+    std::string large(InboundEvent::INLINE_FRAME_SIZE * 3, 'x');
+    std::string exact(InboundEvent::INLINE_FRAME_SIZE, 'y');
+
+    // 尚未啟動：事件留在佇列中，啟動後處理
+    pipeline.postFrame(1, large);
+    pipeline.postFrame(1, exact);
+    ASSERT_TRUE(pipeline.start());
+    pipeline.postFrame(1, "8=FIX.4.2|");
+    pipeline.stop();
+
+    ASSERT_EQ(frames.size(), 3u);
+    EXPECT_EQ(frames[0], large);
+    EXPECT_EQ(frames[1], exact);
+    EXPECT_EQ(frames[2], "8=FIX.4.2|");
+    EXPECT_EQ(pipeline.getStatistics().largeFrames.load(), 1u);
+}
+
+// 測試設定驗證與啟動條件
+TEST(InboundPipelineTest, RequiresHandlerAndThreads) {
+    InboundConfig config;
+    config.stageThreadCount = 0;
+    EXPECT_THROW(InboundPipeline pipeline(config), std::invalid_argument);
+
+    InboundPipeline pipeline;
+    EXPECT_FALSE(pipeline.start());
+    EXPECT_EQ(pipeline.stageForSession(7), 0u);
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
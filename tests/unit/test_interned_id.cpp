@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "../src/core/interned_id.h"
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace mts::core;
+
+// 測試相同名稱得到相同 ID，不同名稱得到不同 ID
+TEST(InternTableTest, InternIsStable) {
+    InternTable table;
+    EXPECT_EQ(table.size(), 1u);                 // 空字串預先佔用 ID 0
+    EXPECT_EQ(table.intern(""), 0u);
+
+    InternTable::Id aapl = table.intern("AAPL");
+    InternTable::Id msft = table.intern("MSFT");
+    EXPECT_NE(aapl, msft);
+    EXPECT_EQ(table.intern(std::string("AAPL")), aapl);
+    EXPECT_EQ(table.name(aapl), "AAPL");
+    EXPECT_EQ(table.name(msft), "MSFT");
+    EXPECT_EQ(table.size(), 3u);
+
+    EXPECT_EQ(table.find("GOOG"), InternTable::NOT_FOUND);
+    EXPECT_EQ(table.size(), 3u);                 // find 不新增
+}
+
+// 測試跨區塊配發後舊名稱參考仍有效
+TEST(InternTableTest, NamesSurviveChunkGrowth) {
+    InternTable table;
+    const std::string& first = table.name(table.intern("SYM0"));
+    for (size_t i = 1; i < InternTable::CHUNK_SIZE * 3; ++i) {
+        table.intern("SYM" + std::to_string(i));
+    }
+    EXPECT_EQ(first, "SYM0");
+    EXPECT_EQ(table.name(table.find("SYM2500")), "SYM2500");
+}
+
+// 測試多執行緒同時駐留相同名稱得到一致 ID
+TEST(InternTableTest, ConcurrentIntern) {
+    InternTable table;
+    constexpr int THREADS = 4;
+    constexpr int NAMES = 500;
+    std::vector<std::vector<InternTable::Id>> results(THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&table, &results, t]() {
+            for (int i = 0; i < NAMES; ++i) {
+                results[t].push_back(table.intern("C" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int t = 1; t < THREADS; ++t) {
+        EXPECT_EQ(results[t], results[0]);
+    }
+    EXPECT_EQ(table.size(), static_cast<size_t>(NAMES + 1));
+}
+
+// 測試 SymbolId / ClientKey 的比較與字串互通
+TEST(InternedIdTest, TypedIds) {
+    SymbolId a("AAPL");
+    SymbolId b(std::string("AAPL"));
+    SymbolId c = "TSLA";
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(a, "AAPL");
+    EXPECT_NE(c, std::string_view("AAPL"));
+    EXPECT_EQ(a.str(), "AAPL");
+    EXPECT_TRUE(SymbolId().empty());
+    EXPECT_EQ(SymbolId::fromValue(a.value()), a);
+
+    const std::string& name = c;                 // 隱式轉換，沿用字串介面
+    EXPECT_EQ(name, "TSLA");
+
+    std::unordered_set<SymbolId> ids{a, b, c};
+    EXPECT_EQ(ids.size(), 2u);
+
+    std::ostringstream oss;
+    oss << c;
+    EXPECT_EQ(oss.str(), "TSLA");
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
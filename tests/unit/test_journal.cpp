@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include "../src/core/journal.h"
+#include "../src/core/sharded_matching_engine.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mts::core;
+
+namespace {
+
+    // 每個測試使用獨立的暫存目錄
+    class JournalTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            directory_ = (std::filesystem::temp_directory_path() /
+                          ("mts_journal_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name())))
+                             .string();
+            std::filesystem::remove_all(directory_);
+        }
+
+        void TearDown() override { std::filesystem::remove_all(directory_); }
+
+        JournalConfig config(size_t segmentSize = JournalConfig::MIN_SEGMENT_SIZE) const {
+            JournalConfig result;
+            result.directory = directory_;
+            result.segmentSize = segmentSize;
+            return result;
+        }
+
+        std::vector<JournalEntry> readAll() const {
+            std::vector<JournalEntry> entries;
+            std::string error;
+            EXPECT_TRUE(readJournal(directory_, entries, error)) << error;
+            return entries;
+        }
+
+        std::string directory_;
+    };
+
+} // namespace
+
+// 測試三種記錄寫入後完整讀回
+TEST_F(JournalTest, RoundTrip) {
+    {
+        JournalWriter writer;
+        std::string error;
+        ASSERT_TRUE(writer.open(config(), error)) << error;
+        Order order(7, "CLIENT_A", "AAPL", Side::Sell, OrderType::Limit, Price(15025), 300, TimeInForce::IOC);
+        EXPECT_EQ(writer.appendNewOrder(order), 1u);
+        EXPECT_EQ(writer.appendCancel(7, "User requested"), 2u);
+        EXPECT_EQ(writer.appendModify(8, Price(15100), 50), 3u);
+        EXPECT_TRUE(writer.commit(false, true));
+        EXPECT_EQ(writer.syncedSequence(), 3u);
+        EXPECT_FALSE(writer.commit(false, true));   // 沒有未同步記錄
+    }
+
+    auto entries = readAll();
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_EQ(entries[0].sequence, 1u);
+    EXPECT_EQ(entries[0].type, JournalRecordType::NewOrder);
+    EXPECT_EQ(entries[0].orderId, 7u);
+    EXPECT_EQ(entries[0].symbol, "AAPL");
+    EXPECT_EQ(entries[0].clientId, "CLIENT_A");
+    EXPECT_EQ(entries[0].side, Side::Sell);
+    EXPECT_EQ(entries[0].price, Price(15025));
+    EXPECT_EQ(entries[0].quantity, 300u);
+    EXPECT_EQ(entries[0].timeInForce, TimeInForce::IOC);
+    EXPECT_GT(entries[0].timestampNs, 0u);
+
+    EXPECT_EQ(entries[1].type, JournalRecordType::CancelOrder);
+    EXPECT_EQ(entries[1].reason, "User requested");
+    EXPECT_EQ(entries[2].type, JournalRecordType::ModifyOrder);
+    EXPECT_EQ(entries[2].price, Price(15100));
+    EXPECT_EQ(entries[2].quantity, 50u);
+}
+
+// 測試群組提交條件：筆數門檻與閒置同步
+TEST_F(JournalTest, GroupCommit) {
+    JournalConfig cfg = config();
+    cfg.syncEveryRecords = 3;
+    cfg.syncInterval = std::chrono::microseconds(0);
+    cfg.syncWhenIdle = false;
+    JournalWriter writer;
+    std::string error;
+    ASSERT_TRUE(writer.open(cfg, error)) << error;
+
+    writer.appendCancel(1, "a");
+    writer.appendCancel(2, "b");
+    EXPECT_FALSE(writer.commit(true));
+    writer.appendCancel(3, "c");
+    EXPECT_TRUE(writer.commit());
+    EXPECT_EQ(writer.syncedSequence(), 3u);
+    EXPECT_EQ(writer.syncCount(), 1u);
+
+    writer.close();
+    cfg.syncWhenIdle = true;
+    ASSERT_TRUE(writer.open(cfg, error)) << error;
+    writer.appendCancel(4, "d");
+    EXPECT_FALSE(writer.commit(false));
+    EXPECT_TRUE(writer.commit(true));
+}
+
+// 測試區段已滿時換檔，讀者跨區段連續讀取
+TEST_F(JournalTest, RollsSegments) {
+    const size_t records = 3000;   // 每筆約 80 bytes，超過一個 64 KB 區段
+    {
+        JournalWriter writer;
+        std::string error;
+        ASSERT_TRUE(writer.open(config(), error)) << error;
+        for (size_t i = 1; i <= records; ++i) {
+            ASSERT_EQ(writer.appendModify(i, Price(100), i), i);
+        }
+        EXPECT_GT(writer.segmentCount(), 1u);
+    }
+
+    auto entries = readAll();
+    ASSERT_EQ(entries.size(), records);
+    for (size_t i = 0; i < records; ++i) {
+        ASSERT_EQ(entries[i].sequence, i + 1);
+        ASSERT_EQ(entries[i].quantity, i + 1);
+    }
+
+    JournalReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.open(directory_, error)) << error;
+    JournalEntry entry;
+    ASSERT_TRUE(reader.next(entry, 2500));
+    EXPECT_EQ(entry.sequence, 2500u);
+}
+
+// 測試重新開啟時續寫序號，殘缺的尾端被捨棄
+TEST_F(JournalTest, ReopenTruncatesTornTail) {
+    std::string error;
+    {
+        JournalWriter writer;
+        ASSERT_TRUE(writer.open(config(), error)) << error;
+        writer.appendCancel(1, "first");
+        writer.appendCancel(2, "second");
+        writer.appendCancel(3, "third");
+    }
+
+    // 模擬寫到一半當機：破壞第三筆記錄的內容
+    auto segments = std::vector<std::filesystem::path>(std::filesystem::directory_iterator(directory_), {});
+    ASSERT_EQ(segments.size(), 1u);
+    {
+        std::fstream file(segments[0], std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(64 + 2 * 72 + 70);
+        file.put('X');
+    }
+    EXPECT_EQ(readAll().size(), 2u);
+
+    {
+        JournalWriter writer;
+        ASSERT_TRUE(writer.open(config(), error)) << error;
+        EXPECT_EQ(writer.lastSequence(), 2u);
+        EXPECT_EQ(writer.appendCancel(3, "again"), 3u);
+    }
+    auto entries = readAll();
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_EQ(entries[2].reason, "again");
+}
+
+// 測試撮合引擎依處理順序寫入所有輸入，停止時全部落盤
+TEST_F(JournalTest, EngineJournalsInputBeforeMatching) {
+    {
+        ShardedMatchingEngine engine(2, 1024, 64);
+        ASSERT_TRUE(engine.enableJournal(config()));
+        ASSERT_TRUE(engine.start());
+
+        std::string symbol = "AAPL";
+        OrderID sellId = engine.tagOrderId(1, symbol);
+        OrderID buyId = engine.tagOrderId(2, symbol);
+        ASSERT_TRUE(engine.submitOrder(engine.createOrder(sellId, "C1", symbol, Side::Sell, OrderType::Limit, Price(10000), Quantity(10))));
+        ASSERT_TRUE(engine.submitOrder(engine.createOrder(buyId, "C2", symbol, Side::Buy, OrderType::Limit, Price(9900), Quantity(5))));
+        ASSERT_TRUE(engine.modifyOrder(buyId, Price(9950), 4));
+        ASSERT_TRUE(engine.cancelOrder(sellId, "done"));
+
+        size_t shard = engine.shardForSymbol(symbol);
+        for (int i = 0; i < 200 && engine.getShard(shard).getJournal()->lastSequence() < 4; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        engine.stop();
+        EXPECT_EQ(engine.getShard(shard).getJournal()->syncedSequence(), 4u);
+    }
+
+    ShardedMatchingEngine probe(2, 16, 16);
+    size_t shard = probe.shardForSymbol("AAPL");
+    std::vector<JournalEntry> entries;
+    std::string error;
+    ASSERT_TRUE(readJournal(ShardedMatchingEngine::journalShardDirectory(directory_, shard), entries, error)) << error;
+    ASSERT_EQ(entries.size(), 4u);
+    EXPECT_EQ(entries[0].type, JournalRecordType::NewOrder);
+    EXPECT_EQ(entries[0].side, Side::Sell);
+    EXPECT_EQ(entries[1].clientId, "C2");
+    EXPECT_EQ(entries[2].type, JournalRecordType::ModifyOrder);
+    EXPECT_EQ(entries[3].type, JournalRecordType::CancelOrder);
+    EXPECT_EQ(entries[3].reason, "done");
+
+    std::vector<JournalEntry> other;
+    ASSERT_TRUE(readJournal(ShardedMatchingEngine::journalShardDirectory(directory_, 1 - shard), other, error));
+    EXPECT_TRUE(other.empty());
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
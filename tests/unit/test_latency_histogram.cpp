@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "../src/core/latency_histogram.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace mts::core;
+
+// 測試分桶邊界：每個值都落在上界不小於自己、且相對誤差不超過 1/32 的桶
+TEST(LatencyHistogramTest, BucketBounds) {
+    const std::vector<uint64_t> values{0, 1, 31, 32, 33, 63, 64, 1000, 123456,
+                                       1000000007, LatencyHistogram::MAX_TRACKABLE_NS};
+    for (uint64_t v : values) {
+        size_t index = LatencyHistogram::bucketIndex(v);
+        ASSERT_LT(index, LatencyHistogram::BUCKET_COUNT);
+        uint64_t upper = LatencyHistogram::bucketUpperBound(index);
+        EXPECT_GE(upper, v);
+        EXPECT_LE(upper - v, v / LatencyHistogram::SUB_BUCKET_COUNT) << "value " << v;
+        if (index > 0) {
+            EXPECT_LT(LatencyHistogram::bucketUpperBound(index - 1), v);
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::bucketIndex(LatencyHistogram::MAX_TRACKABLE_NS + 1),
+              LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+// 測試百分位數與精確值的誤差
+TEST(LatencyHistogramTest, PercentilesMatchExact) {
+    LatencyHistogram histogram;
+    std::mt19937_64 rng(7);
+    std::lognormal_distribution<double> dist(8.0, 1.0);   // 中位數約 3μs，長尾
+    std::vector<uint64_t> values;
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t v = static_cast<uint64_t>(dist(rng));
+        values.push_back(v);
+        histogram.record(v);
+    }
+    std::sort(values.begin(), values.end());
+
+    EXPECT_EQ(histogram.count(), values.size());
+    EXPECT_EQ(histogram.min(), values.front());
+    EXPECT_EQ(histogram.max(), values.back());
+    for (double p : {50.0, 90.0, 99.0, 99.9}) {
+        uint64_t exact = values[static_cast<size_t>(p / 100.0 * values.size()) - 1];
+        uint64_t estimate = histogram.percentile(p);
+        EXPECT_GE(estimate, exact) << "p" << p;
+        EXPECT_LE(estimate, exact + exact / 16 + 1) << "p" << p;
+    }
+    EXPECT_EQ(histogram.percentile(100.0), values.back());
+}
+
+// 測試合併與重設
+TEST(LatencyHistogramTest, MergeAndReset) {
+    LatencyHistogram a, b;
+    for (uint64_t v = 1; v <= 100; ++v) a.record(v);
+    for (uint64_t v = 1001; v <= 1100; ++v) b.record(v);
+
+    a.merge(b);
+    EXPECT_EQ(a.count(), 200u);
+    EXPECT_EQ(a.min(), 1u);
+    EXPECT_EQ(a.max(), 1100u);
+    EXPECT_LE(a.percentile(50.0), 100u + 100u / LatencyHistogram::SUB_BUCKET_COUNT);   // 桶上界
+    EXPECT_GE(a.percentile(51.0), 1001u);
+
+    a.reset();
+    EXPECT_EQ(a.count(), 0u);
+    EXPECT_EQ(a.percentile(99.0), 0u);
+    EXPECT_EQ(a.toString(), "n=0");
+}
+
+// 測試快照依訊息類型與標的合併
+TEST(LatencySnapshotTest, MergeBySymbol) {
+    LatencySnapshot shard0, shard1;
+    shard0.newOrder.record(100);
+    shard0.perSymbol[SymbolId("AAPL")].record(100);
+    shard1.newOrder.record(200);
+    shard1.cancelOrder.record(50);
+    shard1.perSymbol[SymbolId("AAPL")].record(200);
+    shard1.perSymbol[SymbolId("MSFT")].record(50);
+
+    shard0.merge(shard1);
+    EXPECT_EQ(shard0.newOrder.count(), 2u);
+    EXPECT_EQ(shard0.cancelOrder.count(), 1u);
+    ASSERT_EQ(shard0.perSymbol.size(), 2u);
+    EXPECT_EQ(shard0.perSymbol[SymbolId("AAPL")].count(), 2u);
+
+    std::string report = shard0.toString();
+    EXPECT_NE(report.find("p99.9="), std::string::npos);
+    EXPECT_LT(report.find("AAPL"), report.find("MSFT"));
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
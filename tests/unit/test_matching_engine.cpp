@@ -0,0 +1,276 @@
+#include <gtest/gtest.h>
+#include "../src/core/matching_engine.h"
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace mts::core;
+
+namespace {
+
+    template <typename Pred>
+    bool waitUntil(Pred pred, std::chrono::seconds timeout = std::chrono::seconds(10)) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!pred()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+} // namespace
+
+// ===== 批次處理 =====
+
+// 測試批次回報：每批不超過 batchSize，且保持處理順序
+TEST(MatchingEngineBatchTest, DrainsInBatches) {
+    constexpr int ORDERS = 100;
+    constexpr size_t BATCH = 16;
+
+    MatchingEngine engine(1024, 256);
+    ASSERT_TRUE(engine.setBatchSize(BATCH));
+    EXPECT_EQ(engine.getBatchSize(), BATCH);
+
+    std::mutex mutex;
+    std::vector<size_t> batchSizes;
+    std::vector<OrderID> order;
+    std::atomic<bool> release{false};
+    std::atomic<int> singleCallbacks{0};
+
+    engine.setExecutionCallback([&](const ExecutionReportPtr&) { singleCallbacks.fetch_add(1); });
+    engine.setExecutionBatchCallback([&](const ExecutionReportPtr* reports, size_t count) {
+        // 第一批暫停，讓後續訂單在佇列中累積
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        batchSizes.push_back(count);
+        for (size_t i = 0; i < count; ++i) {
+            order.push_back(reports[i]->orderId);
+        }
+    });
+    ASSERT_TRUE(engine.start());
+    EXPECT_FALSE(engine.setBatchSize(4));   // 執行中不可變更
+
+    for (OrderID id = 1; id <= ORDERS; ++id) {
+        OrderHandle handle = engine.createOrder(id, "C", "AAPL", Side::Buy,
+                                                OrderType::Limit, Price(10000 - static_cast<Price::Ticks>(id)), Quantity(1));
+        ASSERT_TRUE(engine.submitOrder(handle));
+    }
+    release.store(true);
+
+    ASSERT_TRUE(waitUntil([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return order.size() == static_cast<size_t>(ORDERS);
+    }));
+    engine.stop();
+
+    EXPECT_EQ(singleCallbacks.load(), 0);   // 設定批次回調後不再逐筆回報
+    size_t largest = 0;
+    for (size_t size : batchSizes) {
+        EXPECT_LE(size, BATCH);
+        largest = std::max(largest, size);
+    }
+    EXPECT_EQ(largest, BATCH);              // 累積的訊息被整批取出
+    for (int i = 0; i < ORDERS; ++i) {
+        EXPECT_EQ(order[i], static_cast<OrderID>(i + 1));
+    }
+}
+
+// 測試同一批次內同標的的行情只發送一次
+TEST(MatchingEngineBatchTest, CoalescesMarketData) {
+    MatchingEngine engine(1024, 256);
+    ASSERT_TRUE(engine.setBatchSize(64));
+
+    std::atomic<bool> release{false};
+    std::atomic<int> reports{0};
+    std::mutex mutex;
+    std::vector<std::vector<std::string>> snapshotBatches;
+
+    engine.setExecutionBatchCallback([&](const ExecutionReportPtr*, size_t count) {
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+        reports.fetch_add(static_cast<int>(count));
+    });
+    engine.setMarketDataBatchCallback([&](const MarketDataPtr* snapshots, size_t count) {
+        std::vector<std::string> symbols;
+        for (size_t i = 0; i < count; ++i) {
+            symbols.push_back(snapshots[i]->symbol);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        snapshotBatches.push_back(std::move(symbols));
+    });
+    ASSERT_TRUE(engine.start());
+
+    // 第一筆佔住處理執行緒，其餘在佇列中累積成同一批
+    OrderID id = 1;
+    for (const char* symbol : {"AAPL", "AAPL", "MSFT", "AAPL", "MSFT", "AAPL"}) {
+        for (Side side : {Side::Sell, Side::Buy}) {
+            ASSERT_TRUE(engine.submitOrder(engine.createOrder(id++, "C", symbol, side,
+                                                              OrderType::Limit, Price(10000), Quantity(1))));
+        }
+    }
+    release.store(true);
+    ASSERT_TRUE(waitUntil([&] { return reports.load() == 18; }));   // 12 筆訂單 + 6 筆被動成交
+    engine.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_FALSE(snapshotBatches.empty());
+    for (const auto& batch : snapshotBatches) {
+        std::set<std::string> unique(batch.begin(), batch.end());
+        EXPECT_EQ(unique.size(), batch.size());
+    }
+}
+
+// 測試未設定批次回調時仍逐筆回報
+TEST(MatchingEngineBatchTest, FallsBackToPerReportCallback) {
+    MatchingEngine engine(1024, 256);
+    ASSERT_TRUE(engine.setBatchSize(32));
+    std::atomic<int> reports{0};
+    engine.setExecutionCallback([&](const ExecutionReportPtr&) { reports.fetch_add(1); });
+    ASSERT_TRUE(engine.start());
+
+    for (OrderID id = 1; id <= 50; ++id) {
+        ASSERT_TRUE(engine.submitOrder(engine.createOrder(id, "C", "AAPL", Side::Buy,
+                                                          OrderType::Limit, Price(10000), Quantity(1))));
+    }
+    EXPECT_TRUE(waitUntil([&] { return reports.load() == 50; }));
+    engine.stop();
+}
+
+// 測試被動成交的掛單也收到成交回報，排在進場訂單的回報之後
+TEST(MatchingEngineBatchTest, ReportsPassiveFills) {
+    MatchingEngine engine(1024, 256);
+    ASSERT_TRUE(engine.setBatchSize(8));
+    std::mutex mutex;
+    std::vector<ExecutionReportPtr> received;
+    engine.setExecutionBatchCallback([&](const ExecutionReportPtr* reports, size_t count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.insert(received.end(), reports, reports + count);
+    });
+    ASSERT_TRUE(engine.start());
+
+    // 兩筆賣單掛簿，買單一次吃掉第一筆全部與第二筆一部分
+    ASSERT_TRUE(engine.submitOrder(engine.createOrder(1, "C", "AAPL", Side::Sell,
+                                                      OrderType::Limit, Price(10000), Quantity(3))));
+    ASSERT_TRUE(engine.submitOrder(engine.createOrder(2, "C", "AAPL", Side::Sell,
+                                                      OrderType::Limit, Price(10000), Quantity(5))));
+    ASSERT_TRUE(engine.submitOrder(engine.createOrder(3, "C", "AAPL", Side::Buy,
+                                                      OrderType::Limit, Price(10000), Quantity(6))));
+    ASSERT_TRUE(waitUntil([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return received.size() == 5;
+    }));
+    engine.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(received[2]->orderId, 3u);
+    EXPECT_EQ(received[2]->status, OrderStatus::Filled);
+    EXPECT_EQ(received[3]->orderId, 1u);
+    EXPECT_EQ(received[3]->status, OrderStatus::Filled);
+    EXPECT_EQ(received[3]->executionQuantity, 3u);
+    EXPECT_EQ(received[3]->counterOrderId, 3u);
+    EXPECT_EQ(received[4]->orderId, 2u);
+    EXPECT_EQ(received[4]->status, OrderStatus::PartiallyFilled);
+    EXPECT_EQ(received[4]->executionQuantity, 3u);
+    EXPECT_EQ(received[4]->remainingQuantity, 2u);
+}
+
+// ===== 價格與金額溢位 =====
+
+// 測試換算精度溢位的價格被拒絕，成交金額溢位時 totalValue 飽和而非回繞
+TEST(MatchingEngineStatisticsTest, GuardsValueOverflow) {
+    MatchingEngine engine(1024, 256);
+    PriceScaleRegistry::set("OVFX", PriceScale(PriceScale::MAX_DECIMALS));
+    engine.setMaxOrderPrice(Price(std::numeric_limits<Price::Ticks>::max()), PriceScale(PriceScale::MAX_DECIMALS));
+
+    // 預設 2 位小數的標的，tick 乘上 100 後溢位，不可因回繞成負值而通過上限檢查
+    auto rejected = engine.processOrderSync(engine.createOrder(OrderID(1), "C", "AAPL", Side::Buy, OrderType::Limit,
+                                                               Price(std::numeric_limits<Price::Ticks>::max() / 10),
+                                                               Quantity(1)));
+    ASSERT_TRUE(rejected);
+    EXPECT_EQ(rejected->status, OrderStatus::Rejected);
+
+    Price huge(std::numeric_limits<Price::Ticks>::max() / 2);
+    engine.processOrderSync(engine.createOrder(OrderID(2), "C", "OVFX", Side::Sell, OrderType::Limit, huge, Quantity(8)));
+    auto fill = engine.processOrderSync(engine.createOrder(OrderID(3), "C", "OVFX", Side::Buy, OrderType::Limit,
+                                                           huge, Quantity(5)));
+    ASSERT_TRUE(fill);
+    EXPECT_EQ(fill->status, OrderStatus::Filled);
+    EXPECT_EQ(engine.getStatistics().totalValue.load(), UINT64_MAX);
+
+    engine.processOrderSync(engine.createOrder(OrderID(4), "C", "OVFX", Side::Buy, OrderType::Limit, huge, Quantity(1)));
+    EXPECT_EQ(engine.getStatistics().totalValue.load(), UINT64_MAX);   // 累加也不回繞
+}
+
+// ===== 回報記憶體池 =====
+
+// 測試回報釋放後區塊回到池中重用，且回報可比池活得久
+TEST(ExecutionReportPoolTest, RecyclesBlocks) {
+    Order order(1, "C", "AAPL", Side::Buy, OrderType::Limit, Price(10000), 5);
+    ExecutionReportPtr survivor;
+    {
+        ExecutionReportPool pool(4);
+        for (int round = 0; round < 3; ++round) {
+            std::vector<ExecutionReportPtr> reports;
+            for (int i = 0; i < 6; ++i) {
+                reports.push_back(pool.create(order));
+            }
+            EXPECT_EQ(reports.back()->orderId, 1u);
+            EXPECT_EQ(reports.back()->remainingQuantity, 5u);
+        }
+        EXPECT_EQ(pool.allocatedBlocks(), 6u);   // 預留 4 塊，第一輪多配 2 塊，之後全部重用
+        EXPECT_EQ(pool.freeBlocks(), 6u);
+        survivor = pool.create(order);
+    }
+    EXPECT_EQ(survivor->orderId, 1u);   // 池已解構，回報仍有效
+}
+
+// ===== 延遲統計 =====
+
+// 測試各訊息類型、排隊延遲與標的的直方圖都有記錄，並出現在統計報告中
+TEST(MatchingEngineLatencyTest, RecordsPerTypeAndSymbol) {
+    MatchingEngine engine(1024, 256);
+    std::atomic<int> reports{0};
+    engine.setExecutionCallback([&](const ExecutionReportPtr&) { reports.fetch_add(1); });
+    ASSERT_TRUE(engine.start());
+
+    for (OrderID id = 1; id <= 20; ++id) {
+        const char* symbol = (id % 2) ? "AAPL" : "MSFT";
+        ASSERT_TRUE(engine.submitOrder(engine.createOrder(id, "C", symbol, Side::Buy,
+                                                          OrderType::Limit, Price(10000), Quantity(1))));
+    }
+    ASSERT_TRUE(engine.cancelOrder(1, "test"));
+    ASSERT_TRUE(engine.cancelOrder(2, "test"));
+    ASSERT_TRUE(waitUntil([&] { return reports.load() == 22; }));
+
+    // 執行中取得快照
+    LatencySnapshot latency = engine.getStatistics().getLatency();
+    EXPECT_EQ(latency.newOrder.count(), 20u);
+    EXPECT_EQ(latency.cancelOrder.count(), 2u);
+    EXPECT_EQ(latency.modifyOrder.count(), 0u);
+    EXPECT_EQ(latency.queueDelay.count(), 22u);
+    EXPECT_EQ(latency.perSymbol[SymbolId("AAPL")].count(), 11u);
+    EXPECT_EQ(latency.perSymbol[SymbolId("MSFT")].count(), 11u);
+    EXPECT_GT(latency.newOrder.percentile(99.0), 0u);
+    EXPECT_NE(engine.getStatistics().toString().find("p99="), std::string::npos);
+
+    // 執行中重設
+    engine.resetStatistics();
+    EXPECT_EQ(engine.getStatistics().getLatency().newOrder.count(), 0u);
+
+    engine.stop();
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
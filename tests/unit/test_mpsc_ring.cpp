@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include "../src/core/mpsc_ring.h"
+#include "../src/core/matching_engine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace mts::core;
+
+// ===== MpscRing =====
+
+// 測試先進先出與滿 / 空邊界
+TEST(MpscRingTest, FifoAndBounds) {
+    MpscRing<int> ring(4);
+    EXPECT_TRUE(ring.empty());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.tryPush(int(i)));
+    }
+    EXPECT_FALSE(ring.tryPush(99));
+    EXPECT_EQ(ring.size(), 4u);
+
+    int value = -1;
+    EXPECT_TRUE(ring.tryPop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(ring.tryPush(4));                      // 讀走一格後可再寫入（繞回）
+
+    for (int expected = 1; expected <= 4; ++expected) {
+        ASSERT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(ring.tryPop(value));
+    EXPECT_TRUE(ring.empty());
+}
+
+// 測試容量驗證
+TEST(MpscRingTest, RejectsInvalidCapacity) {
+    EXPECT_THROW(MpscRing<int>(0), std::invalid_argument);
+    EXPECT_THROW(MpscRing<int>(1), std::invalid_argument);
+    EXPECT_THROW(MpscRing<int>(100), std::invalid_argument);
+    EXPECT_NO_THROW(MpscRing<int>(128));
+}
+
+// 測試多生產者下每個項目恰好被讀取一次，且同一生產者的順序保持不變
+TEST(MpscRingTest, MultipleProducers) {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 20000;
+    MpscRing<uint64_t> ring(1024);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&ring, p]() {
+            for (uint64_t i = 0; i < PER_PRODUCER; ++i) {
+                uint64_t value = (static_cast<uint64_t>(p) << 32) | i;
+                while (!ring.tryPush(uint64_t(value))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int64_t> lastSeen(PRODUCERS, -1);
+    int received = 0;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        uint64_t value;
+        if (!ring.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int producer = static_cast<int>(value >> 32);
+        int64_t seq = static_cast<int64_t>(value & 0xFFFFFFFFu);
+        ASSERT_LT(producer, PRODUCERS);
+        EXPECT_EQ(seq, lastSeen[producer] + 1);
+        lastSeen[producer] = seq;
+        ++received;
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+// 測試原地寫入 / 讀取：槽位中的物件被重用，已滿時不呼叫 fill
+TEST(MpscRingTest, InPlacePublishAndFront) {
+    struct Slot {
+        int value = 0;
+        std::vector<int> buffer;
+    };
+    MpscRing<Slot> ring(2);
+    EXPECT_EQ(ring.front(), nullptr);
+
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_TRUE(ring.tryPublish([i](Slot& slot) noexcept { slot.value = i; }));
+    }
+    bool called = false;
+    EXPECT_FALSE(ring.tryPublish([&called](Slot&) noexcept { called = true; }));
+    EXPECT_FALSE(called);
+
+    Slot* slot = ring.front();
+    ASSERT_NE(slot, nullptr);
+    EXPECT_EQ(slot->value, 0);
+    slot->buffer.reserve(64);
+    const int* storage = slot->buffer.data();
+    ring.release();
+
+    ring.front();
+    ring.release();
+    EXPECT_TRUE(ring.empty());
+
+    // 繞回同一個槽位：先前的容量仍在
+    EXPECT_TRUE(ring.tryPublish([](Slot& s) noexcept { s.value = 2; }));
+    slot = ring.front();
+    ASSERT_NE(slot, nullptr);
+    EXPECT_EQ(slot->value, 2);
+    EXPECT_EQ(slot->buffer.data(), storage);
+    ring.release();
+}
+
+// ===== InternalMessage =====
+
+// 測試取消原因以固定長度保存
+TEST(InternalMessageTest, ReasonIsTruncated) {
+    auto msg = InternalMessage::createCancelOrder(7, "Client requested");
+    EXPECT_EQ(msg.getReason(), "Client requested");
+
+    EXPECT_TRUE(InternalMessage::reasonFits(std::string(InternalMessage::MAX_REASON_LENGTH, 'x')));
+
+    std::string longReason(100, 'x');
+    EXPECT_FALSE(InternalMessage::reasonFits(longReason));
+    msg = InternalMessage::createCancelOrder(7, longReason);
+    EXPECT_EQ(msg.getReason(), std::string(InternalMessage::MAX_REASON_LENGTH, 'x'));
+}
+
+// ===== 撮合引擎在各種等待策略下的異步處理 =====
+
+class WaitStrategyTest : public ::testing::TestWithParam<WaitStrategy> {};
+
+// 多個閘道執行緒同時送單，每筆都會得到執行回報，被成交的掛單另有一筆成交回報
+TEST_P(WaitStrategyTest, ConcurrentSubmitters) {
+    constexpr int SUBMITTERS = 3;
+    constexpr int PER_SUBMITTER = 500;
+    constexpr int TRADES = PER_SUBMITTER;   // 兩條買方、一條賣方，同價同量：每筆賣單各成交一次
+    constexpr int EXPECTED = SUBMITTERS * PER_SUBMITTER + TRADES;
+
+    MatchingEngine engine(8192, 1024);
+    ASSERT_TRUE(engine.setWaitStrategy(GetParam()));
+    std::atomic<int> reports{0};
+    engine.setExecutionCallback([&reports](const ExecutionReportPtr&) { reports.fetch_add(1); });
+    ASSERT_TRUE(engine.start());
+    EXPECT_FALSE(engine.setWaitStrategy(WaitStrategy::Blocking));   // 執行中不可變更
+
+    std::vector<std::thread> submitters;
+    for (int t = 0; t < SUBMITTERS; ++t) {
+        submitters.emplace_back([&engine, t]() {
+            for (int i = 0; i < PER_SUBMITTER; ++i) {
+                OrderID id = static_cast<OrderID>(t * PER_SUBMITTER + i + 1);
+                Side side = (t % 2) ? Side::Sell : Side::Buy;
+                for (;;) {
+                    OrderHandle handle = engine.createOrder(id, "CLIENT", "AAPL", side,
+                                                            OrderType::Limit, Price(10000), Quantity(1));
+                    if (handle != INVALID_ORDER_HANDLE && engine.submitOrder(handle)) {
+                        break;
+                    }
+                    std::this_thread::yield();   // 池或佇列暫時已滿
+                }
+            }
+        });
+    }
+    for (auto& submitter : submitters) {
+        submitter.join();
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (reports.load() < EXPECTED && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    engine.stop();
+    EXPECT_EQ(reports.load(), EXPECTED);
+    EXPECT_EQ(engine.getStatistics().tradesExecuted.load(), static_cast<uint64_t>(TRADES));
+}
+
+INSTANTIATE_TEST_SUITE_P(AllStrategies, WaitStrategyTest,
+    ::testing::Values(WaitStrategy::BusySpin, WaitStrategy::SpinYield, WaitStrategy::Blocking),
+    [](const ::testing::TestParamInfo<WaitStrategy>& info) {
+        std::string name = waitStrategyToString(info.param);
+        name.erase(std::remove(name.begin(), name.end(), '-'), name.end());
+        return name;
+    });
+
+// 測試策略名稱轉換
+TEST(WaitStrategyNameTest, RoundTrip) {
+    for (auto strategy : {WaitStrategy::BusySpin, WaitStrategy::SpinYield, WaitStrategy::Blocking}) {
+        EXPECT_EQ(stringToWaitStrategy(waitStrategyToString(strategy)), strategy);
+    }
+    EXPECT_THROW(stringToWaitStrategy("sleep"), std::invalid_argument);
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
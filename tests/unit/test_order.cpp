@@ -1,5 +1,5 @@
 #include <gtest/gtest.h>
-#include "../src/core/Order.h"
+#include "../src/core/order.h"
 #include <stdexcept>
 #include <thread>
 #include <chrono>
@@ -13,7 +13,7 @@ protected:
         orderId = 12345;
         clientId = "CLIENT001";
         symbol = "AAPL";
-        price = 150.50;
+        price = Price(15050);   // 150.50（預設精度 2 位）
         quantity = 100;
     }
     
@@ -51,7 +51,7 @@ TEST_F(OrderTest, MarketOrderConstructor) {
     Order order(orderId, clientId, symbol, Side::Sell, quantity);
     
     EXPECT_EQ(order.getOrderType(), OrderType::Market);
-    EXPECT_EQ(order.getPrice(), 0.0);
+    EXPECT_EQ(order.getPrice(), Price());
     EXPECT_TRUE(order.isMarketOrder());
     EXPECT_FALSE(order.isLimitOrder());
 }
@@ -118,10 +118,10 @@ TEST_F(OrderTest, InvalidOrderConstruction) {
                  std::invalid_argument);
     
     // 限價單價格為 0 或負數
-    EXPECT_THROW(Order(orderId, clientId, symbol, Side::Buy, OrderType::Limit, 0.0, quantity),
+    EXPECT_THROW(Order(orderId, clientId, symbol, Side::Buy, OrderType::Limit, Price(), quantity),
                  std::invalid_argument);
     
-    EXPECT_THROW(Order(orderId, clientId, symbol, Side::Buy, OrderType::Limit, -10.0, quantity),
+    EXPECT_THROW(Order(orderId, clientId, symbol, Side::Buy, OrderType::Limit, Price(-1000), quantity),
                  std::invalid_argument);
     
     // 空白交易標的
@@ -133,7 +133,7 @@ TEST_F(OrderTest, InvalidOrderConstruction) {
 TEST_F(OrderTest, OrderComparison) {
     Order order1(1, clientId, symbol, Side::Buy, OrderType::Limit, price, quantity);
     Order order2(2, clientId, symbol, Side::Buy, OrderType::Limit, price, quantity);
-    Order order3(1, "CLIENT002", "TSLA", Side::Sell, OrderType::Market, 0, 50);
+    Order order3(1, "CLIENT002", "TSLA", Side::Sell, OrderType::Market, Price(), 50);
     
     // 相同 OrderID 的訂單相等
     EXPECT_EQ(order1, order3);  // 只比較 OrderID
@@ -145,15 +145,15 @@ TEST_F(OrderTest, PriceComparator) {
     Order::PriceComparator comp;
     
     // 買單測試 (價格高的優先)
-    Order buyHigh(1, clientId, symbol, Side::Buy, OrderType::Limit, 151.0, quantity);
-    Order buyLow(2, clientId, symbol, Side::Buy, OrderType::Limit, 150.0, quantity);
+    Order buyHigh(1, clientId, symbol, Side::Buy, OrderType::Limit, Price(15100), quantity);
+    Order buyLow(2, clientId, symbol, Side::Buy, OrderType::Limit, Price(15000), quantity);
     
     EXPECT_TRUE(comp(buyHigh, buyLow));   // 高價買單 > 低價買單
     EXPECT_FALSE(comp(buyLow, buyHigh));  // 低價買單 < 高價買單
     
     // 賣單測試 (價格低的優先)
-    Order sellHigh(3, clientId, symbol, Side::Sell, OrderType::Limit, 151.0, quantity);
-    Order sellLow(4, clientId, symbol, Side::Sell, OrderType::Limit, 150.0, quantity);
+    Order sellHigh(3, clientId, symbol, Side::Sell, OrderType::Limit, Price(15100), quantity);
+    Order sellLow(4, clientId, symbol, Side::Sell, OrderType::Limit, Price(15000), quantity);
     
     EXPECT_TRUE(comp(sellLow, sellHigh));   // 低價賣單 > 高價賣單
     EXPECT_FALSE(comp(sellHigh, sellLow));  // 高價賣單 < 低價賣單
@@ -175,6 +175,20 @@ TEST_F(OrderTest, TimeComparator) {
     EXPECT_FALSE(comp(order2, order1));
 }
 
+// 測試減量
+TEST_F(OrderTest, ReduceQuantity) {
+    Order order(orderId, clientId, symbol, Side::Buy, OrderType::Limit, price, quantity);
+    order.fillQuantity(30);
+    
+    order.reduceQuantity(50);
+    EXPECT_EQ(order.getQuantity(), 50);
+    EXPECT_EQ(order.getFilledQuantity(), 30);
+    EXPECT_EQ(order.getRemainingQuantity(), 20);
+    
+    EXPECT_THROW(order.reduceQuantity(30), std::invalid_argument);   // 不可低於已成交量
+    EXPECT_THROW(order.reduceQuantity(60), std::invalid_argument);   // 不可增量
+}
+
 // 測試訂單驗證
 TEST_F(OrderTest, OrderValidation) {
     // 有效的限價單
@@ -247,6 +261,22 @@ TEST_F(OrderTest, CopyAndMoveSemantics) {
     EXPECT_EQ(moved.getFilledQuantity(), 20);
 }
 
+// 測試熱資料位於第一條快取線，且標的 / 客戶以駐留 ID 保存
+TEST_F(OrderTest, HotColdLayout) {
+    EXPECT_EQ(sizeof(OrderHot), 64u);
+    EXPECT_EQ(alignof(Order), 64u);
+    EXPECT_EQ(sizeof(Order), 128u);
+
+    Order a(orderId, clientId, symbol, Side::Buy, OrderType::Limit, price, quantity);
+    Order b(orderId + 1, clientId, symbol, Side::Sell, OrderType::Limit, price, quantity);
+    EXPECT_EQ(a.getSymbolId(), b.getSymbolId());
+    EXPECT_EQ(a.getClientKey(), b.getClientKey());
+    EXPECT_EQ(a.getSymbolId().str(), symbol);
+    EXPECT_EQ(a.getSequence(), 0u);
+    a.setSequence(42);
+    EXPECT_EQ(a.getSequence(), 42u);
+}
+
 // 效能測試 (簡單版本)
 TEST_F(OrderTest, PerformanceBasic) {
     auto start = std::chrono::high_resolution_clock::now();
@@ -258,7 +288,7 @@ TEST_F(OrderTest, PerformanceBasic) {
     
     for (int i = 0; i < ORDER_COUNT; ++i) {
         orders.emplace_back(i, clientId, symbol, Side::Buy, OrderType::Limit, 
-                           price + i * 0.01, quantity);
+                           price + Price(i), quantity);
     }
     
     auto end = std::chrono::high_resolution_clock::now();
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "../src/core/order_book.h"
+#include "../src/core/order_pool.h"
 #include <memory>
 #include <thread>
 #include <chrono>
@@ -16,11 +17,11 @@ protected:
         orderBook = std::make_unique<OrderBook>("AAPL");
         
         // 設定回調函式來記錄交易和訂單更新
-        orderBook->setTradeCallback([this](const TradePtr& trade) {
+        orderBook->setTradeCallback([this](const Trade& trade) {
             trades.push_back(trade);
         });
         
-        orderBook->setOrderUpdateCallback([this](const std::shared_ptr<Order>& order) {
+        orderBook->setOrderUpdateCallback([this](Order* order) {
             orderUpdates.push_back(order);
         });
     }
@@ -34,34 +35,36 @@ protected:
             for (size_t i = 0; i < trades.size(); ++i) {
                 const auto& trade = trades[i];
                 std::cout << "Trade #" << (i + 1) << ": " 
-                          << trade->quantity << " shares @ $" << std::fixed << std::setprecision(2) << trade->price
-                          << " (Buy#" << trade->buyOrderId 
-                          << " vs Sell#" << trade->sellOrderId << ")"
-                          << " [" << trade->symbol << "]" << std::endl;
+                          << trade.quantity << " shares @ $" << formatPrice(trade.symbol, trade.price)
+                          << " (Buy#" << trade.buyOrderId 
+                          << " vs Sell#" << trade.sellOrderId << ")"
+                          << " [" << trade.symbol << "]" << std::endl;
             }
             
-            // Calculate trade statistics
+            // Calculate trade statistics（以 tick 累計，避免浮點誤差）
             Quantity totalVolume = 0;
-            Price totalValue = 0.0;
-            Price minPrice = std::numeric_limits<Price>::max();
-            Price maxPrice = std::numeric_limits<Price>::min();
+            Price::Ticks totalValueTicks = 0;
+            Price minPrice = Price::max();
+            Price maxPrice = Price::lowest();
             
             for (const auto& trade : trades) {
-                totalVolume += trade->quantity;
-                totalValue += trade->quantity * trade->price;
-                minPrice = std::min(minPrice, trade->price);
-                maxPrice = std::max(maxPrice, trade->price);
+                totalVolume += trade.quantity;
+                totalValueTicks += static_cast<Price::Ticks>(trade.quantity) * trade.price.ticks();
+                minPrice = std::min(minPrice, trade.price);
+                maxPrice = std::max(maxPrice, trade.price);
             }
             
-            Price avgPrice = (totalVolume > 0) ? (totalValue / totalVolume) : 0.0;
+            PriceScale scale;
+            Price totalValue(totalValueTicks);
+            Price avgPrice = (totalVolume > 0) ? Price(totalValueTicks / static_cast<Price::Ticks>(totalVolume)) : Price();
             
             std::cout << std::string(50, '-') << std::endl;
             std::cout << "📊 TRADE SUMMARY:" << std::endl;
             std::cout << "  Total Volume: " << totalVolume << " shares" << std::endl;
-            std::cout << "  Total Value: $" << std::fixed << std::setprecision(2) << totalValue << std::endl;
-            std::cout << "  Average Price: $" << std::fixed << std::setprecision(2) << avgPrice << std::endl;
-            std::cout << "  Price Range: $" << std::fixed << std::setprecision(2) << minPrice 
-                      << " - $" << maxPrice << std::endl;
+            std::cout << "  Total Value: $" << scale.toString(totalValue) << std::endl;
+            std::cout << "  Average Price: $" << scale.toString(avgPrice) << std::endl;
+            std::cout << "  Price Range: $" << scale.toString(minPrice) 
+                      << " - $" << scale.toString(maxPrice) << std::endl;
         } else {
             std::cout << "\n📈 TRADES: No trades executed" << std::endl;
         }
@@ -77,7 +80,7 @@ protected:
                 std::cout << "Order#" << order->getOrderId() 
                           << " [" << (order->isBuyOrder() ? "BUY" : "SELL") << "] ";
                 std::cout << order->getRemainingQuantity() << "/" << order->getQuantity() 
-                          << " shares @ $" << std::fixed << std::setprecision(2) << order->getPrice();
+                          << " shares @ $" << formatPrice(order->getSymbol(), order->getPrice());
                 std::cout << " Status: ";
                 
                 // Display order status
@@ -139,42 +142,47 @@ protected:
     }
     
     // 輔助函式：創建訂單
-    std::shared_ptr<Order> createLimitOrder(OrderID id, Side side, Price price, Quantity qty) {
-        return std::make_shared<Order>(id, "CLIENT001", "AAPL", side, OrderType::Limit, price, qty);
+    // 測試價格以預設精度（2 位）換算成 tick
+    static Price px(double value) { return PriceScale().fromDouble(value); }
+    
+    // 訂單由測試用的訂單池持有，OrderBook 只保存指標
+    Order* createLimitOrder(OrderID id, Side side, Price price, Quantity qty) {
+        return &orderPool[orderPool.acquire(id, "CLIENT001", "AAPL", side, OrderType::Limit, price, qty)];
     }
     
-    std::shared_ptr<Order> createMarketOrder(OrderID id, Side side, Quantity qty) {
-        return std::make_shared<Order>(id, "CLIENT001", "AAPL", side, qty);
+    Order* createMarketOrder(OrderID id, Side side, Quantity qty) {
+        return &orderPool[orderPool.acquire(id, "CLIENT001", "AAPL", side, qty)];
     }
     
+    OrderPool orderPool{4096};
     std::unique_ptr<OrderBook> orderBook;
-    std::vector<TradePtr> trades;
-    std::vector<std::shared_ptr<Order>> orderUpdates;
+    std::vector<Trade> trades;
+    std::vector<Order*> orderUpdates;
 };
 
 // 測試基本訂單加入
 TEST_F(OrderBookTest, AddBasicOrders) {
-    auto buyOrder = createLimitOrder(1, Side::Buy, 100.0, 10);
-    auto sellOrder = createLimitOrder(2, Side::Sell, 101.0, 15);
+    auto buyOrder = createLimitOrder(1, Side::Buy, px(100.0), 10);
+    auto sellOrder = createLimitOrder(2, Side::Sell, px(101.0), 15);
     
     orderBook->addOrder(buyOrder);
     orderBook->addOrder(sellOrder);
     
-    EXPECT_EQ(orderBook->getBidPrice(), 100.0);
-    EXPECT_EQ(orderBook->getAskPrice(), 101.0);
-    EXPECT_EQ(orderBook->getSpread(), 1.0);
-    EXPECT_EQ(orderBook->getMidPrice(), 100.5);
+    EXPECT_EQ(orderBook->getBidPrice(), px(100.0));
+    EXPECT_EQ(orderBook->getAskPrice(), px(101.0));
+    EXPECT_EQ(orderBook->getSpread(), px(1.0));
+    EXPECT_EQ(orderBook->getMidPrice(), px(100.5));
     EXPECT_TRUE(trades.empty()); // 沒有價格重疊，不應該有交易
 }
 
 // 測試基本撮合
 TEST_F(OrderBookTest, BasicMatching) {
     // 先加入賣單
-    auto sellOrder = createLimitOrder(1, Side::Sell, 100.0, 10);
+    auto sellOrder = createLimitOrder(1, Side::Sell, px(100.0), 10);
     orderBook->addOrder(sellOrder);
     
     // 加入可以撮合的買單
-    auto buyOrder = createLimitOrder(2, Side::Buy, 100.0, 8);
+    auto buyOrder = createLimitOrder(2, Side::Buy, px(100.0), 8);
     auto generatedTrades = orderBook->addOrder(buyOrder);
     
     // 檢查交易結果
@@ -182,10 +190,10 @@ TEST_F(OrderBookTest, BasicMatching) {
     EXPECT_EQ(trades.size(), 1);
     
     auto trade = trades[0];
-    EXPECT_EQ(trade->buyOrderId, 2);
-    EXPECT_EQ(trade->sellOrderId, 1);
-    EXPECT_EQ(trade->price, 100.0);
-    EXPECT_EQ(trade->quantity, 8);
+    EXPECT_EQ(trade.buyOrderId, 2);
+    EXPECT_EQ(trade.sellOrderId, 1);
+    EXPECT_EQ(trade.price, px(100.0));
+    EXPECT_EQ(trade.quantity, 8);
     
     // 檢查訂單狀態
     EXPECT_TRUE(buyOrder->isFilled());
@@ -193,15 +201,15 @@ TEST_F(OrderBookTest, BasicMatching) {
     EXPECT_EQ(sellOrder->getStatus(), OrderStatus::PartiallyFilled);
     
     // 檢查 Order Book 狀態
-    EXPECT_EQ(orderBook->getBidPrice(), 0.0); // 買單已完全成交
-    EXPECT_EQ(orderBook->getAskPrice(), 100.0); // 賣單還有剩餘
+    EXPECT_EQ(orderBook->getBidPrice(), px(0.0)); // 買單已完全成交
+    EXPECT_EQ(orderBook->getAskPrice(), px(100.0)); // 賣單還有剩餘
 }
 
 // 測試市價單撮合
 TEST_F(OrderBookTest, MarketOrderMatching) {
     // 建立市場深度
-    auto sell1 = createLimitOrder(1, Side::Sell, 100.0, 5);
-    auto sell2 = createLimitOrder(2, Side::Sell, 101.0, 10);
+    auto sell1 = createLimitOrder(1, Side::Sell, px(100.0), 5);
+    auto sell2 = createLimitOrder(2, Side::Sell, px(101.0), 10);
     
     orderBook->addOrder(sell1);
     orderBook->addOrder(sell2);
@@ -214,12 +222,12 @@ TEST_F(OrderBookTest, MarketOrderMatching) {
     EXPECT_EQ(trades.size(), 2);
     
     // 第一筆：5股 @ 100.0
-    EXPECT_EQ(trades[0]->quantity, 5);
-    EXPECT_EQ(trades[0]->price, 100.0);
+    EXPECT_EQ(trades[0].quantity, 5);
+    EXPECT_EQ(trades[0].price, px(100.0));
     
     // 第二筆：7股 @ 101.0
-    EXPECT_EQ(trades[1]->quantity, 7);
-    EXPECT_EQ(trades[1]->price, 101.0);
+    EXPECT_EQ(trades[1].quantity, 7);
+    EXPECT_EQ(trades[1].price, px(101.0));
     
     // 市價單應該完全成交
     EXPECT_TRUE(marketBuy->isFilled());
@@ -227,25 +235,117 @@ TEST_F(OrderBookTest, MarketOrderMatching) {
 
 // 測試訂單取消
 TEST_F(OrderBookTest, OrderCancellation) {
-    auto buy = createLimitOrder(1, Side::Buy, 100.0, 10);
-    auto sell = createLimitOrder(2, Side::Sell, 101.0, 15);
+    auto buy = createLimitOrder(1, Side::Buy, px(100.0), 10);
+    auto sell = createLimitOrder(2, Side::Sell, px(101.0), 15);
     
     orderBook->addOrder(buy);
     orderBook->addOrder(sell);
     
     // 取消買單
     EXPECT_TRUE(orderBook->cancelOrder(1));
-    EXPECT_EQ(orderBook->getBidPrice(), 0.0);
+    EXPECT_EQ(orderBook->getBidPrice(), px(0.0));
     EXPECT_TRUE(buy->isCancelled());
     
     // 嘗試取消不存在的訂單
     EXPECT_FALSE(orderBook->cancelOrder(999));
 }
 
+// 測試取消同價位中間的訂單後，其餘訂單維持原本的時間優先
+TEST_F(OrderBookTest, CancelMiddleOfLevelKeepsFifo) {
+    for (OrderID id = 1; id <= 3; ++id) {
+        orderBook->addOrder(createLimitOrder(id, Side::Sell, px(100.0), 10));
+    }
+    
+    EXPECT_TRUE(orderBook->cancelOrder(2));
+    EXPECT_EQ(orderBook->getAskOrderCount(), 2u);
+    EXPECT_EQ(orderBook->getAskDepth(1)[0].second, 20u);
+    
+    orderBook->addOrder(createLimitOrder(4, Side::Buy, px(100.0), 15));
+    ASSERT_EQ(trades.size(), 2u);
+    EXPECT_EQ(trades[0].sellOrderId, 1u);
+    EXPECT_EQ(trades[1].sellOrderId, 3u);
+    EXPECT_EQ(trades[1].quantity, 5u);
+    
+    // 取消最後一筆後價格層級消失
+    EXPECT_TRUE(orderBook->cancelOrder(3));
+    EXPECT_TRUE(orderBook->getAskDepth().empty());
+    EXPECT_EQ(orderBook->getAskPrice(), Price());
+}
+
+// 測試減量不失去時間優先
+TEST_F(OrderBookTest, ReduceQuantityKeepsPriority) {
+    auto first = createLimitOrder(1, Side::Buy, px(100.0), 10);
+    auto second = createLimitOrder(2, Side::Buy, px(100.0), 10);
+    orderBook->addOrder(first);
+    orderBook->addOrder(second);
+    
+    EXPECT_TRUE(orderBook->reduceOrderQuantity(1, 4));
+    EXPECT_EQ(first->getQuantity(), 4u);
+    EXPECT_EQ(first->getRemainingQuantity(), 4u);
+    EXPECT_EQ(orderBook->getBidDepth(1)[0].second, 14u);
+    
+    // 增量或不存在的訂單不可就地修改
+    EXPECT_FALSE(orderBook->reduceOrderQuantity(1, 8));
+    EXPECT_FALSE(orderBook->reduceOrderQuantity(999, 1));
+    
+    orderBook->addOrder(createLimitOrder(3, Side::Sell, px(100.0), 4));
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].buyOrderId, 1u);
+    EXPECT_TRUE(first->isFilled());
+    EXPECT_EQ(orderBook->getBidOrderCount(), 1u);
+}
+
+// 測試層級與整側總量在掛單、成交、取消、減量後保持正確
+TEST_F(OrderBookTest, AggregatesTrackEveryChange) {
+    orderBook->addOrder(createLimitOrder(1, Side::Sell, px(100.0), 10));
+    orderBook->addOrder(createLimitOrder(2, Side::Sell, px(100.0), 20));
+    orderBook->addOrder(createLimitOrder(3, Side::Sell, px(101.0), 30));
+    EXPECT_EQ(orderBook->getAskQuantity(), 30u);
+    EXPECT_EQ(orderBook->getTotalAskQuantity(), 60u);
+
+    // 部分成交：跨過第一筆，吃掉第二筆的一部分
+    orderBook->addOrder(createLimitOrder(4, Side::Buy, px(100.0), 15));
+    EXPECT_EQ(orderBook->getAskQuantity(), 15u);
+    EXPECT_EQ(orderBook->getTotalAskQuantity(), 45u);
+
+    // 減量
+    EXPECT_TRUE(orderBook->reduceOrderQuantity(3, 12));
+    EXPECT_EQ(orderBook->getTotalAskQuantity(), 27u);
+
+    // 取消後最佳層級清空
+    EXPECT_TRUE(orderBook->cancelOrder(2));
+    EXPECT_EQ(orderBook->getAskPrice(), px(101.0));
+    EXPECT_EQ(orderBook->getAskQuantity(), 12u);
+    EXPECT_EQ(orderBook->getTotalAskQuantity(), 12u);
+
+    orderBook->clear();
+    EXPECT_EQ(orderBook->getTotalAskQuantity(), 0u);
+    EXPECT_EQ(orderBook->getAskQuantity(), 0u);
+}
+
+// 測試不配置記憶體的深度查詢
+TEST_F(OrderBookTest, DepthIntoBuffer) {
+    orderBook->addOrder(createLimitOrder(1, Side::Buy, px(99.0), 10));
+    orderBook->addOrder(createLimitOrder(2, Side::Buy, px(100.0), 5));
+    orderBook->addOrder(createLimitOrder(3, Side::Buy, px(100.0), 7));
+    orderBook->addOrder(createLimitOrder(4, Side::Buy, px(98.0), 1));
+
+    PriceLevelSummary levels[2];
+    ASSERT_EQ(orderBook->getBidDepth(levels, 2), 2u);
+    EXPECT_EQ(levels[0].price, px(100.0));
+    EXPECT_EQ(levels[0].quantity, 12u);
+    EXPECT_EQ(levels[0].orderCount, 2u);
+    EXPECT_EQ(levels[1].price, px(99.0));
+    EXPECT_EQ(levels[1].quantity, 10u);
+    EXPECT_EQ(levels[1].orderCount, 1u);
+
+    EXPECT_EQ(orderBook->getAskDepth(levels, 2), 0u);
+}
+
 // 測試市價單無法完全成交
 TEST_F(OrderBookTest, MarketOrderPartialReject) {
     // 只有少量賣單
-    auto sell = createLimitOrder(1, Side::Sell, 100.0, 5);
+    auto sell = createLimitOrder(1, Side::Sell, px(100.0), 5);
     orderBook->addOrder(sell);
     
     // 大額市價買單
@@ -254,7 +354,7 @@ TEST_F(OrderBookTest, MarketOrderPartialReject) {
     
     // 應該只成交 5 股，剩餘 15 股被拒絕
     EXPECT_EQ(trades.size(), 1);
-    EXPECT_EQ(trades[0]->quantity, 5);
+    EXPECT_EQ(trades[0].quantity, 5);
     EXPECT_TRUE(marketBuy->isRejected()); // 無法完全成交的市價單被拒絕
 }
 
@@ -267,7 +367,7 @@ TEST_F(OrderBookTest, PerformanceTest) {
     // 加入大量訂單
     for (int i = 1; i <= ORDER_COUNT; ++i) {
         Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
-        Price price = 100.0 + (i % 100) * 0.01; // 價格在 100-101 之間變化
+        Price price = px(100.0 + (i % 100) * 0.01); // 價格在 100-101 之間變化
         
         auto order = createLimitOrder(i, side, price, 10);
         orderBook->addOrder(order);
@@ -287,9 +387,35 @@ TEST_F(OrderBookTest, PerformanceTest) {
 }
 
 // 測試字串輸出
+TEST_F(OrderBookTest, CallerTradeBufferIsReused) {
+    OrderBookConfig config;
+    config.orderCapacity = 16;
+    OrderBook book("AAPL", config);
+    std::vector<Trade> buffer;
+    buffer.reserve(8);
+    const Trade* storage = buffer.data();
+
+    // 超過預先配置的節點數時簿側自動成長
+    for (OrderID id = 1; id <= 20; ++id) {
+        EXPECT_EQ(book.addOrder(createLimitOrder(id, Side::Sell, px(100.0), 1), buffer), 0u);
+    }
+    EXPECT_EQ(book.getAskOrderCount(), 20u);
+
+    // 成交附加在呼叫端緩衝區；清空後重複使用，容量不變
+    EXPECT_EQ(book.addOrder(createLimitOrder(21, Side::Buy, px(100.0), 3), buffer), 3u);
+    ASSERT_EQ(buffer.size(), 3u);
+    EXPECT_EQ(buffer[0].sellOrderId, 1u);
+    EXPECT_EQ(buffer[2].sellOrderId, 3u);
+    buffer.clear();
+    EXPECT_EQ(book.addOrder(createLimitOrder(22, Side::Buy, px(100.0), 2), buffer), 2u);
+    EXPECT_EQ(buffer[0].sellOrderId, 4u);
+    EXPECT_EQ(buffer.data(), storage);
+    EXPECT_EQ(book.getAskOrderCount(), 15u);
+}
+
 TEST_F(OrderBookTest, StringOutput) {
-    orderBook->addOrder(createLimitOrder(1, Side::Buy, 99.5, 100));
-    orderBook->addOrder(createLimitOrder(2, Side::Sell, 100.5, 150));
+    orderBook->addOrder(createLimitOrder(1, Side::Buy, px(99.5), 100));
+    orderBook->addOrder(createLimitOrder(2, Side::Sell, px(100.5), 150));
     
     std::string output = orderBook->toString();
     
@@ -299,7 +425,7 @@ TEST_F(OrderBookTest, StringOutput) {
     EXPECT_TRUE(output.find("100.5") != std::string::npos);  // Best Ask
     
     // 測試交易字串輸出
-    auto trade = std::make_shared<Trade>(1, 2, 100.0, 50, "AAPL");
+    Trade trade(1, 2, px(100.0), 50, "AAPL");
     std::string tradeStr = tradeToString(trade);
     
     EXPECT_TRUE(tradeStr.find("Buy#1") != std::string::npos);
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "../src/core/order_index.h"
+#include <random>
+#include <unordered_map>
+
+using namespace mts::core;
+
+// 測試插入、查詢、重複與刪除
+TEST(OrderIndexTest, InsertFindErase) {
+    OrderIndex index(4);
+    EXPECT_EQ(index.capacity(), 8u);
+
+    auto* book = reinterpret_cast<OrderBook*>(0x1000);
+    EXPECT_TRUE(index.insert(7, 3, book));
+    EXPECT_FALSE(index.insert(7, 4, book));        // 重複的 OrderID
+    EXPECT_EQ(index.size(), 1u);
+
+    const OrderIndex::Entry* entry = index.find(7);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->handle, 3u);
+    EXPECT_EQ(entry->book, book);
+    EXPECT_EQ(index.find(8), nullptr);
+
+    EXPECT_EQ(index.erase(7), 3u);
+    EXPECT_EQ(index.erase(7), INVALID_ORDER_HANDLE);
+    EXPECT_EQ(index.find(7), nullptr);
+    EXPECT_EQ(index.size(), 0u);
+}
+
+// 測試達到上限後拒絕插入，刪除後可再插入
+TEST(OrderIndexTest, BoundedBySize) {
+    OrderIndex index(3);
+    EXPECT_TRUE(index.insert(1, 0, nullptr));
+    EXPECT_TRUE(index.insert(2, 1, nullptr));
+    EXPECT_TRUE(index.insert(3, 2, nullptr));
+    EXPECT_FALSE(index.insert(4, 3, nullptr));
+    index.erase(2);
+    EXPECT_TRUE(index.insert(4, 3, nullptr));
+    index.clear();
+    EXPECT_EQ(index.size(), 0u);
+    EXPECT_EQ(index.find(1), nullptr);
+}
+
+// 測試大量隨機插入 / 刪除（含分片標記的 OrderID）與 unordered_map 結果一致，後移刪除不遺失探測鏈上的項目
+TEST(OrderIndexTest, MatchesReferenceUnderChurn) {
+    const size_t maxOrders = 1000;
+    OrderIndex index(maxOrders);
+    std::unordered_map<OrderID, OrderHandle> reference;
+    std::mt19937_64 rng(12345);
+
+    for (int step = 0; step < 200000; ++step) {
+        OrderID id = (OrderID(rng() % 4) << 56) | (rng() % 3000 + 1);
+        if (rng() % 2 == 0 && reference.size() < maxOrders) {
+            OrderHandle handle = static_cast<OrderHandle>(step);
+            bool inserted = reference.emplace(id, handle).second;
+            ASSERT_EQ(index.insert(id, handle, nullptr), inserted);
+        } else {
+            auto it = reference.find(id);
+            OrderHandle expected = it == reference.end() ? INVALID_ORDER_HANDLE : it->second;
+            ASSERT_EQ(index.erase(id), expected);
+            if (it != reference.end()) {
+                reference.erase(it);
+            }
+        }
+    }
+
+    EXPECT_EQ(index.size(), reference.size());
+    for (const auto& pair : reference) {
+        const OrderIndex::Entry* entry = index.find(pair.first);
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(entry->handle, pair.second);
+    }
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
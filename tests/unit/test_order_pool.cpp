@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "../src/core/order_pool.h"
+#include <set>
+
+using namespace mts::core;
+
+// 測試取得與歸還槽位
+TEST(OrderPoolTest, AcquireAndRelease) {
+    OrderPool pool(4);
+    EXPECT_EQ(pool.capacity(), 4u);
+    EXPECT_EQ(pool.available(), 4u);
+
+    OrderHandle handle = pool.acquire(OrderID(7), "CLIENT001", "AAPL", Side::Buy,
+                                      OrderType::Limit, Price(15000), Quantity(100));
+    ASSERT_NE(handle, INVALID_ORDER_HANDLE);
+    EXPECT_EQ(pool.inUse(), 1u);
+    EXPECT_EQ(pool[handle].getOrderId(), 7u);
+    EXPECT_EQ(pool[handle].getPrice(), Price(15000));
+    EXPECT_EQ(pool.handleOf(&pool[handle]), handle);
+
+    pool.release(handle);
+    EXPECT_EQ(pool.available(), 4u);
+}
+
+// 測試池滿時回傳無效 handle，且歸還後可再取得
+TEST(OrderPoolTest, ExhaustionAndReuse) {
+    OrderPool pool(2);
+    OrderHandle a = pool.acquire(OrderID(1), "C", "AAPL", Side::Buy, Quantity(1));
+    OrderHandle b = pool.acquire(OrderID(2), "C", "AAPL", Side::Buy, Quantity(1));
+    EXPECT_NE(a, b);
+    EXPECT_EQ(pool.acquire(OrderID(3), "C", "AAPL", Side::Buy, Quantity(1)), INVALID_ORDER_HANDLE);
+
+    pool.release(a);
+    OrderHandle c = pool.acquire(OrderID(4), "C", "MSFT", Side::Sell, Quantity(5));
+    EXPECT_EQ(c, a);                                   // LIFO：剛歸還的槽位優先
+    EXPECT_EQ(pool[c].getOrderId(), 4u);               // 內容已重新建構
+    EXPECT_EQ(pool[c].getSymbol(), "MSFT");
+    EXPECT_EQ(pool[c].getStatus(), OrderStatus::New);
+}
+
+// 測試槽位位址在整個生命週期內固定
+TEST(OrderPoolTest, StableAddresses) {
+    OrderPool pool(64);
+    std::set<const Order*> addresses;
+    for (OrderID id = 1; id <= 64; ++id) {
+        OrderHandle handle = pool.acquire(id, "C", "AAPL", Side::Buy, Quantity(1));
+        ASSERT_NE(handle, INVALID_ORDER_HANDLE);
+        addresses.insert(&pool[handle]);
+        EXPECT_EQ(pool.get(handle), &pool[handle]);
+    }
+    EXPECT_EQ(addresses.size(), 64u);
+    EXPECT_EQ(pool.get(INVALID_ORDER_HANDLE), nullptr);
+
+    Order outside;
+    EXPECT_EQ(pool.handleOf(&outside), INVALID_ORDER_HANDLE);
+}
+
+// 測試重複歸還與無效參數
+TEST(OrderPoolTest, RejectsMisuse) {
+    OrderPool pool(2);
+    OrderHandle handle = pool.acquire(OrderID(1), "C", "AAPL", Side::Buy, Quantity(1));
+    pool.release(handle);
+    EXPECT_THROW(pool.release(handle), std::logic_error);
+    EXPECT_THROW(pool.release(99), std::logic_error);
+    EXPECT_THROW(OrderPool(0), std::invalid_argument);
+}
+
+// 測試訂單建構失敗時槽位被歸還
+TEST(OrderPoolTest, ConstructionFailureReleasesSlot) {
+    OrderPool pool(1);
+    EXPECT_THROW(pool.acquire(OrderID(1), "C", "AAPL", Side::Buy, Quantity(0)), std::invalid_argument);
+    EXPECT_EQ(pool.available(), 1u);
+    EXPECT_NE(pool.acquire(OrderID(2), "C", "AAPL", Side::Buy, Quantity(1)), INVALID_ORDER_HANDLE);
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include "../src/core/order_trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace mts::core;
+
+namespace {
+
+    std::vector<TraceEvent> drainAll() {
+        std::vector<TraceEvent> events;
+        OrderTracer::instance().drain(events);
+        return events;
+    }
+
+    size_t countStage(const std::vector<TraceEvent>& events, OrderID orderId, TraceStage stage) {
+        return static_cast<size_t>(std::count_if(events.begin(), events.end(), [&](const TraceEvent& e) {
+            return e.orderId == orderId && e.stage == stage;
+        }));
+    }
+
+} // namespace
+
+// 測試 ring 已滿時丟棄新事件，取出後可再寫入
+TEST(TraceRingTest, DropsWhenFull) {
+    TraceRing ring(4);
+    for (OrderID id = 1; id <= 6; ++id) {
+        ring.push(TraceEvent{id, id, TraceStage::Recv});
+    }
+    EXPECT_EQ(ring.dropped(), 2u);
+
+    std::vector<TraceEvent> events;
+    EXPECT_EQ(ring.drain(events), 4u);
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events.front().orderId, 1u);
+    EXPECT_EQ(events.back().orderId, 4u);
+
+    ring.push(TraceEvent{7, 7, TraceStage::Send});
+    events.clear();
+    EXPECT_EQ(ring.drain(events), 1u);
+    EXPECT_EQ(events[0].stage, TraceStage::Send);
+
+    EXPECT_THROW(TraceRing(3), std::invalid_argument);
+}
+
+// 測試取得 OrderID 前的階段在 bindPending 時掛到訂單上，Recv 保留給同一次 recv 的下一筆
+TEST(OrderTracerTest, PendingStagesBindToOrderId) {
+    OrderTracer& tracer = OrderTracer::instance();
+    tracer.enable();
+    tracer.reset();
+
+    OrderTracer::markPending(TraceStage::Recv);
+    OrderTracer::markPending(TraceStage::Frame);
+    OrderTracer::markPending(TraceStage::Parse);
+    OrderTracer::markPending(TraceStage::SessionValidate);
+    OrderTracer::bindPending(7);
+    OrderTracer::trace(7, TraceStage::Convert);
+
+    OrderTracer::markPending(TraceStage::Frame);
+    OrderTracer::bindPending(8);
+
+    auto events = drainAll();
+    EXPECT_EQ(events.size(), 7u);
+    for (TraceStage stage : {TraceStage::Recv, TraceStage::Frame, TraceStage::Parse,
+                             TraceStage::SessionValidate, TraceStage::Convert}) {
+        EXPECT_EQ(countStage(events, 7, stage), 1u) << traceStageToString(stage);
+    }
+    EXPECT_EQ(countStage(events, 8, TraceStage::Recv), 1u);
+    EXPECT_EQ(countStage(events, 8, TraceStage::Frame), 1u);
+    EXPECT_EQ(countStage(events, 8, TraceStage::Parse), 0u);
+
+    // 關閉後不再記錄
+    tracer.disable();
+    OrderTracer::trace(9, TraceStage::Send);
+    EXPECT_TRUE(drainAll().empty());
+}
+
+// 測試暫存的階段隨訊息交給另一條執行緒後，在該執行緒 bindPending 時掛到訂單上
+TEST(OrderTracerTest, PendingStagesHandOffAcrossThreads) {
+    OrderTracer& tracer = OrderTracer::instance();
+    tracer.enable();
+    tracer.reset();
+
+    OrderTracer::markPending(TraceStage::Recv);
+    OrderTracer::markPending(TraceStage::Frame);
+    PendingTrace handoff;
+    OrderTracer::takePending(handoff);
+    OrderTracer::bindPending(5);                     // 交出後本執行緒只剩 Recv
+
+    std::thread consumer([&handoff] {
+        OrderTracer::restorePending(handoff);
+        OrderTracer::markPending(TraceStage::Parse);
+        OrderTracer::bindPending(6);
+    });
+    consumer.join();
+
+    auto events = drainAll();
+    EXPECT_EQ(countStage(events, 5, TraceStage::Recv), 1u);
+    EXPECT_EQ(countStage(events, 5, TraceStage::Frame), 0u);
+    for (TraceStage stage : {TraceStage::Recv, TraceStage::Frame, TraceStage::Parse}) {
+        EXPECT_EQ(countStage(events, 6, stage), 1u) << traceStageToString(stage);
+    }
+    tracer.disable();
+}
+
+// 測試各執行緒各自的 ring 都會被收集
+TEST(OrderTracerTest, CollectsFromAllThreads) {
+    OrderTracer& tracer = OrderTracer::instance();
+    tracer.enable();
+    tracer.reset();
+
+    std::vector<std::thread> threads;
+    for (OrderID id = 1; id <= 4; ++id) {
+        threads.emplace_back([id] {
+            for (int i = 0; i < 100; ++i) {
+                OrderTracer::trace(id, TraceStage::Match);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto events = drainAll();
+    EXPECT_EQ(events.size(), 400u);
+    for (OrderID id = 1; id <= 4; ++id) {
+        EXPECT_EQ(countStage(events, id, TraceStage::Match), 100u);
+    }
+    EXPECT_EQ(tracer.droppedEvents(), 0u);
+    tracer.disable();
+}
+
+// 測試分析：階段延遲取前一個出現的階段，重複階段取最早的時間
+TEST(TraceAnalysisTest, StageBreakdown) {
+    const double ticksPerNs = 2.0;
+    std::vector<TraceEvent> events = {
+        {1000, 1, TraceStage::Recv},
+        {1200, 1, TraceStage::Parse},        // Frame 缺漏：Recv → Parse
+        {2000, 1, TraceStage::Enqueue},
+        {3000, 1, TraceStage::Report},
+        {9000, 1, TraceStage::Report},       // 之後的成交回報，不影響新單路徑
+        {3400, 1, TraceStage::Send},
+        {5000, 2, TraceStage::Enqueue},      // 沒有 Recv：不計入完整訂單
+        {5600, 2, TraceStage::Report},
+    };
+
+    TraceBreakdown breakdown = analyzeTrace(events, ticksPerNs);
+    EXPECT_EQ(breakdown.orders, 2u);
+    EXPECT_EQ(breakdown.completeOrders, 1u);
+
+    auto stage = [&](TraceStage s) -> const LatencyHistogram& {
+        return breakdown.stages[static_cast<size_t>(s)];
+    };
+    EXPECT_EQ(stage(TraceStage::Frame).count(), 0u);
+    EXPECT_EQ(stage(TraceStage::Parse).count(), 1u);
+    EXPECT_EQ(stage(TraceStage::Parse).max(), 100u);
+    EXPECT_EQ(stage(TraceStage::Report).count(), 2u);
+    EXPECT_EQ(stage(TraceStage::Report).max(), 500u);
+    EXPECT_EQ(stage(TraceStage::Send).max(), 200u);
+
+    EXPECT_EQ(breakdown.endToEnd.count(), 2u);
+    EXPECT_EQ(breakdown.endToEnd.max(), 1200u);
+    EXPECT_NE(breakdown.toString().find("→ Enqueue"), std::string::npos);
+}
+
+// 測試追蹤檔寫入與讀回
+TEST(TraceFileTest, RoundTrip) {
+    const std::string path = "test_order_trace.bin";
+    std::vector<TraceEvent> written = {
+        {100, 42, TraceStage::Recv},
+        {250, 42, TraceStage::Send},
+    };
+    {
+        TraceFileWriter writer;
+        ASSERT_TRUE(writer.open(path, 3.5));
+        ASSERT_TRUE(writer.append(written));
+        ASSERT_TRUE(writer.append({{300, 43, TraceStage::Match}}));
+    }
+
+    std::vector<TraceEvent> read;
+    double ticksPerNs = 0;
+    std::string error;
+    ASSERT_TRUE(readTraceFile(path, read, ticksPerNs, error)) << error;
+    EXPECT_DOUBLE_EQ(ticksPerNs, 3.5);
+    ASSERT_EQ(read.size(), 3u);
+    EXPECT_EQ(read[1].tsc, 250u);
+    EXPECT_EQ(read[1].stage, TraceStage::Send);
+    EXPECT_EQ(read[2].orderId, 43u);
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(readTraceFile("missing_trace.bin", read, ticksPerNs, error));
+    EXPECT_FALSE(error.empty());
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include "../src/core/outbound_pipeline.h"
+#include "../src/core/spsc_ring.h"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mts::core;
+
+// ===== SpscRing =====
+
+// 測試先進先出與滿 / 空邊界
+TEST(SpscRingTest, FifoAndBounds) {
+    SpscRing<int> ring(4);
+    EXPECT_TRUE(ring.empty());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.tryPush(int(i)));
+    }
+    EXPECT_FALSE(ring.tryPush(99));
+    EXPECT_EQ(ring.size(), 4u);
+
+    int value = -1;
+    EXPECT_TRUE(ring.tryPop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(ring.tryPush(4));                      // 讀走一格後可再寫入（繞回）
+
+    for (int expected = 1; expected <= 4; ++expected) {
+        ASSERT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(ring.tryPop(value));
+    EXPECT_TRUE(ring.empty());
+    EXPECT_THROW(SpscRing<int>(100), std::invalid_argument);
+}
+
+// 測試生產者與消費者在不同執行緒時順序不變、不遺失
+TEST(SpscRingTest, ProducerConsumerThreads) {
+    constexpr uint64_t COUNT = 200000;
+    SpscRing<uint64_t> ring(256);
+
+    std::thread producer([&ring]() {
+        for (uint64_t i = 0; i < COUNT; ++i) {
+            while (!ring.tryPush(uint64_t(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 0;
+    while (expected < COUNT) {
+        uint64_t value;
+        if (!ring.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(value, expected);
+        ++expected;
+    }
+    producer.join();
+    EXPECT_TRUE(ring.empty());
+}
+
+// ===== OutboundPipeline =====
+
+namespace {
+    ExecutionReportPtr makeReport(OrderID orderId) {
+        Order order(orderId, "C1", "AAPL", Side::Buy, OrderType::Limit, Price(10000), 100);
+        return std::make_shared<ExecutionReport>(order);
+    }
+}
+
+// 測試 ReportEvent 複製回報欄位，拒絕原因過長時截斷
+TEST(OutboundPipelineTest, ReportEventCopiesFields) {
+    auto report = makeReport(42);
+    report->status = OrderStatus::Rejected;
+    report->rejectReason = std::string(100, 'x');
+
+    ReportEvent event = ReportEvent::fromReport(*report);
+    EXPECT_EQ(event.orderId, 42u);
+    EXPECT_EQ(event.symbol, "AAPL");
+    EXPECT_EQ(event.status, OrderStatus::Rejected);
+    EXPECT_EQ(event.originalQuantity, 100u);
+    EXPECT_EQ(event.getText(), std::string(ReportEvent::MAX_TEXT_LENGTH, 'x'));
+}
+
+// 測試多個生產者的回報都會編碼，同一 Session 的訊息依送出順序寫出
+TEST(OutboundPipelineTest, EncodesAndWritesInOrder) {
+    constexpr size_t PRODUCERS = 2;
+    constexpr OrderID PER_PRODUCER = 5000;
+
+    OutboundConfig config;
+    config.ringCapacity = 64;                 // 小容量：逼出環形佇列已滿的背壓路徑
+    config.ioThreadCount = 2;
+    config.sessionQueueLimit = 1 << 20;
+    OutboundPipeline pipeline(PRODUCERS, config);
+
+    // 生產者 p 的回報都送到 Session p
+    std::map<uint64_t, std::vector<OrderID>> written;
+    std::mutex writtenMutex;
+    std::vector<std::shared_ptr<OutboundSession>> sessions;
+    for (size_t p = 0; p < PRODUCERS; ++p) {
+        sessions.push_back(pipeline.openSession(p, [&, p](const OutboundMessage* messages, size_t count) {
+            std::lock_guard<std::mutex> lock(writtenMutex);
+            for (size_t i = 0; i < count; ++i) {
+                EXPECT_EQ(messages[i].bytes, std::to_string(messages[i].orderId));
+                written[p].push_back(messages[i].orderId);
+            }
+            return true;
+        }));
+    }
+
+    pipeline.setEncodeHandler([&](const ReportEvent* events, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            size_t producer = static_cast<size_t>(events[i].orderId / PER_PRODUCER);
+            pipeline.send(sessions[producer], std::to_string(events[i].orderId), events[i].orderId);
+        }
+    });
+    ASSERT_TRUE(pipeline.start());
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&pipeline, p]() {
+            for (OrderID i = 0; i < PER_PRODUCER; i += 10) {
+                std::vector<ExecutionReportPtr> batch;
+                for (OrderID j = i; j < i + 10; ++j) {
+                    batch.push_back(makeReport(p * PER_PRODUCER + j));
+                }
+                pipeline.post(p, batch.data(), batch.size());
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    pipeline.stop();   // 停止時編碼並寫完剩餘事件
+
+    for (size_t p = 0; p < PRODUCERS; ++p) {
+        const auto& ids = written[p];
+        ASSERT_EQ(ids.size(), static_cast<size_t>(PER_PRODUCER));
+        for (OrderID i = 0; i < PER_PRODUCER; ++i) {
+            ASSERT_EQ(ids[i], p * PER_PRODUCER + i);
+        }
+    }
+    const auto& stats = pipeline.getStatistics();
+    EXPECT_EQ(stats.eventsPosted.load(), PRODUCERS * PER_PRODUCER);
+    EXPECT_EQ(stats.messagesWritten.load(), PRODUCERS * PER_PRODUCER);
+    EXPECT_EQ(stats.overflows.load(), 0u);
+}
+
+// 測試 Disconnect 策略：佇列滿時丟棄該 Session 的訊息、通知斷線，之後的送出一律失敗
+TEST(OutboundPipelineTest, DisconnectOnOverflow) {
+    OutboundConfig config;
+    config.sessionQueueLimit = 3;
+    OutboundPipeline pipeline(1, config);
+
+    std::vector<uint64_t> overflowed;
+    pipeline.setOverflowHandler([&overflowed](uint64_t sessionId) { overflowed.push_back(sessionId); });
+
+    // 尚未啟動：沒有 IO 執行緒取走訊息
+    auto discard = [](const OutboundMessage*, size_t) { return true; };
+    auto slow = pipeline.openSession(7, discard);
+    auto other = pipeline.openSession(8, discard);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(pipeline.send(slow, "m"));
+    }
+    EXPECT_TRUE(pipeline.send(other, "m"));
+    EXPECT_FALSE(pipeline.send(slow, "m"));
+    EXPECT_TRUE(slow->isClosed());
+    EXPECT_FALSE(pipeline.send(slow, "m"));
+    EXPECT_TRUE(pipeline.send(other, "m"));          // 其他 Session 不受影響
+
+    ASSERT_EQ(overflowed.size(), 1u);
+    EXPECT_EQ(overflowed[0], 7u);
+    EXPECT_EQ(pipeline.getStatistics().overflows.load(), 1u);
+    EXPECT_EQ(pipeline.getStatistics().messagesDropped.load(), 5u);
+}
+
+// 測試 Block 策略：寫出變慢時送出端等待，訊息不遺失且順序不變
+TEST(OutboundPipelineTest, BlockWaitsForSpace) {
+    constexpr int COUNT = 200;
+
+    OutboundConfig config;
+    config.sessionQueueLimit = 2;
+    config.overflowPolicy = OverflowPolicy::Block;
+    OutboundPipeline pipeline(1, config);
+
+    std::vector<std::string> written;
+    pipeline.setEncodeHandler([](const ReportEvent*, size_t) {});
+    ASSERT_TRUE(pipeline.start());
+
+    auto session = pipeline.openSession(1, [&written](const OutboundMessage* messages, size_t count) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        for (size_t i = 0; i < count; ++i) {
+            written.push_back(messages[i].bytes);
+        }
+        return true;
+    });
+    for (int i = 0; i < COUNT; ++i) {
+        ASSERT_TRUE(pipeline.send(session, std::to_string(i)));
+    }
+    pipeline.stop();
+
+    ASSERT_EQ(written.size(), static_cast<size_t>(COUNT));
+    for (int i = 0; i < COUNT; ++i) {
+        EXPECT_EQ(written[i], std::to_string(i));
+    }
+    EXPECT_EQ(pipeline.getStatistics().overflows.load(), 0u);
+}
+
+// 測試關閉 Session 後未寫出的訊息被丟棄
+TEST(OutboundPipelineTest, CloseSessionDropsPending) {
+    OutboundPipeline pipeline(1);
+    std::atomic<int> writes{0};
+    pipeline.setEncodeHandler([](const ReportEvent*, size_t) {});
+
+    auto session = pipeline.openSession(3, [&writes](const OutboundMessage*, size_t count) {
+        writes.fetch_add(static_cast<int>(count));
+        return true;
+    });
+    EXPECT_TRUE(pipeline.send(session, "a"));
+    EXPECT_TRUE(pipeline.send(session, "b"));
+    pipeline.closeSession(*session);
+    EXPECT_FALSE(pipeline.send(session, "c"));
+
+    ASSERT_TRUE(pipeline.start());
+    pipeline.stop();
+    EXPECT_EQ(writes.load(), 0);
+    EXPECT_EQ(pipeline.getStatistics().messagesDropped.load(), 3u);
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
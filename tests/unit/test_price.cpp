@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "../src/core/price.h"
+#include "../src/core/order_book.h"
+#include <map>
+#include <string>
+
+using namespace mts::core;
+
+class PriceTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        PriceScaleRegistry::clear();
+    }
+
+    static Price parse(const PriceScale& scale, std::string_view text) {
+        Price price;
+        EXPECT_TRUE(scale.parse(text, price)) << text;
+        return price;
+    }
+
+    static bool rejects(const PriceScale& scale, std::string_view text) {
+        Price price;
+        return !scale.parse(text, price);
+    }
+};
+
+// 測試十進位字串解析
+TEST_F(PriceTest, ParseDecimal) {
+    PriceScale cents;
+    EXPECT_EQ(parse(cents, "150.25"), Price(15025));
+    EXPECT_EQ(parse(cents, "150.5"), Price(15050));
+    EXPECT_EQ(parse(cents, "150"), Price(15000));
+    EXPECT_EQ(parse(cents, "150."), Price(15000));
+    EXPECT_EQ(parse(cents, ".05"), Price(5));
+    EXPECT_EQ(parse(cents, "150.2500"), Price(15025));   // 多出的 0 可接受
+    EXPECT_EQ(parse(cents, "-0.25"), Price(-25));
+
+    PriceScale bps(4);
+    EXPECT_EQ(parse(bps, "1.2345"), Price(12345));
+    EXPECT_EQ(parse(bps, "1.2"), Price(12000));
+}
+
+// 測試無效輸入
+TEST_F(PriceTest, ParseRejectsInvalid) {
+    PriceScale cents;
+    EXPECT_TRUE(rejects(cents, ""));
+    EXPECT_TRUE(rejects(cents, "."));
+    EXPECT_TRUE(rejects(cents, "-"));
+    EXPECT_TRUE(rejects(cents, "abc"));
+    EXPECT_TRUE(rejects(cents, "1.2.3"));
+    EXPECT_TRUE(rejects(cents, "12a"));
+    EXPECT_TRUE(rejects(cents, "150.255"));              // 超過精度
+    EXPECT_TRUE(rejects(cents, "99999999999999999999")); // 溢位
+}
+
+// 測試格式化
+TEST_F(PriceTest, Format) {
+    EXPECT_EQ(PriceScale().toString(Price(15025)), "150.25");
+    EXPECT_EQ(PriceScale().toString(Price(5)), "0.05");
+    EXPECT_EQ(PriceScale().toString(Price(-25)), "-0.25");
+    EXPECT_EQ(PriceScale().toString(Price()), "0.00");
+    EXPECT_EQ(PriceScale(0).toString(Price(42)), "42");
+    EXPECT_EQ(PriceScale(4).toString(Price(12345)), "1.2345");
+
+    PriceScale cents;
+    char buffer[PriceScale::MAX_FORMATTED_SIZE];
+    char* end = cents.format(buffer, Price::lowest());
+    EXPECT_EQ(std::string(buffer, end), "-92233720368547758.08");
+}
+
+// 測試解析與格式化互為反函式
+TEST_F(PriceTest, RoundTrip) {
+    for (uint8_t decimals = 0; decimals <= PriceScale::MAX_DECIMALS; ++decimals) {
+        PriceScale scale(decimals);
+        for (Price::Ticks ticks : {0LL, 1LL, 9LL, 10LL, 15025LL, 123456789LL, -7LL}) {
+            Price price(ticks);
+            EXPECT_EQ(parse(scale, scale.toString(price)), price);
+        }
+    }
+}
+
+// 測試跨精度正規化
+TEST_F(PriceTest, Normalize) {
+    EXPECT_EQ(PriceScale(2).normalize(Price(15025)), 1502500);
+    EXPECT_EQ(PriceScale(4).normalize(Price(15025)), 15025);
+    EXPECT_THROW(PriceScale(PriceScale::MAX_DECIMALS + 1), std::invalid_argument);
+}
+
+// 測試浮點數轉換只做四捨五入
+TEST_F(PriceTest, FromDouble) {
+    PriceScale cents;
+    EXPECT_EQ(cents.fromDouble(0.1 + 0.2), Price(30));
+    EXPECT_EQ(cents.fromDouble(100.0 + 37 * 0.01), Price(10037));
+    EXPECT_DOUBLE_EQ(cents.toDouble(Price(15025)), 150.25);
+}
+
+// 測試 Price 作為 map key 時不會因浮點誤差分裂價格層級
+TEST_F(PriceTest, MapKeyIsExact) {
+    PriceScale cents;
+    std::map<Price, int> levels;
+    levels[parse(cents, "0.30")]++;
+    levels[cents.fromDouble(0.1 + 0.2)]++;
+    levels[parse(cents, "0.3")]++;
+    EXPECT_EQ(levels.size(), 1u);
+    EXPECT_EQ(levels.begin()->second, 3);
+}
+
+// 測試標的精度設定
+TEST_F(PriceTest, Registry) {
+    EXPECT_EQ(PriceScaleRegistry::get("AAPL").decimals(), PriceScale::DEFAULT_DECIMALS);
+
+    PriceScaleRegistry::set("EURUSD", PriceScale(4));
+    EXPECT_EQ(PriceScaleRegistry::get("EURUSD").decimals(), 4);
+    EXPECT_EQ(formatPrice("EURUSD", Price(10875)), "1.0875");
+    EXPECT_EQ(formatPrice("AAPL", Price(10875)), "108.75");
+}
+
+// 測試依 SymbolId 查精度：與名稱查詢一致，未駐留的名稱不會被加入駐留表
+TEST_F(PriceTest, RegistryBySymbolId) {
+    PriceScaleRegistry::set("USDJPY", PriceScale(3));
+    EXPECT_EQ(PriceScaleRegistry::forSymbol(SymbolId("USDJPY")).decimals(), 3);
+    EXPECT_EQ(PriceScaleRegistry::forSymbol(SymbolId("GBPUSD")).decimals(), PriceScale::DEFAULT_DECIMALS);
+
+    EXPECT_EQ(PriceScaleRegistry::get("NEVER_INTERNED").decimals(), PriceScale::DEFAULT_DECIMALS);
+    EXPECT_EQ(SymbolId::table().find("NEVER_INTERNED"), InternTable::NOT_FOUND);
+
+    PriceScaleRegistry::clear();
+    EXPECT_EQ(PriceScaleRegistry::forSymbol(SymbolId("USDJPY")).decimals(), PriceScale::DEFAULT_DECIMALS);
+}
+
+// 測試 checkedNormalize 偵測乘法溢位
+TEST_F(PriceTest, CheckedNormalize) {
+    PriceScale cents(2);
+    Price::Ticks normalized = 0;
+    EXPECT_TRUE(cents.checkedNormalize(Price(15025), normalized));
+    EXPECT_EQ(normalized, cents.normalize(Price(15025)));
+    EXPECT_FALSE(cents.checkedNormalize(Price(std::numeric_limits<Price::Ticks>::max() / 10), normalized));
+    EXPECT_FALSE(cents.checkedNormalize(Price(std::numeric_limits<Price::Ticks>::min() / 10), normalized));
+}
+
+// 測試溢位檢查的整數運算：邊界值成功，超過一單位即失敗且不寫入結果
+TEST_F(PriceTest, CheckedArithmetic) {
+    constexpr int64_t I64_MAX = std::numeric_limits<int64_t>::max();
+    constexpr int64_t I64_MIN = std::numeric_limits<int64_t>::min();
+    int64_t signedOut = 0;
+    EXPECT_TRUE(checkedMul(I64_MIN / 2, int64_t(2), signedOut));
+    EXPECT_EQ(signedOut, I64_MIN);
+    EXPECT_FALSE(checkedMul(I64_MIN, int64_t(-1), signedOut));
+    EXPECT_FALSE(checkedMul(I64_MAX / 2 + 1, int64_t(2), signedOut));
+    EXPECT_EQ(signedOut, I64_MIN);
+
+    uint64_t out = 0;
+    EXPECT_TRUE(checkedMul(UINT64_MAX / 3, uint64_t(3), out));
+    EXPECT_FALSE(checkedMul(UINT64_MAX / 3 + 1, uint64_t(3), out));
+    EXPECT_TRUE(checkedMul(UINT64_MAX, uint64_t(0), out));
+    EXPECT_EQ(out, 0u);
+    EXPECT_TRUE(checkedAdd(UINT64_MAX - 1, uint64_t(1), out));
+    EXPECT_EQ(out, UINT64_MAX);
+    EXPECT_FALSE(checkedAdd(UINT64_MAX, uint64_t(1), out));
+    EXPECT_EQ(out, UINT64_MAX);
+}
+
+// 測試中間價以整數 tick 計算
+TEST_F(PriceTest, MidPrice) {
+    EXPECT_EQ(midPrice(Price(10000), Price(10100)), Price(10050));
+    EXPECT_EQ(midPrice(Price(10000), Price(10001)), Price(10000));   // 半個 tick 向下取整
+    EXPECT_EQ(midPrice(Price(), Price(10100)), Price());
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
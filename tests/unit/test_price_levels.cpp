@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+#include "../src/core/order_book.h"
+#include "../src/core/order_pool.h"
+#include "../src/core/price_levels.h"
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace mts::core;
+
+namespace {
+
+    OrderBookConfig makeConfig(PriceLevelPolicy policy) {
+        OrderBookConfig config;
+        config.policy = policy;
+        config.ladderMinPrice = Price(1);
+        config.ladderMaxPrice = Price(20000);   // 0.01 ~ 200.00
+        return config;
+    }
+
+} // namespace
+
+// ===== 三種容器策略行為一致 =====
+
+class PriceLevelPolicyTest : public ::testing::TestWithParam<PriceLevelPolicy> {
+protected:
+    void SetUp() override {
+        orderBook = std::make_unique<OrderBook>("AAPL", makeConfig(GetParam()));
+        orderBook->setTradeCallback([this](const Trade& trade) {
+            trades.push_back(trade);
+        });
+    }
+
+    Order* limit(OrderID id, Side side, Price::Ticks ticks, Quantity qty) {
+        return &orderPool[orderPool.acquire(id, "CLIENT001", "AAPL", side, OrderType::Limit, Price(ticks), qty)];
+    }
+
+    OrderPool orderPool{8192};
+    std::unique_ptr<OrderBook> orderBook;
+    std::vector<Trade> trades;
+};
+
+// 測試深度排序：買單由高到低、賣單由低到高
+TEST_P(PriceLevelPolicyTest, DepthOrdering) {
+    orderBook->addOrder(limit(1, Side::Buy, 9900, 10));
+    orderBook->addOrder(limit(2, Side::Buy, 10000, 20));
+    orderBook->addOrder(limit(3, Side::Buy, 9800, 30));
+    orderBook->addOrder(limit(4, Side::Buy, 10000, 5));
+    orderBook->addOrder(limit(5, Side::Sell, 10200, 7));
+    orderBook->addOrder(limit(6, Side::Sell, 10100, 8));
+
+    auto bids = orderBook->getBidDepth(2);
+    ASSERT_EQ(bids.size(), 2u);
+    EXPECT_EQ(bids[0], std::make_pair(Price(10000), Quantity(25)));
+    EXPECT_EQ(bids[1], std::make_pair(Price(9900), Quantity(10)));
+
+    auto asks = orderBook->getAskDepth();
+    ASSERT_EQ(asks.size(), 2u);
+    EXPECT_EQ(asks[0], std::make_pair(Price(10100), Quantity(8)));
+    EXPECT_EQ(asks[1], std::make_pair(Price(10200), Quantity(7)));
+}
+
+// 測試清空最佳層級後最佳價正確後退
+TEST_P(PriceLevelPolicyTest, BestPriceAfterLevelEmpties) {
+    orderBook->addOrder(limit(1, Side::Sell, 10000, 10));
+    orderBook->addOrder(limit(2, Side::Sell, 10500, 10));   // 跨過數個 64 位元字組
+    orderBook->addOrder(limit(3, Side::Buy, 9000, 10));
+    orderBook->addOrder(limit(4, Side::Buy, 8000, 10));
+
+    EXPECT_TRUE(orderBook->cancelOrder(1));
+    EXPECT_EQ(orderBook->getAskPrice(), Price(10500));
+    EXPECT_TRUE(orderBook->cancelOrder(3));
+    EXPECT_EQ(orderBook->getBidPrice(), Price(8000));
+
+    EXPECT_TRUE(orderBook->cancelOrder(2));
+    EXPECT_TRUE(orderBook->cancelOrder(4));
+    EXPECT_EQ(orderBook->getAskPrice(), Price());
+    EXPECT_EQ(orderBook->getBidPrice(), Price());
+
+    // 層級釋放後可重新使用
+    orderBook->addOrder(limit(5, Side::Sell, 10000, 3));
+    EXPECT_EQ(orderBook->getAskPrice(), Price(10000));
+    EXPECT_EQ(orderBook->getAskQuantity(), 3u);
+}
+
+// 測試跨多個層級撮合時依價格優先、時間優先
+TEST_P(PriceLevelPolicyTest, SweepMatchesBestFirst) {
+    orderBook->addOrder(limit(1, Side::Sell, 10100, 5));
+    orderBook->addOrder(limit(2, Side::Sell, 10000, 5));
+    orderBook->addOrder(limit(3, Side::Sell, 10000, 5));
+    orderBook->addOrder(limit(4, Side::Sell, 10200, 5));
+
+    auto result = orderBook->addOrder(limit(5, Side::Buy, 10100, 12));
+    ASSERT_EQ(result.size(), 3u);
+    EXPECT_EQ(result[0].sellOrderId, 2u);
+    EXPECT_EQ(result[1].sellOrderId, 3u);
+    EXPECT_EQ(result[2].sellOrderId, 1u);
+    EXPECT_EQ(result[2].price, Price(10100));
+    EXPECT_EQ(result[2].quantity, 2u);
+
+    EXPECT_EQ(orderBook->getAskPrice(), Price(10100));
+    EXPECT_EQ(orderBook->getAskQuantity(), 3u);
+    EXPECT_EQ(orderBook->getTotalOrderCount(), 2u);
+}
+
+// 測試隨機操作下三種策略得到相同的深度
+TEST_P(PriceLevelPolicyTest, MatchesMapReference) {
+    OrderBook reference("AAPL");
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<Price::Ticks> price(9500, 10500);
+    std::uniform_int_distribution<Quantity> qty(1, 50);
+    std::vector<OrderID> live;
+
+    for (OrderID id = 1; id <= 2000; ++id) {
+        if (!live.empty() && rng() % 4 == 0) {
+            OrderID victim = live[rng() % live.size()];
+            EXPECT_EQ(orderBook->cancelOrder(victim), reference.cancelOrder(victim));
+            continue;
+        }
+        Side side = (rng() % 2) ? Side::Buy : Side::Sell;
+        Price::Ticks ticks = price(rng);
+        Quantity q = qty(rng);
+        orderBook->addOrder(limit(id, side, ticks, q));
+        reference.addOrder(limit(id, side, ticks, q));
+        live.push_back(id);
+    }
+
+    EXPECT_EQ(orderBook->getBidDepth(50), reference.getBidDepth(50));
+    EXPECT_EQ(orderBook->getAskDepth(50), reference.getAskDepth(50));
+    EXPECT_EQ(orderBook->getTotalOrderCount(), reference.getTotalOrderCount());
+}
+
+INSTANTIATE_TEST_SUITE_P(AllPolicies, PriceLevelPolicyTest,
+    ::testing::Values(PriceLevelPolicy::Map, PriceLevelPolicy::Ladder, PriceLevelPolicy::FlatVector),
+    [](const ::testing::TestParamInfo<PriceLevelPolicy>& info) {
+        return priceLevelPolicyToString(info.param);
+    });
+
+// ===== Ladder 專屬行為 =====
+
+// 測試超出範圍的限價單被拒絕，且不會先成交
+TEST(LadderPriceLevelsTest, RejectsOutOfRangePrice) {
+    OrderPool pool(16);
+    OrderBook orderBook("AAPL", makeConfig(PriceLevelPolicy::Ladder));
+    EXPECT_TRUE(orderBook.acceptsPrice(Price(20000)));
+    EXPECT_FALSE(orderBook.acceptsPrice(Price(20001)));
+    EXPECT_FALSE(orderBook.acceptsPrice(Price(0)));
+
+    orderBook.addOrder(&pool[pool.acquire(1, "C", "AAPL", Side::Sell, OrderType::Limit, Price(100), 10)]);
+    Order* buy = &pool[pool.acquire(2, "C", "AAPL", Side::Buy, OrderType::Limit, Price(30000), 5)];
+    EXPECT_TRUE(orderBook.addOrder(buy).empty());
+    EXPECT_EQ(buy->getStatus(), OrderStatus::Rejected);
+    EXPECT_EQ(orderBook.getAskQuantity(), 10u);
+}
+
+// 測試市價單不受價格範圍限制
+TEST(LadderPriceLevelsTest, MarketOrderMatches) {
+    OrderPool pool(16);
+    OrderBook orderBook("AAPL", makeConfig(PriceLevelPolicy::Ladder));
+    orderBook.addOrder(&pool[pool.acquire(1, "C", "AAPL", Side::Sell, OrderType::Limit, Price(100), 10)]);
+    Order* market = &pool[pool.acquire(2, "C", "AAPL", Side::Buy, Quantity(4))];
+    EXPECT_EQ(orderBook.addOrder(market).size(), 1u);
+    EXPECT_TRUE(market->isFilled());
+}
+
+// 測試價格範圍設定驗證
+TEST(LadderPriceLevelsTest, InvalidRangeThrows) {
+    OrderBookConfig config;
+    config.policy = PriceLevelPolicy::Ladder;
+    config.ladderMinPrice = Price(100);
+    config.ladderMaxPrice = Price(99);
+    EXPECT_THROW(OrderBook("AAPL", config), std::invalid_argument);
+
+    config.ladderMaxPrice = Price(100 + static_cast<Price::Ticks>(LadderPriceLevels::MAX_LEVELS));
+    EXPECT_THROW(OrderBook("AAPL", config), std::invalid_argument);
+
+    config.ladderMaxPrice = Price(100);
+    EXPECT_NO_THROW(OrderBook("AAPL", config));   // 單一價格
+}
+
+// 測試 bitmap 掃描跨字組邊界
+TEST(LadderPriceLevelsTest, BitmapScanAcrossWords) {
+    OrderBookConfig config = makeConfig(PriceLevelPolicy::Ladder);
+    LadderPriceLevels bids(Side::Buy, config);
+    LadderPriceLevels asks(Side::Sell, config);
+
+    for (Price::Ticks ticks : {1LL, 64LL, 65LL, 128LL, 20000LL}) {
+        bids.acquire(Price(ticks));
+        asks.acquire(Price(ticks));
+    }
+
+    std::vector<Price> bidOrder, askOrder;
+    bids.forEachBestFirst([&](const PriceLevel& level) { bidOrder.push_back(level.price()); return true; });
+    asks.forEachBestFirst([&](const PriceLevel& level) { askOrder.push_back(level.price()); return true; });
+
+    EXPECT_EQ(bidOrder, (std::vector<Price>{Price(20000), Price(128), Price(65), Price(64), Price(1)}));
+    EXPECT_EQ(askOrder, (std::vector<Price>{Price(1), Price(64), Price(65), Price(128), Price(20000)}));
+
+    bids.release(bids.find(Price(20000)));
+    asks.release(asks.find(Price(1)));
+    EXPECT_EQ(bids.at(bids.best()).price(), Price(128));
+    EXPECT_EQ(asks.at(asks.best()).price(), Price(64));
+    EXPECT_EQ(bids.levelCount(), 4u);
+}
+
+// ===== 節點表 =====
+
+// 測試節點用完時加倍、既有節點位址不變，移除後節點重用而不再成長
+TEST(OrderNodeTableTest, GrowsAndReusesNodes) {
+    OrderNodeTable table(16);
+    EXPECT_EQ(table.capacity(), 16u);
+
+    std::vector<OrderNode*> nodes;
+    for (OrderID id = 1; id <= 40; ++id) {
+        OrderNode* node = table.insert(id);
+        ASSERT_NE(node, nullptr);
+        nodes.push_back(node);
+    }
+    EXPECT_EQ(table.size(), 40u);
+    EXPECT_EQ(table.capacity(), 64u);   // 16 → 32 → 64
+    for (OrderID id = 1; id <= 40; ++id) {
+        EXPECT_EQ(table.find(id), nodes[id - 1]);
+    }
+    EXPECT_EQ(table.insert(7), nullptr);   // 重複
+
+    // 刪除一半（後移補洞後其餘仍可查到），再放入新的 OrderID 不需新增區塊
+    for (OrderID id = 1; id <= 40; id += 2) {
+        EXPECT_TRUE(table.erase(id));
+    }
+    EXPECT_FALSE(table.erase(1));
+    for (OrderID id = 2; id <= 40; id += 2) {
+        EXPECT_EQ(table.find(id), nodes[id - 1]);
+    }
+    for (OrderID id = 100; id < 120; ++id) {
+        ASSERT_NE(table.insert(id), nullptr);
+    }
+    EXPECT_EQ(table.capacity(), 64u);
+    EXPECT_EQ(table.size(), 40u);
+
+    table.clear();
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(table.find(2), nullptr);
+    for (OrderID id = 1; id <= 64; ++id) {
+        ASSERT_NE(table.insert(id), nullptr);
+    }
+    EXPECT_EQ(table.capacity(), 64u);
+}
+
+// 測試策略名稱轉換
+TEST(PriceLevelPolicyNameTest, RoundTrip) {
+    for (auto policy : {PriceLevelPolicy::Map, PriceLevelPolicy::Ladder, PriceLevelPolicy::FlatVector}) {
+        EXPECT_EQ(stringToPriceLevelPolicy(priceLevelPolicyToString(policy)), policy);
+    }
+    EXPECT_THROW(stringToPriceLevelPolicy("tree"), std::invalid_argument);
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
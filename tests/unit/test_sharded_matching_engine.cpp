@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "../src/core/sharded_matching_engine.h"
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace mts::core;
+
+namespace {
+
+    // 找出落在指定分片的標的名稱
+    std::string symbolOnShard(const ShardedMatchingEngine& engine, size_t shard, int start = 0) {
+        for (int i = start;; ++i) {
+            std::string symbol = "SYM" + std::to_string(i);
+            if (engine.shardForSymbol(symbol) == shard) {
+                return symbol;
+            }
+        }
+    }
+
+} // namespace
+
+// 測試 OrderID 標記與標的路由
+TEST(ShardedMatchingEngineTest, RoutingAndTags) {
+    ShardedMatchingEngine engine(4, 1024, 64);
+    EXPECT_EQ(engine.getShardCount(), 4u);
+
+    std::set<size_t> used;
+    for (int i = 0; i < 64; ++i) {
+        std::string symbol = "SYM" + std::to_string(i);
+        size_t shard = engine.shardForSymbol(symbol);
+        ASSERT_LT(shard, 4u);
+        EXPECT_EQ(engine.shardForSymbol(symbol), shard);   // 穩定
+        used.insert(shard);
+
+        OrderID id = engine.tagOrderId(i + 1, symbol);
+        EXPECT_EQ(ShardedMatchingEngine::shardOfOrderId(id), shard);
+        EXPECT_EQ(id & ((OrderID(1) << ShardedMatchingEngine::SHARD_TAG_SHIFT) - 1), OrderID(i + 1));
+    }
+    EXPECT_EQ(used.size(), 4u);
+
+    EXPECT_THROW(engine.tagOrderId(OrderID(1) << 60, "AAPL"), std::overflow_error);
+    EXPECT_THROW(ShardedMatchingEngine(0), std::invalid_argument);
+    EXPECT_THROW(ShardedMatchingEngine(257), std::invalid_argument);
+}
+
+// 測試單一分片時 OrderID 不帶標記，行為與 MatchingEngine 相同
+TEST(ShardedMatchingEngineTest, SingleShardIsTransparent) {
+    ShardedMatchingEngine engine(1, 1024, 64);
+    EXPECT_EQ(engine.tagOrderId(42, "AAPL"), 42u);
+
+    OrderHandle sell = engine.createOrder(OrderID(1), "C", "AAPL", Side::Sell, OrderType::Limit, Price(10000), Quantity(10));
+    OrderHandle buy = engine.createOrder(OrderID(2), "C", "AAPL", Side::Buy, OrderType::Limit, Price(10000), Quantity(4));
+    engine.processOrderSync(sell);
+    auto report = engine.processOrderSync(buy);
+    ASSERT_TRUE(report);
+    EXPECT_EQ(report->status, OrderStatus::Filled);
+    EXPECT_EQ(engine.getOrderBook("AAPL")->getAskQuantity(), 6u);
+}
+
+// 測試訂單建立在標的所屬分片，取消依 OrderID 標記路由
+TEST(ShardedMatchingEngineTest, OrdersLiveOnSymbolShard) {
+    ShardedMatchingEngine engine(3, 1024, 64);
+    std::string a = symbolOnShard(engine, 0);
+    std::string b = symbolOnShard(engine, 2);
+
+    OrderID idA = engine.tagOrderId(1, a);
+    OrderID idB = engine.tagOrderId(2, b);
+    OrderHandle ha = engine.createOrder(idA, "C", a, Side::Buy, OrderType::Limit, Price(10000), Quantity(5));
+    OrderHandle hb = engine.createOrder(idB, "C", b, Side::Sell, OrderType::Limit, Price(10100), Quantity(7));
+    EXPECT_EQ(ShardedMatchingEngine::shardOfHandle(ha), 0u);
+    EXPECT_EQ(ShardedMatchingEngine::shardOfHandle(hb), 2u);
+    EXPECT_EQ(engine.getOrder(hb).getOrderId(), idB);
+
+    engine.processOrderSync(ha);
+    engine.processOrderSync(hb);
+    EXPECT_TRUE(engine.getShard(0).getOrderBook(a));
+    EXPECT_FALSE(engine.getShard(0).getOrderBook(b));
+    EXPECT_TRUE(engine.getShard(2).getOrderBook(b));
+    EXPECT_EQ(engine.getAllSymbols().size(), 2u);
+    ASSERT_NE(engine.findOrder(idB), nullptr);
+
+    auto cancel = engine.cancelOrderSync(idB, "test");
+    ASSERT_TRUE(cancel);
+    EXPECT_EQ(cancel->status, OrderStatus::Cancelled);
+    EXPECT_EQ(engine.findOrder(idB), nullptr);
+
+    // 標記與標的分片不符
+    EXPECT_THROW(engine.createOrder(engine.tagOrderId(3, a), "C", b, Side::Buy, Quantity(1)),
+                 std::invalid_argument);
+}
+
+// 測試多標的異步流量：所有回報送達，統計彙總正確
+TEST(ShardedMatchingEngineTest, ConcurrentMultiSymbolFlow) {
+    constexpr size_t SHARDS = 4;
+    constexpr int SYMBOLS = 8;
+    constexpr int ORDERS_PER_SYMBOL = 200;
+
+    ShardedMatchingEngine engine(SHARDS, 4096, 1024);
+    std::atomic<int> reports{0};
+    std::vector<std::atomic<int>> perShard(SHARDS);
+    engine.setExecutionCallback([&](const ExecutionReportPtr& report) {
+        perShard[ShardedMatchingEngine::shardOfOrderId(report->orderId)].fetch_add(1);
+        reports.fetch_add(1);
+    });
+    ASSERT_TRUE(engine.start());
+
+    std::vector<std::thread> gateways;
+    for (int s = 0; s < SYMBOLS; ++s) {
+        gateways.emplace_back([&engine, s]() {
+            std::string symbol = "SYM" + std::to_string(s);
+            for (int i = 0; i < ORDERS_PER_SYMBOL; ++i) {
+                OrderID id = engine.tagOrderId(static_cast<OrderID>(s * ORDERS_PER_SYMBOL + i + 1), symbol);
+                Side side = (i % 2) ? Side::Sell : Side::Buy;
+                for (;;) {
+                    OrderHandle handle = engine.createOrder(id, "C", symbol, side,
+                                                            OrderType::Limit, Price(10000), Quantity(1));
+                    if (handle != INVALID_ORDER_HANDLE && engine.submitOrder(handle)) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& gateway : gateways) {
+        gateway.join();
+    }
+
+    // 每筆訂單一筆回報，每次成交另有一筆被動方回報
+    constexpr int TOTAL = SYMBOLS * ORDERS_PER_SYMBOL;
+    constexpr int EXPECTED = TOTAL + TOTAL / 2;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (reports.load() < EXPECTED && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    engine.stop();
+    ASSERT_EQ(reports.load(), EXPECTED);
+
+    uint64_t shardSum = 0;
+    for (size_t i = 0; i < SHARDS; ++i) {
+        const EngineStatistics& shard = engine.getShardStatistics(i);
+        EXPECT_EQ(shard.ordersProcessed.load() + shard.tradesExecuted.load(), static_cast<uint64_t>(perShard[i].load()));
+        shardSum += engine.getShardStatistics(i).ordersProcessed.load();
+    }
+    EngineStatistics total;
+    engine.getStatistics(total);
+    EXPECT_EQ(total.ordersProcessed.load(), shardSum);
+    EXPECT_EQ(total.ordersProcessed.load(), static_cast<uint64_t>(TOTAL));
+    EXPECT_EQ(total.tradesExecuted.load(), static_cast<uint64_t>(TOTAL / 2));   // 每對買賣各成交一次
+
+    // 多個執行緒同時彙總，各自寫入自己的物件，不會讀到其他查詢重設中的數字
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&engine, &mismatches]() {
+            for (int i = 0; i < 200; ++i) {
+                EngineStatistics snapshot;
+                engine.getStatistics(snapshot);
+                if (snapshot.ordersProcessed.load() != static_cast<uint64_t>(TOTAL)) {
+                    mismatches.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(mismatches.load(), 0);
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
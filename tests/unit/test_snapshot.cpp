@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include "../src/core/snapshot.h"
+#include "../src/core/matching_engine.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mts::core;
+
+namespace {
+
+    class SnapshotTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            directory_ = (std::filesystem::temp_directory_path() /
+                          ("mts_snapshot_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name())))
+                             .string();
+            std::filesystem::remove_all(directory_);
+        }
+
+        void TearDown() override { std::filesystem::remove_all(directory_); }
+
+        JournalConfig journalConfig() const {
+            JournalConfig config;
+            config.directory = directory_;
+            config.segmentSize = JournalConfig::MIN_SEGMENT_SIZE;
+            return config;
+        }
+
+        static bool submit(MatchingEngine& engine, OrderID id, Side side, Price price, Quantity quantity,
+                           const std::string& symbol = "AAPL") {
+            return engine.submitOrder(engine.createOrder(id, "C" + std::to_string(id), symbol, side,
+                                                         OrderType::Limit, price, quantity));
+        }
+
+        // 等待撮合執行緒處理到指定的日誌序號
+        static void waitForSequence(const MatchingEngine& engine, uint64_t sequence) {
+            for (int i = 0; i < 400 && engine.getJournal()->lastSequence() < sequence; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+
+        std::string directory_;
+    };
+
+} // namespace
+
+// 測試快照影像寫檔後讀回，保留優先順序與部分成交狀態
+TEST_F(SnapshotTest, FileRoundTrip) {
+    Order bid1(1, "A", "AAPL", Side::Buy, OrderType::Limit, Price(10000), 100);
+    Order bid2(2, "B", "AAPL", Side::Buy, OrderType::Limit, Price(9900), 50, TimeInForce::GTC);
+    Order ask(3, "C", "AAPL", Side::Sell, OrderType::Limit, Price(10100), 70);
+    bid1.fillQuantity(40);
+    bid1.setSequence(5);
+
+    SnapshotImage image;
+    image.journalSequence = 42;
+    image.engineSequence = 9;
+    OrderBookConfig config;
+    config.policy = PriceLevelPolicy::Ladder;
+    config.ladderMinPrice = Price(1);
+    config.ladderMaxPrice = Price(20000);
+    image.beginBook("AAPL", config);
+    image.addOrder(bid1);
+    image.addOrder(bid2);
+    image.addOrder(ask);
+    image.beginBook("EMPTY", OrderBookConfig());
+    EXPECT_EQ(image.orderCount(), 3u);
+
+    std::string path;
+    std::string error;
+    ASSERT_TRUE(writeSnapshotFile(directory_, image, path, error)) << error;
+    EXPECT_EQ(findLatestSnapshot(directory_), path);
+
+    SnapshotData data;
+    ASSERT_TRUE(readSnapshotFile(path, data, error)) << error;
+    EXPECT_EQ(data.journalSequence, 42u);
+    EXPECT_EQ(data.engineSequence, 9u);
+    ASSERT_EQ(data.books.size(), 2u);
+    const SnapshotBook& book = data.books[0];
+    EXPECT_EQ(book.symbol, "AAPL");
+    EXPECT_EQ(book.config.policy, PriceLevelPolicy::Ladder);
+    EXPECT_EQ(book.config.ladderMaxPrice, Price(20000));
+    ASSERT_EQ(book.bids.size(), 2u);
+    ASSERT_EQ(book.asks.size(), 1u);
+    EXPECT_EQ(book.bids[0].orderId, 1u);
+    EXPECT_EQ(book.bids[0].remainingQuantity, 60u);
+    EXPECT_EQ(book.bids[0].status, OrderStatus::PartiallyFilled);
+    EXPECT_EQ(book.bids[0].sequence, 5u);
+    EXPECT_EQ(book.bids[1].timeInForce, TimeInForce::GTC);
+    EXPECT_EQ(book.asks[0].clientId, "C");
+    EXPECT_TRUE(data.books[1].bids.empty());
+
+    // 內容損毀時拒絕載入
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(64 + 40);
+        file.put('\x7f');
+    }
+    EXPECT_FALSE(readSnapshotFile(path, data, error));
+    EXPECT_NE(error.find("checksum"), std::string::npos);
+}
+
+// 測試只保留最新的快照
+TEST_F(SnapshotTest, PruneKeepsNewest) {
+    std::string path;
+    std::string error;
+    for (uint64_t sequence : {10u, 200u, 30u}) {
+        SnapshotImage image;
+        image.journalSequence = sequence;
+        ASSERT_TRUE(writeSnapshotFile(directory_, image, path, error)) << error;
+    }
+    pruneSnapshots(directory_, 2);
+    SnapshotData data;
+    ASSERT_TRUE(readSnapshotFile(findLatestSnapshot(directory_), data, error)) << error;
+    EXPECT_EQ(data.journalSequence, 200u);
+    size_t files = 0;
+    for (const auto& item : std::filesystem::directory_iterator(directory_)) {
+        (void)item;
+        ++files;
+    }
+    EXPECT_EQ(files, 2u);
+}
+
+// 測試由快照 + 日誌尾端重建，時間優先與後續序號都接續
+TEST_F(SnapshotTest, RecoverFromSnapshotAndJournalTail) {
+    {
+        MatchingEngine engine(1024, 64);
+        ASSERT_TRUE(engine.enableJournal(journalConfig()));
+        ASSERT_TRUE(engine.start());
+        ASSERT_TRUE(submit(engine, 1, Side::Sell, Price(10100), 100));
+        ASSERT_TRUE(submit(engine, 2, Side::Sell, Price(10100), 50));
+        ASSERT_TRUE(submit(engine, 3, Side::Buy, Price(10100), 30));    // #1 部分成交
+        ASSERT_TRUE(submit(engine, 4, Side::Buy, Price(9900), 20));
+        waitForSequence(engine, 4);
+
+        ASSERT_TRUE(engine.requestSnapshot());
+        for (int i = 0; i < 400 && engine.getSnapshotCount() == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        ASSERT_EQ(engine.getSnapshotCount(), 1u);
+
+        // 快照之後的日誌尾端
+        ASSERT_TRUE(submit(engine, 5, Side::Buy, Price(9800), 10));
+        ASSERT_TRUE(engine.cancelOrder(4, "tail"));
+        waitForSequence(engine, 6);
+        engine.stop();
+    }
+
+    MatchingEngine restored(1024, 64);
+    RecoveryResult result;
+    ASSERT_TRUE(restored.recover(directory_, result));
+    EXPECT_EQ(result.snapshotSequence, 4u);
+    EXPECT_EQ(result.restoredOrders, 3u);    // #1(70), #2, #4
+    EXPECT_EQ(result.replayedRecords, 2u);
+    EXPECT_EQ(result.lastSequence, 6u);
+    EXPECT_EQ(result.maxOrderId, 5u);
+
+    auto book = restored.getOrderBook("AAPL");
+    ASSERT_TRUE(book);
+    EXPECT_EQ(book->getAskQuantity(), 120u);
+    EXPECT_EQ(book->getBidPrice(), Price(9800));
+    EXPECT_EQ(book->getTotalOrderCount(), 3u);
+    ASSERT_NE(restored.findOrder(1), nullptr);
+    EXPECT_EQ(restored.findOrder(1)->getRemainingQuantity(), 70u);
+    EXPECT_EQ(restored.findOrder(4), nullptr);
+
+    // 恢復後繼續寫同一份日誌，時間優先不變：#1 先於 #2 成交
+    ASSERT_TRUE(restored.enableJournal(journalConfig()));
+    EXPECT_EQ(restored.getJournal()->lastSequence(), 6u);
+    auto fill = restored.processOrderSync(restored.createOrder(OrderID(6), "D", "AAPL", Side::Buy,
+                                                               OrderType::Limit, Price(10100), Quantity(70)));
+    ASSERT_TRUE(fill);
+    EXPECT_EQ(fill->status, OrderStatus::Filled);
+    EXPECT_EQ(fill->counterOrderId, 1u);
+    EXPECT_EQ(restored.findOrder(2)->getRemainingQuantity(), 50u);
+    EXPECT_EQ(restored.getJournal()->lastSequence(), 7u);
+}
+
+// 測試沒有快照時重播整份日誌；日誌在快照之前中斷時拒絕恢復
+TEST_F(SnapshotTest, RecoverFromJournalOnly) {
+    {
+        MatchingEngine engine(1024, 64);
+        ASSERT_TRUE(engine.enableJournal(journalConfig()));
+        engine.processOrderSync(engine.createOrder(OrderID(1), "A", "MSFT", Side::Buy, OrderType::Limit, Price(5000), Quantity(10)));
+        engine.processOrderSync(engine.createOrder(OrderID(2), "B", "MSFT", Side::Sell, OrderType::Limit, Price(5000), Quantity(4)));
+    }
+
+    MatchingEngine restored(1024, 64);
+    RecoveryResult result;
+    ASSERT_TRUE(restored.recover(directory_, result));
+    EXPECT_EQ(result.snapshotSequence, 0u);
+    EXPECT_EQ(result.replayedRecords, 2u);
+    ASSERT_NE(restored.findOrder(1), nullptr);
+    EXPECT_EQ(restored.findOrder(1)->getRemainingQuantity(), 6u);
+
+    // 快照涵蓋的序號超過日誌
+    SnapshotImage image;
+    image.journalSequence = 10;
+    std::string path;
+    std::string error;
+    ASSERT_TRUE(writeSnapshotFile(directory_, image, path, error)) << error;
+    MatchingEngine mismatched(1024, 64);
+    EXPECT_FALSE(mismatched.recover(directory_, result));
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include "../src/network/tcp_server.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mts::tcp_server;
+
+namespace {
+    // 每個測試用不同的 port，避免 TIME_WAIT 與平行執行互相干擾
+    int nextPort() {
+        static int port = 20000 + static_cast<int>(::getpid() % 5000) * 2;
+        return port++;
+    }
+
+    // 啟動伺服器並建立一條客戶端連線，回傳伺服器端看到的 socket
+    struct Loopback {
+        TCPServer server;
+        SOCKET client = INVALID_SOCKET;
+        std::atomic<SOCKET> accepted{INVALID_SOCKET};
+
+        explicit Loopback(int port) : server(port) {
+            server.setConnectionCallback([this](const TCPServer::ConnectionPtr& connection) {
+                accepted = connection->socket;
+            });
+        }
+
+        bool connect(int port, int receiveBuffer = 0) {
+            if (!server.start()) {
+                return false;
+            }
+            client = ::socket(AF_INET, SOCK_STREAM, 0);
+            if (receiveBuffer > 0) {
+                ::setsockopt(client, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+            }
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(port));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (::connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                return false;
+            }
+            for (int i = 0; i < 200 && accepted.load() == INVALID_SOCKET; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            return accepted.load() != INVALID_SOCKET;
+        }
+
+        std::string receive(size_t length) {
+            std::string data(length, '\0');
+            size_t received = 0;
+            while (received < length) {
+                ssize_t n = ::recv(client, &data[received], length - received, 0);
+                if (n <= 0) {
+                    break;
+                }
+                received += static_cast<size_t>(n);
+            }
+            data.resize(received);
+            return data;
+        }
+
+        ~Loopback() {
+            if (client != INVALID_SOCKET) {
+                closesocket(client);
+            }
+            server.stop();
+        }
+    };
+}
+
+// 測試多筆訊息依序送達；epoll 模式下合併成一次 sendmsg
+TEST(TCPServerTest, GatherWritesBatch) {
+    int port = nextPort();
+    Loopback loopback(port);
+    ASSERT_TRUE(loopback.connect(port));
+
+    std::vector<std::string> messages;
+    std::vector<std::string_view> views;
+    std::string expected;
+    for (int i = 0; i < 12; ++i) {
+        messages.push_back("8=FIX.4.2|35=8|11=ORD" + std::to_string(i) + "|");
+    }
+    for (const auto& message : messages) {
+        views.push_back(message);
+        expected += message;
+    }
+
+    uint64_t callsBefore = loopback.server.getSendStatistics().write_calls.load();
+    ASSERT_TRUE(loopback.server.sendMessages(loopback.accepted.load(), views.data(), views.size()));
+#ifdef MTS_EPOLL_REACTOR
+    EXPECT_EQ(loopback.server.getSendStatistics().write_calls.load() - callsBefore, 1u);
+#else
+    (void)callsBefore;
+#endif
+
+    EXPECT_EQ(loopback.receive(expected.size()), expected);
+}
+
+// 測試客戶端暫停讀取時發送端不阻塞，資料排入連線佇列，恢復讀取後完整且依序送達
+TEST(TCPServerTest, QueuesWhenClientStopsReading) {
+#ifndef MTS_EPOLL_REACTOR
+    GTEST_SKIP() << "每連線一條執行緒的模式使用阻塞 socket";
+#endif
+    constexpr int BATCHES = 64;
+    constexpr int PER_BATCH = 32;
+    constexpr size_t MESSAGE_SIZE = 2048;
+
+    int port = nextPort();
+    Loopback loopback(port);
+    ASSERT_TRUE(loopback.connect(port, 4096));
+
+    std::string expected;
+    std::vector<std::string> messages;
+    for (int i = 0; i < BATCHES * PER_BATCH; ++i) {
+        std::string message = std::to_string(i) + ":";
+        message.resize(MESSAGE_SIZE, static_cast<char>('a' + i % 26));
+        messages.push_back(std::move(message));
+        expected += messages.back();
+    }
+
+    // 客戶端尚未讀取：4 MB 超過核心緩衝，必須排隊
+    auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < BATCHES; ++b) {
+        std::vector<std::string_view> views(messages.begin() + b * PER_BATCH, messages.begin() + (b + 1) * PER_BATCH);
+        ASSERT_TRUE(loopback.server.sendMessages(loopback.accepted.load(), views.data(), views.size()));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    EXPECT_GT(loopback.server.getSendStatistics().would_block.load(), 0u);
+    EXPECT_GT(loopback.server.getSendStatistics().queued_bytes.load(), 0u);
+
+    std::string received = loopback.receive(expected.size());
+    ASSERT_EQ(received.size(), expected.size());
+    EXPECT_TRUE(received == expected);
+}
+
+// 測試連線關閉後，持有的 ConnectionPtr 寫出與斷線一律失敗（socket 編號可能已被重用）
+TEST(TCPServerTest, ConnectionHandleFailsAfterClose) {
+    int port = nextPort();
+    Loopback loopback(port);
+    ASSERT_TRUE(loopback.connect(port));
+
+    TCPServer::ConnectionPtr connection = loopback.server.getConnection(loopback.accepted.load());
+    ASSERT_NE(connection, nullptr);
+    std::string_view hello = "hello";
+    ASSERT_TRUE(loopback.server.sendMessages(connection, &hello, 1));
+    EXPECT_EQ(loopback.receive(hello.size()), hello);
+
+    closesocket(loopback.client);
+    loopback.client = INVALID_SOCKET;
+    for (int i = 0; i < 200 && loopback.server.getActiveClientCount() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(loopback.server.getActiveClientCount(), 0u);
+
+    EXPECT_EQ(loopback.server.getConnection(loopback.accepted.load()), nullptr);
+    EXPECT_FALSE(loopback.server.sendMessages(connection, &hello, 1));
+    EXPECT_FALSE(loopback.server.disconnectClient(connection));
+}
+
+// 測試資料與 FIN 在同一次事件到達時仍偵測到斷線並清理連線
+TEST(TCPServerTest, DetectsCloseAfterFinalData) {
+    constexpr int ROUNDS = 20;
+
+    for (int round = 0; round < ROUNDS; ++round) {
+        int port = nextPort();
+        Loopback loopback(port);
+        std::atomic<int> disconnects{0};
+        loopback.server.setDisconnectionCallback([&disconnects](TCPServer::ConnectionId) { disconnects++; });
+        ASSERT_TRUE(loopback.connect(port));
+
+        // 送出後立刻關閉，讓最後的資料與 FIN 一起進入核心緩衝
+        std::string data(100, 'x');
+        ASSERT_EQ(::send(loopback.client, data.data(), data.size(), 0), static_cast<ssize_t>(data.size()));
+        closesocket(loopback.client);
+        loopback.client = INVALID_SOCKET;
+
+        for (int i = 0; i < 200 && disconnects.load() == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        ASSERT_EQ(disconnects.load(), 1) << "round " << round;
+        EXPECT_EQ(loopback.server.getActiveClientCount(), 0u);
+    }
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+#include "../src/trading_system.h"
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mts;
+
+namespace {
+    // 每個測試用不同的 port，避免 TIME_WAIT 與平行執行互相干擾
+    int nextPort() {
+        static int port = 30000 + static_cast<int>(::getpid() % 5000) * 2;
+        return port++;
+    }
+
+    using Fields = std::map<int, std::string>;
+
+    // 以原始 socket 連線的 FIX 客戶端：自行組 BodyLength / CheckSum，收到的訊息拆成欄位
+    class FixClient {
+    public:
+        ~FixClient() {
+            if (socket_ != INVALID_SOCKET) {
+                closesocket(socket_);
+            }
+        }
+
+        bool connect(int port) {
+            socket_ = ::socket(AF_INET, SOCK_STREAM, 0);
+            timeval timeout{0, 100 * 1000};
+            ::setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(port));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (::connect(socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                return false;
+            }
+            send("A", {{98, "0"}, {108, "30"}});
+            return waitFor([](const Fields& message) { return message.at(35) == "A"; }).has_value();
+        }
+
+        void send(const std::string& msgType, const std::vector<std::pair<int, std::string>>& fields) {
+            std::string body = "35=" + msgType + "\x01" + "49=CLIENT1\x01" + "56=SERVER\x01" +
+                               "34=" + std::to_string(++sequence_) + "\x01" + "52=20240101-00:00:00\x01";
+            for (const auto& [tag, value] : fields) {
+                body += std::to_string(tag) + "=" + value + "\x01";
+            }
+            std::string message = "8=FIX.4.2\x01" "9=" + std::to_string(body.size()) + "\x01" + body;
+            unsigned sum = 0;
+            for (unsigned char c : message) {
+                sum += c;
+            }
+            char checksum[8];
+            std::snprintf(checksum, sizeof(checksum), "%03u", sum % 256);
+            message += std::string("10=") + checksum + "\x01";
+            ASSERT_EQ(::send(socket_, message.data(), message.size(), 0), static_cast<ssize_t>(message.size()));
+        }
+
+        // 等待第一筆符合條件的訊息，之前收到的其他訊息略過
+        template <typename Pred>
+        std::optional<Fields> waitFor(Pred pred, std::chrono::seconds timeout = std::chrono::seconds(5)) {
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            while (std::chrono::steady_clock::now() < deadline) {
+                while (auto message = nextMessage()) {
+                    if (message->count(35) && pred(*message)) {
+                        return message;
+                    }
+                }
+                char chunk[4096];
+                ssize_t n = ::recv(socket_, chunk, sizeof(chunk), 0);
+                if (n == 0) {
+                    break;
+                }
+                if (n > 0) {
+                    buffer_.append(chunk, static_cast<size_t>(n));
+                }
+            }
+            return std::nullopt;
+        }
+
+        // 等待指定 ClOrdID 的執行回報
+        std::optional<Fields> waitForReport(const std::string& clOrdId) {
+            return waitFor([&clOrdId](const Fields& message) {
+                return message.at(35) == "8" && message.count(11) && message.at(11) == clOrdId;
+            });
+        }
+
+    private:
+        std::optional<Fields> nextMessage() {
+            size_t end = buffer_.find("\x01" "10=");
+            if (end == std::string::npos || buffer_.size() < end + 8) {
+                return std::nullopt;
+            }
+            std::string raw = buffer_.substr(0, end + 1);
+            buffer_.erase(0, end + 8);
+            Fields fields;
+            size_t start = 0;
+            while (start < raw.size()) {
+                size_t equals = raw.find('=', start);
+                size_t separator = raw.find('\x01', start);
+                fields[std::stoi(raw.substr(start, equals - start))] = raw.substr(equals + 1, separator - equals - 1);
+                start = separator + 1;
+            }
+            return fields;
+        }
+
+        SOCKET socket_ = INVALID_SOCKET;
+        int sequence_ = 0;
+        std::string buffer_;
+    };
+
+    std::vector<std::pair<int, std::string>> limitOrder(const std::string& clOrdId, char side,
+                                                        const std::string& quantity, const std::string& price) {
+        return {{11, clOrdId}, {55, "AAPL"}, {54, std::string(1, side)}, {38, quantity},
+                {40, "2"}, {44, price}, {21, "1"}};
+    }
+
+    std::vector<std::pair<int, std::string>> statusRequest(const std::string& clOrdId) {
+        return {{11, clOrdId}, {55, "AAPL"}, {54, "1"}};
+    }
+
+    struct RunningSystem {
+        int port = nextPort();
+        TradingSystem system{port};
+
+        RunningSystem() { system.setReactorThreadCount(1); }
+        ~RunningSystem() { system.stop(); }
+    };
+}
+
+// 測試同一 Session 內未終止的 ClOrdID 不可重複，原訂單不受影響
+TEST(TradingSystemTest, RejectsDuplicateClOrdId) {
+    RunningSystem running;
+    ASSERT_TRUE(running.system.start());
+    FixClient client;
+    ASSERT_TRUE(client.connect(running.port));
+
+    client.send("D", limitOrder("A1", '1', "10", "149.00"));
+    auto accepted = client.waitForReport("A1");
+    ASSERT_TRUE(accepted);
+    EXPECT_EQ(accepted->at(39), "0");
+
+    client.send("D", limitOrder("A1", '1', "20", "148.00"));
+    auto rejected = client.waitForReport("A1");
+    ASSERT_TRUE(rejected);
+    EXPECT_EQ(rejected->at(39), "8");
+
+    client.send("H", statusRequest("A1"));
+    auto status = client.waitForReport("A1");
+    ASSERT_TRUE(status);
+    EXPECT_EQ(status->at(150), "I");
+    EXPECT_EQ(status->at(39), "0");
+    EXPECT_EQ(status->at(38), "10");
+}
+
+// 測試撤單依 OrigClOrdID 找到原訂單，撤單後 ClOrdID 不再有效
+TEST(TradingSystemTest, CancelsByOrigClOrdId) {
+    RunningSystem running;
+    ASSERT_TRUE(running.system.start());
+    FixClient client;
+    ASSERT_TRUE(client.connect(running.port));
+
+    client.send("D", limitOrder("R1", '1', "10", "149.00"));
+    ASSERT_TRUE(client.waitForReport("R1"));
+
+    client.send("F", {{11, "C1"}, {41, "R1"}, {55, "AAPL"}, {54, "1"}});
+    auto canceled = client.waitForReport("R1");
+    ASSERT_TRUE(canceled);
+    EXPECT_EQ(canceled->at(39), "4");
+
+    client.send("H", statusRequest("R1"));
+    auto status = client.waitForReport("R1");
+    ASSERT_TRUE(status);
+    EXPECT_EQ(status->at(39), "8");   // 已終止：索引已移除
+
+    // 不存在的 OrigClOrdID 以撤單請求的 ClOrdID 回覆拒絕
+    client.send("F", {{11, "C2"}, {41, "NOPE"}, {55, "AAPL"}, {54, "1"}});
+    auto cancelReject = client.waitForReport("C2");
+    ASSERT_TRUE(cancelReject);
+    EXPECT_EQ(cancelReject->at(39), "8");
+}
+
+// 測試掛單被動成交時收到成交回報，35=H 反映最新狀態
+TEST(TradingSystemTest, ReportsPassiveFills) {
+    RunningSystem running;
+    ASSERT_TRUE(running.system.start());
+    FixClient maker;
+    FixClient taker;
+    ASSERT_TRUE(maker.connect(running.port));
+    ASSERT_TRUE(taker.connect(running.port));
+
+    maker.send("D", limitOrder("S1", '2', "100", "150.00"));
+    auto resting = maker.waitForReport("S1");
+    ASSERT_TRUE(resting);
+    EXPECT_EQ(resting->at(39), "0");
+
+    // 部分成交：掛單仍在簿上，35=H 回覆部分成交與累計數量
+    taker.send("D", limitOrder("B1", '1', "40", "150.00"));
+    ASSERT_TRUE(taker.waitForReport("B1"));
+    auto partial = maker.waitForReport("S1");
+    ASSERT_TRUE(partial);
+    EXPECT_EQ(partial->at(39), "1");
+    EXPECT_EQ(partial->at(32), "40");
+    EXPECT_EQ(partial->at(151), "60");
+
+    maker.send("H", statusRequest("S1"));
+    auto status = maker.waitForReport("S1");
+    ASSERT_TRUE(status);
+    EXPECT_EQ(status->at(39), "1");
+    EXPECT_EQ(status->at(14), "40");
+
+    // 全部成交：索引移除，35=H 不再回覆 New
+    taker.send("D", limitOrder("B2", '1', "60", "150.00"));
+    ASSERT_TRUE(taker.waitForReport("B2"));
+    auto filled = maker.waitForReport("S1");
+    ASSERT_TRUE(filled);
+    EXPECT_EQ(filled->at(39), "2");
+
+    maker.send("H", statusRequest("S1"));
+    status = maker.waitForReport("S1");
+    ASSERT_TRUE(status);
+    EXPECT_EQ(status->at(39), "8");
+}
+
+// 主函式
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
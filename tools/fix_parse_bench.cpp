@@ -0,0 +1,182 @@
+// tools/fix_parse_bench.cpp
+// FIX 解析效能比較：舊版 find() 解析 vs FixScanner / FixMessage / FixMessageView
+//
+// 用法: fix_parse_bench [fix_messages_only.txt] [iterations]
+// 建議以 Release 並關閉 ENABLE_FIX_*_DEBUG 編譯，否則除錯輸出會主導舊版路徑的時間。
+#include "protocol/fix_message.h"
+#include "protocol/fix_message_view.h"
+#include "protocol/fix_scanner.h"
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace mts::protocol;
+
+namespace {
+
+    // 基準前的舊版解析流程：find('=') → find(SOH) → find('|')，再以重新序列化驗證 checksum
+    FixMessage legacyParse(const std::string& rawMessage) {
+        FixMessage msg;
+        size_t pos = 0;
+
+        while (pos < rawMessage.length()) {
+            size_t equalPos = rawMessage.find('=', pos);
+            if (equalPos == std::string::npos) {
+                break;
+            }
+
+            size_t sohPos = rawMessage.find(FixMessage::SOH, equalPos);
+            if (sohPos == std::string::npos) {
+                sohPos = rawMessage.find('|', equalPos);
+                if (sohPos == std::string::npos) {
+                    sohPos = rawMessage.length();
+                }
+            }
+
+            int tag = 0;
+            for (size_t i = pos; i < equalPos; ++i) {
+                tag = tag * 10 + (rawMessage[i] - '0');
+            }
+
+            msg.setField(tag, std::string(rawMessage.data() + equalPos + 1, sohPos - equalPos - 1));
+            pos = sohPos + 1;
+        }
+
+        if (!msg.validateChecksum()) {
+            msg.removeField(FixMessage::CheckSum);
+        }
+        return msg;
+    }
+
+    std::vector<std::string> loadMessages(const std::string& explicitPath) {
+        std::vector<std::string> candidates;
+        if (!explicitPath.empty()) {
+            candidates.push_back(explicitPath);
+        } else {
+            candidates = {"fix_messages_only.txt", "../fix_messages_only.txt", "../../fix_messages_only.txt"};
+        }
+
+        for (const auto& path : candidates) {
+            std::ifstream file(path);
+            if (!file) {
+                continue;
+            }
+
+            std::vector<std::string> messages;
+            std::string line;
+            while (std::getline(file, line)) {
+                while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) {
+                    line.pop_back();
+                }
+                if (line.rfind("8=", 0) == 0) {
+                    messages.push_back(line);
+                }
+            }
+            std::cout << "📂 Loaded " << messages.size() << " messages from " << path << std::endl;
+            return messages;
+        }
+        return {};
+    }
+
+    struct BenchResult {
+        std::string name;
+        double nsPerMessage;
+        double mbPerSecond;
+    };
+
+    BenchResult runBench(const std::string& name, const std::vector<std::string>& messages,
+                         size_t totalBytes, int iterations, const std::function<size_t(const std::string&)>& body) {
+        // 預熱
+        size_t sink = 0;
+        for (const auto& msg : messages) {
+            sink += body(msg);
+        }
+
+        // 暫時關閉 std::cout，避免除錯巨集的輸出干擾量測
+        auto* saved = std::cout.rdbuf(nullptr);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            for (const auto& msg : messages) {
+                sink += body(msg);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        std::cout.rdbuf(saved);
+        std::cout.clear();
+
+        double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        double count = static_cast<double>(messages.size()) * iterations;
+        double bytes = static_cast<double>(totalBytes) * iterations;
+
+        if (sink == 0) {
+            std::cout << "";  // 防止整段被最佳化掉
+        }
+        return BenchResult{name, ns / count, bytes / (ns / 1e9) / (1024.0 * 1024.0)};
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "";
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 2000;
+
+    auto messages = loadMessages(path);
+    if (messages.empty()) {
+        std::cerr << "❌ fix_messages_only.txt not found (pass the path as the first argument)" << std::endl;
+        return 1;
+    }
+
+    size_t totalBytes = 0;
+    for (const auto& msg : messages) {
+        totalBytes += msg.size();
+    }
+
+    std::cout << "⚙️  FixScanner backend: " << FixScanner::backend()
+              << ", iterations: " << iterations << std::endl;
+
+    std::vector<BenchResult> results;
+
+    results.push_back(runBench("legacy find() + re-serialize checksum", messages, totalBytes, iterations,
+        [](const std::string& raw) { return legacyParse(raw).getFieldCount(); }));
+
+    results.push_back(runBench("FixMessage::parse (scanner)", messages, totalBytes, iterations,
+        [](const std::string& raw) { return FixMessage::parse(raw).getFieldCount(); }));
+
+    results.push_back(runBench("FixMessageView::parse", messages, totalBytes, iterations,
+        [](const std::string& raw) { return FixMessageView::parse(raw).getFieldCount(); }));
+
+    results.push_back(runBench("FixScanner::scan (" + std::string(FixScanner::backend()) + ")", messages, totalBytes, iterations,
+        [](const std::string& raw) {
+            FixFieldSpan spans[64];
+            return FixScanner::scan(raw, spans, 64).fieldCount;
+        }));
+
+    results.push_back(runBench("FixScanner::scanScalar", messages, totalBytes, iterations,
+        [](const std::string& raw) {
+            FixFieldSpan spans[64];
+            return FixScanner::scanScalar(raw, spans, 64).fieldCount;
+        }));
+
+    std::cout << "\n📊 FIX Parse Benchmark (" << messages.size() << " messages, "
+              << totalBytes << " bytes per pass)" << std::endl;
+    std::cout << std::string(72, '-') << std::endl;
+    std::cout << std::left << std::setw(42) << "Parser"
+              << std::right << std::setw(14) << "ns/msg"
+              << std::setw(16) << "MB/s" << std::endl;
+    std::cout << std::string(72, '-') << std::endl;
+
+    const double baseline = results.front().nsPerMessage;
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(42) << result.name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << result.nsPerMessage
+                  << std::setw(16) << result.mbPerSecond
+                  << "   (x" << std::setprecision(2) << baseline / result.nsPerMessage << ")" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,406 @@
+// tools/replay_bench.cpp
+// 撮合引擎重播基準：把錄下的輸入（日誌目錄或 FIX 文字檔）全速送進 MatchingEngine，
+// 回報只做雜湊不做輸出，量測純撮合吞吐量與延遲，並以回報雜湊確認最佳化前後撮合結果不變。
+//
+// 用法: replay_bench <journal 目錄 | fix_messages_only.txt> [--repeat N] [--runs N] [--window N] [--batch-size N]
+//   --repeat N      同一次執行中把輸入重複 N 次（OrderID 依次位移，掛單會累積在簿中），預設 1
+//   --runs N        以全新引擎執行 N 次，每次的回報雜湊必須相同，預設 3
+//   --window N      已送出但尚未回報的輸入上限（決定排隊深度與端到端延遲），預設 1024
+//   --batch-size N  撮合執行緒每批最多處理筆數，預設同 MatchingEngine
+// 日誌目錄若含 shard-<i> 子目錄（ShardedMatchingEngine 的日誌），依分片順序串接；
+// 各分片的標的互不重疊，串接後在單一引擎上重播結果相同。
+// 執行期間日誌等級提高到 Warn；建議以 Release 編譯並關閉 ENABLE_MATCHING_DEBUG。
+#include "core/async_logger.h"
+#include "core/journal.h"
+#include "core/matching_engine.h"
+#include "core/sharded_matching_engine.h"
+#include "trading_system.h"
+#include "protocol/fix_message_view.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace mts::core;
+using namespace mts::protocol;
+
+namespace {
+
+    // 重播前已完全展開在記憶體中的輸入，量測期間不做任何 I/O 或解析
+    using ReplayInput = JournalEntry;
+
+    bool loadJournal(const std::string& directory, std::vector<ReplayInput>& inputs, std::string& error) {
+        std::vector<std::string> directories;
+        for (size_t shard = 0;; ++shard) {
+            std::string shardDirectory = ShardedMatchingEngine::journalShardDirectory(directory, shard);
+            if (!std::filesystem::is_directory(shardDirectory)) {
+                break;
+            }
+            directories.push_back(shardDirectory);
+        }
+        if (directories.empty()) {
+            directories.push_back(directory);
+        }
+
+        for (const auto& path : directories) {
+            std::vector<JournalEntry> entries;
+            if (!readJournal(path, entries, error)) {
+                return false;
+            }
+            std::cout << "📂 Loaded " << entries.size() << " journal records from " << path << std::endl;
+            inputs.insert(inputs.end(), entries.begin(), entries.end());
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    // D → 新訂單（依序配發 OrderID）、F → 取消、G → 改單；其餘訊息類型略過
+    bool loadFix(const std::string& path, std::vector<ReplayInput>& inputs, std::string& error) {
+        std::ifstream file(path);
+        if (!file) {
+            error = "Cannot open " + path;
+            return false;
+        }
+
+        std::unordered_map<std::string, OrderID> clOrdIds;   // 以 SenderCompID + ClOrdID 為鍵
+        OrderID nextOrderId = 1;
+        size_t lines = 0;
+        size_t skipped = 0;
+        std::string line;
+        while (std::getline(file, line)) {
+            while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) {
+                line.pop_back();
+            }
+            if (line.rfind("8=", 0) != 0) {
+                continue;
+            }
+            ++lines;
+
+            ReplayInput input;
+            try {
+                FixMessageView msg = FixMessageView::parseUnsafe(line);   // 錄下的輸入視為可信，不驗 checksum
+                std::string sender(msg.getField(FixMessage::SenderCompID));
+                std::string_view msgType = msg.getField(FixMessage::MsgType);
+                if (msgType == "D") {
+                    std::string_view clOrdId = msg.getField(11);
+                    std::string symbol(msg.getField(55));
+                    input.type = JournalRecordType::NewOrder;
+                    input.orderId = nextOrderId;
+                    input.clientId = sender;
+                    input.symbol = symbol;
+                    input.side = parseFixSide(msg.getField(54));
+                    input.orderType = parseFixOrderType(msg.getField(40));
+                    if (clOrdId.empty() || !parseNumber(msg.getField(38), input.quantity)) {
+                        throw std::invalid_argument("missing ClOrdID or OrderQty");
+                    }
+                    if (input.orderType != OrderType::Market &&
+                        !PriceScaleRegistry::get(symbol).parse(msg.getField(44), input.price)) {
+                        throw std::invalid_argument("invalid Price");
+                    }
+                    // 與 TradingSystem 相同：Order 建構失敗的訊息不會進入撮合引擎
+                    Order probe(input.orderId, input.clientId, input.symbol, input.side,
+                                input.orderType, input.price, input.quantity);
+                    clOrdIds[sender + '\x01' + std::string(clOrdId)] = nextOrderId++;
+                } else if (msgType == "F" || msgType == "G") {
+                    auto it = clOrdIds.find(sender + '\x01' + std::string(msg.getField(41)));
+                    if (it == clOrdIds.end()) {
+                        throw std::invalid_argument("unknown OrigClOrdID");
+                    }
+                    input.orderId = it->second;
+                    if (msgType == "F") {
+                        input.type = JournalRecordType::CancelOrder;
+                        input.reason = "User requested";
+                    } else {
+                        std::string symbol(msg.getField(55));
+                        input.type = JournalRecordType::ModifyOrder;
+                        if (!parseNumber(msg.getField(38), input.quantity) ||
+                            !PriceScaleRegistry::get(symbol).parse(msg.getField(44), input.price)) {
+                            throw std::invalid_argument("invalid replace fields");
+                        }
+                    }
+                } else {
+                    ++skipped;
+                    continue;
+                }
+            } catch (const std::exception&) {
+                ++skipped;
+                continue;
+            }
+            inputs.push_back(std::move(input));
+        }
+
+        std::cout << "📂 Loaded " << inputs.size() << " engine messages from " << lines
+                  << " FIX lines in " << path << " (" << skipped << " skipped)" << std::endl;
+        return true;
+    }
+
+    // ===== 回報雜湊 =====
+
+    // FNV-1a；只納入決定性的欄位（不含時間戳記）
+    class ReportHasher {
+    public:
+        void add(const ExecutionReport& report) {
+            mix(report.orderId);
+            mix(report.counterOrderId);
+            mix(report.symbol.str());
+            mix(static_cast<uint64_t>(report.side));
+            mix(static_cast<uint64_t>(report.orderType));
+            mix(static_cast<uint64_t>(report.status));
+            mix(static_cast<uint64_t>(report.price.ticks()));
+            mix(report.originalQuantity);
+            mix(report.filledQuantity);
+            mix(report.remainingQuantity);
+            mix(static_cast<uint64_t>(report.executionPrice.ticks()));
+            mix(report.executionQuantity);
+            mix(report.rejectReason);
+            ++count_;
+        }
+
+        uint64_t value() const noexcept { return hash_; }
+        uint64_t count() const noexcept { return count_; }
+
+    private:
+        void mix(uint64_t value) {
+            for (int i = 0; i < 8; ++i) {
+                hash_ = (hash_ ^ ((value >> (i * 8)) & 0xff)) * 1099511628211ULL;
+            }
+        }
+
+        void mix(const std::string& text) {
+            mix(static_cast<uint64_t>(text.size()));
+            for (unsigned char c : text) {
+                hash_ = (hash_ ^ c) * 1099511628211ULL;
+            }
+        }
+
+        uint64_t hash_ = 14695981039346656037ULL;
+        uint64_t count_ = 0;
+    };
+
+    // ===== 單次重播 =====
+
+    struct RunResult {
+        uint64_t messages = 0;
+        uint64_t reports = 0;
+        uint64_t trades = 0;
+        uint64_t rejected = 0;
+        uint64_t errors = 0;
+        std::string firstError;
+        uint64_t hash = 0;
+        double seconds = 0;
+        LatencyHistogram endToEnd;   // 送出 → 回報到達批次回呼
+        LatencySnapshot latency;     // 撮合引擎內部量測
+    };
+
+    uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    RunResult runReplay(const std::vector<ReplayInput>& inputs, size_t repeat, uint64_t window, size_t batchSize) {
+        // 每輪位移 OrderID 的低位元，分片標記（高 8 位元）保持不變
+        constexpr OrderID LOCAL_MASK = (OrderID(1) << ShardedMatchingEngine::SHARD_TAG_SHIFT) - 1;
+        OrderID maxLocalId = 0;
+        size_t newOrders = 0;
+        for (const auto& input : inputs) {
+            maxLocalId = std::max(maxLocalId, input.orderId & LOCAL_MASK);
+            newOrders += input.type == JournalRecordType::NewOrder;
+        }
+
+        size_t poolCapacity = std::max<size_t>(OrderPool::DEFAULT_CAPACITY, newOrders * repeat + 1);
+        MatchingEngine engine(poolCapacity);
+        engine.enableMarketData(false);
+        if (batchSize > 0) {
+            engine.setBatchSize(batchSize);
+        }
+
+        // 撮合執行緒對每筆輸入恰好產生一筆回報且依序送出，第 k 筆回報對應第 k 筆被接受的輸入
+        RunResult result;
+        ReportHasher hasher;
+        std::vector<uint64_t> submitNs(inputs.size() * repeat);
+        std::atomic<uint64_t> reported{0};
+        engine.setExecutionBatchCallback([&](const ExecutionReportPtr* reports, size_t count) {
+            uint64_t now = nowNs();
+            uint64_t index = reported.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < count; ++i, ++index) {
+                hasher.add(*reports[i]);
+                result.endToEnd.record(now - submitNs[index]);
+            }
+            reported.store(index, std::memory_order_release);
+        });
+        engine.setErrorCallback([&result](const std::string& message) {
+            if (result.errors++ == 0) {
+                result.firstError = message;
+            }
+        });
+        engine.start();
+
+        // 等待撮合執行緒追上；若輸入處理時拋出例外而少了回報，停滯一秒後放棄等待
+        auto waitForReports = [&reported](uint64_t target) {
+            uint64_t last = reported.load(std::memory_order_acquire);
+            auto lastProgress = std::chrono::steady_clock::now();
+            while (last < target) {
+                std::this_thread::yield();
+                uint64_t current = reported.load(std::memory_order_acquire);
+                if (current != last) {
+                    last = current;
+                    lastProgress = std::chrono::steady_clock::now();
+                } else if (std::chrono::steady_clock::now() - lastProgress > std::chrono::seconds(1)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        uint64_t accepted = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < repeat; ++round) {
+            const OrderID offset = static_cast<OrderID>(round) * (maxLocalId + 1);
+            for (const auto& input : inputs) {
+                // 單一生產者：未回報的輸入不超過 window（≤ 佇列容量的一半），tryPush 不會失敗
+                if (accepted - reported.load(std::memory_order_acquire) >= window &&
+                    !waitForReports(accepted - window + 1)) {
+                    break;
+                }
+                OrderID orderId = input.orderId + offset;
+                submitNs[accepted] = nowNs();
+                bool ok = false;
+                switch (input.type) {
+                    case JournalRecordType::NewOrder:
+                        ok = engine.submitOrder(engine.createOrder(orderId, input.clientId, input.symbol, input.side,
+                                                                   input.orderType, input.price, input.quantity,
+                                                                   input.timeInForce));
+                        break;
+                    case JournalRecordType::CancelOrder:
+                        ok = engine.cancelOrder(orderId, input.reason);
+                        break;
+                    case JournalRecordType::ModifyOrder:
+                        ok = engine.modifyOrder(orderId, input.price, input.quantity);
+                        break;
+                }
+                accepted += ok;
+                ++result.messages;
+            }
+        }
+        waitForReports(accepted);
+        auto end = std::chrono::steady_clock::now();
+        engine.stop();
+
+        const auto& stats = engine.getStatistics();
+        result.seconds = std::chrono::duration<double>(end - start).count();
+        result.reports = hasher.count();
+        result.hash = hasher.value();
+        result.trades = stats.tradesExecuted.load();
+        result.rejected = stats.ordersRejected.load();
+        result.latency = stats.getLatency();
+        return result;
+    }
+
+    void printHistogram(const char* name, const LatencyHistogram& histogram) {
+        std::cout << "  " << std::left << std::setw(8) << name << std::right << histogram.toString() << std::endl;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    size_t repeat = 1;
+    size_t runs = 3;
+    uint64_t window = 1024;
+    size_t batchSize = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--runs" && i + 1 < argc) {
+            runs = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--window" && i + 1 < argc) {
+            window = std::min<uint64_t>(std::max<uint64_t>(1, std::stoull(argv[++i])),
+                                        MatchingEngine::DEFAULT_QUEUE_CAPACITY / 2);
+        } else if (arg == "--batch-size" && i + 1 < argc) {
+            batchSize = std::stoul(argv[++i]);
+        } else {
+            path = arg;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "用法: replay_bench <journal 目錄 | fix 檔案> [--repeat N] [--runs N] [--window N] [--batch-size N]" << std::endl;
+        return 1;
+    }
+
+    // 逐筆除錯日誌會主導量測結果
+    AsyncLogger::instance().setLevel(LogLevel::Warn);
+
+    std::vector<ReplayInput> inputs;
+    std::string error;
+    bool loaded = std::filesystem::is_directory(path) ? loadJournal(path, inputs, error) : loadFix(path, inputs, error);
+    if (!loaded) {
+        std::cerr << "❌ " << error << std::endl;
+        return 1;
+    }
+    if (inputs.empty()) {
+        std::cerr << "❌ No replayable messages in " << path << std::endl;
+        return 1;
+    }
+
+    std::cout << "⚙️  " << inputs.size() << " messages x " << repeat << " repeat(s), "
+              << runs << " run(s), window " << window << std::endl;
+
+    std::vector<RunResult> results;
+    for (size_t run = 0; run < runs; ++run) {
+        results.push_back(runReplay(inputs, repeat, window, batchSize));
+        const RunResult& result = results.back();
+        std::cout << "  run " << run + 1 << ": " << std::fixed << std::setprecision(0)
+                  << result.messages / result.seconds << " msgs/s, "
+                  << result.reports << " reports, hash=" << std::hex << std::setw(16) << std::setfill('0')
+                  << result.hash << std::dec << std::setfill(' ') << std::endl;
+    }
+
+    // 以最快的一次作為吞吐量，延遲分佈合併所有執行
+    const RunResult* best = &results.front();
+    LatencyHistogram endToEnd;
+    LatencySnapshot latency;
+    bool deterministic = true;
+    for (const auto& result : results) {
+        if (result.seconds < best->seconds) {
+            best = &result;
+        }
+        endToEnd.merge(result.endToEnd);
+        latency.merge(result.latency);
+        deterministic = deterministic && result.hash == results.front().hash && result.reports == results.front().reports;
+    }
+
+    std::cout << "\n📊 Replay Benchmark (" << path << ")" << std::endl;
+    std::cout << std::string(72, '-') << std::endl;
+    std::cout << "  messages   " << best->messages << " in " << std::setprecision(3) << best->seconds * 1000.0 << " ms" << std::endl;
+    std::cout << "  throughput " << std::setprecision(0) << best->messages / best->seconds << " msgs/s" << std::endl;
+    std::cout << "  reports    " << best->reports << " (trades " << best->trades << ", rejected " << best->rejected
+              << ", errors " << best->errors << ")" << std::endl;
+    if (!best->firstError.empty()) {
+        std::cout << "  first error: " << best->firstError << std::endl;
+    }
+    std::cout << "  latency" << std::endl;
+    printHistogram("e2e", endToEnd);
+    printHistogram("new", latency.newOrder);
+    printHistogram("cancel", latency.cancelOrder);
+    printHistogram("modify", latency.modifyOrder);
+    printHistogram("queue", latency.queueDelay);
+    std::cout << "  hash       " << std::hex << std::setw(16) << std::setfill('0') << results.front().hash << std::dec
+              << std::setfill(' ') << (deterministic ? "  ✅ identical across runs" : "  ❌ differs between runs") << std::endl;
+
+    return deterministic ? 0 : 2;
+}
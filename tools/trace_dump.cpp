@@ -0,0 +1,119 @@
+// tools/trace_dump.cpp
+// 訂單生命週期追蹤檔分析：各階段延遲分佈與最慢的訂單
+//
+// 用法: trace_dump <trace file> [--slowest N]
+// 追蹤檔由 mts_app --trace <file> 產生；TSC 計數以檔頭記錄的頻率換算為奈秒。
+#include "core/order_trace.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace mts::core;
+
+namespace {
+
+    struct OrderTimeline {
+        OrderID orderId = 0;
+        uint64_t tsc[TRACE_STAGE_COUNT] = {};
+        bool present[TRACE_STAGE_COUNT] = {};
+        uint64_t totalNs = 0;
+    };
+
+    // 與 analyzeTrace 相同的規則：每個階段取最早出現的時間
+    std::vector<OrderTimeline> buildTimelines(const std::vector<TraceEvent>& events, double ticksPerNs) {
+        std::map<OrderID, OrderTimeline> byOrder;
+        for (const auto& event : events) {
+            OrderTimeline& timeline = byOrder[event.orderId];
+            timeline.orderId = event.orderId;
+            size_t stage = static_cast<size_t>(event.stage);
+            if (!timeline.present[stage] || event.tsc < timeline.tsc[stage]) {
+                timeline.tsc[stage] = event.tsc;
+                timeline.present[stage] = true;
+            }
+        }
+
+        std::vector<OrderTimeline> timelines;
+        timelines.reserve(byOrder.size());
+        const size_t recv = static_cast<size_t>(TraceStage::Recv);
+        const size_t send = static_cast<size_t>(TraceStage::Send);
+        for (auto& pair : byOrder) {
+            OrderTimeline& timeline = pair.second;
+            if (timeline.present[recv] && timeline.present[send] && timeline.tsc[send] > timeline.tsc[recv]) {
+                timeline.totalNs = static_cast<uint64_t>((timeline.tsc[send] - timeline.tsc[recv]) / ticksPerNs);
+                timelines.push_back(timeline);
+            }
+        }
+        return timelines;
+    }
+
+    void printSlowest(std::vector<OrderTimeline> timelines, size_t count, double ticksPerNs) {
+        std::sort(timelines.begin(), timelines.end(), [](const OrderTimeline& a, const OrderTimeline& b) {
+            return a.totalNs > b.totalNs;
+        });
+        count = std::min(count, timelines.size());
+
+        std::cout << "\n🐢 Slowest " << count << " complete orders (μs from previous stage)" << std::endl;
+        std::cout << std::left << std::setw(22) << "OrderID" << std::right << std::setw(10) << "total";
+        for (size_t stage = 1; stage < TRACE_STAGE_COUNT; ++stage) {
+            std::cout << std::setw(10) << std::string(traceStageToString(static_cast<TraceStage>(stage))).substr(0, 9);
+        }
+        std::cout << std::endl;
+
+        for (size_t i = 0; i < count; ++i) {
+            const OrderTimeline& timeline = timelines[i];
+            std::cout << std::left << std::setw(22) << timeline.orderId
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(10) << timeline.totalNs / 1000.0;
+            size_t previous = static_cast<size_t>(TraceStage::Recv);
+            for (size_t stage = 1; stage < TRACE_STAGE_COUNT; ++stage) {
+                if (!timeline.present[stage]) {
+                    std::cout << std::setw(10) << "-";
+                    continue;
+                }
+                uint64_t delta = timeline.tsc[stage] > timeline.tsc[previous]
+                    ? timeline.tsc[stage] - timeline.tsc[previous] : 0;
+                std::cout << std::setw(10) << delta / ticksPerNs / 1000.0;
+                previous = stage;
+            }
+            std::cout << std::endl;
+        }
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    size_t slowest = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--slowest" && i + 1 < argc) {
+            slowest = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (path.empty()) {
+            path = arg;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <trace file> [--slowest N]" << std::endl;
+        return 1;
+    }
+
+    std::vector<TraceEvent> events;
+    double ticksPerNs = 1.0;
+    std::string error;
+    if (!readTraceFile(path, events, ticksPerNs, error)) {
+        std::cerr << "❌ " << error << std::endl;
+        return 1;
+    }
+
+    std::cout << "📂 " << path << ": " << events.size() << " events, "
+              << std::fixed << std::setprecision(3) << ticksPerNs << " ticks/ns" << std::endl;
+    std::cout << analyzeTrace(events, ticksPerNs).toString() << std::endl;
+
+    if (slowest > 0) {
+        printSlowest(buildTimelines(events, ticksPerNs), slowest, ticksPerNs);
+    }
+    return 0;
+}